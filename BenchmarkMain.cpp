@@ -0,0 +1,425 @@
+/**
+ * @file BenchmarkMain.cpp
+ * @brief 规模基准测试程序（MyAppBenchmark）。
+ * @details 生成（或复用）不同规模的合成地形点云与网格，无界面、不渲染地计时模型加载、Z 轴拉伸、箱体裁剪、
+ *          切面（仅网格）和拾取（点块索引，vtkPointPicker 为基线），以及量化坐标存储的编码、解码与 float 数组复制的对比，
+ *          结果写为 CSV 与 JSON，用于跟踪规模曲线和发现版本间的性能回退。
+ *          渲染请求交给不运行事件循环的 RenderScheduler，因此不需要 OpenGL 上下文，可在纯 CPU 的 Linux 机器上运行。
+ *
+ *          用法示例：
+ *            MyAppBenchmark --sizes 1M,10M,100M,1B --kinds cloud,mesh --repeat 3 --data-dir /data/bench
+ */
+#include "SyntheticDataGenerator.h"
+#include "ModelPinelineBuilder.h"
+#include "BoxClipperController.h"
+#include "MeshSliceController.h"
+#include "RenderScheduler.h"
+#include "PipelineProfiler.h"
+#include "QuantizedPointStore.h"
+#include "PointBlockIndex.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <vtkSmartPointer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkPointPicker.h>
+#include <vtkCamera.h>
+#include <vtkMath.h>
+#include <vtkMapper.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    /**
+     * @struct BenchmarkRow
+     * @brief 一次计时结果。
+     */
+    struct BenchmarkRow
+    {
+        std::string kind;           ///< cloud / mesh
+        std::int64_t points = 0;    ///< 数据点数
+        std::string operation;      ///< 操作或阶段名称
+        int repeat = 0;             ///< 第几次重复
+        double milliseconds = 0.0;  ///< 耗时
+        std::int64_t result = -1;   ///< 操作结果（输出点数、拾取点号、生成文件字节数），-1 表示无
+    };
+
+    double timeMilliseconds(const std::function<void()> &work)
+    {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    // 解析 "1M"、"250k"、"1B"、"1e6" 等规模写法
+    std::int64_t parseSize(QString text)
+    {
+        text = text.trimmed().toUpper();
+        double factor = 1.0;
+        if (text.endsWith('K'))
+            factor = 1e3;
+        else if (text.endsWith('M'))
+            factor = 1e6;
+        else if (text.endsWith('B') || text.endsWith('G'))
+            factor = 1e9;
+        if (factor != 1.0)
+            text.chop(1);
+        bool ok = false;
+        double value = text.toDouble(&ok);
+        return ok ? static_cast<std::int64_t>(value * factor) : 0;
+    }
+
+    bool writeCsv(const std::string &path, const std::vector<BenchmarkRow> &rows)
+    {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "[Benchmark] Cannot open " << path << std::endl;
+            return false;
+        }
+        out << "kind,points,operation,repeat,milliseconds,result\n";
+        out << std::fixed << std::setprecision(3);
+        for (const BenchmarkRow &row : rows)
+        {
+            out << row.kind << ',' << row.points << ',' << row.operation << ',' << row.repeat << ','
+                << row.milliseconds << ',' << row.result << '\n';
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool writeJson(const std::string &path, const std::vector<BenchmarkRow> &rows)
+    {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "[Benchmark] Cannot open " << path << std::endl;
+            return false;
+        }
+        out << std::fixed << std::setprecision(3);
+        out << "{\"results\":[\n";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+        {
+            const BenchmarkRow &row = rows[i];
+            out << "{\"kind\":\"" << row.kind << "\",\"points\":" << row.points << ",\"operation\":\"" << row.operation
+                << "\",\"repeat\":" << row.repeat << ",\"milliseconds\":" << row.milliseconds
+                << ",\"result\":" << row.result << "}" << (i + 1 < rows.size() ? ",\n" : "\n");
+        }
+        out << "]}\n";
+        return static_cast<bool>(out);
+    }
+
+    // 每个 (数据, 操作) 的中位数耗时汇总到标准输出
+    void printSummary(const std::vector<BenchmarkRow> &rows)
+    {
+        std::vector<const BenchmarkRow *> pending;
+        for (const BenchmarkRow &row : rows)
+            pending.push_back(&row);
+
+        std::cout << "\n"
+                  << std::left << std::setw(6) << "kind" << std::right << std::setw(14) << "points" << "  "
+                  << std::left << std::setw(32) << "operation" << std::right << std::setw(12) << "median ms" << "\n";
+        while (!pending.empty())
+        {
+            const BenchmarkRow *first = pending.front();
+            std::vector<double> samples;
+            auto rest = std::stable_partition(pending.begin(), pending.end(), [&](const BenchmarkRow *row)
+                                              { return !(row->kind == first->kind && row->points == first->points &&
+                                                         row->operation == first->operation); });
+            for (auto it = rest; it != pending.end(); ++it)
+                samples.push_back((*it)->milliseconds);
+            pending.erase(rest, pending.end());
+
+            std::sort(samples.begin(), samples.end());
+            std::cout << std::left << std::setw(6) << first->kind << std::right << std::setw(14) << first->points
+                      << "  " << std::left << std::setw(32) << first->operation << std::right << std::setw(12)
+                      << std::fixed << std::setprecision(2) << samples[samples.size() / 2] << "\n";
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv); // 仅为 RenderScheduler 的定时器提供事件分发器，不进入事件循环
+    QCoreApplication::setApplicationName("MyAppBenchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Scale benchmark for model loading, Z stretch, clipping, slicing and picking.");
+    parser.addHelpOption();
+    QCommandLineOption sizesOption("sizes", "Comma separated point counts, e.g. 1M,10M,100M,1B.", "list",
+                                   "1M,10M,100M");
+    QCommandLineOption kindsOption("kinds", "Datasets to run: cloud (binary PLY), mesh (OBJ).", "list", "cloud,mesh");
+    QCommandLineOption repeatOption("repeat", "Repetitions per dataset.", "n", "3");
+    QCommandLineOption dataDirOption("data-dir", "Directory for generated datasets (reused when present).", "dir",
+                                     "benchmark_data");
+    QCommandLineOption csvOption("csv", "CSV output path.", "file", "benchmark_results.csv");
+    QCommandLineOption jsonOption("json", "JSON output path.", "file", "benchmark_results.json");
+    QCommandLineOption cleanupOption("cleanup", "Delete each generated dataset after it has been measured.");
+    QCommandLineOption quantizeOption("quantize-error", "Error bound of the quantized point store, in model units.",
+                                      "value", "0.001");
+    parser.addOptions({sizesOption, kindsOption, repeatOption, dataDirOption, csvOption, jsonOption, cleanupOption,
+                       quantizeOption});
+    parser.process(app);
+
+    std::vector<std::int64_t> sizes;
+    for (const QString &text : parser.value(sizesOption).split(',', QString::SkipEmptyParts))
+    {
+        std::int64_t size = parseSize(text);
+        if (size <= 0)
+        {
+            std::cerr << "[Benchmark] Invalid size: " << text.toStdString() << std::endl;
+            return 1;
+        }
+        sizes.push_back(size);
+    }
+    QStringList kinds = parser.value(kindsOption).split(',', QString::SkipEmptyParts);
+    int repeats = std::max(1, parser.value(repeatOption).toInt());
+    double quantizeError = parser.value(quantizeOption).toDouble();
+    if (quantizeError <= 0.0)
+    {
+        std::cerr << "[Benchmark] Invalid quantize error: " << parser.value(quantizeOption).toStdString() << std::endl;
+        return 1;
+    }
+    QDir dataDir(parser.value(dataDirOption));
+    if (!dataDir.exists() && !QDir().mkpath(dataDir.path()))
+    {
+        std::cerr << "[Benchmark] Cannot create data directory: " << dataDir.path().toStdString() << std::endl;
+        return 1;
+    }
+
+    // 离屏窗口只提供相机与视口尺寸，整个过程中不调用 Render()
+    auto renderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+    renderWindow->SetOffScreenRendering(1);
+    renderWindow->SetSize(1280, 720);
+    auto renderer = vtkSmartPointer<vtkRenderer>::New();
+    renderWindow->AddRenderer(renderer);
+    auto interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+    interactor->SetRenderWindow(renderWindow);
+    RenderScheduler scheduler(renderWindow);
+
+    std::vector<BenchmarkRow> rows;
+    for (const QString &kindName : kinds)
+    {
+        const bool isMesh = kindName.trimmed() == "mesh";
+        if (!isMesh && kindName.trimmed() != "cloud")
+        {
+            std::cerr << "[Benchmark] Unknown dataset kind: " << kindName.toStdString() << std::endl;
+            continue;
+        }
+        const std::string kind = isMesh ? "mesh" : "cloud";
+
+        for (std::int64_t size : sizes)
+        {
+            TerrainOptions options;
+            options.pointCount = size;
+            SyntheticDataGenerator generator(options);
+            const std::int64_t points = isMesh ? generator.getMeshVertexCount() : size;
+
+            BenchmarkRow base;
+            base.kind = kind;
+            base.points = points;
+
+            // 生成数据（已存在时复用）
+            QString fileName = QString("terrain_%1_%2.%3").arg(QString::fromStdString(kind)).arg(size).arg(isMesh ? "obj" : "ply");
+            QString filePath = dataDir.filePath(fileName);
+            if (!QFileInfo::exists(filePath))
+            {
+                std::cout << "[Benchmark] Generating " << filePath.toStdString() << std::endl;
+                bool written = false;
+                BenchmarkRow row = base;
+                row.operation = "generate";
+                row.milliseconds = timeMilliseconds([&]()
+                                                    { written = isMesh ? generator.writeMeshObj(filePath.toStdString())
+                                                                       : generator.writePointCloudPly(filePath.toStdString()); });
+                if (!written)
+                {
+                    QFile::remove(filePath);
+                    return 1;
+                }
+                row.result = QFileInfo(filePath).size();
+                rows.push_back(row);
+            }
+
+            for (int repeat = 0; repeat < repeats; ++repeat)
+            {
+                std::cout << "[Benchmark] " << kind << " " << points << " points, run " << repeat + 1 << "/" << repeats
+                          << std::endl;
+                base.repeat = repeat;
+                auto record = [&](const std::string &operation, double milliseconds, std::int64_t result)
+                {
+                    BenchmarkRow row = base;
+                    row.operation = operation;
+                    row.milliseconds = milliseconds;
+                    row.result = result;
+                    rows.push_back(row);
+                };
+
+                // 加载（含读取与默认管线），并记录 PipelineProfiler 中的子阶段
+                ModelPipelineBuilder builder;
+                bool loaded = false;
+                PipelineProfiler::instance().reset();
+                double loadMs = timeMilliseconds([&]()
+                                                 { loaded = builder.loadModel(filePath); });
+                if (!loaded)
+                {
+                    std::cerr << "[Benchmark] Failed to load " << filePath.toStdString() << std::endl;
+                    return 1;
+                }
+                vtkSmartPointer<vtkPolyData> polyData = builder.getProcessedPolyData();
+                record("loadModel", loadMs, polyData->GetNumberOfPoints());
+                for (const PipelineProfiler::StageStats &stage : PipelineProfiler::instance().snapshot())
+                    record("loadModel/" + stage.name, stage.last, -1);
+
+                record("setZAxisScale", timeMilliseconds([&]()
+                                                         { builder.setZAxisScale(2.0); }),
+                       -1);
+                polyData = builder.getProcessedPolyData();
+
+                // 量化存储：编码（结果为字节数）、解码与 float 数组复制（结果为点数）、实测最大误差（微米）
+                {
+                    vtkPoints *positions = polyData->GetPoints();
+                    QuantizedPointStore store;
+                    double encodeMs = timeMilliseconds([&]()
+                                                       { store.encode(positions, quantizeError); });
+                    record("quantize.encode", encodeMs, static_cast<std::int64_t>(store.getMemorySize()));
+                    vtkSmartPointer<vtkPoints> decoded;
+                    double decodeMs = timeMilliseconds([&]()
+                                                       { decoded = store.decode(); });
+                    record("quantize.decode", decodeMs, decoded->GetNumberOfPoints());
+                    auto copy = vtkSmartPointer<vtkPoints>::New();
+                    double copyMs = timeMilliseconds([&]()
+                                                     { copy->DeepCopy(positions); });
+                    record("float.copy", copyMs, copy->GetNumberOfPoints());
+                    record("quantize.maxErrorUm", 0.0, std::llround(store.getMaxError() * 1e6));
+                }
+
+                vtkActor *actor = builder.getActor();
+                renderer->AddActor(actor);
+                renderer->ResetCamera();
+
+                // 箱体裁剪：初始放置（整个模型），再裁剪到中心一半大小的盒子
+                {
+                    BoxClipperController clipper(interactor, renderer);
+                    clipper.SetRenderScheduler(&scheduler);
+                    record("clip.place", timeMilliseconds([&]()
+                                                          { clipper.SetInputDataAndReplaceOriginal(polyData, actor); }),
+                           -1);
+                    double bounds[6];
+                    polyData->GetBounds(bounds);
+                    double box[6];
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        double center = 0.5 * (bounds[2 * axis] + bounds[2 * axis + 1]);
+                        double half = 0.25 * (bounds[2 * axis + 1] - bounds[2 * axis]);
+                        box[2 * axis] = center - half;
+                        box[2 * axis + 1] = center + half;
+                    }
+                    box[4] = bounds[4]; // Z 方向保留全部高度
+                    box[5] = bounds[5];
+                    double clipMs = timeMilliseconds([&]()
+                                                     { clipper.SetBoxBounds(box); });
+                    auto clipped = vtkPolyData::SafeDownCast(clipper.GetClippedActor()->GetMapper()->GetInput());
+                    record("clip", clipMs, clipped ? clipped->GetNumberOfPoints() : -1);
+                }
+
+                // 过中心的水平切面：vtkCutter 只与面相交，点云没有交点，不计时
+                if (isMesh)
+                {
+                    MeshSliceController slicer(renderer);
+                    slicer.SetRenderScheduler(&scheduler);
+                    slicer.SetOriginalActor(actor);
+                    slicer.UpdatePolyData(polyData);
+                    double sliceMs = timeMilliseconds([&]()
+                                                      { slicer.ShowSlice(SLICE_Z); });
+                    record("slice", sliceMs, slicer.GetSliceOutput()->GetNumberOfPoints());
+                    actor->VisibilityOn();
+                }
+
+                // 视口中心的点拾取：与测量控制器相同，用点块索引沿射线拾取（射线与容差的换算同
+                // MeasurementController::pickWithIndex）；vtkPointPicker 作为基线单独记录
+                {
+                    int *windowSize = renderWindow->GetSize();
+                    const int x = windowSize[0] / 2;
+                    const int y = windowSize[1] / 2;
+                    auto displayToWorld = [&](double dx, double dy, double dz, double world[3])
+                    {
+                        renderer->SetDisplayPoint(dx, dy, dz);
+                        renderer->DisplayToWorld();
+                        double homogeneous[4];
+                        renderer->GetWorldPoint(homogeneous);
+                        for (int axis = 0; axis < 3; ++axis)
+                            world[axis] = homogeneous[3] != 0.0 ? homogeneous[axis] / homogeneous[3] : homogeneous[axis];
+                    };
+
+                    PointBlockIndex index;
+                    record("pick.indexBuild", timeMilliseconds([&]()
+                                                               { index.build(polyData); }),
+                           index.getNumberOfBlocks());
+
+                    double p0[3];
+                    double p1[3];
+                    displayToWorld(x, y, 0.0, p0);
+                    displayToWorld(x, y, 1.0, p1);
+                    double focalPoint[3];
+                    renderer->GetActiveCamera()->GetFocalPoint(focalPoint);
+                    renderer->SetWorldPoint(focalPoint[0], focalPoint[1], focalPoint[2], 1.0);
+                    renderer->WorldToDisplay();
+                    double focalDisplay[3];
+                    renderer->GetDisplayPoint(focalDisplay);
+                    double tolerancePixels = 0.025 * std::sqrt(double(windowSize[0]) * windowSize[0] +
+                                                               double(windowSize[1]) * windowSize[1]);
+                    double a[3];
+                    double b[3];
+                    displayToWorld(x, y, focalDisplay[2], a);
+                    displayToWorld(x + tolerancePixels, y, focalDisplay[2], b);
+                    double tolerance = std::sqrt(vtkMath::Distance2BetweenPoints(a, b));
+
+                    vtkIdType pointId = -1;
+                    double pickMs = timeMilliseconds([&]()
+                                                     { pointId = index.pickPoint(p0, p1, tolerance); });
+                    record("pick", pickMs, pointId);
+
+                    auto picker = vtkSmartPointer<vtkPointPicker>::New();
+                    double pickerMs = timeMilliseconds([&]()
+                                                       { picker->Pick(x, y, 0, renderer); });
+                    record("pick.vtkPointPicker", pickerMs, picker->GetPointId());
+                }
+
+                // 紧凑存储原始坐标后重建管线（含解码），与上面的 setZAxisScale 对比
+                if (!isMesh && builder.setCompactPositions(quantizeError))
+                {
+                    record("setZAxisScale.compact", timeMilliseconds([&]()
+                                                                     { builder.setZAxisScale(1.0); }),
+                           static_cast<std::int64_t>(builder.getCompactPositions().getMemorySize()));
+                }
+
+                renderer->RemoveAllViewProps();
+            }
+
+            if (parser.isSet(cleanupOption))
+                QFile::remove(filePath);
+        }
+    }
+
+    printSummary(rows);
+    bool ok = writeCsv(parser.value(csvOption).toStdString(), rows);
+    ok = writeJson(parser.value(jsonOption).toStdString(), rows) && ok;
+    if (ok)
+    {
+        std::cout << "[Benchmark] Wrote " << rows.size() << " results to " << parser.value(csvOption).toStdString()
+                  << " and " << parser.value(jsonOption).toStdString() << std::endl;
+    }
+    return ok ? 0 : 1;
+}
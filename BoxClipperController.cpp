@@ -1,4 +1,11 @@
 #include "BoxClipperController.h"
+#include "RenderScheduler.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+#include "MemoryReport.h"
+#include "InteractionRecorder.h"
+#include "PointBlockIndex.h"
+#include "SpatialReorder.h"
 
 #include <vtkBoxWidget.h>
 #include <vtkPlanes.h>
@@ -10,18 +17,21 @@
 #include <vtkProperty.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
+#include <vtkTransform.h>
+#include <vtkMatrix4x4.h>
+#include <iostream>
 
 BoxClipperController::BoxClipperController(vtkRenderWindowInteractor *interactor, vtkRenderer *renderer)
     : interactor(interactor), renderer(renderer)
 {
-    originalActor = nullptr;
     // 裁剪用平面集（由 BoxWidget 生成）
     clipPlanes = vtkSmartPointer<vtkPlanes>::New();
     // 裁剪器：使用 box widget 的平面集进行裁剪
     clipper = vtkSmartPointer<vtkClipPolyData>::New();
-    // 映射器连接裁剪器的输出
+    // 映射器使用裁剪结果（vtkClipPolyData 输出或点云快速裁剪结果）
+    clippedData = vtkSmartPointer<vtkPolyData>::New();
     vtkSmartPointer<vtkPolyDataMapper> mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputConnection(clipper->GetOutputPort());
+    mapper->SetInputData(clippedData);
     // 显示裁剪后模型的 actor
     clippedActor = vtkSmartPointer<vtkActor>::New();
     clippedActor->SetMapper(mapper);
@@ -39,6 +49,14 @@ BoxClipperController::BoxClipperController(vtkRenderWindowInteractor *interactor
                           {
                               auto self = static_cast<BoxClipperController *>(clientData);
                               self->UpdateClipping(); // 当 box widget 改变时更新裁剪
+                              if (self->interactionRecorder && self->interactionRecorder->isRecording())
+                              {
+                                  auto transform = vtkSmartPointer<vtkTransform>::New();
+                                  self->GetBoxTransform(transform);
+                                  std::vector<double> matrix(16);
+                                  vtkMatrix4x4::DeepCopy(matrix.data(), transform->GetMatrix());
+                                  self->interactionRecorder->record(InteractionType::BoxTransform, matrix);
+                              }
                           });
 
     boxWidget->AddObserver(vtkCommand::InteractionEvent, callback); // 绑定观察者
@@ -46,14 +64,34 @@ BoxClipperController::BoxClipperController(vtkRenderWindowInteractor *interactor
 // 设置原始输入数据与原始 actor（不拥有生命周期）
 void BoxClipperController::SetInputDataAndReplaceOriginal(vtkSmartPointer<vtkPolyData> input, vtkActor *original)
 {
-    originalActor = original; // 不用智能指针，不控制生命周期
+    std::vector<vtkActor *> originals;
+    if (original)
+        originals.push_back(original);
+    SetInputDataAndReplaceOriginals(input, originals);
+}
+
+// 设置原始输入数据与多个原始 actor（多模型合并裁剪）
+void BoxClipperController::SetInputDataAndReplaceOriginals(vtkSmartPointer<vtkPolyData> input,
+                                                           const std::vector<vtkActor *> &originals)
+{
+    originalActors = originals; // 不用智能指针，不控制生命周期
     inputData = input;
 
+    // 只有顶点单元的点云建立块索引
+    pointIndex.reset();
+    if (inputData && inputData->GetNumberOfPoints() > 0 && inputData->GetNumberOfPolys() == 0 &&
+        inputData->GetNumberOfLines() == 0 && inputData->GetNumberOfStrips() == 0)
+    {
+        pointIndex = std::make_shared<PointBlockIndex>();
+        pointIndex->build(inputData);
+    }
+
     clipper->SetInputData(inputData);
     boxWidget->SetInputData(inputData);
     boxWidget->PlaceWidget();
     // ✅ 拷贝颜色、透明度、边框等属性
-    CopyActorAppearance(originalActor, clippedActor);
+    if (!originalActors.empty())
+        CopyActorAppearance(originalActors.front(), clippedActor);
 
     UpdateClipping(); // 更新 planes 和裁剪结果
     SetEnabled(false);
@@ -64,30 +102,53 @@ void BoxClipperController::SetEnabled(bool enabled)
     boxWidget->SetEnabled(enabled ? 1 : 0); // 开启或关闭 box 控件
     if (enabled)
     {
-        if (originalActor && renderer->HasViewProp(originalActor))
+        for (vtkActor *originalActor : originalActors)
         {
-            renderer->RemoveActor(originalActor); // 移除原始 actor
+            if (renderer->HasViewProp(originalActor))
+                renderer->RemoveActor(originalActor); // 移除原始 actor
         }
         renderer->AddActor(clippedActor); // 启用裁剪后显示 actor
     }
     else
     {
         renderer->RemoveActor(clippedActor);
-        if (originalActor)
-        {
+        for (vtkActor *originalActor : originalActors)
             renderer->AddActor(originalActor);
-        }
     }
-    renderer->GetRenderWindow()->Render();
+    RenderScheduler::requestOrRender(renderScheduler, renderer->GetRenderWindow());
 }
 
 void BoxClipperController::UpdateClipping()
 {
+    ScopedStageTimer timer("Clipper.Update");
+    TRACE_SCOPE("BoxClipperController::UpdateClipping");
     vtkSmartPointer<vtkPlanes> planes = vtkSmartPointer<vtkPlanes>::New();
     boxWidget->GetPlanes(planes);     // 获取当前 box widget 对应的平面
+    if (pointIndex && pointIndex->isBuiltFor(inputData))
+    {
+        ClipPointCloud(planes);
+        return;
+    }
     clipper->SetClipFunction(planes); // 使用这些平面裁剪
     clipper->InsideOutOn();           // 保留 box 内部数据
     clipper->Update();                // 更新裁剪结果
+    clippedData->ShallowCopy(clipper->GetOutput());
+}
+
+void BoxClipperController::ClipPointCloud(vtkPlanes *planes)
+{
+    TRACE_SCOPE("BoxClipperController::ClipPointCloud");
+    std::vector<vtkIdType> ids;
+    int acceptedBlocks = 0;
+    int testedBlocks = 0;
+    pointIndex->collectInside(planes, ids, &acceptedBlocks, &testedBlocks);
+
+    vtkSmartPointer<vtkPolyData> output = SpatialReorder::gatherPoints(inputData, ids);
+    SpatialReorder::addVertexCells(output);
+    clippedData->ShallowCopy(output);
+    const vtkIdType count = static_cast<vtkIdType>(ids.size());
+    std::cout << "[BoxClipperController] Kept " << count << " points (" << acceptedBlocks << " blocks accepted, "
+              << testedBlocks << " blocks tested of " << pointIndex->getNumberOfBlocks() << ")" << std::endl;
 }
 
 void BoxClipperController::CopyActorAppearance(vtkActor *from, vtkActor *to)
@@ -112,3 +173,39 @@ vtkSmartPointer<vtkActor> BoxClipperController::GetClippedActor()
 {
     return clippedActor;
 }
+
+void BoxClipperController::GetBoxBounds(double bounds[6])
+{
+    vtkSmartPointer<vtkPolyData> boxPolyData = vtkSmartPointer<vtkPolyData>::New();
+    boxWidget->GetPolyData(boxPolyData); // 盒子的顶点（含变换）
+    boxPolyData->GetBounds(bounds);
+}
+
+void BoxClipperController::SetBoxBounds(const double bounds[6])
+{
+    double placeBounds[6] = {bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]};
+    boxWidget->PlaceWidget(placeBounds);
+    UpdateClipping();
+    RenderScheduler::requestOrRender(renderScheduler, renderer->GetRenderWindow());
+}
+
+void BoxClipperController::GetBoxTransform(vtkTransform *transform)
+{
+    boxWidget->GetTransform(transform);
+}
+
+void BoxClipperController::SetBoxTransform(vtkTransform *transform)
+{
+    boxWidget->SetTransform(transform);
+    UpdateClipping();
+    RenderScheduler::requestOrRender(renderScheduler, renderer->GetRenderWindow());
+}
+
+void BoxClipperController::AppendMemoryUsage(MemoryReport &report) const
+{
+    // 输入数据属于模型，由 ModelPipelineBuilder 登记
+    report.addPolyData("BoxClipper", "clipped output", clippedData);
+    if (pointIndex)
+        report.addBytes("BoxClipper", "point block index", pointIndex->getMemorySize());
+    report.addActor("BoxClipper", "clipped mapper", clippedActor);
+}
@@ -3,6 +3,8 @@
  * @brief 该头文件定义了 BoxClipperController 类，用于管理基于盒子的网格数据裁剪操作。
  * @details 该类提供了使用 vtkBoxWidget 对网格数据进行裁剪的功能，允许用户通过交互方式调整裁剪盒子的位置和大小，
  *          并实时更新裁剪结果。
+ *          输入为点云（只有顶点单元）时用 PointBlockIndex 按块判断：整块在盒内直接接受、整块在盒外跳过，
+ *          只对跨越盒面的块逐点判断；网格仍由 vtkClipPolyData 裁剪。
  * @author qtree
  * @date 2025年5月16日
  */
@@ -13,6 +15,8 @@
 #include <vtkCallbackCommand.h>
 #include <vtkRenderWindowInteractor.h>
 #include <vtkObjectBase.h>
+#include <memory>
+#include <vector>
 
 class vtkRenderWindowInteractor;
 class vtkBoxWidget;
@@ -21,6 +25,11 @@ class vtkClipPolyData;
 class vtkPolyData;
 class vtkActor;
 class vtkRenderer;
+class RenderScheduler;
+class MemoryReport;
+class InteractionRecorder;
+class vtkTransform;
+class PointBlockIndex;
 
 /**
  * @class BoxClipperController
@@ -52,6 +61,16 @@ public:
      */
     void SetInputDataAndReplaceOriginal(vtkSmartPointer<vtkPolyData> input, vtkActor *originalActor);
 
+    /**
+     * @brief 设置输入数据并替换多个原始 Actor（多模型场景中同时裁剪多个模型）。
+     *
+     * 输入数据为这些模型合并后的网格数据，裁剪后的 Actor 沿用第一个原始 Actor 的外观。
+     *
+     * @param input 用于裁剪的输入网格数据。
+     * @param originalActors 原始的 Actor 列表，启用裁剪时全部移除。
+     */
+    void SetInputDataAndReplaceOriginals(vtkSmartPointer<vtkPolyData> input, const std::vector<vtkActor *> &originalActors);
+
     /**
      * @brief 启用或禁用裁剪功能。
      *
@@ -70,15 +89,77 @@ public:
      */
     vtkSmartPointer<vtkActor> GetClippedActor();
 
+    /**
+     * @brief 获取当前裁剪盒子的轴对齐包围盒。
+     *
+     * 盒子旋转后返回其 8 个顶点的包围盒。
+     *
+     * @param bounds 输出 [xmin, xmax, ymin, ymax, zmin, zmax]。
+     */
+    void GetBoxBounds(double bounds[6]);
+
+    /**
+     * @brief 将盒子放置到指定包围盒并立即更新裁剪结果（脚本或基准测试中代替手动拖拽）。
+     *
+     * @param bounds 包围盒 [xmin, xmax, ymin, ymax, zmin, zmax]。
+     */
+    void SetBoxBounds(const double bounds[6]);
+
+    /**
+     * @brief 获取盒子相对初始放置（SetInputDataAndReplaceOriginal）的变换。
+     *
+     * @param transform 输出变换。
+     */
+    void GetBoxTransform(vtkTransform *transform);
+
+    /**
+     * @brief 设置盒子相对初始放置的变换并立即更新裁剪结果（用于回放录制的拖拽）。
+     *
+     * @param transform 盒子变换。
+     */
+    void SetBoxTransform(vtkTransform *transform);
+
+    /**
+     * @brief 设置交互录制器，拖拽盒子时记录其变换。
+     *
+     * @param recorder 交互录制器（由页面持有），nullptr 表示不录制。
+     */
+    void SetInteractionRecorder(InteractionRecorder *recorder) { interactionRecorder = recorder; }
+
+    /**
+     * @brief 设置渲染调度器，未设置时直接渲染。
+     *
+     * @param scheduler 渲染调度器（由页面持有）。
+     */
+    void SetRenderScheduler(RenderScheduler *scheduler) { renderScheduler = scheduler; }
+
+    /**
+     * @brief 将裁剪结果及其显存估算登记到内存报告（所属模块 "BoxClipper"）。
+     *
+     * @param report 内存报告。
+     */
+    void AppendMemoryUsage(MemoryReport &report) const;
+
+    /**
+     * @brief 获取输入点云的块索引（输入为网格时为空），供拾取等同一数据上的查询复用。
+     *
+     * @return 块索引，输入数据变化时重建。
+     */
+    std::shared_ptr<const PointBlockIndex> GetPointBlockIndex() const { return pointIndex; }
+
 private:
     vtkSmartPointer<vtkBoxWidget> boxWidget;               ///< 用于用户交互的盒子小部件，用于定义裁剪区域
     vtkSmartPointer<vtkPlanes> clipPlanes;                 ///< 由盒子小部件定义的裁剪平面
     vtkSmartPointer<vtkClipPolyData> clipper;              ///< 用于执行裁剪操作的 VTK 过滤器
     vtkSmartPointer<vtkActor> clippedActor;                ///< 裁剪后的网格数据对应的 Actor
+    vtkSmartPointer<vtkPolyData> clippedData;              ///< 裁剪结果（mapper 输入）
+    std::shared_ptr<PointBlockIndex> pointIndex;           ///< 输入为点云时的块索引
     vtkSmartPointer<vtkPolyData> inputData;                ///< 用于裁剪的输入网格数据
     vtkSmartPointer<vtkRenderer> renderer;                 ///< 用于渲染裁剪结果的渲染器
     vtkSmartPointer<vtkRenderWindowInteractor> interactor; ///< 用于处理用户交互的渲染窗口交互器
-    vtkActor *originalActor;                               ///< 原始的 Actor，将被裁剪后的 Actor 替换
+    std::vector<vtkActor *> originalActors;                ///< 原始的 Actor，将被裁剪后的 Actor 替换
+    RenderScheduler *renderScheduler = nullptr;            ///< 渲染调度器
+    InteractionRecorder *interactionRecorder = nullptr;    ///< 交互录制器
 
     /**
      * @brief 更新裁剪结果。
@@ -87,6 +168,13 @@ private:
      */
     void UpdateClipping();
 
+    /**
+     * @brief 点云裁剪：按块索引收集盒内的点，复制坐标与点属性并生成顶点单元。
+     *
+     * @param planes 盒子的 6 个平面。
+     */
+    void ClipPointCloud(vtkPlanes *planes);
+
     void CopyActorAppearance(vtkActor *from, vtkActor *to);
 };
 
@@ -0,0 +1,178 @@
+#include "CloudChangeDetector.h"
+#include "TraceRecorder.h"
+
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkMath.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <vtkXMLPolyDataWriter.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+bool CloudChangeDetector::setReference(vtkPolyData *reference, const double displayToCentered[16])
+{
+    auto tree = std::make_shared<PointKdTree>();
+    if (!tree->build(reference, displayToCentered))
+    {
+        tree_.reset();
+        return false;
+    }
+    tree_ = tree;
+    ownsTree_ = true;
+    return true;
+}
+
+void CloudChangeDetector::setReferenceIndex(std::shared_ptr<const PointKdTree> index)
+{
+    tree_ = index;
+    ownsTree_ = false;
+}
+
+vtkSmartPointer<vtkFloatArray> CloudChangeDetector::compute(vtkPolyData *compared, const double displayToCentered[16],
+                                                            Method method)
+{
+    statistics_ = DeviationStatistics();
+    if (!compared || compared->GetNumberOfPoints() == 0 || !hasReference())
+        return nullptr;
+
+    auto start = std::chrono::steady_clock::now();
+    const double maxDistance2 = maxDistance_ > 0.0 ? maxDistance_ * maxDistance_ : std::numeric_limits<double>::max();
+    const vtkIdType numPoints = compared->GetNumberOfPoints();
+
+    auto change = vtkSmartPointer<vtkFloatArray>::New();
+    change->SetName(ArrayName);
+    change->SetNumberOfComponents(1);
+    change->SetNumberOfTuples(numPoints);
+    float *out = change->GetPointer(0);
+
+    vtkPoints *points = compared->GetPoints();
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                     {
+        TRACE_SCOPE_CAT("CloudChangeDetector::compute chunk", "smp");
+        std::vector<std::int64_t> neighbours;
+        neighbours.reserve(neighbourCount_ + 1);
+        const double *m = displayToCentered;
+        double q[3];
+        double p[3];
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            points->GetPoint(i, q);
+            for (int row = 0; row < 3; ++row)
+                p[row] = m[4 * row] * q[0] + m[4 * row + 1] * q[1] + m[4 * row + 2] * q[2] + m[4 * row + 3];
+            if (method == Method::NearestNeighbour)
+            {
+                double d2 = 0.0;
+                tree_->nearest(p, d2);
+                out[i] = d2 < maxDistance2 ? static_cast<float>(std::sqrt(d2)) : std::numeric_limits<float>::quiet_NaN();
+            }
+            else
+            {
+                tree_->kNearest(p, neighbourCount_, neighbours, maxDistance2);
+                out[i] = localPlaneDistance(p, neighbours);
+            }
+        } });
+
+    statistics_ = CloudMeshDeviation::summarize(change);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[CloudChangeDetector] " << numPoints << " points against " << tree_->size() << " reference points in "
+              << seconds << " s, " << statistics_.count << " matched, mean " << statistics_.mean << std::endl;
+    return change;
+}
+
+float CloudChangeDetector::localPlaneDistance(const double p[3], std::vector<std::int64_t> &neighbours) const
+{
+    if (neighbours.size() < 3)
+        return std::numeric_limits<float>::quiet_NaN();
+
+    // 近邻质心与协方差
+    double centroid[3] = {0.0, 0.0, 0.0};
+    for (std::int64_t index : neighbours)
+    {
+        const float *q = tree_->point(index);
+        for (int k = 0; k < 3; ++k)
+            centroid[k] += q[k];
+    }
+    for (int k = 0; k < 3; ++k)
+        centroid[k] /= neighbours.size();
+
+    double covariance[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+    for (std::int64_t index : neighbours)
+    {
+        const float *q = tree_->point(index);
+        double d[3] = {q[0] - centroid[0], q[1] - centroid[1], q[2] - centroid[2]};
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                covariance[r][c] += d[r] * d[c];
+    }
+
+    // 最小特征值对应的特征向量即平面法向
+    double w[3];
+    double V[3][3];
+    vtkMath::Diagonalize3x3(covariance, w, V);
+    int smallest = 0;
+    for (int k = 1; k < 3; ++k)
+    {
+        if (std::abs(w[k]) < std::abs(w[smallest]))
+            smallest = k;
+    }
+    double normal[3] = {V[0][smallest], V[1][smallest], V[2][smallest]};
+    if (normal[2] < 0.0)
+    {
+        for (int k = 0; k < 3; ++k)
+            normal[k] = -normal[k];
+    }
+
+    double d[3] = {p[0] - centroid[0], p[1] - centroid[1], p[2] - centroid[2]};
+    return static_cast<float>(vtkMath::Dot(d, normal));
+}
+
+bool CloudChangeDetector::exportScalarField(vtkPolyData *cloud, vtkFloatArray *field, const double displayToWorld[16],
+                                            const std::string &path)
+{
+    if (!cloud || !field || field->GetNumberOfTuples() != cloud->GetNumberOfPoints())
+        return false;
+
+    // 显示变换为 z' = s·z − c_z，逆变换须先加回中心再除以拉伸比例：z = (z' + c_z) / s，
+    // 矩阵已按此顺序求逆并加回数据原点，原始坐标以 double 写出
+    const vtkIdType numPoints = cloud->GetNumberOfPoints();
+    const double *m = displayToWorld;
+    auto coords = vtkSmartPointer<vtkDoubleArray>::New();
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(numPoints);
+    double *dst = coords->GetPointer(0);
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double p[3];
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            cloud->GetPoints()->GetPoint(i, p);
+            for (int row = 0; row < 3; ++row)
+                dst[3 * i + row] = m[4 * row] * p[0] + m[4 * row + 1] * p[1] + m[4 * row + 2] * p[2] + m[4 * row + 3];
+        } });
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetData(coords);
+
+    auto output = vtkSmartPointer<vtkPolyData>::New();
+    output->SetPoints(points);
+    output->SetVerts(cloud->GetVerts());
+    output->GetPointData()->AddArray(field);
+    output->GetPointData()->SetActiveScalars(field->GetName());
+
+    auto writer = vtkSmartPointer<vtkXMLPolyDataWriter>::New();
+    writer->SetFileName(path.c_str());
+    writer->SetInputData(output);
+    writer->SetDataModeToAppended();
+    writer->SetCompressorTypeToZLib();
+    if (writer->Write() != 1)
+    {
+        std::cerr << "[CloudChangeDetector] Failed to write " << path << std::endl;
+        return false;
+    }
+    std::cout << "[CloudChangeDetector] Exported " << numPoints << " points to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file CloudChangeDetector.h
+ * @brief 该头文件定义了 CloudChangeDetector 类，用于比较两期点云扫描之间的变化。
+ * @details 在参考点云上构建 PointKdTree，对比较点云的每个点并行计算最近邻距离，或以参考点云
+ *          k 近邻拟合的局部平面计算有符号距离（M3C2 风格，法向朝 +Z，正值表示抬升）。结果写入名为
+ *          "Change" 的点数据数组，超出最大搜索距离的点记为 NaN。
+ */
+#pragma once
+
+#include "PointKdTree.h"
+#include "CloudMeshDeviation.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkFloatArray.h>
+#include <memory>
+#include <string>
+
+/**
+ * @class CloudChangeDetector
+ * @brief 点云到点云变化检测引擎，不依赖渲染器。
+ */
+class CloudChangeDetector
+{
+public:
+    /**
+     * @enum Method
+     * @brief 距离计算方式。
+     */
+    enum class Method
+    {
+        NearestNeighbour, ///< 到最近参考点的距离（无符号）
+        LocalPlane        ///< 到参考点云局部拟合平面的有符号距离
+    };
+
+    /**
+     * @brief 变化量数组名称。
+     */
+    static constexpr const char *ArrayName = "Change";
+
+    /**
+     * @brief 设置参考（早期）点云并构建 k-d 树。
+     * @param reference 参考点云。
+     * @param displayToCentered 参考点云显示坐标到“原始坐标 − 中心”的矩阵（ModelPipelineBuilder::getDisplayToCenteredMatrix），
+     *        为空时直接使用点坐标。
+     * @return 点云为空时返回 false。
+     */
+    bool setReference(vtkPolyData *reference, const double displayToCentered[16] = nullptr);
+
+    /**
+     * @brief 直接使用已构建的参考点云 k-d 树（如场景中按模型共享的空间索引），不再重复构建。
+     * @param index 以“原始坐标 − 中心”构建的 k-d 树（见 PointKdTree::build），空树视为未设置参考点云。
+     */
+    void setReferenceIndex(std::shared_ptr<const PointKdTree> index);
+
+    /**
+     * @brief 局部平面拟合使用的近邻数量，默认 12。
+     */
+    void setNeighbourCount(int count) { neighbourCount_ = count > 3 ? count : 3; }
+
+    /**
+     * @brief 最大搜索距离，超出时该点记为 NaN；0 表示不限制。
+     */
+    void setMaxDistance(double distance) { maxDistance_ = distance > 0.0 ? distance : 0.0; }
+
+    /**
+     * @brief 计算比较点云每个点的变化量。
+     * @param compared 比较（近期）点云，与参考点云共用中心。
+     * @param displayToCentered 比较点云显示坐标到“原始坐标 − 中心”的矩阵，与参考点云的树处于同一坐标系，
+     *        结果与两者的 Z 拉伸无关。
+     * @param method 距离计算方式。
+     * @return 名为 "Change" 的单分量数组，未设置参考点云时返回 nullptr。
+     */
+    vtkSmartPointer<vtkFloatArray> compute(vtkPolyData *compared, const double displayToCentered[16], Method method);
+
+    /**
+     * @brief 获取最近一次 compute 的统计结果。
+     */
+    const DeviationStatistics &getStatistics() const { return statistics_; }
+
+    /**
+     * @brief 将点云与标量场导出为 VTK XML PolyData（.vtp），坐标还原为原始坐标系。
+     * @param cloud 显示用点云（已中心对齐与 Z 拉伸）。
+     * @param field 要导出的标量场。
+     * @param displayToWorld 显示坐标到原始坐标的矩阵（ModelPipelineBuilder::getDisplayToWorldMatrix），
+     *        即 z = (z' + c_z) / s 的逆变换；不能先除拉伸比例再加中心。
+     * @param path 输出文件路径。
+     */
+    static bool exportScalarField(vtkPolyData *cloud, vtkFloatArray *field, const double displayToWorld[16],
+                                  const std::string &path);
+
+    bool hasReference() const { return tree_ && !tree_->empty(); }
+
+    // 参考点云 kd 树占用的内存字节数，共享的索引由其持有者登记
+    std::size_t getMemorySize() const { return tree_ && ownsTree_ ? tree_->getMemorySize() : 0; }
+
+private:
+    // 以 k 近邻拟合局部平面，返回查询点到平面的有符号距离，近邻不足时返回 NaN
+    float localPlaneDistance(const double p[3], std::vector<std::int64_t> &neighbours) const;
+
+    std::shared_ptr<const PointKdTree> tree_;
+    bool ownsTree_ = false;
+    int neighbourCount_ = 12;
+    double maxDistance_ = 0.0;
+    DeviationStatistics statistics_;
+};
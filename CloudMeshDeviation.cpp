@@ -0,0 +1,160 @@
+#include "CloudMeshDeviation.h"
+#include "TraceRecorder.h"
+
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocal.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+bool CloudMeshDeviation::setReference(vtkPolyData *mesh, double zScale)
+{
+    return bvh_.build(mesh, zScale);
+}
+
+vtkSmartPointer<vtkFloatArray> CloudMeshDeviation::compute(vtkPolyData *cloud, double zScale)
+{
+    statistics_ = DeviationStatistics();
+    if (!cloud || cloud->GetNumberOfPoints() == 0 || bvh_.empty())
+        return nullptr;
+
+    const double invZ = zScale > 0.0 ? 1.0 / zScale : 1.0;
+    const vtkIdType numPoints = cloud->GetNumberOfPoints();
+
+    auto deviations = vtkSmartPointer<vtkFloatArray>::New();
+    deviations->SetName(ArrayName);
+    deviations->SetNumberOfComponents(1);
+    deviations->SetNumberOfTuples(numPoints);
+    float *out = deviations->GetPointer(0);
+
+    vtkPoints *points = cloud->GetPoints();
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                     {
+        TRACE_SCOPE_CAT("CloudMeshDeviation::compute chunk", "smp");
+        double p[3];
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            points->GetPoint(i, p);
+            p[2] *= invZ;
+            out[i] = static_cast<float>(bvh_.signedDistance(p));
+        } });
+
+    statistics_ = summarize(deviations);
+
+    std::cout << "[CloudMeshDeviation] " << numPoints << " points against " << bvh_.getNumberOfTriangles()
+              << " triangles, mean " << statistics_.mean << ", RMS " << statistics_.rms << std::endl;
+    return deviations;
+}
+
+DeviationStatistics CloudMeshDeviation::summarize(vtkFloatArray *deviations)
+{
+    DeviationStatistics statistics;
+    if (!deviations || deviations->GetNumberOfTuples() == 0)
+        return statistics;
+
+    struct Accumulator
+    {
+        double min = std::numeric_limits<double>::max();
+        double max = -std::numeric_limits<double>::max();
+        double sum = 0.0;
+        double sum2 = 0.0;
+        vtkIdType count = 0;
+    };
+    vtkSMPThreadLocal<Accumulator> accumulators;
+
+    const float *in = deviations->GetPointer(0);
+    vtkSMPTools::For(0, deviations->GetNumberOfTuples(), [&](vtkIdType begin, vtkIdType end)
+                     {
+        Accumulator &acc = accumulators.Local();
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            double d = in[i];
+            if (std::isnan(d))
+                continue;
+            acc.min = std::min(acc.min, d);
+            acc.max = std::max(acc.max, d);
+            acc.sum += d;
+            acc.sum2 += d * d;
+            ++acc.count;
+        } });
+
+    Accumulator total;
+    for (auto it = accumulators.begin(); it != accumulators.end(); ++it)
+    {
+        total.min = std::min(total.min, it->min);
+        total.max = std::max(total.max, it->max);
+        total.sum += it->sum;
+        total.sum2 += it->sum2;
+        total.count += it->count;
+    }
+    if (total.count == 0)
+        return statistics;
+
+    statistics.valid = true;
+    statistics.count = total.count;
+    statistics.min = total.min;
+    statistics.max = total.max;
+    statistics.mean = total.sum / total.count;
+    statistics.rms = std::sqrt(total.sum2 / total.count);
+    statistics.absP95 = absolutePercentile(deviations, 0.95);
+    return statistics;
+}
+
+double CloudMeshDeviation::absolutePercentile(vtkFloatArray *deviations, double fraction)
+{
+    const vtkIdType n = deviations->GetNumberOfTuples();
+    if (n == 0)
+        return 0.0;
+
+    std::vector<float> values(static_cast<std::size_t>(n));
+    const float *in = deviations->GetPointer(0);
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType i = begin; i < end; ++i)
+            values[i] = std::abs(in[i]); });
+
+    // NaN 移到末尾，只在有效值中取分位数
+    auto valid = std::partition(values.begin(), values.end(), [](float v)
+                                { return !std::isnan(v); });
+    std::size_t count = static_cast<std::size_t>(valid - values.begin());
+    if (count == 0)
+        return 0.0;
+    auto k = static_cast<std::size_t>(fraction * (count - 1));
+    std::nth_element(values.begin(), values.begin() + k, valid);
+    return values[k];
+}
+
+std::vector<vtkIdType> CloudMeshDeviation::histogram(vtkFloatArray *deviations, double minValue, double maxValue, int bins)
+{
+    std::vector<vtkIdType> counts(static_cast<std::size_t>(std::max(bins, 1)), 0);
+    if (!deviations || maxValue <= minValue)
+        return counts;
+
+    const vtkIdType n = deviations->GetNumberOfTuples();
+    const float *in = deviations->GetPointer(0);
+    const double scale = counts.size() / (maxValue - minValue);
+    const int last = static_cast<int>(counts.size()) - 1;
+
+    vtkSMPThreadLocal<std::vector<vtkIdType>> partials;
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end)
+                     {
+        std::vector<vtkIdType> &local = partials.Local();
+        if (local.empty())
+            local.assign(counts.size(), 0);
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            if (std::isnan(in[i]))
+                continue;
+            int bin = static_cast<int>(std::floor((in[i] - minValue) * scale));
+            ++local[std::min(std::max(bin, 0), last)];
+        } });
+
+    for (auto it = partials.begin(); it != partials.end(); ++it)
+    {
+        for (std::size_t b = 0; b < it->size(); ++b)
+            counts[b] += (*it)[b];
+    }
+    return counts;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file CloudMeshDeviation.h
+ * @brief 该头文件定义了 CloudMeshDeviation 类，用于计算点云相对参考网格的有符号偏差。
+ * @details 参考网格构建为 TriangleBVH，逐点并行查询最近三角形，距离沿三角形法向取正负号，
+ *          结果写入名为 "Deviation" 的点数据数组，同时统计最值、均值、RMS 与 95% 绝对偏差分位数，
+ *          供着色时确定对称色带范围。
+ */
+#pragma once
+
+#include "TriangleBVH.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkFloatArray.h>
+#include <vector>
+
+/**
+ * @struct DeviationStatistics
+ * @brief 偏差统计结果，单位与模型真实坐标一致（已去除 Z 轴拉伸）。
+ */
+struct DeviationStatistics
+{
+    bool valid = false;    ///< 是否有点参与计算
+    vtkIdType count = 0;   ///< 参与统计的点数
+    double min = 0.0;      ///< 最小偏差（最大负偏差）
+    double max = 0.0;      ///< 最大偏差
+    double mean = 0.0;     ///< 平均偏差
+    double rms = 0.0;      ///< 均方根偏差
+    double absP95 = 0.0;   ///< 绝对偏差的 95% 分位数，用作默认对称色带范围
+};
+
+/**
+ * @class CloudMeshDeviation
+ * @brief 点云到网格偏差计算引擎，不依赖渲染器。
+ */
+class CloudMeshDeviation
+{
+public:
+    /**
+     * @brief 偏差数组名称。
+     */
+    static constexpr const char *ArrayName = "Deviation";
+
+    /**
+     * @brief 设置参考网格并构建 BVH。
+     * @param mesh 参考网格（与点云处于同一坐标系）。
+     * @param zScale 参考网格显示时的 Z 轴拉伸比例。
+     * @return 网格没有三角形时返回 false。
+     */
+    bool setReference(vtkPolyData *mesh, double zScale = 1.0);
+
+    /**
+     * @brief 计算点云每个点到参考网格的有符号距离。
+     * @param cloud 点云（与参考网格处于同一坐标系）。
+     * @param zScale 点云显示时的 Z 轴拉伸比例，查询前 Z 坐标会除以该比例。
+     * @return 名为 "Deviation" 的单分量数组，未设置参考网格时返回 nullptr。
+     */
+    vtkSmartPointer<vtkFloatArray> compute(vtkPolyData *cloud, double zScale = 1.0);
+
+    /**
+     * @brief 获取最近一次 compute 的统计结果。
+     */
+    const DeviationStatistics &getStatistics() const { return statistics_; }
+
+    /**
+     * @brief 统计偏差直方图，超出范围的值计入两端的格子。
+     * @param deviations 偏差数组。
+     * @param minValue 直方图下界。
+     * @param maxValue 直方图上界。
+     * @param bins 格子数。
+     */
+    static std::vector<vtkIdType> histogram(vtkFloatArray *deviations, double minValue, double maxValue, int bins);
+
+    /**
+     * @brief 并行统计偏差数组，NaN（无对应点）不参与统计。
+     */
+    static DeviationStatistics summarize(vtkFloatArray *deviations);
+
+    bool hasReference() const { return !bvh_.empty(); }
+
+    // 参考网格 BVH 占用的内存字节数
+    std::size_t getMemorySize() const { return bvh_.getMemorySize(); }
+
+private:
+    // 计算绝对偏差分位数（跳过 NaN）
+    static double absolutePercentile(vtkFloatArray *deviations, double fraction);
+
+    TriangleBVH bvh_;
+    DeviationStatistics statistics_;
+};
@@ -0,0 +1,146 @@
+#include "ColorMaps.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace ColorMaps
+{
+    vtkSmartPointer<vtkLookupTable> createJetLookupTable(double minValue, double maxValue, double gamma)
+    {
+        auto lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetNumberOfTableValues(256);
+        lut->SetRange(minValue, maxValue); // 设置标量范围
+
+        for (int i = 0; i < 256; ++i)
+        {
+            double t = static_cast<double>(i) / 255.0;
+
+            // 非线性调整 t，使颜色更集中于中间值
+            t = std::pow(t, gamma);
+
+            // Jet 配色映射：蓝 → 青 → 绿 → 黄 → 红
+            double r = std::clamp(1.5 - std::abs(4.0 * t - 3.0), 0.0, 1.0);
+            double g = std::clamp(1.5 - std::abs(4.0 * t - 2.0), 0.0, 1.0);
+            double b = std::clamp(1.5 - std::abs(4.0 * t - 1.0), 0.0, 1.0);
+
+            lut->SetTableValue(i, r, g, b);
+        }
+
+        lut->Build();
+        return lut;
+    }
+
+    vtkSmartPointer<vtkLookupTable> createViridisLookupTable(double minValue, double maxValue)
+    {
+        auto lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetNumberOfTableValues(256);
+        lut->SetRange(minValue, maxValue);
+
+        for (int i = 0; i < 256; ++i)
+        {
+            double t = i / 255.0;
+            // 近似 Matplotlib Viridis 色带（更精确的RGB值可参考官方定义）
+            double r = 0.2795 + 0.4702 * t + 0.1649 * t * t - 0.0008 * t * t * t;
+            double g = 0.0021 + 0.7047 * t + 0.0704 * t * t - 0.0053 * t * t * t;
+            double b = 0.3904 + 0.1066 * t + 0.1968 * t * t - 0.0641 * t * t * t;
+            lut->SetTableValue(i, r, g, b);
+        }
+        lut->Build();
+        return lut;
+    }
+
+    vtkSmartPointer<vtkLookupTable> createCoolToWarmLookupTable(double minValue, double maxValue)
+    {
+        auto lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetNumberOfTableValues(256);
+        lut->SetRange(minValue, maxValue);
+
+        for (int i = 0; i < 256; ++i)
+        {
+            double t = i / 255.0;
+            double r = t;                          // 红：从0→1
+            double g = 1 - std::fabs(t - 0.5) * 2; // 绿：中间最亮
+            double b = 1 - t;                      // 蓝：从1→0
+            lut->SetTableValue(i, r, g, b);
+        }
+        lut->Build();
+        return lut;
+    }
+
+    vtkSmartPointer<vtkLookupTable> createGrayscaleLookupTable(double minValue, double maxValue)
+    {
+        auto lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetNumberOfTableValues(256);
+        lut->SetRange(minValue, maxValue);
+
+        for (int i = 0; i < 256; ++i)
+        {
+            double gray = i / 255.0; // 从黑→白
+            lut->SetTableValue(i, gray, gray, gray);
+        }
+        lut->Build();
+        return lut;
+    }
+
+    vtkSmartPointer<vtkLookupTable> createRainbowLookupTable(double minValue, double maxValue)
+    {
+        auto lut = vtkSmartPointer<vtkLookupTable>::New();
+        lut->SetNumberOfTableValues(256);
+        lut->SetHueRange(0.666, 0.0); // 色相从蓝(0.666)→红(0.0)
+        lut->SetSaturationRange(1.0, 1.0);
+        lut->SetValueRange(1.0, 1.0);
+        lut->SetRange(minValue, maxValue);
+        lut->Build();
+        return lut;
+    }
+
+    vtkSmartPointer<vtkLookupTable> createLookupTableForStyle(int style, double minValue, double maxValue)
+    {
+        switch (style)
+        {
+        case 1:
+            return createViridisLookupTable(minValue, maxValue);
+        case 2:
+            return createCoolToWarmLookupTable(minValue, maxValue);
+        case 3:
+            return createGrayscaleLookupTable(minValue, maxValue);
+        case 4:
+            return createRainbowLookupTable(minValue, maxValue);
+        default:
+            return createJetLookupTable(minValue, maxValue);
+        }
+    }
+
+    int styleFromName(const std::string &name)
+    {
+        std::string lower(name);
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        for (int style = 0; style < kStyleCount; ++style)
+        {
+            if (lower == styleName(style))
+                return style;
+        }
+        return -1;
+    }
+
+    const char *styleName(int style)
+    {
+        switch (style)
+        {
+        case 0:
+            return "jet";
+        case 1:
+            return "viridis";
+        case 2:
+            return "cooltowarm";
+        case 3:
+            return "grayscale";
+        case 4:
+            return "rainbow";
+        default:
+            return "unknown";
+        }
+    }
+}
@@ -0,0 +1,39 @@
+/**
+ * @file ColorMaps.h
+ * @brief 高程/标量着色用的颜色查找表。
+ * @details 三维页面与批量截图工具共用同一组色带，保证交互显示与离线缩略图颜色一致。
+ *          风格编号与页面颜色按钮顺序一致：0 Jet、1 Viridis、2 CoolToWarm、3 Grayscale、4 Rainbow。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkLookupTable.h>
+#include <string>
+
+namespace ColorMaps
+{
+    // 颜色风格数量
+    constexpr int kStyleCount = 5;
+
+    // Jet 配色（蓝 → 青 → 绿 → 黄 → 红），gamma 小于 1 时颜色更集中于中间值
+    vtkSmartPointer<vtkLookupTable> createJetLookupTable(double minValue, double maxValue, double gamma = 0.7);
+    // 近似 Matplotlib Viridis 色带
+    vtkSmartPointer<vtkLookupTable> createViridisLookupTable(double minValue, double maxValue);
+    vtkSmartPointer<vtkLookupTable> createCoolToWarmLookupTable(double minValue, double maxValue);
+    vtkSmartPointer<vtkLookupTable> createGrayscaleLookupTable(double minValue, double maxValue);
+    vtkSmartPointer<vtkLookupTable> createRainbowLookupTable(double minValue, double maxValue);
+
+    /**
+     * @brief 按颜色风格编号创建查找表，未知编号使用 Jet。
+     */
+    vtkSmartPointer<vtkLookupTable> createLookupTableForStyle(int style, double minValue, double maxValue);
+
+    /**
+     * @brief 风格名称（jet、viridis、cooltowarm、grayscale、rainbow）转编号，不区分大小写。
+     * @return 未知名称返回 -1。
+     */
+    int styleFromName(const std::string &name);
+
+    // 风格编号转名称
+    const char *styleName(int style);
+}
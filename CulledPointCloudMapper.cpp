@@ -0,0 +1,233 @@
+#include "CulledPointCloudMapper.h"
+#include "SpatialReorder.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkRenderer.h>
+#include <vtkCamera.h>
+#include <vtkActor.h>
+#include <vtkProperty.h>
+#include <vtkMath.h>
+#include <vtkSMPTools.h>
+#include <algorithm>
+#include <cmath>
+
+vtkStandardNewMacro(CulledPointCloudMapper);
+
+void CulledPointCloudMapper::SetSourceData(vtkPolyData *source)
+{
+    source_ = source;
+    culled_ = nullptr;
+    levels_.clear();
+    sourceTime_ = 0;
+    drawnPoints_ = source ? source->GetNumberOfPoints() : 0;
+    visibleBlocks_ = 0;
+    SetInputData(source);
+}
+
+void CulledPointCloudMapper::SetCulling(bool enabled)
+{
+    if (culling_ == enabled)
+        return;
+    culling_ = enabled;
+    culled_ = nullptr;
+    levels_.clear();
+    if (source_)
+    {
+        SetInputData(source_);
+        drawnPoints_ = source_->GetNumberOfPoints();
+    }
+    Modified();
+}
+
+std::size_t CulledPointCloudMapper::GetCullingMemorySize() const
+{
+    std::size_t bytes = index_.getMemorySize();
+    if (culled_)
+        bytes += static_cast<std::size_t>(culled_->GetActualMemorySize()) * 1024;
+    return bytes;
+}
+
+double *CulledPointCloudMapper::GetBounds()
+{
+    if (!source_)
+        return Superclass::GetBounds();
+    source_->GetBounds(Bounds);
+    return Bounds;
+}
+
+bool CulledPointCloudMapper::PrepareBlocks()
+{
+    if (!source_ || !culling_ || source_->GetNumberOfPoints() == 0)
+        return false;
+    if (!index_.isBuiltFor(source_))
+    {
+        index_.build(source_);
+        levels_.clear();
+    }
+    return true;
+}
+
+vtkIdType CulledPointCloudMapper::GetBlockPointCount(int block) const
+{
+    const vtkIdType first = static_cast<vtkIdType>(block) * index_.getBlockSize();
+    return std::min(source_->GetNumberOfPoints(), first + index_.getBlockSize()) - first;
+}
+
+void CulledPointCloudMapper::Render(vtkRenderer *renderer, vtkActor *actor)
+{
+    if (PrepareBlocks())
+    {
+        TRACE_SCOPE("CulledPointCloudMapper::Render.Cull");
+        ScopedStageTimer timer("Render.Cull");
+        std::vector<unsigned char> levels;
+        if (budgetLevels_.size() == static_cast<std::size_t>(index_.getNumberOfBlocks()))
+            levels = budgetLevels_;
+        else
+            ComputeLevels(renderer, actor, levels);
+        if (levels != levels_ || source_->GetMTime() != sourceTime_)
+        {
+            levels_.swap(levels);
+            sourceTime_ = source_->GetMTime();
+            rebuildDrawData();
+        }
+    }
+    Superclass::Render(renderer, actor);
+}
+
+void CulledPointCloudMapper::ComputeLevels(vtkRenderer *renderer, vtkActor *actor, std::vector<unsigned char> &levels,
+                                           std::vector<float> *diameters) const
+{
+    const int blockCount = index_.getNumberOfBlocks();
+    if (diameters)
+        diameters->assign(static_cast<std::size_t>(blockCount), 0.0f);
+    if (!actor->GetIsIdentity())
+    {
+        levels.assign(static_cast<std::size_t>(blockCount), 1); // 块包围盒为数据坐标，带变换时不剔除
+        return;
+    }
+
+    vtkCamera *camera = renderer->GetActiveCamera();
+    // 平面方程 ax + by + cz + d >= 0 为内侧，顺序为左、右、下、上、近、远；近远平面随裁剪范围变化，不参与剔除
+    double planes[24];
+    camera->GetFrustumPlanes(renderer->GetTiledAspectRatio(), planes);
+    double position[3];
+    double direction[3];
+    camera->GetPosition(position);
+    camera->GetDirectionOfProjection(direction);
+    int *size = renderer->GetSize();
+    const double spanPixels = camera->GetUseHorizontalViewAngle() ? size[0] : size[1];
+    const bool parallel = camera->GetParallelProjection() != 0;
+    const double parallelScale = camera->GetParallelScale();
+    const double tanHalfAngle = std::tan(vtkMath::RadiansFromDegrees(0.5 * camera->GetViewAngle()));
+    // 每个点覆盖 pointSize^2 个像素
+    const double pointSize = std::max(1.0, static_cast<double>(actor->GetProperty()->GetPointSize()));
+    const double pixelsPerPoint = pointSize * pointSize;
+
+    const vtkIdType blockSize = index_.getBlockSize();
+    const vtkIdType numPoints = source_->GetNumberOfPoints();
+    levels.assign(static_cast<std::size_t>(blockCount), 0);
+    vtkSMPTools::For(0, blockCount, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double bounds[6];
+        for (vtkIdType b = begin; b < end; ++b)
+        {
+            index_.getBlockBounds(static_cast<int>(b), bounds);
+            bool outside = false;
+            for (int k = 0; k < 4 && !outside; ++k)
+            {
+                const double *plane = &planes[4 * k];
+                double farthest = plane[3];
+                for (int axis = 0; axis < 3; ++axis)
+                    farthest += std::max(plane[axis] * bounds[2 * axis], plane[axis] * bounds[2 * axis + 1]);
+                outside = farthest < 0.0;
+            }
+            if (outside)
+                continue;
+
+            // 包围球投影的像素直径
+            double center[3];
+            double radius2 = 0.0;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                center[axis] = 0.5 * (bounds[2 * axis] + bounds[2 * axis + 1]);
+                double half = 0.5 * (bounds[2 * axis + 1] - bounds[2 * axis]);
+                radius2 += half * half;
+            }
+            const double radius = std::sqrt(radius2);
+            double pixelsPerUnit = 0.0;
+            if (parallel)
+            {
+                pixelsPerUnit = parallelScale > 0.0 ? spanPixels / (2.0 * parallelScale) : 0.0;
+            }
+            else
+            {
+                double depth = (center[0] - position[0]) * direction[0] + (center[1] - position[1]) * direction[1] +
+                               (center[2] - position[2]) * direction[2];
+                if (depth <= radius || tanHalfAngle <= 0.0)
+                {
+                    // 相机在包围球内或紧贴包围球：完整绘制，优先级最高
+                    levels[b] = 1;
+                    if (diameters)
+                        (*diameters)[b] = static_cast<float>(spanPixels);
+                    continue;
+                }
+                pixelsPerUnit = spanPixels / (2.0 * depth * tanHalfAngle);
+            }
+            const double diameter = 2.0 * radius * pixelsPerUnit;
+            const double capacity = std::max(1.0, diameter * diameter / pixelsPerPoint);
+            if (diameters)
+                (*diameters)[b] = static_cast<float>(diameter);
+
+            // 点数多于覆盖的像素数时加倍步长
+            const vtkIdType first = b * blockSize;
+            const double count = static_cast<double>(std::min(numPoints, first + blockSize) - first);
+            unsigned char level = 1;
+            double stride = 1.0;
+            while (level < MaxLevel && count > stride * capacity)
+            {
+                stride *= 2.0;
+                ++level;
+            }
+            levels[b] = level;
+        } });
+}
+
+void CulledPointCloudMapper::rebuildDrawData()
+{
+    TRACE_SCOPE("CulledPointCloudMapper::rebuildDrawData");
+    const vtkIdType numPoints = source_->GetNumberOfPoints();
+    const vtkIdType blockSize = index_.getBlockSize();
+    visibleBlocks_ = 0;
+    bool complete = true;
+    for (unsigned char level : levels_)
+    {
+        visibleBlocks_ += level > 0 ? 1 : 0;
+        complete = complete && level == 1;
+    }
+    if (complete)
+    {
+        culled_ = nullptr;
+        if (GetInput() != source_.GetPointer())
+            SetInputData(source_);
+        drawnPoints_ = numPoints;
+        return;
+    }
+
+    std::vector<vtkIdType> ids;
+    for (std::size_t b = 0; b < levels_.size(); ++b)
+    {
+        if (levels_[b] == 0)
+            continue;
+        const vtkIdType stride = vtkIdType(1) << (levels_[b] - 1);
+        const vtkIdType first = static_cast<vtkIdType>(b) * blockSize;
+        const vtkIdType last = std::min(numPoints, first + blockSize);
+        for (vtkIdType i = first; i < last; i += stride)
+            ids.push_back(i);
+    }
+    culled_ = SpatialReorder::gatherPoints(source_, ids);
+    SpatialReorder::addVertexCells(culled_);
+    SetInputData(culled_);
+    drawnPoints_ = static_cast<vtkIdType>(ids.size());
+}
@@ -0,0 +1,104 @@
+/**
+ * @file CulledPointCloudMapper.h
+ * @brief 该头文件定义了 CulledPointCloudMapper 类，按视锥与屏幕尺寸逐帧剔除点块的点云 mapper。
+ * @details 点云按点号定长分块（见 PointBlockIndex），每帧渲染前用相机的 4 个侧面平面剔除视锥外的块，
+ *          并估算每块包围球投影到屏幕上的像素直径：块内点数多于覆盖的像素数（按点大小折算）时按 2 的幂步长抽稀，
+ *          使绘制的点数不超过块所占像素。各步长取到的点互相嵌套，步长减半只增加点。
+ *          各块的结果（剔除 / 步长）与上一帧相同且源数据未修改时不重建，
+ *          只在可见集合变化时收集可见点组成绘制数据（上传量与可见点数成正比）；全部块完整可见时直接绘制源数据。
+ *          点数预算模式下各块的级别由 PointBudgetController 在帧开始时统一分配（见 SetBudgetLevels）。
+ *
+ *          包围盒始终返回源数据的范围，重置相机、裁剪范围与包围盒不受剔除影响。
+ *          采集顺序的点云块包围盒很大，几乎不能剔除；沿空间填充曲线重排后（见 SpatialReorder）剔除才有效。
+ *          不做遮挡剔除：点云没有封闭表面，块之间很少完全遮挡，且需要 GPU 查询回读。
+ */
+#pragma once
+
+#include "PointBlockIndex.h"
+
+#include <vtkOpenGLPolyDataMapper.h>
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vector>
+
+/**
+ * @class CulledPointCloudMapper
+ * @brief 带视锥 / 屏幕尺寸剔除的点云 mapper，由 ModelPipelineBuilder 为 PLY 点云创建。
+ */
+class CulledPointCloudMapper : public vtkOpenGLPolyDataMapper
+{
+public:
+    static CulledPointCloudMapper *New();
+    vtkTypeMacro(CulledPointCloudMapper, vtkOpenGLPolyDataMapper);
+
+    static constexpr unsigned char MaxLevel = 7; ///< 最粗级别，步长 2^(MaxLevel-1)
+
+    /**
+     * @brief 设置完整点云（需带顶点单元），替代 SetInputData；剔除结果作为实际输入。
+     */
+    void SetSourceData(vtkPolyData *source);
+    vtkPolyData *GetSourceData() const { return source_; }
+
+    /**
+     * @brief 启用或关闭剔除，关闭时直接绘制源数据。
+     */
+    void SetCulling(bool enabled);
+    bool GetCulling() const { return culling_; }
+
+    // 最近一帧绘制的点数与可见块数
+    vtkIdType GetDrawnPoints() const { return drawnPoints_; }
+    int GetVisibleBlocks() const { return visibleBlocks_; }
+    int GetNumberOfBlocks() const { return index_.getNumberOfBlocks(); }
+
+    /**
+     * @brief 块索引与剔除后绘制数据占用的字节数。
+     */
+    std::size_t GetCullingMemorySize() const;
+
+    /**
+     * @brief 按需构建源数据的块索引。
+     * @return 剔除已启用且有数据时返回 true。
+     */
+    bool PrepareBlocks();
+    vtkIdType GetBlockPointCount(int block) const;
+
+    /**
+     * @brief 计算当前视图下各块的级别：0 剔除，k > 0 表示步长 2^(k-1)。
+     * @param diameters 可选输出：各块包围球投影的像素直径（剔除的块为 0）。
+     */
+    void ComputeLevels(vtkRenderer *renderer, vtkActor *actor, std::vector<unsigned char> &levels,
+                       std::vector<float> *diameters = nullptr) const;
+
+    /**
+     * @brief 设置由外部（点数预算）分配的各块级别，之后的帧使用该级别直到清除；块数不符时忽略。
+     */
+    void SetBudgetLevels(const std::vector<unsigned char> &levels) { budgetLevels_ = levels; }
+    void ClearBudgetLevels() { budgetLevels_.clear(); }
+
+    void Render(vtkRenderer *renderer, vtkActor *actor) override;
+
+    // 返回源数据的包围盒
+    double *GetBounds() override;
+    void GetBounds(double bounds[6]) override { Superclass::GetBounds(bounds); }
+
+protected:
+    CulledPointCloudMapper() = default;
+    ~CulledPointCloudMapper() override = default;
+
+private:
+    CulledPointCloudMapper(const CulledPointCloudMapper &) = delete;
+    void operator=(const CulledPointCloudMapper &) = delete;
+
+    // 按当前级别收集可见点并设为 mapper 输入
+    void rebuildDrawData();
+
+    vtkSmartPointer<vtkPolyData> source_;   ///< 完整点云
+    vtkSmartPointer<vtkPolyData> culled_;   ///< 剔除后的绘制数据，全部完整可见时为空
+    PointBlockIndex index_;                 ///< 源数据的块包围盒
+    std::vector<unsigned char> levels_;     ///< 上次构建绘制数据时各块的级别
+    std::vector<unsigned char> budgetLevels_; ///< 点数预算分配的级别，为空时按视图自行计算
+    vtkMTimeType sourceTime_ = 0;           ///< 上次构建时源数据的修改时间
+    bool culling_ = true;
+    vtkIdType drawnPoints_ = 0;
+    int visibleBlocks_ = 0;
+};
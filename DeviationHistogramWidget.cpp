@@ -0,0 +1,84 @@
+#include "DeviationHistogramWidget.h"
+
+#include <QPainter>
+#include <algorithm>
+
+DeviationHistogramWidget::DeviationHistogramWidget(QWidget *parent)
+    : QWidget(parent), minValue_(0.0), maxValue_(1.0)
+{
+    setWindowFlags(Qt::Tool);                   // 悬浮窗
+    setAttribute(Qt::WA_ShowWithoutActivating); // 不抢焦点
+    setWindowTitle("Deviation");
+    resize(360, 220);
+}
+
+void DeviationHistogramWidget::setHistogram(const std::vector<vtkIdType> &counts, double minValue, double maxValue,
+                                            vtkSmartPointer<vtkLookupTable> lut)
+{
+    counts_ = counts;
+    minValue_ = minValue;
+    maxValue_ = maxValue;
+    lut_ = lut;
+    update();
+}
+
+void DeviationHistogramWidget::setSummary(const QString &summary)
+{
+    summary_ = summary;
+    update();
+}
+
+void DeviationHistogramWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+    if (counts_.empty())
+        return;
+
+    const int margin = 10;
+    const int textHeight = painter.fontMetrics().height();
+    const int summaryLines = summary_.isEmpty() ? 0 : summary_.count('\n') + 1;
+    QRect plot(margin, margin, width() - 2 * margin, height() - 2 * margin - (summaryLines + 1) * textHeight);
+    if (plot.width() <= 0 || plot.height() <= 0)
+        return;
+
+    vtkIdType peak = *std::max_element(counts_.begin(), counts_.end());
+    if (peak == 0)
+        peak = 1;
+
+    // 柱子：颜色取区间中点在查找表中的颜色
+    const double barWidth = static_cast<double>(plot.width()) / counts_.size();
+    const double step = (maxValue_ - minValue_) / counts_.size();
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+    {
+        QColor color(Qt::gray);
+        if (lut_)
+        {
+            double rgb[3];
+            lut_->GetColor(minValue_ + (i + 0.5) * step, rgb);
+            color = QColor::fromRgbF(rgb[0], rgb[1], rgb[2]);
+        }
+        int h = static_cast<int>(plot.height() * static_cast<double>(counts_[i]) / peak);
+        QRectF bar(plot.left() + i * barWidth, plot.bottom() - h, std::max(barWidth - 1.0, 1.0), h);
+        painter.fillRect(bar, color);
+    }
+
+    // 零偏差参考线
+    painter.setPen(Qt::black);
+    if (minValue_ < 0.0 && maxValue_ > 0.0)
+    {
+        int x = plot.left() + static_cast<int>(plot.width() * (-minValue_) / (maxValue_ - minValue_));
+        painter.drawLine(x, plot.top(), x, plot.bottom());
+    }
+    painter.drawLine(plot.bottomLeft(), plot.bottomRight());
+
+    // 坐标标注
+    int labelTop = plot.bottom() + 2;
+    painter.drawText(QRect(plot.left(), labelTop, plot.width(), textHeight), Qt::AlignLeft,
+                     QString::number(minValue_, 'f', 3));
+    painter.drawText(QRect(plot.left(), labelTop, plot.width(), textHeight), Qt::AlignRight,
+                     QString::number(maxValue_, 'f', 3));
+    if (!summary_.isEmpty())
+        painter.drawText(QRect(plot.left(), labelTop + textHeight, plot.width(), summaryLines * textHeight),
+                         Qt::AlignLeft, summary_);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QWidget>
+#include <QString>
+#include <vtkSmartPointer.h>
+#include <vtkLookupTable.h>
+#include <vtkType.h>
+#include <vector>
+
+/**
+ * @class DeviationHistogramWidget
+ * @brief 偏差直方图悬浮窗，柱子颜色与点云着色使用同一张查找表。
+ */
+class DeviationHistogramWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DeviationHistogramWidget(QWidget *parent = nullptr);
+
+    // 设置直方图数据，counts 覆盖 [minValue, maxValue] 的等宽区间
+    void setHistogram(const std::vector<vtkIdType> &counts, double minValue, double maxValue,
+                      vtkSmartPointer<vtkLookupTable> lut);
+    // 底部显示的统计文字
+    void setSummary(const QString &summary);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    std::vector<vtkIdType> counts_;
+    double minValue_;
+    double maxValue_;
+    vtkSmartPointer<vtkLookupTable> lut_;
+    QString summary_;
+};
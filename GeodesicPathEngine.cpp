@@ -0,0 +1,241 @@
+#include "GeodesicPathEngine.h"
+
+#include <vtkCellArray.h>
+#include <vtkMath.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <utility>
+
+void GeodesicPathEngine::setMesh(vtkPolyData *mesh)
+{
+    if (!mesh || mesh->GetNumberOfPoints() == 0 || mesh->GetNumberOfPolys() == 0)
+    {
+        mesh_ = nullptr;
+        offsets_.clear();
+        neighbors_.clear();
+        weights_.clear();
+        coords_.clear();
+        locator_ = nullptr;
+        return;
+    }
+
+    // 同一网格且未修改时复用缓存
+    if (mesh_ == mesh && builtTime_ == mesh->GetMTime() && !offsets_.empty())
+        return;
+
+    mesh_ = mesh;
+    builtTime_ = mesh->GetMTime();
+    buildAdjacency();
+
+    locator_ = vtkSmartPointer<vtkStaticPointLocator>::New();
+    locator_->SetDataSet(mesh_);
+    locator_->BuildLocator();
+}
+
+void GeodesicPathEngine::buildAdjacency()
+{
+    const vtkIdType numPoints = mesh_->GetNumberOfPoints();
+
+    // 顶点坐标副本
+    coords_.resize(static_cast<std::size_t>(numPoints) * 3);
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double p[3];
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            mesh_->GetPoints()->GetPoint(i, p);
+            coords_[3 * i + 0] = static_cast<float>(p[0]);
+            coords_[3 * i + 1] = static_cast<float>(p[1]);
+            coords_[3 * i + 2] = static_cast<float>(p[2]);
+        } });
+
+    // 第一遍：统计每个顶点的（含重复）邻边数量
+    std::vector<std::int64_t> degree(static_cast<std::size_t>(numPoints) + 1, 0);
+    vtkCellArray *polys = mesh_->GetPolys();
+    vtkIdType npts = 0;
+    vtkIdType *pts = nullptr;
+    for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+        for (vtkIdType k = 0; k < npts; ++k)
+        {
+            ++degree[pts[k]];
+            ++degree[pts[(k + 1) % npts]];
+        }
+    }
+
+    offsets_.assign(static_cast<std::size_t>(numPoints) + 1, 0);
+    for (vtkIdType i = 0; i < numPoints; ++i)
+        offsets_[i + 1] = offsets_[i] + degree[i];
+
+    // 第二遍：填充邻居
+    std::vector<std::int32_t> raw(static_cast<std::size_t>(offsets_[numPoints]));
+    std::vector<std::int64_t> cursor(offsets_.begin(), offsets_.end() - 1);
+    for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+        for (vtkIdType k = 0; k < npts; ++k)
+        {
+            vtkIdType a = pts[k];
+            vtkIdType b = pts[(k + 1) % npts];
+            raw[cursor[a]++] = static_cast<std::int32_t>(b);
+            raw[cursor[b]++] = static_cast<std::int32_t>(a);
+        }
+    }
+
+    // 每行排序去重（共享边在两个面中各出现一次），并行处理
+    std::vector<std::int64_t> uniqueCount(static_cast<std::size_t>(numPoints), 0);
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            auto first = raw.begin() + offsets_[i];
+            auto last = raw.begin() + offsets_[i + 1];
+            std::sort(first, last);
+            uniqueCount[i] = std::unique(first, last) - first;
+        } });
+
+    // 压缩为最终 CSR
+    std::vector<std::int64_t> compactOffsets(static_cast<std::size_t>(numPoints) + 1, 0);
+    for (vtkIdType i = 0; i < numPoints; ++i)
+        compactOffsets[i + 1] = compactOffsets[i] + uniqueCount[i];
+
+    neighbors_.resize(static_cast<std::size_t>(compactOffsets[numPoints]));
+    weights_.resize(neighbors_.size());
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            const float *pi = &coords_[3 * i];
+            for (std::int64_t k = 0; k < uniqueCount[i]; ++k)
+            {
+                std::int32_t j = raw[offsets_[i] + k];
+                const float *pj = &coords_[3 * static_cast<std::size_t>(j)];
+                float dx = pj[0] - pi[0], dy = pj[1] - pi[1], dz = pj[2] - pi[2];
+                neighbors_[compactOffsets[i] + k] = j;
+                weights_[compactOffsets[i] + k] = std::sqrt(dx * dx + dy * dy + dz * dz);
+            }
+        } });
+    offsets_.swap(compactOffsets);
+
+    dist_.assign(static_cast<std::size_t>(numPoints), 0.0);
+    prev_.assign(static_cast<std::size_t>(numPoints), -1);
+    stamp_.assign(static_cast<std::size_t>(numPoints), 0);
+    currentStamp_ = 0;
+
+    std::cout << "[GeodesicPathEngine] Adjacency built: " << numPoints << " vertices, "
+              << neighbors_.size() / 2 << " edges." << std::endl;
+}
+
+vtkIdType GeodesicPathEngine::findClosestVertex(const double pos[3])
+{
+    if (!hasMesh() || !locator_)
+        return -1;
+    double x[3] = {pos[0], pos[1], pos[2]};
+    return locator_->FindClosestPoint(x);
+}
+
+double GeodesicPathEngine::computePath(vtkIdType source, vtkIdType target, Method method, std::vector<vtkIdType> &outVertices)
+{
+    outVertices.clear();
+    const vtkIdType numPoints = static_cast<vtkIdType>(offsets_.size()) - 1;
+    if (!hasMesh() || source < 0 || target < 0 || source >= numPoints || target >= numPoints)
+        return -1.0;
+    if (source == target)
+    {
+        outVertices.push_back(source);
+        return 0.0;
+    }
+
+    // stamp 溢出时整体重置一次
+    if (++currentStamp_ == 0)
+    {
+        std::fill(stamp_.begin(), stamp_.end(), 0);
+        currentStamp_ = 1;
+    }
+
+    const float *goal = &coords_[3 * target];
+    auto heuristic = [&](std::int32_t v) -> double
+    {
+        if (method != Method::AStar)
+            return 0.0;
+        const float *p = &coords_[3 * static_cast<std::size_t>(v)];
+        double dx = goal[0] - p[0], dy = goal[1] - p[1], dz = goal[2] - p[2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    };
+
+    using QueueItem = std::pair<double, std::int32_t>; // (f = g + h, 顶点)
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> open;
+
+    auto src = static_cast<std::int32_t>(source);
+    stamp_[src] = currentStamp_;
+    dist_[src] = 0.0;
+    prev_[src] = -1;
+    open.emplace(heuristic(src), src);
+
+    bool found = false;
+    while (!open.empty())
+    {
+        auto [f, u] = open.top();
+        open.pop();
+        double g = dist_[u];
+        // 过期条目（已有更短路径）
+        if (f - heuristic(u) > g + 1e-9)
+            continue;
+        if (u == target)
+        {
+            found = true;
+            break;
+        }
+        for (std::int64_t e = offsets_[u]; e < offsets_[u + 1]; ++e)
+        {
+            std::int32_t v = neighbors_[e];
+            double candidate = g + weights_[e];
+            if (stamp_[v] != currentStamp_ || candidate < dist_[v])
+            {
+                stamp_[v] = currentStamp_;
+                dist_[v] = candidate;
+                prev_[v] = u;
+                open.emplace(candidate + heuristic(v), v);
+            }
+        }
+    }
+
+    if (!found)
+        return -1.0;
+
+    for (std::int32_t v = static_cast<std::int32_t>(target); v != -1; v = prev_[v])
+        outVertices.push_back(v);
+    std::reverse(outVertices.begin(), outVertices.end());
+    return dist_[target];
+}
+
+double GeodesicPathEngine::computePath(const double p1[3], const double p2[3], std::vector<std::array<double, 3>> &outPoints,
+                                       Method method)
+{
+    outPoints.clear();
+    vtkIdType source = findClosestVertex(p1);
+    vtkIdType target = findClosestVertex(p2);
+
+    std::vector<vtkIdType> vertices;
+    double length = computePath(source, target, method, vertices);
+    if (length < 0.0)
+        return -1.0;
+
+    // 拾取点通常落在三角形内部，把端点到吸附顶点的一小段也计入路径
+    double v[3];
+    outPoints.push_back({p1[0], p1[1], p1[2]});
+    mesh_->GetPoint(source, v);
+    double total = length + std::sqrt(vtkMath::Distance2BetweenPoints(p1, v));
+    for (vtkIdType id : vertices)
+    {
+        mesh_->GetPoint(id, v);
+        outPoints.push_back({v[0], v[1], v[2]});
+    }
+    mesh_->GetPoint(target, v);
+    total += std::sqrt(vtkMath::Distance2BetweenPoints(p2, v));
+    outPoints.push_back({p2[0], p2[1], p2[2]});
+    return total;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file GeodesicPathEngine.h
+ * @brief 该头文件定义了 GeodesicPathEngine 类，用于计算网格表面上两点之间沿表面的最短路径。
+ * @details 每个网格只构建一次紧凑的 CSR 顶点邻接表（偏移数组 + 邻居数组 + 边长数组），
+ *          之后的每次查询在邻接表上运行 Dijkstra 或 A*（欧氏距离启发），查询间复用临时数组，
+ *          不会为每次查询重新分配 O(N) 的内存。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkStaticPointLocator.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class GeodesicPathEngine
+ * @brief 基于缓存 CSR 邻接表的表面最短路径计算引擎。
+ */
+class GeodesicPathEngine
+{
+public:
+    /**
+     * @enum Method
+     * @brief 最短路径搜索算法。
+     */
+    enum class Method
+    {
+        Dijkstra, ///< 经典 Dijkstra，按距离扩展
+        AStar     ///< A*，以到终点的欧氏距离作为启发（可采纳，结果与 Dijkstra 相同但扩展更少）
+    };
+
+    /**
+     * @brief 设置用于计算的网格。
+     * @details 网格指针与修改时间均未变化时复用已构建的邻接表。传入 nullptr 清空引擎。
+     * @param mesh 含多边形单元的网格数据。
+     */
+    void setMesh(vtkPolyData *mesh);
+
+    /**
+     * @brief 当前是否有可用的网格。
+     */
+    bool hasMesh() const { return mesh_ != nullptr && !offsets_.empty(); }
+
+    // 邻接表与查询缓存占用的内存字节数（不含网格本身）
+    std::size_t getMemorySize() const
+    {
+        return offsets_.capacity() * sizeof(std::int64_t) + neighbors_.capacity() * sizeof(std::int32_t) +
+               (weights_.capacity() + coords_.capacity()) * sizeof(float) + dist_.capacity() * sizeof(double) +
+               prev_.capacity() * sizeof(std::int32_t) + stamp_.capacity() * sizeof(std::uint32_t);
+    }
+
+    /**
+     * @brief 查找离给定坐标最近的网格顶点。
+     * @return 顶点 id，无网格时返回 -1。
+     */
+    vtkIdType findClosestVertex(const double pos[3]);
+
+    /**
+     * @brief 计算两个顶点之间沿网格边的最短路径。
+     * @param source 起点顶点 id。
+     * @param target 终点顶点 id。
+     * @param method 搜索算法。
+     * @param outVertices 输出路径上的顶点 id（从起点到终点）。
+     * @return 路径长度，不连通或参数非法时返回 -1。
+     */
+    double computePath(vtkIdType source, vtkIdType target, Method method, std::vector<vtkIdType> &outVertices);
+
+    /**
+     * @brief 计算两个空间点之间沿表面的最短路径（两点先吸附到最近顶点）。
+     * @param p1 起点坐标。
+     * @param p2 终点坐标。
+     * @param outPoints 输出路径点坐标（包含吸附前的两个端点）。
+     * @param method 搜索算法，默认 A*。
+     * @return 路径长度，失败返回 -1。
+     */
+    double computePath(const double p1[3], const double p2[3], std::vector<std::array<double, 3>> &outPoints,
+                       Method method = Method::AStar);
+
+private:
+    // 由网格多边形单元构建 CSR 邻接表
+    void buildAdjacency();
+
+    vtkSmartPointer<vtkPolyData> mesh_;                 ///< 当前网格
+    vtkMTimeType builtTime_ = 0;                        ///< 构建邻接表时网格的修改时间
+    vtkSmartPointer<vtkStaticPointLocator> locator_;    ///< 最近顶点查找
+
+    std::vector<std::int64_t> offsets_;  ///< CSR 偏移，长度为顶点数 + 1
+    std::vector<std::int32_t> neighbors_; ///< CSR 邻居顶点
+    std::vector<float> weights_;          ///< CSR 边长
+    std::vector<float> coords_;           ///< 顶点坐标副本（xyz 交错），用于启发函数
+
+    // 查询间复用的临时数组，通过 stamp 判断是否属于本次查询，避免每次 O(N) 重置
+    std::vector<double> dist_;
+    std::vector<std::int32_t> prev_;
+    std::vector<std::uint32_t> stamp_;
+    std::uint32_t currentStamp_ = 0;
+};
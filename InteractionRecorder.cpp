@@ -0,0 +1,188 @@
+#include "InteractionRecorder.h"
+
+#include <vtkCamera.h>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+    const char *kSessionHeader = "MyAppInteractionSession";
+    const int kSessionVersion = 1;
+
+    const InteractionType kAllTypes[] = {
+        InteractionType::LoadModel, InteractionType::Camera, InteractionType::BoxEnabled,
+        InteractionType::BoxTransform, InteractionType::Slice, InteractionType::HideSlice,
+        InteractionType::ZScale, InteractionType::MeasurementMode, InteractionType::MeasurementClick};
+
+    double nowMilliseconds()
+    {
+        std::chrono::duration<double, std::milli> now = std::chrono::steady_clock::now().time_since_epoch();
+        return now.count();
+    }
+}
+
+void InteractionRecorder::start(int width, int height)
+{
+    events_.clear();
+    lastCamera_.clear();
+    width_ = width;
+    height_ = height;
+    startTime_ = nowMilliseconds();
+    recording_ = true;
+}
+
+void InteractionRecorder::record(InteractionType type, const std::vector<double> &values, const std::string &text)
+{
+    if (!recording_)
+        return;
+    InteractionEvent event;
+    event.time = nowMilliseconds() - startTime_;
+    event.type = type;
+    event.values = values;
+    event.text = text;
+    events_.push_back(event);
+}
+
+void InteractionRecorder::recordCameraIfChanged(vtkCamera *camera)
+{
+    if (!recording_ || !camera)
+        return;
+    std::vector<double> values(12);
+    camera->GetPosition(&values[0]);
+    camera->GetFocalPoint(&values[3]);
+    camera->GetViewUp(&values[6]);
+    values[9] = camera->GetViewAngle();
+    values[10] = camera->GetParallelScale();
+    values[11] = camera->GetParallelProjection();
+    if (values == lastCamera_)
+        return;
+    lastCamera_ = values;
+    record(InteractionType::Camera, values);
+}
+
+bool InteractionRecorder::save(const std::string &filePath) const
+{
+    std::ofstream out(filePath, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[InteractionRecorder] Cannot open file for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    // 文件格式（逐行文本）：
+    //   MyAppInteractionSession <version>
+    //   window <width> <height>
+    //   重复：<time_ms> <type> <valueCount> <values...> [text]
+    out << kSessionHeader << " " << kSessionVersion << "\n";
+    out << "window " << width_ << " " << height_ << "\n";
+    for (const InteractionEvent &event : events_)
+    {
+        out << std::fixed << std::setprecision(3) << event.time << " " << typeName(event.type) << " "
+            << event.values.size();
+        out << std::defaultfloat << std::setprecision(std::numeric_limits<double>::max_digits10);
+        for (double value : event.values)
+            out << " " << value;
+        if (!event.text.empty())
+            out << " " << event.text;
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool InteractionRecorder::load(const std::string &filePath)
+{
+    std::ifstream in(filePath);
+    if (!in)
+    {
+        std::cerr << "[InteractionRecorder] Cannot open file: " << filePath << std::endl;
+        return false;
+    }
+
+    std::string header;
+    int version = 0;
+    std::string windowKey;
+    int width = 0;
+    int height = 0;
+    if (!(in >> header >> version >> windowKey >> width >> height) || header != kSessionHeader ||
+        version != kSessionVersion || windowKey != "window")
+    {
+        std::cerr << "[InteractionRecorder] Not an interaction session file: " << filePath << std::endl;
+        return false;
+    }
+    in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    std::vector<InteractionEvent> events;
+    std::string line;
+    int lineNumber = 2;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        if (line.empty())
+            continue;
+
+        std::istringstream fields(line);
+        InteractionEvent event;
+        std::string name;
+        std::size_t count = 0;
+        bool known = false;
+        if (fields >> event.time >> name >> count && count <= 64)
+        {
+            for (InteractionType type : kAllTypes)
+            {
+                if (name == typeName(type))
+                {
+                    event.type = type;
+                    known = true;
+                }
+            }
+        }
+        event.values.resize(known ? count : 0);
+        for (std::size_t i = 0; known && i < count; ++i)
+            known = static_cast<bool>(fields >> event.values[i]);
+        if (!known)
+        {
+            std::cerr << "[InteractionRecorder] Invalid event at line " << lineNumber << ": " << filePath << std::endl;
+            return false;
+        }
+        std::getline(fields, event.text);
+        if (!event.text.empty() && event.text[0] == ' ')
+            event.text.erase(0, 1);
+        events.push_back(event);
+    }
+
+    events_.swap(events);
+    width_ = width;
+    height_ = height;
+    recording_ = false;
+    return true;
+}
+
+const char *InteractionRecorder::typeName(InteractionType type)
+{
+    switch (type)
+    {
+    case InteractionType::LoadModel:
+        return "LoadModel";
+    case InteractionType::Camera:
+        return "Camera";
+    case InteractionType::BoxEnabled:
+        return "BoxEnabled";
+    case InteractionType::BoxTransform:
+        return "BoxTransform";
+    case InteractionType::Slice:
+        return "Slice";
+    case InteractionType::HideSlice:
+        return "HideSlice";
+    case InteractionType::ZScale:
+        return "ZScale";
+    case InteractionType::MeasurementMode:
+        return "MeasurementMode";
+    case InteractionType::MeasurementClick:
+        return "MeasurementClick";
+    }
+    return "Unknown";
+}
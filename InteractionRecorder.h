@@ -0,0 +1,97 @@
+/**
+ * @file InteractionRecorder.h
+ * @brief 该头文件定义了 InteractionRecorder 类，录制三维页面上的交互操作并保存为会话文件，供回放基准测试使用。
+ * @details 录制的事件包括加载模型、相机变化（每帧最多一次）、箱体裁剪开关与盒子变换、切面、Z 轴拉伸、
+ *          测量模式与测量点击。会话文件为逐行文本，便于比较和手工编辑；回放由 MyAppReplay 在离屏窗口中完成。
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class vtkCamera;
+
+/**
+ * @enum InteractionType
+ * @brief 交互事件类型，名称会写入会话文件。
+ */
+enum class InteractionType : std::uint8_t
+{
+    LoadModel,        ///< text：模型路径
+    Camera,           ///< position[3] focal[3] viewUp[3] viewAngle parallelScale parallelProjection
+    BoxEnabled,       ///< 1 启用 / 0 关闭
+    BoxTransform,     ///< 盒子相对初始放置的 4x4 变换矩阵（行优先 16 个值）
+    Slice,            ///< 切面方向（SliceDirection）
+    HideSlice,        ///< 无参数
+    ZScale,           ///< Z 轴拉伸比例
+    MeasurementMode,  ///< 测量模式（MeasurementMode）
+    MeasurementClick  ///< 交互器事件位置 x y
+};
+
+/**
+ * @struct InteractionEvent
+ * @brief 一条交互事件。
+ */
+struct InteractionEvent
+{
+    double time = 0.0;                           ///< 相对录制开始的毫秒数
+    InteractionType type = InteractionType::Camera;
+    std::vector<double> values;                  ///< 数值参数
+    std::string text;                            ///< 文本参数（如路径）
+};
+
+/**
+ * @class InteractionRecorder
+ * @brief 交互会话录制器，与渲染器无关（相机只读取状态）。
+ */
+class InteractionRecorder
+{
+public:
+    /**
+     * @brief 清空已有事件并开始录制。
+     * @param width 录制时渲染窗口宽度（点击坐标依赖窗口尺寸）。
+     * @param height 录制时渲染窗口高度。
+     */
+    void start(int width, int height);
+
+    void stop() { recording_ = false; }
+    bool isRecording() const { return recording_; }
+
+    /**
+     * @brief 追加一条事件，未在录制时忽略。
+     */
+    void record(InteractionType type, const std::vector<double> &values = {}, const std::string &text = {});
+
+    /**
+     * @brief 相机自上次记录后有变化时追加 Camera 事件（在每帧渲染前调用）。
+     */
+    void recordCameraIfChanged(vtkCamera *camera);
+
+    /**
+     * @brief 保存为文本会话文件。
+     * @return 写入成功返回 true。
+     */
+    bool save(const std::string &filePath) const;
+
+    /**
+     * @brief 加载会话文件，成功时替换当前事件。
+     * @return 文件格式正确返回 true。
+     */
+    bool load(const std::string &filePath);
+
+    const std::vector<InteractionEvent> &getEvents() const { return events_; }
+    int getWindowWidth() const { return width_; }
+    int getWindowHeight() const { return height_; }
+
+    // 事件类型名称（会话文件与报告中使用）
+    static const char *typeName(InteractionType type);
+
+private:
+    bool recording_ = false;
+    double startTime_ = 0.0;                 ///< 录制开始时刻（steady_clock 毫秒）
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<double> lastCamera_;         ///< 最近一次记录的相机参数
+    std::vector<InteractionEvent> events_;
+};
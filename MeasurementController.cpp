@@ -3,15 +3,22 @@
 #endif
 
 #include "MeasurementController.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+#include "PointBlockIndex.h"
 #include <vtkPointPicker.h>
 #include <vtkTextProperty.h>
 #include <vtkProperty.h>
 #include <vtkMath.h>
+#include <vtkMatrix4x4.h>
 #include <cmath>
+#include <algorithm>
 #include <vtkRenderWindow.h>
+#include <vtkCamera.h>
 #include <vtkSphereSource.h>
 #include <vtkProperty2D.h>
 #include <QDebug>
+#include <QElapsedTimer>
 
 MeasurementController::MeasurementController(vtkRenderer *renderer, vtkRenderWindowInteractor *interactor)
     : renderer_(renderer), interactor_(interactor)
@@ -27,6 +34,178 @@ MeasurementController::MeasurementController(vtkRenderer *renderer, vtkRenderWin
     textActor_->GetTextProperty()->SetFrameColor(1.0, 0.0, 0.0);      // 红框
     textActor_->SetVisibility(0);                                     // 初始隐藏
     renderer_->AddActor2D(textActor_);
+
+    initMarkerActors();
+}
+
+void MeasurementController::initMarkerActors()
+{
+    // ---------- 标记点：一个点缓冲 + 一个球体 glyph mapper ----------
+    markerPoints_ = vtkSmartPointer<vtkPoints>::New();
+    markerPolyData_ = vtkSmartPointer<vtkPolyData>::New();
+    markerPolyData_->SetPoints(markerPoints_);
+
+    auto sphere = vtkSmartPointer<vtkSphereSource>::New();
+    sphere->SetRadius(1.0);
+
+    markerMapper_ = vtkSmartPointer<vtkGlyph3DMapper>::New();
+    markerMapper_->SetInputData(markerPolyData_);
+    markerMapper_->SetSourceConnection(sphere->GetOutputPort());
+    markerMapper_->ScalingOff();
+    markerMapper_->ScalarVisibilityOff();
+
+    markerActor_ = vtkSmartPointer<vtkActor>::New();
+    markerActor_->SetMapper(markerMapper_);
+    markerActor_->GetProperty()->SetColor(1, 0, 0); // 红色球体
+    markerActor_->PickableOff();                    // 避免拾取到标记点本身
+    renderer_->AddActor(markerActor_);
+
+    // ---------- 线段：所有测量线共用一个 polydata ----------
+    linePoints_ = vtkSmartPointer<vtkPoints>::New();
+    lineCells_ = vtkSmartPointer<vtkCellArray>::New();
+    linePolyData_ = vtkSmartPointer<vtkPolyData>::New();
+    linePolyData_->SetPoints(linePoints_);
+    linePolyData_->SetLines(lineCells_);
+
+    auto lineMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    lineMapper->SetInputData(linePolyData_);
+
+    // ⭐关键：启用拓扑偏移，让线绘制时偏移一点点，避免被遮挡（VTK 8.2 的做法）
+    vtkMapper::SetResolveCoincidentTopologyToPolygonOffset();
+    lineMapper->SetResolveCoincidentTopology(true);
+    lineMapper->SetResolveCoincidentTopologyPolygonOffsetParameters(1.0, 1.0); // 偏移强度
+
+    lineActor_ = vtkSmartPointer<vtkActor>::New();
+    lineActor_->SetMapper(lineMapper);
+    lineActor_->GetProperty()->SetColor(1, 0, 0);  // 红色
+    lineActor_->GetProperty()->SetLineWidth(2.0);  // 线宽
+    lineActor_->GetProperty()->SetLighting(false); // 关闭光照影响
+    lineActor_->GetProperty()->SetOpacity(1.0);    // 强制不透明，避免透明影响排序
+    lineActor_->PickableOff();
+    renderer_->AddActor(lineActor_);
+
+    // ---------- 测地线：沿表面的路径叠加显示 ----------
+    geodesicPoints_ = vtkSmartPointer<vtkPoints>::New();
+    geodesicCells_ = vtkSmartPointer<vtkCellArray>::New();
+    geodesicPolyData_ = vtkSmartPointer<vtkPolyData>::New();
+    geodesicPolyData_->SetPoints(geodesicPoints_);
+    geodesicPolyData_->SetLines(geodesicCells_);
+
+    auto geodesicMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+    geodesicMapper->SetInputData(geodesicPolyData_);
+    geodesicMapper->SetResolveCoincidentTopology(true);
+    geodesicMapper->SetResolveCoincidentTopologyPolygonOffsetParameters(1.0, 1.0);
+
+    geodesicActor_ = vtkSmartPointer<vtkActor>::New();
+    geodesicActor_->SetMapper(geodesicMapper);
+    geodesicActor_->GetProperty()->SetColor(0, 1, 0); // 绿色，区别于直线
+    geodesicActor_->GetProperty()->SetLineWidth(3.0);
+    geodesicActor_->GetProperty()->SetLighting(false);
+    geodesicActor_->PickableOff();
+    renderer_->AddActor(geodesicActor_);
+}
+
+void MeasurementController::setSurfaceMesh(vtkPolyData *mesh)
+{
+    geodesicEngine_.setMesh(mesh);
+}
+
+void MeasurementController::setPickActors(const std::vector<vtkActor *> &actors)
+{
+    pickActors_.assign(actors.begin(), actors.end());
+}
+
+void MeasurementController::setPointIndex(std::shared_ptr<const PointBlockIndex> index,
+                                          const std::vector<vtkActor *> &coveredActors)
+{
+    pointIndex_ = std::move(index);
+    indexActors_.assign(coveredActors.begin(), coveredActors.end());
+}
+
+bool MeasurementController::canPickWithIndex() const
+{
+    if (!pointIndex_ || !pointIndex_->isBuiltFor(pointIndex_->getPolyData()) || indexActors_.empty())
+        return false;
+    // 索引数据是显示坐标下的合并数据：覆盖的 actor 须全部显示且无额外变换
+    for (const auto &actor : indexActors_)
+    {
+        if (!actor || !actor->GetVisibility() || !renderer_->HasViewProp(actor) || !actor->GetIsIdentity())
+            return false;
+    }
+    // 其它可拾取 actor 显示在场景中（如箱体裁剪结果）时索引不代表所见数据
+    for (const auto &actor : pickActors_)
+    {
+        if (actor && actor->GetVisibility() && renderer_->HasViewProp(actor) &&
+            std::find(indexActors_.begin(), indexActors_.end(), actor) == indexActors_.end())
+            return false;
+    }
+    return true;
+}
+
+bool MeasurementController::pickWithIndex(int x, int y, double pos[3])
+{
+    // 拾取射线：近裁剪面（显示深度 0）到远裁剪面（显示深度 1）
+    auto displayToWorld = [this](double dx, double dy, double dz, double world[3])
+    {
+        renderer_->SetDisplayPoint(dx, dy, dz);
+        renderer_->DisplayToWorld();
+        double homogeneous[4];
+        renderer_->GetWorldPoint(homogeneous);
+        for (int axis = 0; axis < 3; ++axis)
+            world[axis] = homogeneous[3] != 0.0 ? homogeneous[axis] / homogeneous[3] : homogeneous[axis];
+    };
+    double p0[3];
+    double p1[3];
+    displayToWorld(x, y, 0.0, p0);
+    displayToWorld(x, y, 1.0, p1);
+
+    // 容差与 vtkPointPicker 默认值一致：窗口对角线的 0.025，在焦点深度处换算为世界长度
+    double focalPoint[3];
+    renderer_->GetActiveCamera()->GetFocalPoint(focalPoint);
+    renderer_->SetWorldPoint(focalPoint[0], focalPoint[1], focalPoint[2], 1.0);
+    renderer_->WorldToDisplay();
+    double focalDisplay[3];
+    renderer_->GetDisplayPoint(focalDisplay);
+    int *size = renderer_->GetRenderWindow()->GetSize();
+    double tolerancePixels = 0.025 * std::sqrt(double(size[0]) * size[0] + double(size[1]) * size[1]);
+    double a[3];
+    double b[3];
+    displayToWorld(x, y, focalDisplay[2], a);
+    displayToWorld(x + tolerancePixels, y, focalDisplay[2], b);
+    double tolerance = std::sqrt(vtkMath::Distance2BetweenPoints(a, b));
+
+    return pointIndex_->pickPoint(p0, p1, tolerance, pos) >= 0;
+}
+
+void MeasurementController::setDisplayToWorld(const double matrix[16])
+{
+    hasDisplayToWorld_ = matrix != nullptr;
+    if (!matrix)
+        return;
+    std::copy(matrix, matrix + 16, displayToWorld_.begin());
+    vtkMatrix4x4::Invert(displayToWorld_.data(), worldToDisplay_.data());
+}
+
+MeasurementPoint MeasurementController::toWorld(const MeasurementPoint &p) const
+{
+    if (!hasDisplayToWorld_)
+        return p;
+    const double *m = displayToWorld_.data();
+    MeasurementPoint w;
+    for (int row = 0; row < 3; ++row)
+        w[row] = m[4 * row] * p[0] + m[4 * row + 1] * p[1] + m[4 * row + 2] * p[2] + m[4 * row + 3];
+    return w;
+}
+
+MeasurementPoint MeasurementController::toDisplay(const MeasurementPoint &world) const
+{
+    if (!hasDisplayToWorld_)
+        return world;
+    const double *m = worldToDisplay_.data();
+    MeasurementPoint p;
+    for (int row = 0; row < 3; ++row)
+        p[row] = m[4 * row] * world[0] + m[4 * row + 1] * world[1] + m[4 * row + 2] * world[2] + m[4 * row + 3];
+    return p;
 }
 
 void MeasurementController::setMode(MeasurementMode mode)
@@ -42,17 +221,13 @@ void MeasurementController::setMode(MeasurementMode mode)
 void MeasurementController::clearMeasurements()
 {
     pickedPoints_.clear();
-    for (auto &actor : pointMarkers_)
-    {
-        renderer_->RemoveActor(actor);
-    }
-    pointMarkers_.clear();
+    clearAllMarkers();
     textActor_->SetInput("");
-    render();
 }
 
 void MeasurementController::onLeftButtonPressed()
 {
+    TRACE_SCOPE("MeasurementController::onLeftButtonPressed");
     if (mode_ == MeasurementMode::None)
     {
         qDebug() << "[MeasurementController] Current mode is None. Click ignored.";
@@ -63,14 +238,32 @@ void MeasurementController::onLeftButtonPressed()
     interactor_->GetEventPosition(x, y);
     qDebug() << "[MeasurementController] Mouse clicked at: (" << x << "," << y << ")";
 
-    auto picker = vtkSmartPointer<vtkPointPicker>::New();
-    if (!picker->Pick(x, y, 0, renderer_))
+    double pos[3];
+    int picked = 0;
+    if (canPickWithIndex())
+    {
+        ScopedStageTimer timer("Pick.Indexed");
+        picked = pickWithIndex(x, y, pos);
+    }
+    else
+    {
+        auto picker = vtkSmartPointer<vtkPointPicker>::New();
+        if (!pickActors_.empty())
+        {
+            picker->PickFromListOn();
+            for (const auto &actor : pickActors_)
+                picker->AddPickList(actor);
+        }
+        ScopedStageTimer timer("Pick");
+        picked = picker->Pick(x, y, 0, renderer_);
+        if (picked)
+            picker->GetPickPosition(pos);
+    }
+    if (!picked)
     {
         qDebug() << "[MeasurementController] Point picking failed. No valid geometry hit.";
         return;
     }
-    double pos[3];
-    picker->GetPickPosition(pos);
     qDebug() << "[MeasurementController] Point picked at: ("
              << pos[0] << "," << pos[1] << "," << pos[2] << ")";
 
@@ -118,24 +311,78 @@ void MeasurementController::onLeftButtonPressed()
         qDebug() << "[MeasurementController] Required number of points reached. Updating measurement display.";
         updateMeasurementDisplay();
     }
+    commitCurrentMeasurement();
     updateTextActor();
 }
 
-void MeasurementController::addPointMarker(const double pos[3])
+void MeasurementController::commitCurrentMeasurement()
 {
-    auto sphere = vtkSmartPointer<vtkSphereSource>::New();
-    double center[3] = {pos[0], pos[1], pos[2]};
-    sphere->SetCenter(center);
-    sphere->SetRadius(1.0);
+    // 会话保存原始坐标：长度、面积按真实尺度计算，且不随中心、Z 拉伸或当前模型变化
+    if (mode_ == MeasurementMode::Point && pickedPoints_.size() == 1)
+        session_.addPoint("", toWorld(pickedPoints_[0]));
+    else if (mode_ == MeasurementMode::Line && pickedPoints_.size() == 2 && geodesicPath_.size() >= 2)
+    {
+        std::vector<MeasurementPoint> path;
+        path.reserve(geodesicPath_.size());
+        for (const auto &p : geodesicPath_)
+            path.push_back(toWorld(p));
+        session_.addGeodesic("", path); // 路径首尾即两个拾取点，直线距离可由首尾求得
+    }
+    else if (mode_ == MeasurementMode::Line && pickedPoints_.size() == 2)
+        session_.addLine("", toWorld(pickedPoints_[0]), toWorld(pickedPoints_[1]));
+    else if (mode_ == MeasurementMode::Triangle && pickedPoints_.size() == 3)
+        session_.addTriangle("", toWorld(pickedPoints_[0]), toWorld(pickedPoints_[1]), toWorld(pickedPoints_[2]));
+    else
+        return;
+    qDebug() << "[MeasurementController] Measurement committed. Session size:" << session_.size();
+}
 
-    auto mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputConnection(sphere->GetOutputPort());
+void MeasurementController::showSession()
+{
+    pickedPoints_.clear();
+    clearAllMarkers();
 
-    auto actor = vtkSmartPointer<vtkActor>::New();
-    actor->SetMapper(mapper);
-    actor->GetProperty()->SetColor(1, 0, 0); // 红色球体
-    pointMarkers_.push_back(actor);
-    renderer_->AddActor(actor);
+    for (const auto &m : session_.measurements())
+    {
+        // 会话中为原始坐标，按当前显示变换还原
+        std::vector<MeasurementPoint> pts;
+        pts.reserve(m.points.size());
+        for (const auto &p : m.points)
+            pts.push_back(toDisplay(p));
+        if (pts.empty())
+            continue;
+
+        if (m.type == MeasurementType::Geodesic)
+        {
+            // 与拾取时的显示一致：首尾标记点、直线与沿表面路径
+            markerPoints_->InsertNextPoint(pts.front().data());
+            markerPoints_->InsertNextPoint(pts.back().data());
+            renderLine(pts.front().data(), pts.back().data());
+            drawGeodesicPath(pts);
+            continue;
+        }
+
+        for (const auto &p : pts)
+            markerPoints_->InsertNextPoint(p.data());
+
+        for (std::size_t i = 1; i < pts.size(); ++i)
+            renderLine(pts[i - 1].data(), pts[i].data());
+        bool closed = m.type == MeasurementType::Triangle || m.type == MeasurementType::Polygon;
+        if (closed && pts.size() > 2)
+            renderLine(pts.back().data(), pts.front().data());
+    }
+    markerPoints_->Modified();
+    markerPolyData_->Modified();
+
+    qDebug() << "[MeasurementController] Session shown, measurements:" << session_.size();
+    render();
+}
+
+void MeasurementController::addPointMarker(const double pos[3])
+{
+    markerPoints_->InsertNextPoint(pos);
+    markerPoints_->Modified();
+    markerPolyData_->Modified();
 
     render();
 }
@@ -145,6 +392,7 @@ void MeasurementController::updateMeasurementDisplay()
     if (mode_ == MeasurementMode::Line && pickedPoints_.size() >= 2)
     {
         renderLine(pickedPoints_[0].data(), pickedPoints_[1].data());
+        renderGeodesicPath(pickedPoints_[0].data(), pickedPoints_[1].data());
         // textActor_->SetInput(formatDistanceInfo(pickedPoints_[0].data(), pickedPoints_[1].data()).toUtf8().data());
     }
     else if (mode_ == MeasurementMode::Triangle && pickedPoints_.size() >= 3)
@@ -158,33 +406,47 @@ void MeasurementController::updateMeasurementDisplay()
 
 void MeasurementController::renderLine(const double p1[3], const double p2[3])
 {
-    qDebug() << "[MeasurementController] Entering renderLine function";
-    auto line = vtkSmartPointer<vtkLineSource>::New();
-    double pt1[3] = {p1[0], p1[1], p1[2]}; // 非 const 拷贝
-    double pt2[3] = {p2[0], p2[1], p2[2]}; // 非 const 拷贝
-    line->SetPoint1(pt1);
-    line->SetPoint2(pt2);
+    vtkIdType ids[2];
+    ids[0] = linePoints_->InsertNextPoint(p1);
+    ids[1] = linePoints_->InsertNextPoint(p2);
+    lineCells_->InsertNextCell(2, ids);
+
+    linePoints_->Modified();
+    lineCells_->Modified();
+    linePolyData_->Modified();
+}
 
-    auto mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputConnection(line->GetOutputPort());
+void MeasurementController::renderGeodesicPath(const double p1[3], const double p2[3])
+{
+    geodesicLength_ = -1.0;
+    geodesicPath_.clear();
+    if (!geodesicEngine_.hasMesh())
+        return;
 
-    // ⭐关键：启用拓扑偏移，让线绘制时偏移一点点，避免被遮挡（VTK 8.2 的做法）
-    vtkMapper::SetResolveCoincidentTopologyToPolygonOffset();
-    mapper->SetResolveCoincidentTopology(true);
-    mapper->SetResolveCoincidentTopologyPolygonOffsetParameters(1.0, 1.0); // 偏移强度
-
-    auto actor = vtkSmartPointer<vtkActor>::New();
-    actor->SetMapper(mapper);
-    actor->GetProperty()->SetColor(1, 0, 0);
-    actor->GetProperty()->SetLineWidth(2.0);
-    actor->GetProperty()->SetColor(1, 0, 0);  // 红色
-    actor->GetProperty()->SetLineWidth(2.0);  // 线宽
-    actor->GetProperty()->SetLighting(false); // 可选，关闭光照影响
-    // 可选：强制不透明，避免透明影响排序
-    actor->GetProperty()->SetOpacity(1.0);
-
-    pointMarkers_.push_back(actor);
-    renderer_->AddActor(actor);
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<std::array<double, 3>> path;
+    geodesicLength_ = geodesicEngine_.computePath(p1, p2, path);
+    qDebug() << "[MeasurementController] Geodesic path:" << path.size() << "points, length"
+             << geodesicLength_ << "in" << timer.elapsed() << "ms";
+    if (geodesicLength_ < 0.0 || path.size() < 2)
+        return;
+
+    drawGeodesicPath(path);
+    geodesicPath_ = std::move(path);
+}
+
+void MeasurementController::drawGeodesicPath(const std::vector<MeasurementPoint> &path)
+{
+    std::vector<vtkIdType> ids;
+    ids.reserve(path.size());
+    for (const auto &p : path)
+        ids.push_back(geodesicPoints_->InsertNextPoint(p.data()));
+    geodesicCells_->InsertNextCell(static_cast<vtkIdType>(ids.size()), ids.data());
+
+    geodesicPoints_->Modified();
+    geodesicCells_->Modified();
+    geodesicPolyData_->Modified();
 }
 
 void MeasurementController::renderTriangle(const double p1[3], const double p2[3], const double p3[3])
@@ -232,35 +494,23 @@ QString MeasurementController::formatTriangleInfo(const double *A, const double
 
 double MeasurementController::computeDistance(const double *p1, const double *p2)
 {
-    return std::sqrt(vtkMath::Distance2BetweenPoints(p1, p2));
+    return MeasurementMath::distance(p1, p2);
 }
 
 double MeasurementController::computeArea(const double *A, const double *B, const double *C)
 {
-    double AB[3], AC[3], cross[3];
-    vtkMath::Subtract(B, A, AB);
-    vtkMath::Subtract(C, A, AC);
-    vtkMath::Cross(AB, AC, cross);
-    return 0.5 * vtkMath::Norm(cross);
+    return MeasurementMath::triangleArea(A, B, C);
 }
 
 double MeasurementController::computeAngleDeg(const double *A, const double *B, const double *C)
 {
-    double AB[3], CB[3];
-    vtkMath::Subtract(A, B, AB);
-    vtkMath::Subtract(C, B, CB);
-    vtkMath::Normalize(AB);
-    vtkMath::Normalize(CB);
-    double dot = vtkMath::Dot(AB, CB);
-    return std::acos(dot) * 180.0 / vtkMath::Pi();
+    return MeasurementMath::angleDeg(A, B, C);
 }
 
 void MeasurementController::render()
 {
-    if (renderer_ && renderer_->GetRenderWindow())
-    {
-        renderer_->GetRenderWindow()->Render();
-    }
+    if (renderer_)
+        RenderScheduler::requestOrRender(renderScheduler_, renderer_->GetRenderWindow());
 }
 
 void MeasurementController::updateTextActor()
@@ -280,6 +530,15 @@ void MeasurementController::updateTextActor()
                    .arg(p[0], 0, 'f', 6)
                    .arg(p[1], 0, 'f', 6)
                    .arg(p[2], 0, 'f', 6);
+        if (hasDisplayToWorld_)
+        {
+            // 地理参考坐标数值大，按 double 矩阵还原后以 3 位小数（毫米）显示
+            MeasurementPoint w = toWorld(p);
+            text += QString("\nPoint@World\nX1:%1    Y1:%2    Z1:%3")
+                        .arg(w[0], 0, 'f', 3)
+                        .arg(w[1], 0, 'f', 3)
+                        .arg(w[2], 0, 'f', 3);
+        }
     }
     else if (pickedPoints_.size() == 2)
     {
@@ -304,6 +563,12 @@ void MeasurementController::updateTextActor()
                    .arg(QString::number(dxy, 'f', 6).rightJustified(12, ' '))
                    .arg(QString::number(dxz, 'f', 6).rightJustified(12, ' '))
                    .arg(QString::number(dyz, 'f', 6).rightJustified(12, ' '));
+
+        if (geodesicLength_ >= 0.0)
+        {
+            text += QString("\nGeodesic:%1")
+                        .arg(QString::number(geodesicLength_, 'f', 6).rightJustified(12, ' '));
+        }
     }
     else if (pickedPoints_.size() == 3)
     {
@@ -383,24 +648,66 @@ void MeasurementController::updateTextActor()
 
 void MeasurementController::clearAllMarkers()
 {
-    for (auto actor : pointMarkers_)
-    {
-        renderer_->RemoveActor(actor);
-    }
-    pointMarkers_.clear();
+    // 只清空缓冲，actor 常驻场景
+    markerPoints_->Reset();
+    markerPoints_->Modified();
+    markerPolyData_->Modified();
+
+    linePoints_->Reset();
+    lineCells_->Reset();
+    linePoints_->Modified();
+    lineCells_->Modified();
+    linePolyData_->Modified();
+
+    geodesicPoints_->Reset();
+    geodesicCells_->Reset();
+    geodesicPoints_->Modified();
+    geodesicCells_->Modified();
+    geodesicPolyData_->Modified();
+    geodesicLength_ = -1.0;
+    geodesicPath_.clear();
 
     if (textActor_)
     {
         textActor_->SetVisibility(0); // 不删除，只隐藏
     }
 
-    interactor_->GetRenderWindow()->Render();
+    render();
 }
 
 void MeasurementController::ReAddActorsToRenderer()
 {
-    if (textActor_ && renderer_)
+    if (!renderer_)
+        return;
+    if (textActor_)
     {
         renderer_->AddActor2D(textActor_);
     }
+    if (markerActor_)
+    {
+        renderer_->AddActor(markerActor_);
+    }
+    if (lineActor_)
+    {
+        renderer_->AddActor(lineActor_);
+    }
+    if (geodesicActor_)
+    {
+        renderer_->AddActor(geodesicActor_);
+    }
+}
+
+void MeasurementController::appendMemoryUsage(MemoryReport &report) const
+{
+    const std::string owner = "Measurement";
+    report.addPolyData(owner, "markers", markerPolyData_);
+    report.addPolyData(owner, "lines", linePolyData_);
+    report.addPolyData(owner, "geodesic paths", geodesicPolyData_);
+    report.addBytes(owner, "geodesic adjacency", geodesicEngine_.getMemorySize());
+
+    // glyph 实例缓冲：每个实例 4x4 变换矩阵、3x3 法向矩阵与 RGBA 颜色
+    std::size_t instanceBytes = (16 + 9) * sizeof(float) + 4;
+    report.addBytes(owner, "marker instances", 0, static_cast<std::size_t>(markerPoints_->GetNumberOfPoints()) * instanceBytes);
+    report.addActor(owner, "line mapper", lineActor_);
+    report.addActor(owner, "geodesic mapper", geodesicActor_);
 }
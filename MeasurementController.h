@@ -1,5 +1,10 @@
 #pragma once
 
+#include "MeasurementSession.h"
+#include "GeodesicPathEngine.h"
+#include "RenderScheduler.h"
+#include "MemoryReport.h"
+
 #include <QObject>
 #include <vtkSmartPointer.h>
 #include <vtkRenderer.h>
@@ -10,8 +15,15 @@
 #include <vtkPolyDataMapper.h>
 #include <vtkSphereSource.h>
 #include <vtkCaptionActor2D.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkPolyData.h>
+#include <vtkGlyph3DMapper.h>
 #include <vector>
 #include <array>
+#include <memory>
+
+class PointBlockIndex;
 
 enum class MeasurementMode
 {
@@ -29,30 +41,87 @@ class MeasurementController : public QObject
 public:
     MeasurementController(vtkRenderer *renderer, vtkRenderWindowInteractor *interactor);
     void setMode(MeasurementMode mode); // 设置当前测量模式
+    MeasurementMode getMode() const { return mode_; }
     void clearMeasurements();           // 清除当前所有测量
     void onLeftButtonPressed();         // 鼠标左键点击事件响应（需外部连接）
     // 重新添加文本框到场景中
     void ReAddActorsToRenderer();
+    // 测量会话（保存所有已完成的测量，可脱离界面使用；设置了 setDisplayToWorld 时点为原始坐标）
+    MeasurementSession &session() { return session_; }
+    const MeasurementSession &session() const { return session_; }
+    // 按会话内容重新绘制全部测量的标记点与线段（如加载会话文件后）
+    void showSession();
+    // 设置用于沿表面（测地线）测距的网格，点云模型传 nullptr
+    void setSurfaceMesh(vtkPolyData *mesh);
+    // 设置可拾取的 actor（多模型场景中只测量选中的模型），为空时拾取场景中所有 actor
+    void setPickActors(const std::vector<vtkActor *> &actors);
+    // 设置拾取目标数据的点块索引及其覆盖的 actor：这些 actor 均在场景中显示且没有其它可拾取 actor 时
+    // 用索引拾取（只遍历射线穿过的块），否则（箱体裁剪、切面等）回退到 vtkPointPicker；传 nullptr 关闭
+    void setPointIndex(std::shared_ptr<const PointBlockIndex> index, const std::vector<vtkActor *> &coveredActors);
+    // 设置渲染调度器，未设置时直接渲染
+    void setRenderScheduler(RenderScheduler *scheduler) { renderScheduler_ = scheduler; }
+    // 设置显示坐标到原始坐标的矩阵（行主序 4x4），单点测量同时显示原始坐标；传 nullptr 只显示显示坐标
+    void setDisplayToWorld(const double matrix[16]);
+    // 会话中的原始坐标换算为当前显示坐标（未设置矩阵时原样返回）
+    MeasurementPoint toDisplay(const MeasurementPoint &world) const;
+    // 将标记点、线段、测地线数据与邻接表缓存登记到内存报告（所属模块 "Measurement"）
+    void appendMemoryUsage(MemoryReport &report) const;
 
 private:
+    void initMarkerActors();                                                          // 初始化批量绘制的标记点/线段 actor
     void addPointMarker(const double pos[3]);                                         // 添加球体标记点
     void updateMeasurementDisplay();                                                  // 根据点数更新测量图形与文字
     void renderLine(const double p1[3], const double p2[3]);                          // 渲染一条直线
     void renderTriangle(const double p1[3], const double p2[3], const double p3[3]);  // 渲染一个三角形
+    void renderGeodesicPath(const double p1[3], const double p2[3]);                 // 计算并渲染沿表面的最短路径
+    void drawGeodesicPath(const std::vector<MeasurementPoint> &path);                // 把一条路径追加到测地线 polydata
     QString formatDistanceInfo(const double *p1, const double *p2);                   // 格式化距离测量文本
     QString formatTriangleInfo(const double *p1, const double *p2, const double *p3); // 格式化三角形测量文本
     double computeDistance(const double *p1, const double *p2);                       // 计算两点距离
     double computeArea(const double *A, const double *B, const double *C);            // 计算三角形面积
     double computeAngleDeg(const double *A, const double *B, const double *C);        // 计算角度
     void render();                                                                    // 请求刷新渲染窗口
+    bool canPickWithIndex() const;                                                    // 当前场景是否可用点块索引拾取
+    bool pickWithIndex(int x, int y, double pos[3]);                                  // 用点块索引拾取屏幕位置处的点
     void updateTextActor();                                                           // 更新文本信息框
     // 清除所有标记点和测量图形
     void clearAllMarkers();
+    // 当前测量完成后写入会话
+    void commitCurrentMeasurement();
+    // 显示坐标换算为原始坐标（未设置矩阵时原样返回）
+    MeasurementPoint toWorld(const MeasurementPoint &p) const;
 
     vtkRenderer *renderer_;
+    RenderScheduler *renderScheduler_ = nullptr; // 渲染调度器（由页面持有）
     vtkRenderWindowInteractor *interactor_;
     MeasurementMode mode_ = MeasurementMode::None;
     std::vector<std::array<double, 3>> pickedPoints_;     // 已选的测量点
-    std::vector<vtkSmartPointer<vtkActor>> pointMarkers_; // 所有绘制的 actor（点、线）
+    std::vector<vtkSmartPointer<vtkActor>> pickActors_;   // 拾取目标，为空表示不限制
+    std::shared_ptr<const PointBlockIndex> pointIndex_;   // 拾取目标数据的点块索引
+    std::vector<vtkSmartPointer<vtkActor>> indexActors_;  // 索引数据对应的 actor
+    MeasurementSession session_;                          // 已完成测量的会话记录
     vtkSmartPointer<vtkTextActor> textActor_;             // 文本显示 actor
+    bool hasDisplayToWorld_ = false;                      // 是否可换算原始坐标
+    std::array<double, 16> displayToWorld_{};             // 显示坐标到原始坐标的矩阵
+    std::array<double, 16> worldToDisplay_{};             // 原始坐标到显示坐标的矩阵（上者的逆）
+
+    // 所有标记点共用一个点缓冲 + 一个 glyph mapper，所有线段共用一个 polydata，
+    // 新增测量只需追加数据并 Modified()，actor 数量与测量数量无关
+    vtkSmartPointer<vtkPoints> markerPoints_;         // 标记点坐标缓冲
+    vtkSmartPointer<vtkPolyData> markerPolyData_;     // 标记点 polydata（glyph 输入）
+    vtkSmartPointer<vtkGlyph3DMapper> markerMapper_;  // 球体 glyph 实例化绘制
+    vtkSmartPointer<vtkActor> markerActor_;           // 标记点 actor
+    vtkSmartPointer<vtkPoints> linePoints_;           // 线段端点缓冲
+    vtkSmartPointer<vtkCellArray> lineCells_;         // 线段拓扑
+    vtkSmartPointer<vtkPolyData> linePolyData_;       // 所有线段的 polydata
+    vtkSmartPointer<vtkActor> lineActor_;             // 线段 actor
+
+    // 测地线（沿表面最短路径）
+    GeodesicPathEngine geodesicEngine_;               // 缓存 CSR 邻接表的测地线引擎
+    double geodesicLength_ = -1.0;                    // 当前线测量的测地线长度，<0 表示无
+    std::vector<MeasurementPoint> geodesicPath_;      // 当前线测量的测地线路径，提交时作为测量点写入会话
+    vtkSmartPointer<vtkPoints> geodesicPoints_;       // 所有测地线路径点
+    vtkSmartPointer<vtkCellArray> geodesicCells_;     // 测地线折线拓扑
+    vtkSmartPointer<vtkPolyData> geodesicPolyData_;   // 测地线 polydata
+    vtkSmartPointer<vtkActor> geodesicActor_;         // 测地线叠加显示 actor
 };
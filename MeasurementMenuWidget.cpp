@@ -17,10 +17,14 @@ MeasurementMenuWidget::MeasurementMenuWidget(QWidget *parent)
     lineBtn_ = new QPushButton("xian");
     triangleBtn_ = new QPushButton("mian");
     closeBtn_ = new QPushButton("close");
+    saveBtn_ = new QPushButton("save");
+    loadBtn_ = new QPushButton("load");
 
     layout->addWidget(pointBtn_);
     layout->addWidget(lineBtn_);
     layout->addWidget(triangleBtn_);
+    layout->addWidget(saveBtn_);
+    layout->addWidget(loadBtn_);
     layout->addWidget(closeBtn_);
 
     connect(pointBtn_, &QPushButton::clicked, this, [=]()
@@ -35,6 +39,8 @@ MeasurementMenuWidget::MeasurementMenuWidget(QWidget *parent)
             {
         emit triangleMeasureRequested();
         updateHighlight(triangleBtn_); });
+    connect(saveBtn_, &QPushButton::clicked, this, &MeasurementMenuWidget::saveSessionRequested);
+    connect(loadBtn_, &QPushButton::clicked, this, &MeasurementMenuWidget::loadSessionRequested);
     connect(closeBtn_, &QPushButton::clicked, this, [=]()
             {
         emit closeMeasureRequested();
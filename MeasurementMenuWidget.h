@@ -23,12 +23,16 @@ signals:
     void lineMeasureRequested();
     void triangleMeasureRequested();
     void closeMeasureRequested();
+    void saveSessionRequested();
+    void loadSessionRequested();
 
 private:
     QPushButton *pointBtn_;
     QPushButton *lineBtn_;
     QPushButton *triangleBtn_;
     QPushButton *closeBtn_;
+    QPushButton *saveBtn_;
+    QPushButton *loadBtn_;
     QPoint anchorOffset_; // 相对于父窗口的位置偏移
 
     void updateHighlight(QPushButton *activeBtn);
@@ -0,0 +1,461 @@
+#include "MeasurementSession.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    // 会话文件头：魔数 + 版本号
+    const char kSessionMagic[4] = {'V', 'M', 'S', '1'};
+    const std::uint32_t kSessionVersion = 1;
+
+    // 每条测量记录的最小字节数：type:u8 nameLen:u16 pointCount:u32
+    const std::uint64_t kRecordHeaderSize = sizeof(std::uint8_t) + sizeof(std::uint16_t) + sizeof(std::uint32_t);
+
+    bool hostIsLittleEndian()
+    {
+        const std::uint16_t probe = 1;
+        unsigned char first = 0;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    // 文件按小端存储，大端主机上读写时逐字节翻转
+    template <typename T>
+    void toFileOrder(T &value)
+    {
+        if (hostIsLittleEndian())
+            return;
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        std::reverse(bytes, bytes + sizeof(T));
+        std::memcpy(&value, bytes, sizeof(T));
+    }
+
+    template <typename T>
+    void writePod(std::ostream &out, T value)
+    {
+        toFileOrder(value);
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readPod(std::istream &in, T &value)
+    {
+        in.read(reinterpret_cast<char *>(&value), sizeof(T));
+        toFileOrder(value);
+        return static_cast<bool>(in);
+    }
+
+    // 文件中从当前读取位置到末尾的剩余字节数
+    std::uint64_t remainingBytes(std::istream &in, std::uint64_t fileSize)
+    {
+        std::streamoff position = in.tellg();
+        return position < 0 || static_cast<std::uint64_t>(position) > fileSize ? 0 : fileSize - static_cast<std::uint64_t>(position);
+    }
+
+    void subtract(const double *a, const double *b, double *out)
+    {
+        out[0] = a[0] - b[0];
+        out[1] = a[1] - b[1];
+        out[2] = a[2] - b[2];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// MeasurementMath
+// ---------------------------------------------------------------------------
+
+double MeasurementMath::distance(const double *p1, const double *p2)
+{
+    double d[3];
+    subtract(p2, p1, d);
+    return std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+}
+
+double MeasurementMath::triangleArea(const double *A, const double *B, const double *C)
+{
+    double AB[3], AC[3];
+    subtract(B, A, AB);
+    subtract(C, A, AC);
+    double cx = AB[1] * AC[2] - AB[2] * AC[1];
+    double cy = AB[2] * AC[0] - AB[0] * AC[2];
+    double cz = AB[0] * AC[1] - AB[1] * AC[0];
+    return 0.5 * std::sqrt(cx * cx + cy * cy + cz * cz);
+}
+
+double MeasurementMath::angleDeg(const double *A, const double *B, const double *C)
+{
+    double BA[3], BC[3];
+    subtract(A, B, BA);
+    subtract(C, B, BC);
+    double lenBA = std::sqrt(BA[0] * BA[0] + BA[1] * BA[1] + BA[2] * BA[2]);
+    double lenBC = std::sqrt(BC[0] * BC[0] + BC[1] * BC[1] + BC[2] * BC[2]);
+    if (lenBA <= 0.0 || lenBC <= 0.0)
+        return 0.0;
+    double cosTheta = (BA[0] * BC[0] + BA[1] * BC[1] + BA[2] * BC[2]) / (lenBA * lenBC);
+    cosTheta = std::clamp(cosTheta, -1.0, 1.0);
+    return std::acos(cosTheta) * 180.0 / 3.14159265358979323846;
+}
+
+double MeasurementMath::polylineLength(const std::vector<MeasurementPoint> &points, bool closed)
+{
+    if (points.size() < 2)
+        return 0.0;
+    double length = 0.0;
+    for (std::size_t i = 1; i < points.size(); ++i)
+        length += distance(points[i - 1].data(), points[i].data());
+    if (closed && points.size() > 2)
+        length += distance(points.back().data(), points.front().data());
+    return length;
+}
+
+double MeasurementMath::polygonArea(const std::vector<MeasurementPoint> &points, double normal[3])
+{
+    normal[0] = normal[1] = normal[2] = 0.0;
+    if (points.size() < 3)
+        return 0.0;
+
+    // Newell 法：对非严格共面的多边形也稳定
+    double n[3] = {0.0, 0.0, 0.0};
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        const auto &cur = points[i];
+        const auto &next = points[(i + 1) % points.size()];
+        n[0] += (cur[1] - next[1]) * (cur[2] + next[2]);
+        n[1] += (cur[2] - next[2]) * (cur[0] + next[0]);
+        n[2] += (cur[0] - next[0]) * (cur[1] + next[1]);
+    }
+    double len = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (len > 1e-12)
+    {
+        normal[0] = n[0] / len;
+        normal[1] = n[1] / len;
+        normal[2] = n[2] / len;
+    }
+    return 0.5 * len;
+}
+
+// ---------------------------------------------------------------------------
+// MeasurementSession
+// ---------------------------------------------------------------------------
+
+std::size_t MeasurementSession::minimumPointCount(MeasurementType type)
+{
+    switch (type)
+    {
+    case MeasurementType::Point:
+        return 1;
+    case MeasurementType::Line:
+    case MeasurementType::Polyline:
+    case MeasurementType::Geodesic:
+        return 2;
+    case MeasurementType::Triangle:
+    case MeasurementType::Polygon:
+        return 3;
+    }
+    return 1;
+}
+
+const char *MeasurementSession::typeName(MeasurementType type)
+{
+    switch (type)
+    {
+    case MeasurementType::Point:
+        return "Point";
+    case MeasurementType::Line:
+        return "Line";
+    case MeasurementType::Triangle:
+        return "Triangle";
+    case MeasurementType::Polyline:
+        return "Polyline";
+    case MeasurementType::Polygon:
+        return "Polygon";
+    case MeasurementType::Geodesic:
+        return "Geodesic";
+    }
+    return "Measurement";
+}
+
+bool MeasurementSession::isValidPointCount(MeasurementType type, std::size_t count)
+{
+    std::size_t minCount = minimumPointCount(type);
+    bool fixedCount = type == MeasurementType::Point || type == MeasurementType::Line || type == MeasurementType::Triangle;
+    return count >= minCount && (!fixedCount || count == minCount);
+}
+
+bool MeasurementSession::add(const std::string &name, MeasurementType type, const std::vector<MeasurementPoint> &points)
+{
+    if (!isValidPointCount(type, points.size()))
+    {
+        std::cerr << "[MeasurementSession] " << typeName(type) << " needs "
+                  << minimumPointCount(type) << " points, got " << points.size() << std::endl;
+        return false;
+    }
+
+    Measurement measurement;
+    measurement.name = name.empty() ? makeUniqueName(type) : name;
+    measurement.type = type;
+    measurement.points = points;
+
+    // 重名时覆盖
+    auto it = std::find_if(measurements_.begin(), measurements_.end(),
+                           [&](const Measurement &m)
+                           { return m.name == measurement.name; });
+    if (it != measurements_.end())
+        *it = std::move(measurement);
+    else
+        measurements_.push_back(std::move(measurement));
+    return true;
+}
+
+bool MeasurementSession::addPoint(const std::string &name, const MeasurementPoint &p)
+{
+    return add(name, MeasurementType::Point, {p});
+}
+
+bool MeasurementSession::addLine(const std::string &name, const MeasurementPoint &p1, const MeasurementPoint &p2)
+{
+    return add(name, MeasurementType::Line, {p1, p2});
+}
+
+bool MeasurementSession::addTriangle(const std::string &name, const MeasurementPoint &A, const MeasurementPoint &B, const MeasurementPoint &C)
+{
+    return add(name, MeasurementType::Triangle, {A, B, C});
+}
+
+bool MeasurementSession::addPolyline(const std::string &name, const std::vector<MeasurementPoint> &points)
+{
+    return add(name, MeasurementType::Polyline, points);
+}
+
+bool MeasurementSession::addPolygon(const std::string &name, const std::vector<MeasurementPoint> &points)
+{
+    return add(name, MeasurementType::Polygon, points);
+}
+
+bool MeasurementSession::addGeodesic(const std::string &name, const std::vector<MeasurementPoint> &path)
+{
+    return add(name, MeasurementType::Geodesic, path);
+}
+
+bool MeasurementSession::remove(const std::string &name)
+{
+    auto it = std::find_if(measurements_.begin(), measurements_.end(),
+                           [&](const Measurement &m)
+                           { return m.name == name; });
+    if (it == measurements_.end())
+        return false;
+    measurements_.erase(it);
+    return true;
+}
+
+const Measurement *MeasurementSession::find(const std::string &name) const
+{
+    for (const auto &m : measurements_)
+    {
+        if (m.name == name)
+            return &m;
+    }
+    return nullptr;
+}
+
+void MeasurementSession::clear()
+{
+    measurements_.clear();
+}
+
+MeasurementResult MeasurementSession::evaluate(const Measurement &measurement)
+{
+    MeasurementResult result;
+    const auto &pts = measurement.points;
+    if (pts.size() < minimumPointCount(measurement.type))
+        return result;
+    result.valid = true;
+
+    switch (measurement.type)
+    {
+    case MeasurementType::Point:
+        break;
+
+    case MeasurementType::Line:
+    case MeasurementType::Polyline:
+    case MeasurementType::Geodesic:
+    {
+        result.length = MeasurementMath::polylineLength(pts, false);
+        for (std::size_t i = 1; i < pts.size(); ++i)
+        {
+            double dx = pts[i][0] - pts[i - 1][0];
+            double dy = pts[i][1] - pts[i - 1][1];
+            result.horizontalLength += std::sqrt(dx * dx + dy * dy);
+        }
+        for (int k = 0; k < 3; ++k)
+            result.delta[k] = pts.back()[k] - pts.front()[k];
+        break;
+    }
+
+    case MeasurementType::Triangle:
+    {
+        const double *A = pts[0].data();
+        const double *B = pts[1].data();
+        const double *C = pts[2].data();
+        result.area = MeasurementMath::polygonArea(pts, result.normal.data());
+        result.length = MeasurementMath::polylineLength(pts, true);
+        result.anglesDeg = {MeasurementMath::angleDeg(C, A, B),
+                            MeasurementMath::angleDeg(A, B, C),
+                            MeasurementMath::angleDeg(B, C, A)};
+        break;
+    }
+
+    case MeasurementType::Polygon:
+        result.area = MeasurementMath::polygonArea(pts, result.normal.data());
+        result.length = MeasurementMath::polylineLength(pts, true);
+        break;
+    }
+    return result;
+}
+
+std::vector<MeasurementResult> MeasurementSession::evaluateAll() const
+{
+    std::vector<MeasurementResult> results;
+    results.reserve(measurements_.size());
+    for (const auto &m : measurements_)
+        results.push_back(evaluate(m));
+    return results;
+}
+
+bool MeasurementSession::save(const std::string &filePath) const
+{
+    std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[MeasurementSession] Cannot open file for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    // 文件格式：
+    //   magic[4] version:u32 count:u32
+    //   重复 count 次：type:u8 nameLen:u16 name[nameLen] pointCount:u32 xyz:f64[3 * pointCount]
+    out.write(kSessionMagic, sizeof(kSessionMagic));
+    writePod(out, kSessionVersion);
+    writePod(out, static_cast<std::uint32_t>(measurements_.size()));
+
+    for (const auto &m : measurements_)
+    {
+        std::uint16_t nameLen = static_cast<std::uint16_t>(std::min<std::size_t>(m.name.size(), 0xFFFF));
+        writePod(out, static_cast<std::uint8_t>(m.type));
+        writePod(out, nameLen);
+        out.write(m.name.data(), nameLen);
+        writePod(out, static_cast<std::uint32_t>(m.points.size()));
+        if (hostIsLittleEndian())
+        {
+            out.write(reinterpret_cast<const char *>(m.points.data()),
+                      static_cast<std::streamsize>(m.points.size() * sizeof(MeasurementPoint)));
+        }
+        else
+        {
+            for (const auto &p : m.points)
+                for (double v : p)
+                    writePod(out, v);
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+bool MeasurementSession::load(const std::string &filePath)
+{
+    std::ifstream in(filePath, std::ios::binary | std::ios::ate);
+    if (!in)
+    {
+        std::cerr << "[MeasurementSession] Cannot open file: " << filePath << std::endl;
+        return false;
+    }
+    const std::streamoff end = in.tellg();
+    const std::uint64_t fileSize = end > 0 ? static_cast<std::uint64_t>(end) : 0;
+    in.seekg(0);
+
+    char magic[4];
+    std::uint32_t version = 0;
+    std::uint32_t count = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, kSessionMagic, sizeof(magic)) != 0 ||
+        !readPod(in, version) || version != kSessionVersion || !readPod(in, count))
+    {
+        std::cerr << "[MeasurementSession] Not a measurement session file: " << filePath << std::endl;
+        return false;
+    }
+
+    // 数量字段来自文件，先按剩余字节数检查，损坏的文件不会触发巨量分配
+    if (count > remainingBytes(in, fileSize) / kRecordHeaderSize)
+    {
+        std::cerr << "[MeasurementSession] Measurement count " << count << " exceeds file size: " << filePath << std::endl;
+        return false;
+    }
+
+    std::vector<Measurement> loaded;
+    loaded.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        std::uint8_t type = 0;
+        std::uint16_t nameLen = 0;
+        std::uint32_t pointCount = 0;
+        if (!readPod(in, type) || type > static_cast<std::uint8_t>(MeasurementType::Geodesic) || !readPod(in, nameLen))
+            return false;
+
+        Measurement m;
+        m.type = static_cast<MeasurementType>(type);
+        m.name.resize(nameLen);
+        in.read(&m.name[0], nameLen);
+        if (!in || !readPod(in, pointCount))
+            return false;
+        if (!isValidPointCount(m.type, pointCount))
+        {
+            std::cerr << "[MeasurementSession] " << typeName(m.type) << " with " << pointCount
+                      << " points in session file: " << filePath << std::endl;
+            return false;
+        }
+        if (pointCount > remainingBytes(in, fileSize) / sizeof(MeasurementPoint))
+        {
+            std::cerr << "[MeasurementSession] Truncated session file: " << filePath << std::endl;
+            return false;
+        }
+
+        m.points.resize(pointCount);
+        in.read(reinterpret_cast<char *>(m.points.data()),
+                static_cast<std::streamsize>(pointCount * sizeof(MeasurementPoint)));
+        if (!hostIsLittleEndian())
+        {
+            for (auto &p : m.points)
+                for (double &v : p)
+                    toFileOrder(v);
+        }
+        if (!in)
+        {
+            std::cerr << "[MeasurementSession] Truncated session file: " << filePath << std::endl;
+            return false;
+        }
+        loaded.push_back(std::move(m));
+    }
+
+    measurements_ = std::move(loaded);
+    return true;
+}
+
+std::string MeasurementSession::makeUniqueName(MeasurementType type) const
+{
+    std::size_t index = 1;
+    for (const auto &m : measurements_)
+    {
+        if (m.type == type)
+            ++index;
+    }
+    std::string name;
+    do
+    {
+        name = std::string(typeName(type)) + " " + std::to_string(index++);
+    } while (find(name));
+    return name;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file MeasurementSession.h
+ * @brief 该头文件定义了 MeasurementSession 类，用于保存任意数量的命名测量（点、线、三角形、折线、多边形、测地线）。
+ * @details 该类与界面和渲染器完全无关，直接接收坐标进行计算，脚本和测试可以在没有渲染窗口的情况下批量计算测量结果，
+ *          并支持将整个测量会话保存为紧凑的二进制文件以及从文件加载。
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @enum MeasurementType
+ * @brief 测量类型，数值会写入会话文件，只能追加不能修改。
+ */
+enum class MeasurementType : std::uint8_t
+{
+    Point = 0,    ///< 单点坐标
+    Line = 1,     ///< 两点直线
+    Triangle = 2, ///< 三点三角形
+    Polyline = 3, ///< 折线（>= 2 点）
+    Polygon = 4,  ///< 闭合多边形（>= 3 点）
+    Geodesic = 5  ///< 沿表面的最短路径（>= 2 点，首尾为两个拾取点）
+};
+
+using MeasurementPoint = std::array<double, 3>;
+
+/**
+ * @struct Measurement
+ * @brief 一条命名测量，只保存坐标，结果按需计算。
+ */
+struct Measurement
+{
+    std::string name;                     ///< 测量名称（会话内唯一）
+    MeasurementType type = MeasurementType::Point;
+    std::vector<MeasurementPoint> points; ///< 测量点坐标
+};
+
+/**
+ * @struct MeasurementResult
+ * @brief 一条测量的计算结果，不适用的字段保持为 0。
+ */
+struct MeasurementResult
+{
+    bool valid = false;              ///< 点数是否满足该测量类型
+    double length = 0.0;             ///< 线长 / 折线长 / 测地线长 / 三角形与多边形周长
+    double horizontalLength = 0.0;   ///< 在 XY 平面上的投影长度（线、折线、测地线）
+    double area = 0.0;               ///< 三角形 / 多边形面积
+    MeasurementPoint delta{};        ///< 线 / 折线 / 测地线首尾的 ΔX ΔY ΔZ
+    MeasurementPoint normal{};       ///< 三角形 / 多边形单位法向量
+    std::vector<double> anglesDeg;   ///< 三角形各顶点内角（度）
+};
+
+/**
+ * @namespace MeasurementMath
+ * @brief 与界面无关的几何计算函数。
+ */
+namespace MeasurementMath
+{
+    double distance(const double *p1, const double *p2);
+    double triangleArea(const double *A, const double *B, const double *C);
+    // 以 B 为顶点的夹角 ∠ABC（度）
+    double angleDeg(const double *A, const double *B, const double *C);
+    double polylineLength(const std::vector<MeasurementPoint> &points, bool closed);
+    // Newell 法计算多边形（可非严格共面）的面积与单位法向量
+    double polygonArea(const std::vector<MeasurementPoint> &points, double normal[3]);
+}
+
+/**
+ * @class MeasurementSession
+ * @brief 保存任意数量命名测量的会话模型，可保存、加载并批量计算，不依赖渲染器。
+ */
+class MeasurementSession
+{
+public:
+    /**
+     * @brief 添加一条测量。
+     * @param name 测量名称，为空时自动生成（如 "Line 3"），重名时覆盖旧测量。
+     * @param type 测量类型。
+     * @param points 测量点坐标。
+     * @return 点数满足类型要求时返回 true，否则不添加并返回 false。
+     */
+    bool add(const std::string &name, MeasurementType type, const std::vector<MeasurementPoint> &points);
+
+    bool addPoint(const std::string &name, const MeasurementPoint &p);
+    bool addLine(const std::string &name, const MeasurementPoint &p1, const MeasurementPoint &p2);
+    bool addTriangle(const std::string &name, const MeasurementPoint &A, const MeasurementPoint &B, const MeasurementPoint &C);
+    bool addPolyline(const std::string &name, const std::vector<MeasurementPoint> &points);
+    bool addPolygon(const std::string &name, const std::vector<MeasurementPoint> &points);
+    bool addGeodesic(const std::string &name, const std::vector<MeasurementPoint> &path);
+
+    // 按名称删除，存在返回 true
+    bool remove(const std::string &name);
+    // 按名称查找，不存在返回 nullptr
+    const Measurement *find(const std::string &name) const;
+    void clear();
+
+    std::size_t size() const { return measurements_.size(); }
+    const std::vector<Measurement> &measurements() const { return measurements_; }
+
+    /**
+     * @brief 计算单条测量结果。
+     */
+    static MeasurementResult evaluate(const Measurement &measurement);
+
+    /**
+     * @brief 批量计算会话内所有测量，结果顺序与 measurements() 一致。
+     */
+    std::vector<MeasurementResult> evaluateAll() const;
+
+    /**
+     * @brief 保存为紧凑二进制文件（小端，坐标为 double），大端主机上写入时翻转字节序。
+     * @return 写入成功返回 true。
+     */
+    bool save(const std::string &filePath) const;
+
+    /**
+     * @brief 从文件加载，成功时替换当前会话内容。
+     * @return 文件格式正确返回 true，失败时会话保持不变。
+     *         测量数与点数先按剩余文件大小检查，点数须符合测量类型，损坏的文件不会触发巨量分配。
+     */
+    bool load(const std::string &filePath);
+
+    // 该类型所需的最少点数
+    static std::size_t minimumPointCount(MeasurementType type);
+    // 点数是否符合该类型（点 / 线 / 三角形为固定点数，折线、多边形与测地线不少于最少点数）
+    static bool isValidPointCount(MeasurementType type, std::size_t count);
+    // 类型显示名称，用于自动命名
+    static const char *typeName(MeasurementType type);
+
+private:
+    std::string makeUniqueName(MeasurementType type) const;
+
+    std::vector<Measurement> measurements_; ///< 会话内全部测量，按添加顺序保存
+};
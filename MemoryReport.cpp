@@ -0,0 +1,214 @@
+#include "MemoryReport.h"
+
+#include <vtkActor.h>
+#include <vtkCellArray.h>
+#include <vtkPointData.h>
+#include <vtkCellData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    std::string formatMegabytes(std::size_t bytes)
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0) << " MB";
+        return oss.str();
+    }
+
+    // 单元的点编号总数（旧式单元数组每个单元前有一个点数）
+    vtkIdType connectivityIds(vtkCellArray *cells)
+    {
+        if (!cells)
+            return 0;
+        return cells->GetNumberOfConnectivityEntries() - cells->GetNumberOfCells();
+    }
+}
+
+void MemoryReport::addPolyData(const std::string &owner, const std::string &item, vtkPolyData *data)
+{
+    if (!data)
+        return;
+
+    std::size_t bytes = 0;
+    if (data->GetPoints())
+        bytes += arrayBytes(data->GetPoints()->GetData());
+    bytes += cellArrayBytes(data->GetVerts());
+    bytes += cellArrayBytes(data->GetLines());
+    bytes += cellArrayBytes(data->GetPolys());
+    bytes += cellArrayBytes(data->GetStrips());
+    for (vtkFieldData *fields : {static_cast<vtkFieldData *>(data->GetPointData()),
+                                 static_cast<vtkFieldData *>(data->GetCellData())})
+    {
+        for (int i = 0; fields && i < fields->GetNumberOfArrays(); ++i)
+            bytes += arrayBytes(fields->GetAbstractArray(i));
+    }
+    addBytes(owner, item, bytes);
+}
+
+void MemoryReport::addArray(const std::string &owner, const std::string &item, vtkAbstractArray *array)
+{
+    if (!array)
+        return;
+    addBytes(owner, item, arrayBytes(array));
+}
+
+void MemoryReport::addActor(const std::string &owner, const std::string &item, vtkActor *actor)
+{
+    if (!actor)
+        return;
+    auto mapper = vtkPolyDataMapper::SafeDownCast(actor->GetMapper());
+    if (!mapper || !mapper->GetInput())
+        return;
+    vtkPolyData *input = mapper->GetInput();
+    bool mapScalars = mapper->GetScalarVisibility() != 0 &&
+                      (input->GetPointData()->GetNumberOfArrays() > 0 || input->GetCellData()->GetNumberOfArrays() > 0);
+    addBytes(owner, item, 0, estimateGpuBytes(input, mapScalars, actor->GetProperty()->GetRepresentation()));
+}
+
+void MemoryReport::addBytes(const std::string &owner, const std::string &item, std::size_t cpuBytes,
+                            std::size_t gpuBytes)
+{
+    if (cpuBytes == 0 && gpuBytes == 0)
+        return;
+    Entry entry;
+    entry.owner = owner;
+    entry.item = item;
+    entry.cpuBytes = cpuBytes;
+    entry.gpuBytes = gpuBytes;
+    entries_.push_back(entry);
+}
+
+std::size_t MemoryReport::estimateGpuBytes(vtkPolyData *data, bool mapScalars, int representation)
+{
+    if (!data || data->GetNumberOfPoints() == 0)
+        return 0;
+
+    // 顶点缓冲：坐标统一转为 float 上传
+    std::size_t vertexSize = 3 * sizeof(float);
+    if (data->GetPointData()->GetNormals())
+        vertexSize += 3 * sizeof(float);
+    if (data->GetPointData()->GetTCoords())
+        vertexSize += data->GetPointData()->GetTCoords()->GetNumberOfComponents() * sizeof(float);
+    if (mapScalars)
+        vertexSize += 4; // RGBA 颜色
+    std::size_t bytes = static_cast<std::size_t>(data->GetNumberOfPoints()) * vertexSize;
+
+    // 索引缓冲（32 位）
+    vtkIdType vertIds = connectivityIds(data->GetVerts());
+    vtkIdType lineIds = connectivityIds(data->GetLines());
+    vtkIdType polyIds = connectivityIds(data->GetPolys());
+    vtkIdType stripIds = connectivityIds(data->GetStrips());
+    vtkIdType lineSegments = lineIds - (data->GetLines() ? data->GetLines()->GetNumberOfCells() : 0);
+    vtkIdType indices = vertIds + lineSegments * 2;
+    if (representation == VTK_POINTS)
+    {
+        indices = vertIds + lineIds + polyIds + stripIds;
+    }
+    else if (representation == VTK_WIREFRAME)
+    {
+        indices += (polyIds + stripIds) * 2; // 每条边两个索引
+    }
+    else
+    {
+        vtkIdType polys = data->GetPolys() ? data->GetPolys()->GetNumberOfCells() : 0;
+        vtkIdType strips = data->GetStrips() ? data->GetStrips()->GetNumberOfCells() : 0;
+        indices += (polyIds - 2 * polys) * 3 + (stripIds - 2 * strips) * 3; // 扇形 / 条带三角化
+    }
+    bytes += static_cast<std::size_t>(indices) * sizeof(std::uint32_t);
+    return bytes;
+}
+
+std::vector<MemoryReport::Entry> MemoryReport::totalsByOwner() const
+{
+    std::vector<Entry> totals;
+    for (const Entry &entry : entries_)
+    {
+        auto it = totals.begin();
+        while (it != totals.end() && it->owner != entry.owner)
+            ++it;
+        if (it == totals.end())
+        {
+            Entry total;
+            total.owner = entry.owner;
+            totals.push_back(total);
+            it = totals.end() - 1;
+        }
+        it->cpuBytes += entry.cpuBytes;
+        it->gpuBytes += entry.gpuBytes;
+    }
+    return totals;
+}
+
+std::size_t MemoryReport::getTotalCpuBytes() const
+{
+    std::size_t total = 0;
+    for (const Entry &entry : entries_)
+        total += entry.cpuBytes;
+    return total;
+}
+
+std::size_t MemoryReport::getTotalGpuBytes() const
+{
+    std::size_t total = 0;
+    for (const Entry &entry : entries_)
+        total += entry.gpuBytes;
+    return total;
+}
+
+bool MemoryReport::isOverBudget() const
+{
+    return budgetBytes_ > 0 && getTotalCpuBytes() + getTotalGpuBytes() > budgetBytes_;
+}
+
+std::string MemoryReport::toText() const
+{
+    std::ostringstream oss;
+    oss << std::left << std::setw(34) << "" << std::right << std::setw(12) << "CPU" << std::setw(12) << "GPU (est.)"
+        << "\n";
+    for (const Entry &total : totalsByOwner())
+    {
+        oss << std::left << std::setw(34) << total.owner << std::right << std::setw(12)
+            << formatMegabytes(total.cpuBytes) << std::setw(12) << formatMegabytes(total.gpuBytes) << "\n";
+        for (const Entry &entry : entries_)
+        {
+            if (entry.owner != total.owner)
+                continue;
+            oss << "  " << std::left << std::setw(32) << entry.item << std::right << std::setw(12)
+                << formatMegabytes(entry.cpuBytes) << std::setw(12) << formatMegabytes(entry.gpuBytes) << "\n";
+        }
+    }
+    oss << std::left << std::setw(34) << "Total" << std::right << std::setw(12) << formatMegabytes(getTotalCpuBytes())
+        << std::setw(12) << formatMegabytes(getTotalGpuBytes()) << "\n";
+    if (budgetBytes_ > 0)
+    {
+        oss << "Budget " << formatMegabytes(budgetBytes_);
+        if (isOverBudget())
+            oss << "  -- WARNING: budget exceeded";
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+void MemoryReport::clear()
+{
+    entries_.clear();
+    seen_.clear();
+}
+
+std::size_t MemoryReport::arrayBytes(vtkAbstractArray *array)
+{
+    if (!array || !seen_.insert(array).second)
+        return 0;
+    return static_cast<std::size_t>(array->GetActualMemorySize()) * 1024; // GetActualMemorySize 单位为 KiB
+}
+
+std::size_t MemoryReport::cellArrayBytes(vtkCellArray *cells)
+{
+    if (!cells || !seen_.insert(cells).second)
+        return 0;
+    return static_cast<std::size_t>(cells->GetActualMemorySize()) * 1024;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file MemoryReport.h
+ * @brief 该头文件定义了 MemoryReport 类，统计模型、派生数据和显存缓冲的内存占用。
+ * @details 各模块通过 appendMemoryUsage 把自己持有的 vtkPolyData、数组和加速结构登记到报告中。
+ *          CPU 内存按数组逐个统计（GetActualMemorySize），同一数组被多个 polydata 共享时只计一次；
+ *          显存按 vtkOpenGLPolyDataMapper 的 VBO / IBO 布局估算。报告按所属模块汇总，并可设置预算。
+ */
+#pragma once
+
+#include <vtkPolyData.h>
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class vtkAbstractArray;
+class vtkActor;
+
+/**
+ * @class MemoryReport
+ * @brief 内存占用报告。
+ */
+class MemoryReport
+{
+public:
+    /**
+     * @struct Entry
+     * @brief 单条占用记录，单位字节。
+     */
+    struct Entry
+    {
+        std::string owner;         ///< 所属模型或子系统，如 "Model: a.ply"、"BoxClipper"
+        std::string item;          ///< 数据名称
+        std::size_t cpuBytes = 0;  ///< 内存
+        std::size_t gpuBytes = 0;  ///< 显存（估算）
+    };
+
+    /**
+     * @brief 登记一个 polydata 的点、单元和属性数组（已登记过的数组不重复计入）。
+     */
+    void addPolyData(const std::string &owner, const std::string &item, vtkPolyData *data);
+
+    /**
+     * @brief 登记单个数组。
+     */
+    void addArray(const std::string &owner, const std::string &item, vtkAbstractArray *array);
+
+    /**
+     * @brief 估算 actor 的 polydata mapper 上传到显存的缓冲大小并登记（非 vtkPolyDataMapper 时忽略）。
+     */
+    void addActor(const std::string &owner, const std::string &item, vtkActor *actor);
+
+    /**
+     * @brief 直接登记字节数（加速结构、缓存等非 VTK 数据）。
+     */
+    void addBytes(const std::string &owner, const std::string &item, std::size_t cpuBytes, std::size_t gpuBytes = 0);
+
+    /**
+     * @brief 按 vtkOpenGLPolyDataMapper 的缓冲布局估算显存：每点 float 坐标，可选法向 / 纹理坐标 / RGBA 颜色，
+     *        加上按表示方式（点 / 线框 / 面）生成的 32 位索引。
+     * @param data 输入数据。
+     * @param mapScalars 是否按标量生成颜色缓冲。
+     * @param representation VTK_POINTS / VTK_WIREFRAME / VTK_SURFACE。
+     */
+    static std::size_t estimateGpuBytes(vtkPolyData *data, bool mapScalars, int representation);
+
+    const std::vector<Entry> &getEntries() const { return entries_; }
+
+    /**
+     * @brief 按所属模块汇总，顺序与首次登记顺序一致。
+     */
+    std::vector<Entry> totalsByOwner() const;
+
+    std::size_t getTotalCpuBytes() const;
+    std::size_t getTotalGpuBytes() const;
+
+    /**
+     * @brief 设置内存预算（内存与显存之和），0 表示不限制。
+     */
+    void setBudgetBytes(std::size_t bytes) { budgetBytes_ = bytes; }
+    std::size_t getBudgetBytes() const { return budgetBytes_; }
+    bool isOverBudget() const;
+
+    /**
+     * @brief 生成等宽排版的文本报告（各模块明细与合计，超出预算时附警告）。
+     */
+    std::string toText() const;
+
+    void clear();
+
+private:
+    // 数组实际占用字节数，已登记过的数组返回 0
+    std::size_t arrayBytes(vtkAbstractArray *array);
+    std::size_t cellArrayBytes(vtkCellArray *cells);
+
+    std::vector<Entry> entries_;
+    std::unordered_set<const void *> seen_; ///< 已计入的数组，避免共享数组重复统计
+    std::size_t budgetBytes_ = 0;
+};
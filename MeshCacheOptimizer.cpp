@@ -0,0 +1,496 @@
+#include "MeshCacheOptimizer.h"
+#include "MeshCleaner.h"
+#include "SpatialReorder.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkCellData.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    // Forsyth 算法的参数（模拟的 LRU 缓存大小与得分函数）
+    constexpr int CacheSize = 32;
+    constexpr float CacheDecayPower = 1.5f;
+    constexpr float LastFaceScore = 0.75f;
+    constexpr float ValenceBoostScale = 2.0f;
+    constexpr float ValenceBoostPower = 0.5f;
+    constexpr int ValenceTableSize = 64;
+
+    // 过度绘制簇：簇内 ACMR 不超过整体的该倍数、且不少于该三角形数时可断开
+    constexpr double ClusterThreshold = 1.05;
+    constexpr vtkIdType MinClusterTriangles = 64;
+
+    // 单元数组中的面，按面号访问点号
+    struct FaceList
+    {
+        const vtkIdType *data = nullptr;
+        std::vector<vtkIdType> offsets;
+
+        explicit FaceList(vtkCellArray *cells) : offsets(MeshCleaner::cellOffsets(cells))
+        {
+            if (!offsets.empty())
+                data = cells->GetData()->GetPointer(0);
+        }
+
+        vtkIdType count() const { return static_cast<vtkIdType>(offsets.size()); }
+        vtkIdType size(vtkIdType face) const { return data[offsets[face]]; }
+        const vtkIdType *ids(vtkIdType face) const { return data + offsets[face] + 1; }
+    };
+
+    struct ScoreTables
+    {
+        float cache[CacheSize];
+        float valence[ValenceTableSize];
+
+        ScoreTables()
+        {
+            // 最近一个面的 3 个顶点得分固定，其后随缓存位置衰减
+            for (int position = 0; position < CacheSize; ++position)
+            {
+                const float scaler = 1.0f / (CacheSize - 3);
+                cache[position] = position < 3 ? LastFaceScore
+                                               : std::pow(1.0f - (position - 3) * scaler, CacheDecayPower);
+            }
+            valence[0] = 0.0f;
+            for (int remaining = 1; remaining < ValenceTableSize; ++remaining)
+                valence[remaining] = ValenceBoostScale * std::pow(static_cast<float>(remaining), -ValenceBoostPower);
+        }
+
+        // 剩余面少的顶点加分，尽快用完以免留下孤立的面
+        float score(int position, vtkIdType remaining, vtkIdType lastFaceSize) const
+        {
+            if (remaining == 0)
+                return -1.0f;
+            float result = 0.0f;
+            if (position >= 0)
+                result = position < lastFaceSize ? LastFaceScore : cache[position];
+            result += remaining < ValenceTableSize
+                          ? valence[remaining]
+                          : ValenceBoostScale * std::pow(static_cast<float>(remaining), -ValenceBoostPower);
+            return result;
+        }
+    };
+
+    // 按 order 的面顺序模拟 FIFO 缓存（多边形按扇形三角化），返回未命中数与三角形数
+    void simulateFifo(const FaceList &faces, const std::vector<vtkIdType> &order, vtkIdType numPoints, int cacheSize,
+                      vtkIdType &misses, vtkIdType &triangles)
+    {
+        // 顶点进入缓存时的时间戳，与当前时间相差小于缓存大小时仍在缓存中
+        std::vector<std::int64_t> stamps(static_cast<std::size_t>(numPoints), std::numeric_limits<std::int64_t>::min() / 2);
+        std::int64_t time = 0;
+        misses = 0;
+        triangles = 0;
+        auto touch = [&](vtkIdType id)
+        {
+            if (time - stamps[id] >= cacheSize)
+            {
+                stamps[id] = time++;
+                ++misses;
+            }
+        };
+        for (vtkIdType face : order)
+        {
+            const vtkIdType *ids = faces.ids(face);
+            for (vtkIdType k = 1; k + 1 < faces.size(face); ++k)
+            {
+                touch(ids[0]);
+                touch(ids[k]);
+                touch(ids[k + 1]);
+                ++triangles;
+            }
+        }
+    }
+
+    double acmrOf(const FaceList &faces, const std::vector<vtkIdType> &order, vtkIdType numPoints, int cacheSize)
+    {
+        vtkIdType misses = 0;
+        vtkIdType triangles = 0;
+        simulateFifo(faces, order, numPoints, cacheSize, misses, triangles);
+        return triangles > 0 ? static_cast<double>(misses) / triangles : 0.0;
+    }
+
+    // Forsyth 线性时间顶点缓存排序，返回面的输出顺序
+    std::vector<vtkIdType> forsythOrder(const FaceList &faces, vtkIdType numPoints)
+    {
+        TRACE_SCOPE("MeshCacheOptimizer::forsythOrder");
+        const vtkIdType faceCount = faces.count();
+
+        // 顶点 -> 面（CSR），每个顶点的前 remaining[v] 项为未输出的面
+        std::vector<vtkIdType> adjacencyStart(static_cast<std::size_t>(numPoints) + 1, 0);
+        for (vtkIdType f = 0; f < faceCount; ++f)
+        {
+            for (vtkIdType k = 0; k < faces.size(f); ++k)
+                ++adjacencyStart[faces.ids(f)[k] + 1];
+        }
+        std::partial_sum(adjacencyStart.begin(), adjacencyStart.end(), adjacencyStart.begin());
+        std::vector<vtkIdType> adjacency(static_cast<std::size_t>(adjacencyStart.back()));
+        std::vector<vtkIdType> remaining(static_cast<std::size_t>(numPoints));
+        for (vtkIdType f = 0; f < faceCount; ++f)
+        {
+            for (vtkIdType k = 0; k < faces.size(f); ++k)
+            {
+                const vtkIdType v = faces.ids(f)[k];
+                adjacency[adjacencyStart[v] + remaining[v]++] = f;
+            }
+        }
+
+        const ScoreTables tables;
+        std::vector<int> cachePosition(static_cast<std::size_t>(numPoints), -1);
+        std::vector<float> vertexScores(static_cast<std::size_t>(numPoints));
+        for (vtkIdType v = 0; v < numPoints; ++v)
+            vertexScores[v] = tables.score(-1, remaining[v], 3);
+        auto faceScore = [&](vtkIdType f)
+        {
+            float score = 0.0f;
+            for (vtkIdType k = 0; k < faces.size(f); ++k)
+                score += vertexScores[faces.ids(f)[k]];
+            return score;
+        };
+        std::vector<float> faceScores(static_cast<std::size_t>(faceCount));
+        vtkSMPTools::For(0, faceCount, [&](vtkIdType begin, vtkIdType end)
+                         {
+            for (vtkIdType f = begin; f < end; ++f)
+                faceScores[f] = faceScore(f); });
+
+        std::vector<char> emitted(static_cast<std::size_t>(faceCount), 0);
+        std::vector<vtkIdType> order;
+        order.reserve(static_cast<std::size_t>(faceCount));
+        std::vector<vtkIdType> cache;
+        std::vector<vtkIdType> nextCache;
+        vtkIdType cursor = 0;
+        vtkIdType best = -1;
+        while (static_cast<vtkIdType>(order.size()) < faceCount)
+        {
+            // 缓存中没有候选时按原顺序取下一个未输出的面
+            if (best < 0)
+            {
+                while (emitted[cursor])
+                    ++cursor;
+                best = cursor;
+            }
+            emitted[best] = 1;
+            order.push_back(best);
+
+            // 从面的各顶点的未输出列表中移除该面，面的顶点移到缓存前端
+            const vtkIdType *ids = faces.ids(best);
+            nextCache.clear();
+            for (vtkIdType k = 0; k < faces.size(best); ++k)
+            {
+                const vtkIdType v = ids[k];
+                if (std::find(nextCache.begin(), nextCache.end(), v) != nextCache.end())
+                    continue;
+                nextCache.push_back(v);
+                // 重复点号的面（如未焊接的 f 7 7 8）在该顶点的列表中出现多次，全部移除
+                vtkIdType *list = &adjacency[adjacencyStart[v]];
+                for (vtkIdType j = 0; j < remaining[v];)
+                {
+                    if (list[j] == best)
+                        std::swap(list[j], list[--remaining[v]]);
+                    else
+                        ++j;
+                }
+            }
+            const vtkIdType lastFaceSize = static_cast<vtkIdType>(nextCache.size());
+            for (vtkIdType v : cache)
+            {
+                if (std::find(nextCache.begin(), nextCache.begin() + lastFaceSize, v) == nextCache.begin() + lastFaceSize)
+                    nextCache.push_back(v);
+            }
+
+            // 更新缓存位置与得分（含刚被挤出缓存的顶点），在相邻的未输出面中选得分最高的面
+            for (std::size_t i = 0; i < nextCache.size(); ++i)
+                cachePosition[nextCache[i]] = i < static_cast<std::size_t>(CacheSize) ? static_cast<int>(i) : -1;
+            for (vtkIdType v : nextCache)
+                vertexScores[v] = tables.score(cachePosition[v], remaining[v], lastFaceSize);
+            best = -1;
+            float bestScore = -std::numeric_limits<float>::max();
+            for (vtkIdType v : nextCache)
+            {
+                const vtkIdType *list = &adjacency[adjacencyStart[v]];
+                for (vtkIdType j = 0; j < remaining[v]; ++j)
+                {
+                    const vtkIdType f = list[j];
+                    if (emitted[f])
+                        continue;
+                    faceScores[f] = faceScore(f);
+                    if (faceScores[f] > bestScore)
+                    {
+                        bestScore = faceScores[f];
+                        best = f;
+                    }
+                }
+            }
+            if (nextCache.size() > static_cast<std::size_t>(CacheSize))
+                nextCache.resize(CacheSize);
+            cache.swap(nextCache);
+        }
+        return order;
+    }
+
+    // 在顶点缓存顺序上切分簇，按朝外程度从大到小排列簇
+    std::vector<vtkIdType> overdrawOrder(const FaceList &faces, vtkPoints *points, const std::vector<vtkIdType> &order,
+                                         vtkIdType numPoints, int &clusterCount)
+    {
+        TRACE_SCOPE("MeshCacheOptimizer::overdrawOrder");
+        const double threshold = ClusterThreshold * acmrOf(faces, order, numPoints, 16);
+
+        // 沿整个序列模拟缓存（GPU 不会在簇边界清空缓存），簇内 ACMR 足够低时断开
+        std::vector<std::size_t> clusterStarts{0};
+        {
+            std::vector<std::int64_t> stamps(static_cast<std::size_t>(numPoints),
+                                             std::numeric_limits<std::int64_t>::min() / 2);
+            std::int64_t time = 0;
+            vtkIdType misses = 0;
+            vtkIdType triangles = 0;
+            for (std::size_t i = 0; i < order.size(); ++i)
+            {
+                if (triangles >= MinClusterTriangles && misses <= threshold * triangles)
+                {
+                    clusterStarts.push_back(i);
+                    misses = 0;
+                    triangles = 0;
+                }
+                const vtkIdType face = order[i];
+                const vtkIdType *ids = faces.ids(face);
+                for (vtkIdType k = 1; k + 1 < faces.size(face); ++k)
+                {
+                    for (vtkIdType id : {ids[0], ids[k], ids[k + 1]})
+                    {
+                        if (time - stamps[id] >= 16)
+                        {
+                            stamps[id] = time++;
+                            ++misses;
+                        }
+                    }
+                    ++triangles;
+                }
+            }
+        }
+        clusterCount = static_cast<int>(clusterStarts.size());
+        clusterStarts.push_back(order.size());
+
+        // 各簇按面积加权的中心与法向（扇形三角化）
+        std::vector<double> centroids(3 * static_cast<std::size_t>(clusterCount), 0.0);
+        std::vector<double> normals(3 * static_cast<std::size_t>(clusterCount), 0.0);
+        std::vector<double> areas(static_cast<std::size_t>(clusterCount), 0.0);
+        vtkSMPTools::For(0, clusterCount, [&](vtkIdType begin, vtkIdType end)
+                         {
+            double p0[3];
+            double p1[3];
+            double p2[3];
+            for (vtkIdType c = begin; c < end; ++c)
+            {
+                double *centroid = &centroids[3 * c];
+                double *normal = &normals[3 * c];
+                for (std::size_t i = clusterStarts[c]; i < clusterStarts[c + 1]; ++i)
+                {
+                    const vtkIdType face = order[i];
+                    const vtkIdType *ids = faces.ids(face);
+                    points->GetPoint(ids[0], p0);
+                    for (vtkIdType k = 1; k + 1 < faces.size(face); ++k)
+                    {
+                        points->GetPoint(ids[k], p1);
+                        points->GetPoint(ids[k + 1], p2);
+                        const double u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+                        const double v[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+                        const double cross[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2],
+                                                 u[0] * v[1] - u[1] * v[0]};
+                        const double area = 0.5 * std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] +
+                                                            cross[2] * cross[2]);
+                        for (int axis = 0; axis < 3; ++axis)
+                        {
+                            centroid[axis] += area * (p0[axis] + p1[axis] + p2[axis]) / 3.0;
+                            normal[axis] += cross[axis];
+                        }
+                        areas[c] += area;
+                    }
+                }
+            } });
+
+        double meshCentroid[3] = {0.0, 0.0, 0.0};
+        double meshArea = 0.0;
+        for (int c = 0; c < clusterCount; ++c)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+                meshCentroid[axis] += centroids[3 * c + axis];
+            meshArea += areas[c];
+        }
+        for (int axis = 0; axis < 3 && meshArea > 0.0; ++axis)
+            meshCentroid[axis] /= meshArea;
+
+        std::vector<double> keys(static_cast<std::size_t>(clusterCount), 0.0);
+        for (int c = 0; c < clusterCount; ++c)
+        {
+            const double *normal = &normals[3 * c];
+            const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if (areas[c] <= 0.0 || length <= 0.0)
+                continue;
+            for (int axis = 0; axis < 3; ++axis)
+                keys[c] += (centroids[3 * c + axis] / areas[c] - meshCentroid[axis]) * normal[axis] / length;
+        }
+        std::vector<int> clusterOrder(static_cast<std::size_t>(clusterCount));
+        std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&keys](int a, int b)
+                         { return keys[a] > keys[b]; });
+
+        std::vector<vtkIdType> result;
+        result.reserve(order.size());
+        for (int c : clusterOrder)
+            result.insert(result.end(), order.begin() + clusterStarts[c], order.begin() + clusterStarts[c + 1]);
+        return result;
+    }
+}
+
+const char *MeshCacheOptimizer::modeName(Mode mode)
+{
+    switch (mode)
+    {
+    case Mode::VertexCache:
+        return "vertex cache";
+    case Mode::Overdraw:
+        return "vertex cache + overdraw";
+    default:
+        return "none";
+    }
+}
+
+double MeshCacheOptimizer::computeACMR(vtkCellArray *polys, vtkIdType numPoints, int cacheSize)
+{
+    FaceList faces(polys);
+    std::vector<vtkIdType> order(static_cast<std::size_t>(faces.count()));
+    std::iota(order.begin(), order.end(), vtkIdType(0));
+    return acmrOf(faces, order, numPoints, cacheSize);
+}
+
+bool MeshCacheOptimizer::optimize(vtkPolyData *mesh, Mode mode, Report *report)
+{
+    TRACE_SCOPE("MeshCacheOptimizer::optimize");
+    if (mode == Mode::None || !mesh || !mesh->GetPoints() || mesh->GetNumberOfPolys() == 0)
+        return false;
+
+    ScopedStageTimer timer("Load.MeshOrder");
+    const vtkIdType numPoints = mesh->GetNumberOfPoints();
+    FaceList faces(mesh->GetPolys());
+    const vtkIdType faceCount = faces.count();
+    Report stats;
+    stats.mode = mode;
+
+    std::vector<vtkIdType> order(static_cast<std::size_t>(faceCount));
+    std::iota(order.begin(), order.end(), vtkIdType(0));
+    vtkIdType misses = 0;
+    simulateFifo(faces, order, numPoints, 16, misses, stats.triangles);
+    stats.acmrBefore = stats.triangles > 0 ? static_cast<double>(misses) / stats.triangles : 0.0;
+
+    order = forsythOrder(faces, numPoints);
+    if (mode == Mode::Overdraw)
+        order = overdrawOrder(faces, mesh->GetPoints(), order, numPoints, stats.clusters);
+
+    // 顶点按面顺序中首次使用的顺序编号，面未引用的顶点保持原顺序排在最后
+    std::vector<vtkIdType> newIds(static_cast<std::size_t>(numPoints), -1);
+    std::vector<vtkIdType> oldIds;
+    oldIds.reserve(static_cast<std::size_t>(numPoints));
+    for (vtkIdType face : order)
+    {
+        for (vtkIdType k = 0; k < faces.size(face); ++k)
+        {
+            const vtkIdType id = faces.ids(face)[k];
+            if (newIds[id] < 0)
+            {
+                newIds[id] = static_cast<vtkIdType>(oldIds.size());
+                oldIds.push_back(id);
+            }
+        }
+    }
+    for (vtkIdType id = 0; id < numPoints; ++id)
+    {
+        if (newIds[id] < 0)
+        {
+            newIds[id] = static_cast<vtkIdType>(oldIds.size());
+            oldIds.push_back(id);
+        }
+    }
+
+    // 按新顺序写出面：前缀和确定位置后并行复制并重映射点号
+    std::vector<vtkIdType> locations(static_cast<std::size_t>(faceCount));
+    vtkIdType connectivitySize = 0;
+    for (vtkIdType i = 0; i < faceCount; ++i)
+    {
+        locations[i] = connectivitySize;
+        connectivitySize += faces.size(order[i]) + 1;
+    }
+    auto connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity->SetNumberOfValues(connectivitySize);
+    vtkIdType *target = connectivity->GetPointer(0);
+    vtkSMPTools::For(0, faceCount, [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            const vtkIdType face = order[i];
+            vtkIdType *cell = target + locations[i];
+            cell[0] = faces.size(face);
+            for (vtkIdType k = 0; k < faces.size(face); ++k)
+                cell[k + 1] = newIds[faces.ids(face)[k]];
+        } });
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->SetCells(faceCount, connectivity);
+
+    // 面数据随面重排（单元顺序为顶点、线、面、三角带）
+    vtkCellData *cellData = mesh->GetCellData();
+    if (cellData->GetNumberOfArrays() > 0)
+    {
+        const vtkIdType leading = mesh->GetNumberOfVerts() + mesh->GetNumberOfLines();
+        std::vector<vtkIdType> cellIds(static_cast<std::size_t>(leading));
+        std::iota(cellIds.begin(), cellIds.end(), vtkIdType(0));
+        for (vtkIdType face : order)
+            cellIds.push_back(leading + face);
+        for (vtkIdType s = 0; s < mesh->GetNumberOfStrips(); ++s)
+            cellIds.push_back(leading + faceCount + s);
+        auto sortedCellData = vtkSmartPointer<vtkCellData>::New();
+        for (int i = 0; i < cellData->GetNumberOfArrays(); ++i)
+        {
+            if (vtkDataArray *array = cellData->GetArray(i))
+                sortedCellData->AddArray(SpatialReorder::gatherArray(array, cellIds));
+        }
+        for (int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attribute)
+        {
+            vtkDataArray *array = cellData->GetAttribute(attribute);
+            if (array && array->GetName())
+                sortedCellData->SetActiveAttribute(array->GetName(), attribute);
+        }
+        cellData->ShallowCopy(sortedCellData);
+    }
+
+    // 坐标与全部点属性（法向、纹理坐标、标量）按新点号重排
+    vtkSmartPointer<vtkPolyData> sorted = SpatialReorder::gatherPoints(mesh, oldIds);
+    mesh->SetPoints(sorted->GetPoints());
+    mesh->GetPointData()->ShallowCopy(sorted->GetPointData());
+    if (mesh->GetNumberOfVerts() > 0)
+        mesh->SetVerts(MeshCleaner::remapCells(mesh->GetVerts(), newIds));
+    if (mesh->GetNumberOfLines() > 0)
+        mesh->SetLines(MeshCleaner::remapCells(mesh->GetLines(), newIds));
+    if (mesh->GetNumberOfStrips() > 0)
+        mesh->SetStrips(MeshCleaner::remapCells(mesh->GetStrips(), newIds));
+    mesh->SetPolys(polys);
+
+    stats.acmrAfter = computeACMR(mesh->GetPolys(), numPoints);
+    if (report)
+        *report = stats;
+    std::cout << "[MeshCacheOptimizer] Reordered " << faceCount << " faces (" << stats.triangles
+              << " triangles) for " << modeName(mode) << ", ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter;
+    if (mode == Mode::Overdraw)
+        std::cout << ", " << stats.clusters << " clusters";
+    std::cout << std::endl;
+    return true;
+}
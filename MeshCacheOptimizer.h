@@ -0,0 +1,57 @@
+/**
+ * @file MeshCacheOptimizer.h
+ * @brief 该头文件定义了 MeshCacheOptimizer 类，按 GPU 顶点缓存（可选兼顾过度绘制）重排 OBJ 网格的面与顶点。
+ * @details OBJ 中面的顺序任意，相邻绘制的三角形很少共享顶点，顶点着色器结果的缓存（post-transform cache）命中率低，
+ *          多百万三角形的网格绘制远慢于应有的速度。加载时重排：
+ *          - 顶点缓存：Forsyth 线性时间算法，模拟 LRU 缓存，顶点得分取决于缓存位置与剩余未输出的面数，
+ *            每次输出与缓存中顶点相邻的得分最高的面；没有候选时按原顺序取下一个未输出的面；
+ *          - 过度绘制：在顶点缓存顺序上按缓存模拟切分为簇（簇内 ACMR 不超过整体的 1.05 倍时可断开），
+ *            按 (簇中心 - 网格中心)·簇法向 从大到小排列簇，朝外的面先画，从大多数视角都能先遮挡内侧的面；
+ *          - 顶点按面顺序中首次使用的顺序重新编号（顶点数据读取连续），法向、纹理坐标等点属性与面数据随之重排。
+ *          用 16 项 FIFO 缓存模拟统计重排前后的 ACMR（平均每个三角形的缓存未命中数，多边形按扇形三角化计数）。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+
+/**
+ * @class MeshCacheOptimizer
+ * @brief 网格面与顶点的缓存友好重排。
+ */
+class MeshCacheOptimizer
+{
+public:
+    enum class Mode
+    {
+        None,        ///< 保持文件中的顺序
+        VertexCache, ///< 顶点缓存
+        Overdraw     ///< 顶点缓存 + 过度绘制
+    };
+
+    static const char *modeName(Mode mode);
+
+    /**
+     * @brief 一次重排的统计。
+     */
+    struct Report
+    {
+        Mode mode = Mode::None;
+        vtkIdType triangles = 0;  ///< 扇形三角化后的三角形数
+        double acmrBefore = 0.0;
+        double acmrAfter = 0.0;
+        int clusters = 0;         ///< 过度绘制模式下的簇数
+    };
+
+    /**
+     * @brief 原地重排网格的面、点与全部点 / 面属性。
+     * @return 没有面或 mode 为 None 时不修改并返回 false。
+     */
+    static bool optimize(vtkPolyData *mesh, Mode mode, Report *report = nullptr);
+
+    /**
+     * @brief 按面的顺序模拟 FIFO 顶点缓存，返回平均每个三角形的缓存未命中数。
+     */
+    static double computeACMR(vtkCellArray *polys, vtkIdType numPoints, int cacheSize = 16);
+};
@@ -0,0 +1,448 @@
+#include "MeshCleaner.h"
+#include "SpatialReorder.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkSMPTools.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    // 网格中的点为 float，直接读取连续数组；其它类型经 vtkPoints::GetPoint
+    struct PointReader
+    {
+        vtkPoints *points = nullptr;
+        const float *xyz = nullptr;
+
+        explicit PointReader(vtkPoints *p) : points(p)
+        {
+            if (p->GetDataType() == VTK_FLOAT)
+                xyz = static_cast<const float *>(p->GetData()->GetVoidPointer(0));
+        }
+
+        void get(vtkIdType id, double p[3]) const
+        {
+            if (xyz)
+            {
+                p[0] = xyz[3 * id];
+                p[1] = xyz[3 * id + 1];
+                p[2] = xyz[3 * id + 2];
+            }
+            else
+            {
+                points->GetPoint(id, p);
+            }
+        }
+    };
+
+    // 焊接网格的单元坐标
+    struct CellKey
+    {
+        std::int64_t x = 0;
+        std::int64_t y = 0;
+        std::int64_t z = 0;
+
+        bool operator==(const CellKey &other) const { return x == other.x && y == other.y && z == other.z; }
+        bool operator<(const CellKey &other) const { return std::tie(x, y, z) < std::tie(other.x, other.y, other.z); }
+    };
+
+    struct CellKeyHash
+    {
+        std::size_t operator()(const CellKey &key) const
+        {
+            std::uint64_t h = static_cast<std::uint64_t>(key.x) * 0x9E3779B97F4A7C15ULL;
+            h ^= static_cast<std::uint64_t>(key.y) * 0xC2B2AE3D27D4EB4FULL + (h << 6) + (h >> 2);
+            h ^= static_cast<std::uint64_t>(key.z) * 0x165667B19E3779F9ULL + (h << 6) + (h >> 2);
+            return static_cast<std::size_t>(h);
+        }
+    };
+
+    enum class FaceState : char
+    {
+        Kept,
+        Degenerate,
+        Duplicate
+    };
+}
+
+std::vector<vtkIdType> MeshCleaner::cellOffsets(vtkCellArray *cells)
+{
+    std::vector<vtkIdType> offsets(static_cast<std::size_t>(cells->GetNumberOfCells()));
+    const vtkIdType *data = cells->GetData()->GetPointer(0);
+    vtkIdType location = 0;
+    for (std::size_t c = 0; c < offsets.size(); ++c)
+    {
+        offsets[c] = location;
+        location += data[location] + 1;
+    }
+    return offsets;
+}
+
+vtkSmartPointer<vtkCellArray> MeshCleaner::remapCells(vtkCellArray *cells, const std::vector<vtkIdType> &map)
+{
+    std::vector<vtkIdType> offsets = cellOffsets(cells);
+    auto connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity->SetNumberOfValues(cells->GetNumberOfConnectivityEntries());
+    const vtkIdType *source = cells->GetData()->GetPointer(0);
+    vtkIdType *target = connectivity->GetPointer(0);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(offsets.size()), [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType c = begin; c < end; ++c)
+        {
+            const vtkIdType location = offsets[c];
+            target[location] = source[location];
+            for (vtkIdType k = 1; k <= source[location]; ++k)
+                target[location + k] = map[source[location + k]];
+        } });
+    auto output = vtkSmartPointer<vtkCellArray>::New();
+    output->SetCells(static_cast<vtkIdType>(offsets.size()), connectivity);
+    return output;
+}
+
+std::vector<vtkIdType> MeshCleaner::weldPoints(vtkPoints *points, double tolerance,
+                                               std::vector<vtkIdType> &representatives)
+{
+    TRACE_SCOPE("MeshCleaner::weldPoints");
+    const vtkIdType numPoints = points->GetNumberOfPoints();
+    std::vector<vtkIdType> map(static_cast<std::size_t>(numPoints));
+    representatives.clear();
+    if (numPoints == 0)
+        return map;
+
+    // 单元边长不小于容差，距离不超过容差的两点必在相邻单元内；容差为 0 时坐标相同的点必在同一单元
+    tolerance = std::max(0.0, tolerance);
+    double bounds[6];
+    points->GetBounds(bounds);
+    const double diagonal = std::sqrt((bounds[1] - bounds[0]) * (bounds[1] - bounds[0]) +
+                                      (bounds[3] - bounds[2]) * (bounds[3] - bounds[2]) +
+                                      (bounds[5] - bounds[4]) * (bounds[5] - bounds[4]));
+    double cellSize = std::max(tolerance, diagonal * 1e-6);
+    if (cellSize <= 0.0)
+        cellSize = 1.0;
+    const double inverse = 1.0 / cellSize;
+
+    PointReader reader(points);
+    std::vector<CellKey> keys(static_cast<std::size_t>(numPoints));
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double p[3];
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            reader.get(i, p);
+            keys[i].x = static_cast<std::int64_t>(std::floor((p[0] - bounds[0]) * inverse));
+            keys[i].y = static_cast<std::int64_t>(std::floor((p[1] - bounds[2]) * inverse));
+            keys[i].z = static_cast<std::int64_t>(std::floor((p[2] - bounds[4]) * inverse));
+        } });
+
+    // 按 (单元, 点号) 排序，同一单元的点连续且点号递增
+    std::vector<vtkIdType> order(static_cast<std::size_t>(numPoints));
+    std::iota(order.begin(), order.end(), vtkIdType(0));
+    vtkSMPTools::Sort(order.begin(), order.end(), [&keys](vtkIdType a, vtkIdType b)
+                      { return keys[a] < keys[b] || (keys[a] == keys[b] && a < b); });
+
+    // 单元 -> order 中的区间
+    std::unordered_map<CellKey, std::pair<vtkIdType, vtkIdType>, CellKeyHash> cells;
+    cells.reserve(static_cast<std::size_t>(numPoints));
+    for (vtkIdType first = 0; first < numPoints;)
+    {
+        vtkIdType last = first + 1;
+        while (last < numPoints && keys[order[last]] == keys[order[first]])
+            ++last;
+        cells.emplace(keys[order[first]], std::make_pair(first, last));
+        first = last;
+    }
+
+    // 每个点在相邻单元中找点号比自身小、距离不超过容差的最小点号
+    const double tolerance2 = tolerance * tolerance;
+    const int reach = tolerance > 0.0 ? 1 : 0;
+    std::vector<vtkIdType> nearest(static_cast<std::size_t>(numPoints));
+    vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double p[3];
+        double q[3];
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            reader.get(i, p);
+            vtkIdType best = i;
+            for (int dx = -reach; dx <= reach; ++dx)
+            {
+                for (int dy = -reach; dy <= reach; ++dy)
+                {
+                    for (int dz = -reach; dz <= reach; ++dz)
+                    {
+                        CellKey key{keys[i].x + dx, keys[i].y + dy, keys[i].z + dz};
+                        auto it = cells.find(key);
+                        if (it == cells.end())
+                            continue;
+                        for (vtkIdType k = it->second.first; k < it->second.second; ++k)
+                        {
+                            const vtkIdType j = order[k];
+                            if (j >= best)
+                                break;
+                            reader.get(j, q);
+                            const double distance2 = (p[0] - q[0]) * (p[0] - q[0]) + (p[1] - q[1]) * (p[1] - q[1]) +
+                                                     (p[2] - q[2]) * (p[2] - q[2]);
+                            if (distance2 <= tolerance2)
+                            {
+                                best = j;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            nearest[i] = best;
+        } });
+
+    // 按点号顺序传递代表点（nearest[i] <= i 已确定新点号）
+    for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+        if (nearest[i] == i)
+        {
+            map[i] = static_cast<vtkIdType>(representatives.size());
+            representatives.push_back(i);
+        }
+        else
+        {
+            map[i] = map[nearest[i]];
+        }
+    }
+    return map;
+}
+
+vtkSmartPointer<vtkPolyData> MeshCleaner::clean(vtkPolyData *input, double tolerance, Report *report)
+{
+    TRACE_SCOPE("MeshCleaner::clean");
+    ScopedStageTimer timer("Load.MeshClean");
+    Report stats;
+    stats.tolerance = std::max(0.0, tolerance);
+    if (!input || !input->GetPoints() || input->GetNumberOfPoints() == 0)
+    {
+        if (report)
+            *report = stats;
+        return input;
+    }
+    stats.inputPoints = input->GetNumberOfPoints();
+    stats.inputFaces = input->GetNumberOfPolys();
+    stats.inputBytes = static_cast<std::size_t>(input->GetActualMemorySize()) * 1024;
+
+    std::vector<vtkIdType> representatives;
+    std::vector<vtkIdType> map = weldPoints(input->GetPoints(), stats.tolerance, representatives);
+
+    // 重映射面的点号并去掉相邻的重复点号（含首尾），结果按原布局写入 faces
+    vtkCellArray *polys = input->GetPolys();
+    const vtkIdType faceCount = stats.inputFaces;
+    std::vector<vtkIdType> offsets = cellOffsets(polys);
+    const vtkIdType *source = polys->GetData()->GetPointer(0);
+    std::vector<vtkIdType> faces(static_cast<std::size_t>(polys->GetNumberOfConnectivityEntries()));
+    std::vector<vtkIdType> canonical(faces.size()); // 规范循环序列，用于比较重复面
+    std::vector<std::uint64_t> hashes(static_cast<std::size_t>(faceCount));
+    std::vector<FaceState> states(static_cast<std::size_t>(faceCount), FaceState::Kept);
+    PointReader reader(input->GetPoints());
+    vtkSMPTools::For(0, faceCount, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double origin[3];
+        double a[3];
+        double b[3];
+        for (vtkIdType c = begin; c < end; ++c)
+        {
+            const vtkIdType location = offsets[c];
+            vtkIdType *ids = &faces[location + 1];
+            vtkIdType count = 0;
+            for (vtkIdType k = 1; k <= source[location]; ++k)
+            {
+                const vtkIdType id = map[source[location + k]];
+                if (count == 0 || ids[count - 1] != id)
+                    ids[count++] = id;
+            }
+            while (count > 1 && ids[count - 1] == ids[0])
+                --count;
+            faces[location] = count;
+            if (count < 3)
+            {
+                states[c] = FaceState::Degenerate;
+                continue;
+            }
+
+            // 以第一个点为原点累加三角扇的叉积（Newell 法向），为 0 时面积为 0
+            double normal[3] = {0.0, 0.0, 0.0};
+            reader.get(representatives[ids[0]], origin);
+            reader.get(representatives[ids[1]], a);
+            for (vtkIdType k = 2; k < count; ++k)
+            {
+                reader.get(representatives[ids[k]], b);
+                const double u[3] = {a[0] - origin[0], a[1] - origin[1], a[2] - origin[2]};
+                const double v[3] = {b[0] - origin[0], b[1] - origin[1], b[2] - origin[2]};
+                normal[0] += u[1] * v[2] - u[2] * v[1];
+                normal[1] += u[2] * v[0] - u[0] * v[2];
+                normal[2] += u[0] * v[1] - u[1] * v[0];
+                std::copy(b, b + 3, a);
+            }
+            if (normal[0] == 0.0 && normal[1] == 0.0 && normal[2] == 0.0)
+            {
+                states[c] = FaceState::Degenerate;
+                continue;
+            }
+
+            // 规范序列：保持绕向，从字典序最小的旋转开始；只是起点不同的同一面得到相同序列，
+            // 反向绕行的面（双面网格的背面）与点号相同但顺序不同的多边形保持不同
+            vtkIdType start = 0;
+            for (vtkIdType k = 1; k < count; ++k)
+            {
+                if (ids[k] > ids[start])
+                    continue;
+                for (vtkIdType i = 0; i < count; ++i)
+                {
+                    const vtkIdType x = ids[(k + i) % count];
+                    const vtkIdType y = ids[(start + i) % count];
+                    if (x != y)
+                    {
+                        if (x < y)
+                            start = k;
+                        break;
+                    }
+                }
+            }
+            vtkIdType *key = &canonical[location];
+            key[0] = count;
+            std::rotate_copy(ids, ids + start, ids + count, key + 1);
+            std::uint64_t hash = 0xCBF29CE484222325ULL; // FNV-1a
+            for (vtkIdType k = 0; k <= count; ++k)
+                hash = (hash ^ static_cast<std::uint64_t>(key[k])) * 0x100000001B3ULL;
+            hashes[c] = hash;
+        } });
+
+    // 规范序列相同的面按 (哈希, 点号, 面号) 排序后相邻，只保留面号最小的一个
+    std::vector<vtkIdType> candidates;
+    candidates.reserve(static_cast<std::size_t>(faceCount));
+    for (vtkIdType c = 0; c < faceCount; ++c)
+    {
+        if (states[c] == FaceState::Kept)
+            candidates.push_back(c);
+        else
+            ++stats.degenerateFaces;
+    }
+    auto keyBegin = [&](vtkIdType c)
+    { return &canonical[offsets[c]]; };
+    auto keyEnd = [&](vtkIdType c)
+    { return &canonical[offsets[c]] + canonical[offsets[c]] + 1; };
+    vtkSMPTools::Sort(candidates.begin(), candidates.end(), [&](vtkIdType a, vtkIdType b)
+                      {
+        if (hashes[a] != hashes[b])
+            return hashes[a] < hashes[b];
+        if (std::lexicographical_compare(keyBegin(a), keyEnd(a), keyBegin(b), keyEnd(b)))
+            return true;
+        if (std::lexicographical_compare(keyBegin(b), keyEnd(b), keyBegin(a), keyEnd(a)))
+            return false;
+        return a < b; });
+    for (std::size_t k = 1, head = 0; k < candidates.size(); ++k)
+    {
+        const vtkIdType c = candidates[k];
+        const vtkIdType first = candidates[head];
+        if (hashes[c] == hashes[first] && std::equal(keyBegin(c), keyEnd(c), keyBegin(first), keyEnd(first)))
+        {
+            states[c] = FaceState::Duplicate;
+            ++stats.duplicateFaces;
+        }
+        else
+        {
+            head = k;
+        }
+    }
+
+    stats.outputPoints = static_cast<vtkIdType>(representatives.size());
+    stats.outputFaces = faceCount - stats.degenerateFaces - stats.duplicateFaces;
+    if (stats.outputPoints == stats.inputPoints && stats.outputFaces == faceCount)
+    {
+        stats.outputBytes = stats.inputBytes;
+        if (report)
+            *report = stats;
+        std::cout << "[MeshCleaner] Nothing to weld or remove in " << stats.inputPoints << " points, " << faceCount
+                  << " faces" << std::endl;
+        return input;
+    }
+
+    // 保留的面：前缀和确定输出位置后并行复制
+    std::vector<vtkIdType> keptFaces;
+    std::vector<vtkIdType> keptLocations;
+    keptFaces.reserve(static_cast<std::size_t>(stats.outputFaces));
+    keptLocations.reserve(static_cast<std::size_t>(stats.outputFaces));
+    vtkIdType connectivitySize = 0;
+    for (vtkIdType c = 0; c < faceCount; ++c)
+    {
+        if (states[c] != FaceState::Kept)
+            continue;
+        keptFaces.push_back(c);
+        keptLocations.push_back(connectivitySize);
+        connectivitySize += faces[offsets[c]] + 1;
+    }
+    auto connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity->SetNumberOfValues(connectivitySize);
+    vtkIdType *target = connectivity->GetPointer(0);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(keptFaces.size()), [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType k = begin; k < end; ++k)
+        {
+            const vtkIdType *face = &faces[offsets[keptFaces[k]]];
+            std::copy(face, face + face[0] + 1, target + keptLocations[k]);
+        } });
+    auto cleanedPolys = vtkSmartPointer<vtkCellArray>::New();
+    cleanedPolys->SetCells(static_cast<vtkIdType>(keptFaces.size()), connectivity);
+
+    // 代表点的坐标与全部点属性
+    vtkSmartPointer<vtkPolyData> output = SpatialReorder::gatherPoints(input, representatives);
+    if (input->GetNumberOfVerts() > 0)
+        output->SetVerts(remapCells(input->GetVerts(), map));
+    if (input->GetNumberOfLines() > 0)
+        output->SetLines(remapCells(input->GetLines(), map));
+    output->SetPolys(cleanedPolys);
+    if (input->GetNumberOfStrips() > 0)
+        output->SetStrips(remapCells(input->GetStrips(), map));
+
+    // 面数据按保留的单元复制（单元顺序为顶点、线、面、三角带）
+    vtkCellData *inputCellData = input->GetCellData();
+    if (inputCellData->GetNumberOfArrays() > 0)
+    {
+        const vtkIdType leading = input->GetNumberOfVerts() + input->GetNumberOfLines();
+        std::vector<vtkIdType> cellIds(static_cast<std::size_t>(leading));
+        std::iota(cellIds.begin(), cellIds.end(), vtkIdType(0));
+        for (vtkIdType c : keptFaces)
+            cellIds.push_back(leading + c);
+        for (vtkIdType s = 0; s < input->GetNumberOfStrips(); ++s)
+            cellIds.push_back(leading + faceCount + s);
+        vtkCellData *outputCellData = output->GetCellData();
+        for (int i = 0; i < inputCellData->GetNumberOfArrays(); ++i)
+        {
+            if (vtkDataArray *array = inputCellData->GetArray(i))
+                outputCellData->AddArray(SpatialReorder::gatherArray(array, cellIds));
+        }
+        for (int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attribute)
+        {
+            vtkDataArray *array = inputCellData->GetAttribute(attribute);
+            if (array && array->GetName())
+                outputCellData->SetActiveAttribute(array->GetName(), attribute);
+        }
+    }
+
+    stats.outputBytes = static_cast<std::size_t>(output->GetActualMemorySize()) * 1024;
+    if (report)
+        *report = stats;
+    const double savedMB = (static_cast<double>(stats.inputBytes) - static_cast<double>(stats.outputBytes)) /
+                           (1024.0 * 1024.0);
+    std::cout << "[MeshCleaner] Welded " << stats.inputPoints << " -> " << stats.outputPoints
+              << " points (tolerance " << stats.tolerance << "), removed " << stats.degenerateFaces
+              << " degenerate and " << stats.duplicateFaces << " duplicate faces of " << faceCount << ", saved "
+              << savedMB << " MB" << std::endl;
+    return output;
+}
@@ -0,0 +1,69 @@
+/**
+ * @file MeshCleaner.h
+ * @brief 该头文件定义了 MeshCleaner 类，对 OBJ 网格做并行的重复顶点焊接与退化 / 重复面清理。
+ * @details 摄影测量导出的 OBJ 在纹理接缝处为每个 (位置, 纹理坐标, 法向) 组合写出一个顶点，
+ *          读入后同一位置有多个顶点，面之间不共享顶点，显存与拾取、切片的开销随之增加。
+ *          - 顶点焊接：按容差把坐标划入网格单元，排序后建立单元哈希表，并行为每个点在相邻 27 个单元
+ *            （容差为 0 时只查本单元）中找点号最小的、距离不超过容差的点，再按点号顺序传递代表点；
+ *            间距均不超过容差的一串点合并为一个点。合并后的点保留代表点（最小点号）的法向、纹理坐标等属性。
+ *          - 面清理：重映射点号后并行去掉相邻的重复点号，点数不足 3 或面积为 0 的面视为退化面；
+ *            按绕向排列、从最小点号起始的点号序列（循环序列的规范形式）相同的面只保留第一个。
+ *            只比较点号集合会把点号相同但连接顺序不同的多边形（四边形及以上）误判为重复，并去掉
+ *            双面网格中绕向相反的背面，因此起点不同视为同一面，绕向相反视为不同面。
+ *          顶点、线与三角带只重映射点号；面数据按保留的单元复制。结果与输入无差异时直接返回输入。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class MeshCleaner
+ * @brief 网格顶点焊接与面清理。
+ */
+class MeshCleaner
+{
+public:
+    /**
+     * @brief 一次清理的统计。
+     */
+    struct Report
+    {
+        double tolerance = 0.0;
+        vtkIdType inputPoints = 0;
+        vtkIdType outputPoints = 0;
+        vtkIdType inputFaces = 0;
+        vtkIdType outputFaces = 0;
+        vtkIdType degenerateFaces = 0; ///< 焊接后点数不足 3 或面积为 0 的面
+        vtkIdType duplicateFaces = 0;  ///< 与之前的面规范点号序列相同的面（同绕向、起点可不同）
+        std::size_t inputBytes = 0;
+        std::size_t outputBytes = 0;
+    };
+
+    /**
+     * @brief 焊接顶点并去掉退化面与重复面。
+     * @param tolerance 焊接容差（模型单位），<= 0 只合并坐标完全相同的顶点。
+     * @return 清理后的网格；没有可合并的顶点与可去掉的面时返回输入本身。
+     */
+    static vtkSmartPointer<vtkPolyData> clean(vtkPolyData *input, double tolerance, Report *report = nullptr);
+
+    /**
+     * @brief 计算焊接后的点号：返回 map[i] 为原点 i 的新点号，representatives[k] 为新点 k 对应的原点号。
+     */
+    static std::vector<vtkIdType> weldPoints(vtkPoints *points, double tolerance,
+                                             std::vector<vtkIdType> &representatives);
+
+    /**
+     * @brief 单元数组（[n, id0, id1, ...] 连续存储）中每个单元的起始位置。
+     */
+    static std::vector<vtkIdType> cellOffsets(vtkCellArray *cells);
+
+    /**
+     * @brief 复制单元数组并把点号 i 替换为 map[i]。
+     */
+    static vtkSmartPointer<vtkCellArray> remapCells(vtkCellArray *cells, const std::vector<vtkIdType> &map);
+};
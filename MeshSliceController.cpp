@@ -1,4 +1,9 @@
 #include "MeshSliceController.h"
+#include "RenderScheduler.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+#include "MemoryReport.h"
+#include <vtkRenderWindow.h>
 #include <vtkProperty.h>
 #include <vtkBoundingBox.h>
 #include <iostream> // 添加标准输出
@@ -24,15 +29,17 @@ MeshSliceController::MeshSliceController(vtkSmartPointer<vtkRenderer> renderer)
 
 void MeshSliceController::ShowSlice(SliceDirection direction)
 {
+    ScopedStageTimer timer("Slice.Show");
+    TRACE_SCOPE("MeshSliceController::ShowSlice");
     if (!polyData_)
     {
         std::cerr << "[MeshSliceController] polyData_ is null. Cannot show slice." << std::endl;
         return;
     }
-    if (originalActor_)
+    for (const auto &originalActor : originalActors_)
     {
         std::cout << "[ShowSlice] Hiding original actor." << std::endl;
-        originalActor_->VisibilityOff();
+        originalActor->VisibilityOff();
     }
 
     std::cout << "[MeshSliceController] ShowSlice called." << std::endl;
@@ -89,21 +96,22 @@ void MeshSliceController::ShowSlice(SliceDirection direction)
 
     sliceMapper_->SetInputConnection(cutter_->GetOutputPort());
     sliceMapper_->Update();
-    renderer_->Render();
+    RenderScheduler::requestOrRender(renderScheduler_, renderer_->GetRenderWindow());
 }
 
 void MeshSliceController::HideSlice()
 {
-    if (originalActor_)
-    {
-        std::cout << "[HideSlice] Restoring original actor visibility." << std::endl;
-        originalActor_->VisibilityOn();
-    }
+    // 只在切面显示中时恢复原始 actor，避免覆盖其他功能设置的可见性
     if (renderer_->HasViewProp(sliceActor_))
     {
+        for (const auto &originalActor : originalActors_)
+        {
+            std::cout << "[HideSlice] Restoring original actor visibility." << std::endl;
+            originalActor->VisibilityOn();
+        }
         std::cout << "[HideSlice] Removing slice actor." << std::endl;
         renderer_->RemoveActor(sliceActor_);
-        renderer_->Render();
+        RenderScheduler::requestOrRender(renderScheduler_, renderer_->GetRenderWindow());
     }
 }
 
@@ -118,5 +126,18 @@ void MeshSliceController::UpdatePolyData(vtkSmartPointer<vtkPolyData> polyData)
 
 void MeshSliceController::SetOriginalActor(vtkSmartPointer<vtkActor> actor)
 {
-    originalActor_ = actor;
+    originalActors_.clear();
+    if (actor)
+        originalActors_.push_back(actor);
+}
+
+void MeshSliceController::SetOriginalActors(const std::vector<vtkActor *> &actors)
+{
+    originalActors_.assign(actors.begin(), actors.end());
+}
+
+void MeshSliceController::AppendMemoryUsage(MemoryReport &report) const
+{
+    report.addPolyData("MeshSlice", "slice output", cutter_->GetOutput());
+    report.addActor("MeshSlice", "slice mapper", sliceActor_);
 }
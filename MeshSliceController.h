@@ -17,6 +17,10 @@
 #include <vtkPolyDataMapper.h>
 #include <vtkActor.h>
 #include <vtkRenderer.h>
+#include <vector>
+
+class RenderScheduler;
+class MemoryReport;
 
 /**
  * @enum SliceDirection
@@ -55,6 +59,12 @@ public:
      */
     void HideSlice();
 
+    /**
+     * @brief 获取最近一次切面的结果数据。
+     * @return 切面折线数据。
+     */
+    vtkSmartPointer<vtkPolyData> GetSliceOutput() const { return cutter_->GetOutput(); }
+
     /**
      * @brief 更新用于切面操作的网格数据。
      * @param polyData 新的网格数据。
@@ -67,6 +77,24 @@ public:
      */
     void SetOriginalActor(vtkSmartPointer<vtkActor> actor);
 
+    /**
+     * @brief 设置多个原始 Actor（多模型场景中对合并数据切面时，显示切面期间全部隐藏）。
+     * @param actors 原始 Actor 列表。
+     */
+    void SetOriginalActors(const std::vector<vtkActor *> &actors);
+
+    /**
+     * @brief 设置渲染调度器，未设置时直接渲染。
+     * @param scheduler 渲染调度器（由页面持有）。
+     */
+    void SetRenderScheduler(RenderScheduler *scheduler) { renderScheduler_ = scheduler; }
+
+    /**
+     * @brief 将切面结果及其显存估算登记到内存报告（所属模块 "MeshSlice"）。
+     * @param report 内存报告。
+     */
+    void AppendMemoryUsage(MemoryReport &report) const;
+
 private:
     vtkSmartPointer<vtkRenderer> renderer_; ///< 用于渲染切面的渲染器
     vtkSmartPointer<vtkPolyData> polyData_; ///< 用于切面操作的网格数据
@@ -76,7 +104,8 @@ private:
     vtkSmartPointer<vtkPolyDataMapper> sliceMapper_; ///< 切面数据的映射器
     vtkSmartPointer<vtkActor> sliceActor_;           ///< 用于显示切面的 Actor
 
-    vtkSmartPointer<vtkActor> originalActor_; ///< 原始网格数据的 Actor
+    std::vector<vtkSmartPointer<vtkActor>> originalActors_; ///< 原始网格数据的 Actor
+    RenderScheduler *renderScheduler_ = nullptr; ///< 渲染调度器
 };
 
 #endif // MESHSLICECONTROLLER_H
@@ -1,14 +1,23 @@
 #include "ModelPinelineBuilder.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+#include "MemoryReport.h"
+#include "PlyVertexReader.h"
+#include "CulledPointCloudMapper.h"
 
 #include <vtkPLYReader.h>
 #include <vtkOBJReader.h>
 #include <vtkTransform.h>
+#include <vtkMatrix4x4.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkElevationFilter.h>
 #include <vtkVertexGlyphFilter.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkLookupTable.h>
 #include <vtkProperty.h>
+#include <vtkPointData.h>
+#include <QFileInfo>
+#include <algorithm>
 #include <qDebug>
 
 static vtkSmartPointer<vtkLookupTable> createJetLookupTable(double min, double max)
@@ -25,24 +34,27 @@ ModelPipelineBuilder::ModelPipelineBuilder()
     actor_ = vtkSmartPointer<vtkActor>::New();
 }
 
-bool ModelPipelineBuilder::loadModel(const QString &filePath)
+bool ModelPipelineBuilder::loadModel(const QString &filePath, double zScale)
 {
+    TRACE_SCOPE("ModelPipelineBuilder::loadModel");
     std::string ext = filePath.section('.', -1).toLower().toStdString();
 
     if (ext == "ply")
     {
-        auto reader = vtkSmartPointer<vtkPLYReader>::New();
-        reader->SetFileName(filePath.toStdString().c_str());
-        reader->Update();
-        originalPolyData_ = reader->GetOutput();
+        // 保留强度、分类等全部顶点属性，供按属性着色
+        // 坐标以 float 存储为相对 dataOrigin_ 的局部坐标
+        originalPolyData_ = PlyVertexReader::read(filePath.toStdString(), dataOrigin_);
+        SpatialReorder::reorder(originalPolyData_, spatialOrder_);
         modelType_ = ModelType::PLY;
     }
     else if (ext == "obj")
     {
+        ScopedStageTimer timer("Load.OBJReader");
         auto reader = vtkSmartPointer<vtkOBJReader>::New();
         reader->SetFileName(filePath.toStdString().c_str());
         reader->Update();
         originalPolyData_ = reader->GetOutput();
+        dataOrigin_[0] = dataOrigin_[1] = dataOrigin_[2] = 0.0;
         modelType_ = ModelType::OBJ;
     }
     else
@@ -54,7 +66,37 @@ bool ModelPipelineBuilder::loadModel(const QString &filePath)
     if (!originalPolyData_ || originalPolyData_->GetNumberOfPoints() == 0)
         return false;
 
-    setZAxisScale(1.0); // 默认拉伸为 1.0
+    // 在变换、着色之前焊接接缝处的重复顶点，之后的管线只处理清理后的网格
+    meshCleanReport_ = MeshCleaner::Report();
+    if (modelType_ == ModelType::OBJ && meshCleanTolerance_ >= 0.0)
+        originalPolyData_ = MeshCleaner::clean(originalPolyData_, meshCleanTolerance_, &meshCleanReport_);
+    // 焊接后顶点才在面之间共享，再按顶点缓存重排
+    meshOrderReport_ = MeshCacheOptimizer::Report();
+    if (modelType_ == ModelType::OBJ)
+        MeshCacheOptimizer::optimize(originalPolyData_, meshOrder_, &meshOrderReport_);
+
+    filePath_ = filePath;
+    compactPositions_.clear(); // 启用紧凑存储时在首次构建管线后重新编码
+
+    setZAxisScale(zScale); // 默认拉伸为 1.0
+    return true;
+}
+
+bool ModelPipelineBuilder::loadPolyData(vtkSmartPointer<vtkPolyData> polyData, const QString &filePath,
+                                        const double origin[3])
+{
+    TRACE_SCOPE("ModelPipelineBuilder::loadPolyData");
+    if (!polyData || polyData->GetNumberOfPoints() == 0)
+        return false;
+
+    originalPolyData_ = polyData;
+    compactPositions_.clear();
+    for (int i = 0; i < 3; ++i)
+        dataOrigin_[i] = origin ? origin[i] : 0.0;
+    modelType_ = ModelType::PLY;
+    filePath_ = filePath;
+
+    updatePipeline(); // 沿用当前拉伸比例，瓦片重新加载时无需重建两次
     return true;
 }
 
@@ -64,6 +106,124 @@ void ModelPipelineBuilder::setZAxisScale(double scale)
     updatePipeline();
 }
 
+void ModelPipelineBuilder::setCenterOverride(const double center[3])
+{
+    hasCenterOverride_ = true;
+    center_[0] = center[0];
+    center_[1] = center[1];
+    center_[2] = center[2];
+}
+
+void ModelPipelineBuilder::clearCenterOverride()
+{
+    hasCenterOverride_ = false;
+}
+
+void ModelPipelineBuilder::setElevationRange(double lowZ, double highZ)
+{
+    hasElevationRange_ = true;
+    elevationRange_[0] = lowZ;
+    elevationRange_[1] = highZ;
+}
+
+void ModelPipelineBuilder::clearElevationRange()
+{
+    hasElevationRange_ = false;
+}
+
+void ModelPipelineBuilder::getCenter(double center[3]) const
+{
+    center[0] = center_[0];
+    center[1] = center_[1];
+    center[2] = center_[2];
+}
+
+void ModelPipelineBuilder::getDataOrigin(double origin[3]) const
+{
+    origin[0] = dataOrigin_[0];
+    origin[1] = dataOrigin_[1];
+    origin[2] = dataOrigin_[2];
+}
+
+void ModelPipelineBuilder::worldToDisplay(const double world[3], double display[3]) const
+{
+    double local[3] = {world[0] - dataOrigin_[0], world[1] - dataOrigin_[1], world[2] - dataOrigin_[2]};
+    if (transformFilter_)
+        transformFilter_->GetTransform()->TransformPoint(local, display);
+    else
+        std::copy(local, local + 3, display);
+}
+
+void ModelPipelineBuilder::displayToWorld(const double display[3], double world[3]) const
+{
+    double matrix[16];
+    getDisplayToWorldMatrix(matrix);
+    for (int row = 0; row < 3; ++row)
+        world[row] = matrix[4 * row] * display[0] + matrix[4 * row + 1] * display[1] + matrix[4 * row + 2] * display[2] +
+                     matrix[4 * row + 3];
+}
+
+bool ModelPipelineBuilder::setCompactPositions(double errorBound)
+{
+    TRACE_SCOPE("ModelPipelineBuilder::setCompactPositions");
+    restoreOriginalPositions();
+    compactPositions_.clear();
+    if (errorBound <= 0.0)
+    {
+        compactErrorBound_ = 0.0;
+        return true;
+    }
+    compactErrorBound_ = errorBound;
+    if (!originalPolyData_)
+        return true; // 加载后首次构建管线时编码
+    if (modelType_ != ModelType::PLY)
+        return false;
+    releaseOriginalPositions();
+    return isCompactPositions();
+}
+
+void ModelPipelineBuilder::restoreOriginalPositions()
+{
+    if (compactPositions_.isEmpty() || !originalPolyData_ || originalPolyData_->GetPoints())
+        return;
+    originalPolyData_->SetPoints(compactPositions_.decode());
+}
+
+void ModelPipelineBuilder::releaseOriginalPositions()
+{
+    if (compactErrorBound_ <= 0.0 || modelType_ != ModelType::PLY || !originalPolyData_ || !originalPolyData_->GetPoints())
+        return;
+    // 首次释放时编码，之后重建管线使用的是解码坐标，无需重新编码
+    if (compactPositions_.isEmpty() && !compactPositions_.encode(originalPolyData_->GetPoints(), compactErrorBound_))
+        return;
+    // mapper 的输入是各级输出的副本，释放变换过滤器输入的坐标不会触发管线重新执行
+    originalPolyData_->SetPoints(nullptr);
+}
+
+void ModelPipelineBuilder::getDisplayToWorldMatrix(double matrix[16]) const
+{
+    // 变换的逆（局部坐标）再加上数据原点；原点平移在 double 中完成
+    auto inverse = vtkSmartPointer<vtkMatrix4x4>::New();
+    if (transformFilter_)
+    {
+        auto transform = vtkTransform::SafeDownCast(transformFilter_->GetTransform());
+        if (transform)
+            vtkMatrix4x4::Invert(transform->GetMatrix(), inverse);
+    }
+    for (int row = 0; row < 4; ++row)
+        for (int col = 0; col < 4; ++col)
+            matrix[4 * row + col] = inverse->GetElement(row, col);
+    for (int row = 0; row < 3; ++row)
+        matrix[4 * row + 3] += dataOrigin_[row];
+}
+
+void ModelPipelineBuilder::getDisplayToCenteredMatrix(double matrix[16]) const
+{
+    getDisplayToWorldMatrix(matrix);
+    for (int row = 0; row < 3; ++row)
+        matrix[4 * row + 3] -= center_[row];
+}
+
 vtkSmartPointer<vtkActor> ModelPipelineBuilder::getActor() const
 {
     return actor_;
@@ -88,20 +248,113 @@ ModelPipelineBuilder::ModelType ModelPipelineBuilder::getModelType() const
 
 void ModelPipelineBuilder::updatePipeline()
 {
+    TRACE_SCOPE("ModelPipelineBuilder::updatePipeline");
+    if (!originalPolyData_)
+        return; // 尚未加载数据（如加载前先设置拉伸比例）
+    // 紧凑存储时先解码原始坐标
+    restoreOriginalPositions();
+
     // 清空旧状态
     resetState();
 
     // 变换（中心对齐 + Z拉伸）
-    applyTransform();
+    {
+        ScopedStageTimer timer("Pipeline.Transform");
+        applyTransform();
+    }
 
     // 着色（按 Z 高度生成 scalar）
-    applyElevationColoring();
+    {
+        ScopedStageTimer timer("Pipeline.Elevation");
+        applyElevationColoring();
+    }
 
     // 按模型类型构建渲染管线
     if (modelType_ == ModelType::OBJ)
+    {
+        ScopedStageTimer timer("Pipeline.OBJSetup");
         setupOBJPipeline();
+    }
     else if (modelType_ == ModelType::PLY)
+    {
+        ScopedStageTimer timer("Pipeline.PLYSetup");
         setupPLYPipeline();
+    }
+
+    // 新建的 mapper 默认按高程着色，恢复之前选择的着色来源
+    if (colorSource_ != ElevationSource && !setColorSource(colorSource_))
+        colorSource_ = ElevationSource;
+
+    releaseOriginalPositions();
+}
+
+std::vector<std::string> ModelPipelineBuilder::getColorSources() const
+{
+    std::vector<std::string> sources;
+    vtkPolyData *data = getColorSourceData();
+    if (!data)
+        return sources;
+    sources.push_back(ElevationSource);
+    vtkPointData *pointData = data->GetPointData();
+    for (int i = 0; i < pointData->GetNumberOfArrays(); ++i)
+    {
+        vtkDataArray *array = pointData->GetArray(i);
+        if (!array || !array->GetName() || array == pointData->GetNormals())
+            continue;
+        // 单分量属性按色带映射，RGB / RGBA 直接作为颜色
+        bool directColor = array->GetDataType() == VTK_UNSIGNED_CHAR && array->GetNumberOfComponents() >= 3;
+        if ((array->GetNumberOfComponents() == 1 || directColor) && array->GetName() != std::string(ElevationSource))
+            sources.push_back(array->GetName());
+    }
+    return sources;
+}
+
+bool ModelPipelineBuilder::setColorSource(const std::string &name)
+{
+    TRACE_SCOPE("ModelPipelineBuilder::setColorSource");
+    vtkPolyData *data = getColorSourceData();
+    vtkDataArray *array = data ? data->GetPointData()->GetArray(name.c_str()) : nullptr;
+    if (!array)
+        return false;
+    colorSource_ = name;
+
+    // 只重新绑定 mapper 的标量数组与范围，几何与管线保持不变
+    bool elevation = name == ElevationSource;
+    bool directColor = array->GetDataType() == VTK_UNSIGNED_CHAR && array->GetNumberOfComponents() >= 3;
+    double range[2];
+    if (elevation)
+        getScalarRange(data, range);
+    else
+        array->GetRange(range, 0);
+    // OBJ 的面由 surfaceActor_ 显示（actor_ 只在管线完整建立后才指向它），单独列出；同一 actor 只处理一次
+    vtkActor *actors[] = {actor_.GetPointer(), surfaceActor_.GetPointer(), wireframeActor_.GetPointer(), pointsActor_.GetPointer()};
+    for (std::size_t i = 0; i < sizeof(actors) / sizeof(actors[0]); ++i)
+    {
+        vtkActor *actor = actors[i];
+        auto mapper = actor ? vtkPolyDataMapper::SafeDownCast(actor->GetMapper()) : nullptr;
+        if (!mapper || std::find(actors, actors + i, actor) != actors + i)
+            continue;
+        if (elevation)
+        {
+            mapper->SetScalarModeToDefault();
+        }
+        else
+        {
+            mapper->SetScalarModeToUsePointFieldData();
+            mapper->SelectColorArray(name.c_str());
+        }
+        if (directColor)
+            mapper->SetColorModeToDefault(); // uchar 颜色直接使用
+        else
+            mapper->SetColorModeToMapScalars();
+        mapper->SetScalarRange(range);
+    }
+    return true;
+}
+
+vtkPolyData *ModelPipelineBuilder::getColorSourceData() const
+{
+    return modelType_ == ModelType::OBJ ? processedSurfacePolyData_.GetPointer() : processedPolyData_.GetPointer();
 }
 
 void ModelPipelineBuilder::resetState()
@@ -114,16 +367,21 @@ void ModelPipelineBuilder::resetState()
 
 void ModelPipelineBuilder::applyTransform()
 {
-    double bounds[6];
-    originalPolyData_->GetBounds(bounds);
-    double center[3] = {
-        (bounds[0] + bounds[1]) * 0.5,
-        (bounds[2] + bounds[3]) * 0.5,
-        (bounds[4] + bounds[5]) * 0.5};
+    if (!hasCenterOverride_)
+    {
+        double bounds[6];
+        originalPolyData_->GetBounds(bounds);
+        center_[0] = (bounds[0] + bounds[1]) * 0.5 + dataOrigin_[0];
+        center_[1] = (bounds[2] + bounds[3]) * 0.5 + dataOrigin_[1];
+        center_[2] = (bounds[4] + bounds[5]) * 0.5 + dataOrigin_[2];
+    }
 
+    // 输入为局部坐标：先加回数据原点，再做中心对齐与 Z 拉伸（与原始坐标直接变换的结果一致）。
+    // 矩阵元素为 double，原点与中心的大数值在平移分量中相消，显示坐标保持 float 精度
     auto transform = vtkSmartPointer<vtkTransform>::New();
-    transform->Translate(-center[0], -center[1], -center[2]);
+    transform->Translate(-center_[0], -center_[1], -center_[2]);
     transform->Scale(1.0, 1.0, zScale_);
+    transform->Translate(dataOrigin_[0], dataOrigin_[1], dataOrigin_[2]);
 
     transformFilter_ = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
     transformFilter_->SetInputData(originalPolyData_);
@@ -138,6 +396,16 @@ void ModelPipelineBuilder::applyElevationColoring()
     transformFilter_->GetOutput()->GetBounds(bounds);
     double lowZ = bounds[4];
     double highZ = bounds[5];
+    if (hasElevationRange_)
+    {
+        // 全局高程范围按与模型相同的变换换算到显示坐标
+        double low[3] = {center_[0], center_[1], elevationRange_[0]};
+        double high[3] = {center_[0], center_[1], elevationRange_[1]};
+        worldToDisplay(low, low);
+        worldToDisplay(high, high);
+        lowZ = low[2];
+        highZ = high[2];
+    }
 
     elevationFilter_ = vtkSmartPointer<vtkElevationFilter>::New();
     elevationFilter_->SetInputConnection(transformFilter_->GetOutputPort());
@@ -152,7 +420,8 @@ void ModelPipelineBuilder::setupOBJPipeline()
     if (!basePolyData)
         return;
 
-    double *scalarRange = basePolyData->GetScalarRange();
+    double scalarRange[2];
+    getScalarRange(basePolyData, scalarRange);
     auto lut = createJetLookupTable(scalarRange[0], scalarRange[1]);
 
     processedSurfacePolyData_ = basePolyData;
@@ -234,11 +503,13 @@ void ModelPipelineBuilder::setupPLYPipeline()
     processedPolyData_ = vtkSmartPointer<vtkPolyData>::New();
     processedPolyData_->ShallowCopy(polyData);
 
-    auto scalarRange = processedPolyData_->GetScalarRange();
+    double scalarRange[2];
+    getScalarRange(processedPolyData_, scalarRange);
     auto lut = createJetLookupTable(scalarRange[0], scalarRange[1]);
 
-    auto mapper = vtkSmartPointer<vtkPolyDataMapper>::New();
-    mapper->SetInputData(processedPolyData_);
+    auto mapper = vtkSmartPointer<CulledPointCloudMapper>::New();
+    mapper->SetSourceData(processedPolyData_);
+    mapper->SetCulling(viewCulling_);
     mapper->SetScalarRange(scalarRange);
     mapper->SetLookupTable(lut);
     mapper->SetColorModeToMapScalars();
@@ -250,6 +521,25 @@ void ModelPipelineBuilder::setupPLYPipeline()
     actor_->GetProperty()->LightingOff(); // 确保无光照影响
 }
 
+void ModelPipelineBuilder::setViewCulling(bool enabled)
+{
+    viewCulling_ = enabled;
+    if (auto mapper = actor_ ? CulledPointCloudMapper::SafeDownCast(actor_->GetMapper()) : nullptr)
+        mapper->SetCulling(enabled);
+}
+
+void ModelPipelineBuilder::getScalarRange(vtkPolyData *polyData, double range[2]) const
+{
+    if (hasElevationRange_)
+    {
+        // 指定全局高程范围时标量已归一化到该范围
+        range[0] = 0.0;
+        range[1] = 1.0;
+        return;
+    }
+    polyData->GetScalarRange(range);
+}
+
 vtkSmartPointer<vtkTransformPolyDataFilter> ModelPipelineBuilder::getTransformFilter() const
 {
     return transformFilter_;
@@ -259,3 +549,34 @@ vtkSmartPointer<vtkElevationFilter> ModelPipelineBuilder::getElevationFilter() c
 {
     return elevationFilter_;
 }
+
+void ModelPipelineBuilder::appendMemoryUsage(MemoryReport &report) const
+{
+    if (!originalPolyData_)
+        return;
+
+    std::string owner = "Model: " + QFileInfo(filePath_).fileName().toStdString();
+    // 按数据流顺序登记，下游与上游共享的数组只计在上游
+    report.addPolyData(owner, "original", originalPolyData_);
+    if (isCompactPositions())
+        report.addBytes(owner, "compact positions", compactPositions_.getMemorySize());
+    if (transformFilter_)
+        report.addPolyData(owner, "transformed", transformFilter_->GetOutput());
+    if (elevationFilter_)
+        report.addPolyData(owner, "elevation", elevationFilter_->GetOutput());
+
+    if (modelType_ == ModelType::PLY)
+    {
+        report.addPolyData(owner, "vertex glyphs", processedPolyData_);
+        report.addActor(owner, "points mapper", actor_);
+        if (auto mapper = CulledPointCloudMapper::SafeDownCast(actor_->GetMapper()))
+            report.addBytes(owner, "view culling", mapper->GetCullingMemorySize());
+    }
+    else if (modelType_ == ModelType::OBJ)
+    {
+        report.addPolyData(owner, "vertex glyphs", processedPointPolyData_);
+        report.addActor(owner, "surface mapper", surfaceActor_);
+        report.addActor(owner, "wireframe mapper", wireframeActor_);
+        report.addActor(owner, "points mapper", pointsActor_);
+    }
+}
@@ -7,6 +7,11 @@
  */
 #pragma once
 
+#include "QuantizedPointStore.h"
+#include "SpatialReorder.h"
+#include "MeshCleaner.h"
+#include "MeshCacheOptimizer.h"
+
 #include <vtkSmartPointer.h>
 #include <vtkPolyData.h>
 #include <vtkActor.h>
@@ -15,6 +20,10 @@
 #include <vtkOBJReader.h>
 #include <vtkPLYReader.h>
 #include <QString>
+#include <string>
+#include <vector>
+
+class MemoryReport;
 
 /**
  * @class ModelPipelineBuilder
@@ -34,6 +43,11 @@ public:
         OBJ      ///< OBJ 格式模型
     };
 
+    /**
+     * @brief 高程着色来源的名称（vtkElevationFilter 输出的标量数组）。
+     */
+    static constexpr const char *ElevationSource = "Elevation";
+
     /**
      * @brief 构造函数，初始化类的成员变量。
      */
@@ -42,9 +56,20 @@ public:
     /**
      * @brief 加载指定路径的模型文件。
      * @param filePath 模型文件的路径。
+     * @param zScale 初始 Z 轴拉伸比例，管线只按该比例构建一次。
      * @return 如果模型加载成功返回 true，否则返回 false。
      */
-    bool loadModel(const QString &filePath);
+    bool loadModel(const QString &filePath, double zScale = 1.0);
+
+    /**
+     * @brief 使用已读取的点云数据构建管线（如并行读取的瓦片），按 PLY 点云管线处理，沿用当前 Z 轴拉伸比例。
+     * @param polyData 点云数据（相对 origin 的局部坐标）。
+     * @param filePath 数据来源文件路径，仅用于显示与内存报告。
+     * @param origin 数据原点（原始坐标 = 局部坐标 + 原点），为空时数据即原始坐标。
+     * @return 数据为空时返回 false。
+     */
+    bool loadPolyData(vtkSmartPointer<vtkPolyData> polyData, const QString &filePath,
+                      const double origin[3] = nullptr);
 
     /**
      * @brief 设置模型在 Z 轴上的拉伸比例。
@@ -52,6 +77,125 @@ public:
      */
     void setZAxisScale(double scale);
 
+    /**
+     * @brief 获取当前 Z 轴拉伸比例。
+     */
+    double getZAxisScale() const { return zScale_; }
+
+    /**
+     * @brief 指定中心对齐使用的中心点（默认使用模型自身包围盒中心）。
+     * @details 多个模型需要处于同一坐标系时（如参考面、对比模型），将它们的中心统一设置为主模型的中心。
+     * @param center 世界坐标中心点。
+     */
+    void setCenterOverride(const double center[3]);
+
+    /**
+     * @brief 取消中心点覆盖，恢复按模型自身包围盒中心对齐。
+     */
+    void clearCenterOverride();
+
+    /**
+     * @brief 指定 Elevation 着色使用的高程范围（默认使用模型自身的 Z 范围）。
+     * @details 多个瓦片组成一个数据集时统一设置为全局高程范围，相同高度在各瓦片中颜色一致；
+     *          此时标量范围固定为 0~1，不随单个瓦片的数据范围变化。
+     * @param lowZ 最低高程（原始坐标）。
+     * @param highZ 最高高程（原始坐标）。
+     */
+    void setElevationRange(double lowZ, double highZ);
+
+    /**
+     * @brief 取消高程范围覆盖。
+     */
+    void clearElevationRange();
+
+    /**
+     * @brief 可用的着色来源：ElevationSource 以及模型自带的单分量属性（强度、分类等）和 RGB 颜色。
+     */
+    std::vector<std::string> getColorSources() const;
+
+    /**
+     * @brief 切换着色来源，只重新绑定 mapper 的标量数组与范围，不重建管线；Z 轴拉伸重建管线后保持该选择。
+     * @param name getColorSources 返回的名称。
+     * @return 当前数据中没有该属性时返回 false，着色不变。
+     */
+    bool setColorSource(const std::string &name);
+    std::string getColorSource() const { return colorSource_; }
+
+    /**
+     * @brief 获取中心对齐实际使用的中心点（原始坐标）。
+     * @param center 输出中心点。
+     */
+    void getCenter(double center[3]) const;
+
+    /**
+     * @brief 获取数据原点：PLY 点坐标以 float 存储为相对该原点的局部坐标，OBJ 为 0。
+     */
+    void getDataOrigin(double origin[3]) const;
+
+    /**
+     * @brief 原始坐标换算到显示坐标（减去数据原点后按管线的中心对齐与 Z 拉伸变换）。
+     */
+    void worldToDisplay(const double world[3], double display[3]) const;
+
+    /**
+     * @brief 显示坐标（拾取、测量结果）还原为原始坐标，计算在 double 中完成。
+     */
+    void displayToWorld(const double display[3], double world[3]) const;
+
+    /**
+     * @brief 显示坐标到原始坐标的 4x4 矩阵（行主序），供批量导出在并行循环中使用。
+     * @details 显示变换为 p' = S·p − c（S 为 Z 拉伸），逆变换为 p = S⁻¹·(p' + c)。
+     */
+    void getDisplayToWorldMatrix(double matrix[16]) const;
+
+    /**
+     * @brief 显示坐标到“原始坐标 − 中心”的 4x4 矩阵（行主序）。
+     * @details 结果为真实尺度、与 Z 拉伸无关，数值小，可用 float 存储；共用中心的模型处于同一坐标系。
+     */
+    void getDisplayToCenteredMatrix(double matrix[16]) const;
+
+    /**
+     * @brief 紧凑存储原始点坐标（仅 PLY 点云）。
+     * @details 原始数据只在重建管线（Z 拉伸、中心变化）时使用。启用后原始坐标以分块量化整数保存（误差不超过
+     *          errorBound），释放 float 坐标；重建管线时先解码再处理，完成后再次释放。显示数据不受影响。
+     * @param errorBound 允许的最大误差（原始坐标单位），<= 0 时恢复 float 存储（为解码后的坐标）。
+     *                   加载前设置时在首次构建管线后编码。
+     * @return 模型不是 PLY 点云或编码失败时返回 false。
+     */
+    bool setCompactPositions(double errorBound);
+    bool isCompactPositions() const { return !compactPositions_.isEmpty(); }
+    const QuantizedPointStore &getCompactPositions() const { return compactPositions_; }
+
+    /**
+     * @brief 设置 PLY 点云加载后的点顺序（见 SpatialReorder），对之后加载的模型生效。
+     * @details 沿空间填充曲线重排后相邻的点在内存中相邻，箱体裁剪与拾取可按点块跳过（见 PointBlockIndex）。
+     */
+    void setSpatialOrder(SpatialReorder::Curve curve) { spatialOrder_ = curve; }
+    SpatialReorder::Curve getSpatialOrder() const { return spatialOrder_; }
+
+    /**
+     * @brief 启用或关闭 PLY 点云按视锥与屏幕尺寸的逐帧剔除（见 CulledPointCloudMapper），默认启用。
+     */
+    void setViewCulling(bool enabled);
+    bool isViewCulling() const { return viewCulling_; }
+
+    /**
+     * @brief 设置 OBJ 网格加载后的顶点焊接与退化 / 重复面清理（见 MeshCleaner），对之后加载的模型生效。
+     * @param tolerance 焊接容差（模型单位），0 只合并坐标完全相同的顶点，< 0 关闭（默认）。
+     */
+    void setMeshCleanTolerance(double tolerance) { meshCleanTolerance_ = tolerance; }
+    double getMeshCleanTolerance() const { return meshCleanTolerance_; }
+    // 最近一次加载的清理统计，未清理时各项为 0
+    const MeshCleaner::Report &getMeshCleanReport() const { return meshCleanReport_; }
+
+    /**
+     * @brief 设置 OBJ 网格加载后（焊接之后）面与顶点的重排方式（见 MeshCacheOptimizer），对之后加载的模型生效。
+     */
+    void setMeshOrder(MeshCacheOptimizer::Mode mode) { meshOrder_ = mode; }
+    MeshCacheOptimizer::Mode getMeshOrder() const { return meshOrder_; }
+    // 最近一次加载的重排统计（重排前后的 ACMR），未重排时各项为 0
+    const MeshCacheOptimizer::Report &getMeshOrderReport() const { return meshOrderReport_; }
+
     /**
      * @brief 获取处理后的模型对应的 Actor。
      * @return 处理后的模型的 Actor 智能指针。
@@ -100,6 +244,17 @@ public:
      */
     vtkSmartPointer<vtkActor> getPointsActor() const { return pointsActor_; }
 
+    /**
+     * @brief 获取最近一次加载的模型文件路径。
+     */
+    QString getFilePath() const { return filePath_; }
+
+    /**
+     * @brief 将原始数据、各级过滤器输出与 mapper 显存估算登记到内存报告，所属模块为 "Model: 文件名"。
+     * @param report 内存报告。
+     */
+    void appendMemoryUsage(MemoryReport &report) const;
+
 private:
     /**
      * @brief 更新模型处理流程，包括变换、Elevation 着色等操作。
@@ -115,10 +270,32 @@ private:
     void applyElevationColoring();
     void setupOBJPipeline();
     void setupPLYPipeline();
+    // mapper 使用的标量范围
+    void getScalarRange(vtkPolyData *polyData, double range[2]) const;
+    // 着色来源所在的数据（OBJ 为面数据，PLY 为点数据）
+    vtkPolyData *getColorSourceData() const;
+    // 紧凑存储时：重建管线前解码原始坐标 / 重建后释放
+    void restoreOriginalPositions();
+    void releaseOriginalPositions();
 
 private:
     ModelType modelType_ = ModelType::UNKNOWN; ///< 当前加载模型的类型，默认为未知类型
+    QString filePath_;                         ///< 最近一次加载的模型文件路径
     double zScale_ = 1.0;                      ///< 模型在 Z 轴上的拉伸比例，默认为 1.0
+    bool hasCenterOverride_ = false;           ///< 是否使用外部指定的中心点
+    double center_[3] = {0.0, 0.0, 0.0};       ///< 中心对齐使用的中心点
+    double dataOrigin_[3] = {0.0, 0.0, 0.0};   ///< 原始数据的坐标原点（局部坐标 + 原点 = 原始坐标）
+    bool hasElevationRange_ = false;           ///< 是否使用外部指定的高程范围
+    double elevationRange_[2] = {0.0, 1.0};    ///< Elevation 着色使用的高程范围（原始坐标）
+    std::string colorSource_ = ElevationSource; ///< 当前着色来源
+    double compactErrorBound_ = 0.0;           ///< 紧凑存储的误差界，<= 0 表示未启用
+    QuantizedPointStore compactPositions_;     ///< 紧凑存储的原始坐标，未启用时为空
+    SpatialReorder::Curve spatialOrder_ = SpatialReorder::Curve::None; ///< PLY 点云加载后的点顺序
+    bool viewCulling_ = true;                  ///< PLY 点云是否逐帧剔除点块
+    double meshCleanTolerance_ = -1.0;         ///< OBJ 网格的焊接容差，< 0 表示不清理
+    MeshCleaner::Report meshCleanReport_;      ///< 最近一次加载的清理统计
+    MeshCacheOptimizer::Mode meshOrder_ = MeshCacheOptimizer::Mode::None; ///< OBJ 网格加载后的面顺序
+    MeshCacheOptimizer::Report meshOrderReport_; ///< 最近一次加载的重排统计
 
     vtkSmartPointer<vtkPolyData> originalPolyData_;  ///< 原始的多边形数据，即加载的模型数据
     vtkSmartPointer<vtkPolyData> processedPolyData_; ///< 处理后的多边形数据
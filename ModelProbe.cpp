@@ -0,0 +1,408 @@
+#include "ModelProbe.h"
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    // 按 PLY 类型读取一个标量并转为 double
+    double readPlyScalar(const char *data, const std::string &type, bool swapBytes)
+    {
+        char bytes[8];
+        int size = ModelProbe::plyTypeSize(type);
+        std::memcpy(bytes, data, size);
+        if (swapBytes)
+            std::reverse(bytes, bytes + size);
+        if (type == "float" || type == "float32")
+        {
+            float value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        if (type == "double" || type == "float64")
+        {
+            double value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        if (type == "int" || type == "int32")
+        {
+            std::int32_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        if (type == "uint" || type == "uint32")
+        {
+            std::uint32_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        if (type == "short" || type == "int16")
+        {
+            std::int16_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        if (type == "ushort" || type == "uint16")
+        {
+            std::uint16_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+        if (type == "char" || type == "int8")
+            return static_cast<std::int8_t>(bytes[0]);
+        return static_cast<std::uint8_t>(bytes[0]);
+    }
+
+    std::string toLower(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+                       { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    bool hasSuffix(const std::string &text, const std::string &suffix)
+    {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    std::string formatBytes(std::size_t bytes)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0) << " MB";
+        return out.str();
+    }
+
+    std::string formatCount(std::int64_t count)
+    {
+        std::string digits = std::to_string(count);
+        for (int i = static_cast<int>(digits.size()) - 3; i > 0; i -= 3)
+            digits.insert(i, ",");
+        return digits;
+    }
+}
+
+int ModelProbe::plyTypeSize(const std::string &type)
+{
+    if (type == "char" || type == "uchar" || type == "int8" || type == "uint8")
+        return 1;
+    if (type == "short" || type == "ushort" || type == "int16" || type == "uint16")
+        return 2;
+    if (type == "int" || type == "uint" || type == "float" || type == "int32" || type == "uint32" || type == "float32")
+        return 4;
+    if (type == "double" || type == "float64")
+        return 8;
+    return 0;
+}
+
+bool ModelProbe::probe(const std::string &path, ModelInfo &info)
+{
+    TRACE_SCOPE("ModelProbe::probe");
+    auto start = std::chrono::steady_clock::now();
+    info = ModelInfo();
+    std::string lowerPath = toLower(path);
+    bool ok = false;
+    if (hasSuffix(lowerPath, ".ply"))
+    {
+        ok = readPlyHeader(path, info);
+        if (ok && info.format != "ascii")
+            samplePlyBounds(path, info);
+    }
+    else if (hasSuffix(lowerPath, ".obj"))
+    {
+        ok = scanObj(path, info);
+    }
+    else
+    {
+        std::cerr << "[ModelProbe] Unsupported file type: " << path << std::endl;
+        return false;
+    }
+    info.probeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+bool ModelProbe::readPlyHeader(const std::string &path, ModelInfo &info)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    std::uint64_t fileSize = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+    std::string line;
+    if (!std::getline(in, line) || line.compare(0, 3, "ply") != 0)
+        return false;
+
+    info = ModelInfo();
+    info.type = ModelInfo::Type::PLY;
+    info.fileSize = fileSize;
+    std::string currentElement;
+    const int maxHeaderLines = 4096; // 防止把非 PLY 文件整体当作文件头读取
+    for (int i = 0; i < maxHeaderLines && std::getline(in, line); ++i)
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "end_header")
+        {
+            info.headerBytes = static_cast<std::uint64_t>(in.tellg());
+            return info.vertexCount > 0;
+        }
+        if (keyword == "format")
+        {
+            tokens >> info.format;
+        }
+        else if (keyword == "element")
+        {
+            std::int64_t count = 0;
+            bool firstElement = currentElement.empty();
+            tokens >> currentElement >> count;
+            if (currentElement == "vertex")
+            {
+                info.vertexCount = count;
+                info.vertexElementFirst = firstElement;
+            }
+            else if (currentElement == "face")
+                info.faceCount = count;
+        }
+        else if (keyword == "property" && currentElement == "vertex")
+        {
+            ModelInfo::Property property;
+            tokens >> property.type;
+            if (property.type == "list")
+            {
+                std::string countType;
+                tokens >> countType >> property.type;
+                property.isList = true;
+            }
+            tokens >> property.name;
+            std::string name = toLower(property.name);
+            if (name == "red" || name == "green" || name == "blue" || name == "diffuse_red" || name == "r")
+                info.hasColor = true;
+            else if (name == "nx" || name == "ny" || name == "nz")
+                info.hasNormals = true;
+            else if (name.find("intensity") != std::string::npos || name == "reflectance")
+                info.hasIntensity = true;
+            info.vertexProperties.push_back(property);
+        }
+    }
+    return false;
+}
+
+void ModelProbe::samplePlyBounds(const std::string &path, ModelInfo &info)
+{
+    // 只处理顶点在第一个元素、属性均为定长标量的二进制文件（扫描仪输出的常见布局）
+    if (!info.vertexElementFirst)
+        return;
+    int stride = 0;
+    int offsets[3] = {-1, -1, -1};
+    std::string types[3];
+    for (const ModelInfo::Property &property : info.vertexProperties)
+    {
+        int size = plyTypeSize(property.type);
+        if (property.isList || size == 0)
+            return;
+        int axis = property.name == "x" ? 0 : property.name == "y" ? 1 : property.name == "z" ? 2 : -1;
+        if (axis >= 0)
+        {
+            offsets[axis] = stride;
+            types[axis] = property.type;
+        }
+        stride += size;
+    }
+    if (offsets[0] < 0 || offsets[1] < 0 || offsets[2] < 0)
+        return;
+    std::uint64_t vertexBytes = static_cast<std::uint64_t>(info.vertexCount) * stride;
+    if (info.headerBytes + vertexBytes > info.fileSize)
+        return; // 文件被截断
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return;
+    // 小端主机上读取大端文件时交换字节
+    const std::uint16_t probeValue = 1;
+    bool hostLittleEndian = *reinterpret_cast<const std::uint8_t *>(&probeValue) == 1;
+    bool swapBytes = (info.format == "binary_big_endian") == hostLittleEndian;
+
+    const std::int64_t maxSamples = 4096;
+    std::int64_t samples = std::min(info.vertexCount, maxSamples);
+    std::vector<char> vertex(stride);
+    for (std::int64_t i = 0; i < samples; ++i)
+    {
+        std::int64_t index = samples == info.vertexCount ? i : i * (info.vertexCount - 1) / (samples - 1);
+        in.seekg(static_cast<std::streamoff>(info.headerBytes + static_cast<std::uint64_t>(index) * stride));
+        if (!in.read(vertex.data(), stride))
+            return;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            double value = readPlyScalar(vertex.data() + offsets[axis], types[axis], swapBytes);
+            if (i == 0 || value < info.bounds[2 * axis])
+                info.bounds[2 * axis] = value;
+            if (i == 0 || value > info.bounds[2 * axis + 1])
+                info.bounds[2 * axis + 1] = value;
+        }
+    }
+    info.hasBounds = samples > 0;
+    info.boundsApproximate = samples < info.vertexCount;
+}
+
+bool ModelProbe::scanObj(const std::string &path, ModelInfo &info)
+{
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    info.type = ModelInfo::Type::OBJ;
+    info.format = "ascii";
+    info.fileSize = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+
+    // 按块读取；跨块的行首最多保留一个字节到下一块
+    std::vector<char> buffer(1 << 20);
+    std::size_t carry = 0;
+    bool atLineStart = true;
+    bool checkedVertexColor = false;
+    while (in)
+    {
+        in.read(buffer.data() + carry, static_cast<std::streamsize>(buffer.size() - carry));
+        std::size_t size = carry + static_cast<std::size_t>(in.gcount());
+        bool lastChunk = !in;
+        carry = 0;
+        const char *data = buffer.data();
+        std::size_t pos = 0;
+        while (pos < size)
+        {
+            if (!atLineStart)
+            {
+                const void *newline = std::memchr(data + pos, '\n', size - pos);
+                if (!newline)
+                {
+                    pos = size;
+                    break;
+                }
+                pos = static_cast<const char *>(newline) - data + 1;
+                atLineStart = true;
+                continue;
+            }
+            if (size - pos < 2 && !lastChunk)
+            {
+                carry = size - pos; // 行首前缀不完整，留到下一块
+                std::memmove(buffer.data(), data + pos, carry);
+                break;
+            }
+            char first = data[pos];
+            char second = pos + 1 < size ? data[pos + 1] : '\n';
+            bool separator = second == ' ' || second == '\t';
+            if (first == 'v' && separator)
+            {
+                ++info.vertexCount;
+                if (!checkedVertexColor)
+                {
+                    // 第一行顶点带 6 个数值时视为顶点颜色（v x y z r g b）
+                    const void *newline = std::memchr(data + pos, '\n', size - pos);
+                    std::size_t end = newline ? static_cast<const char *>(newline) - data : size;
+                    std::istringstream values(std::string(data + pos + 2, end - pos - 2));
+                    int count = 0;
+                    double value;
+                    while (values >> value)
+                        ++count;
+                    info.hasColor = count >= 6;
+                    checkedVertexColor = true;
+                }
+            }
+            else if (first == 'v' && second == 'n')
+            {
+                ++info.normalCount;
+            }
+            else if (first == 'v' && second == 't')
+            {
+                ++info.texCoordCount;
+            }
+            else if (first == 'f' && separator)
+            {
+                ++info.faceCount;
+            }
+            atLineStart = false;
+        }
+    }
+    info.hasNormals = info.normalCount > 0;
+    return info.vertexCount > 0;
+}
+
+std::size_t ModelProbe::estimateCpuBytes(const ModelInfo &info)
+{
+    std::size_t points = static_cast<std::size_t>(std::max<std::int64_t>(info.vertexCount, 0));
+    std::size_t faces = static_cast<std::size_t>(std::max<std::int64_t>(info.faceCount, 0));
+    // 读取结果与中心对齐后各一份 float 坐标，Elevation 标量，顶点单元（点数 + id，各 vtkIdType）的点副本
+    std::size_t perPoint = 3 * sizeof(float) * 2 + sizeof(float) + 3 * sizeof(float) + 2 * sizeof(std::int64_t);
+    if (info.hasColor)
+        perPoint += 3;
+    if (info.hasNormals)
+        perPoint += 3 * sizeof(float);
+    if (info.hasIntensity)
+        perPoint += sizeof(float);
+    // 三角面：点数 + 3 个 id
+    std::size_t perFace = 4 * sizeof(std::int64_t);
+    return points * perPoint + faces * perFace;
+}
+
+std::size_t ModelProbe::estimateGpuBytes(const ModelInfo &info)
+{
+    std::size_t points = static_cast<std::size_t>(std::max<std::int64_t>(info.vertexCount, 0));
+    std::size_t faces = static_cast<std::size_t>(std::max<std::int64_t>(info.faceCount, 0));
+    // 每个 actor 的顶点缓冲：float 坐标 + RGBA
+    std::size_t vertexBuffer = points * (3 * sizeof(float) + 4);
+    if (info.type == ModelInfo::Type::OBJ)
+    {
+        // 面（3 个索引）、线框（每条边 2 个索引）与点 actor
+        return vertexBuffer * 3 + faces * 3 * 4 + faces * 6 * 4 + points * 4;
+    }
+    return vertexBuffer + points * 4 + faces * 3 * 4;
+}
+
+double ModelProbe::suggestKeepRatio(const ModelInfo &info, std::size_t budgetBytes)
+{
+    std::size_t total = estimateCpuBytes(info) + estimateGpuBytes(info);
+    if (budgetBytes == 0 || total <= budgetBytes)
+        return 1.0;
+    return static_cast<double>(budgetBytes) / static_cast<double>(total);
+}
+
+std::string ModelProbe::toText(const ModelInfo &info)
+{
+    std::ostringstream out;
+    out << (info.type == ModelInfo::Type::PLY ? "PLY" : info.type == ModelInfo::Type::OBJ ? "OBJ" : "Unknown") << " ("
+        << info.format << "), " << formatBytes(static_cast<std::size_t>(info.fileSize)) << " on disk\n";
+    out << "Points: " << formatCount(info.vertexCount) << "\n";
+    out << "Faces:  " << formatCount(info.faceCount) << "\n";
+    out << "Attributes:";
+    if (!info.hasColor && !info.hasIntensity && !info.hasNormals)
+        out << " none";
+    if (info.hasColor)
+        out << " RGB";
+    if (info.hasIntensity)
+        out << " intensity";
+    if (info.hasNormals)
+        out << " normals";
+    out << "\n";
+    if (info.hasBounds)
+    {
+        out << (info.boundsApproximate ? "Bounds (sampled): " : "Bounds: ") << std::fixed << std::setprecision(3);
+        for (int axis = 0; axis < 3; ++axis)
+            out << (axis ? "  " : "") << "xyz"[axis] << " [" << info.bounds[2 * axis] << ", "
+                << info.bounds[2 * axis + 1] << "]";
+        out << "\n";
+    }
+    out << "Estimated memory: " << formatBytes(estimateCpuBytes(info)) << " CPU + "
+        << formatBytes(estimateGpuBytes(info)) << " GPU\n";
+    out << std::fixed << std::setprecision(1) << "Probed in " << info.probeMs << " ms";
+    return out.str();
+}
@@ -0,0 +1,109 @@
+/**
+ * @file ModelProbe.h
+ * @brief 该头文件定义了 ModelProbe 类，在完整加载前快速读取模型元数据。
+ * @details 完整加载数 GB 的模型前，先探测点数、面数、顶点属性（颜色、强度、法向）与文件格式：
+ *          - PLY 只读取文件头；二进制 PLY 按顶点步长等间隔抽样若干顶点得到近似包围盒（顶点数不多时为精确值）。
+ *          - OBJ 按块读取文件，用 memchr 跳到行尾，只检查行首前缀统计 v / vn / vt / f 行数，不解析数值，
+ *            因此不提供包围盒。
+ *
+ *          根据探测结果按 ModelPipelineBuilder 的管线结构估算加载后的内存与显存占用，超出预算时给出建议的抽稀比例。
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ModelInfo
+ * @brief 模型元数据。
+ */
+struct ModelInfo
+{
+    enum class Type
+    {
+        Unknown,
+        PLY,
+        OBJ
+    };
+
+    /**
+     * @struct Property
+     * @brief PLY 顶点属性。
+     */
+    struct Property
+    {
+        std::string name;
+        std::string type;    ///< PLY 类型名（float、uchar 等），列表属性为元素类型
+        bool isList = false; ///< 列表属性（顶点中少见）
+    };
+
+    Type type = Type::Unknown;
+    std::string format;               ///< PLY：ascii / binary_little_endian / binary_big_endian，OBJ 为 "ascii"
+    std::uint64_t fileSize = 0;       ///< 文件字节数
+    std::int64_t vertexCount = 0;     ///< 顶点数
+    std::int64_t faceCount = 0;       ///< 面数
+    std::int64_t normalCount = 0;     ///< OBJ vn 行数
+    std::int64_t texCoordCount = 0;   ///< OBJ vt 行数
+    std::vector<Property> vertexProperties; ///< PLY 顶点属性（按文件顺序）
+    bool hasColor = false;            ///< 顶点颜色（PLY red/green/blue，OBJ v 行带 RGB）
+    bool hasIntensity = false;        ///< 强度（PLY intensity / scalar_intensity 等）
+    bool hasNormals = false;          ///< 法向（PLY nx/ny/nz，OBJ vn）
+    bool hasBounds = false;           ///< 是否得到包围盒
+    bool boundsApproximate = false;   ///< 包围盒由抽样顶点得到
+    double bounds[6] = {0.0, -1.0, 0.0, -1.0, 0.0, -1.0};
+    std::uint64_t headerBytes = 0;    ///< PLY 文件头字节数（数据起始偏移）
+    bool vertexElementFirst = false;  ///< PLY 顶点是文件中第一个元素（数据紧跟文件头）
+    double probeMs = 0.0;             ///< 探测耗时
+};
+
+/**
+ * @class ModelProbe
+ * @brief 模型元数据探测与加载内存估算。
+ */
+class ModelProbe
+{
+public:
+    /**
+     * @brief 按扩展名探测 PLY / OBJ 文件。
+     * @return 文件不存在、格式不支持或文件头无效时返回 false。
+     */
+    static bool probe(const std::string &path, ModelInfo &info);
+
+    /**
+     * @brief 只读取 PLY 文件头（读到 end_header 为止），不抽样包围盒。
+     * @return 不是有效的 PLY 文件或没有顶点时返回 false。
+     */
+    static bool readPlyHeader(const std::string &path, ModelInfo &info);
+
+    /**
+     * @brief PLY 标量类型（char、uchar、float32 等）的字节数，未知类型返回 0。
+     */
+    static int plyTypeSize(const std::string &type);
+
+    /**
+     * @brief 按 ModelPipelineBuilder 的管线（读取、中心对齐、Elevation 着色、顶点单元）估算加载后的内存占用。
+     */
+    static std::size_t estimateCpuBytes(const ModelInfo &info);
+
+    /**
+     * @brief 按各 actor 的 VBO / IBO 估算显存占用（OBJ 为面、线框、点三个 actor）。
+     */
+    static std::size_t estimateGpuBytes(const ModelInfo &info);
+
+    /**
+     * @brief 建议的抽稀比例（保留点的比例，0~1）：预估占用不超过预算或预算为 0 时返回 1。
+     */
+    static double suggestKeepRatio(const ModelInfo &info, std::size_t budgetBytes);
+
+    /**
+     * @brief 生成多行文本摘要（格式、点面数、属性、包围盒、估算占用）。
+     */
+    static std::string toText(const ModelInfo &info);
+
+private:
+    // 二进制 PLY：按顶点步长抽样读取坐标
+    static void samplePlyBounds(const std::string &path, ModelInfo &info);
+    static bool scanObj(const std::string &path, ModelInfo &info);
+};
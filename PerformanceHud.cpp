@@ -0,0 +1,105 @@
+#include "PerformanceHud.h"
+#include "PipelineProfiler.h"
+#include "RenderScheduler.h"
+#include "TraceRecorder.h"
+
+#include <vtkTextProperty.h>
+#include <vtkCommand.h>
+#include <iomanip>
+#include <sstream>
+
+PerformanceHud::PerformanceHud(vtkSmartPointer<vtkRenderer> renderer, vtkSmartPointer<vtkRenderWindow> renderWindow,
+                               RenderScheduler *scheduler)
+    : renderer_(renderer), renderWindow_(renderWindow), renderScheduler_(scheduler)
+{
+    textActor_ = vtkSmartPointer<vtkTextActor>::New();
+    textActor_->GetTextProperty()->SetFontSize(14);
+    textActor_->GetTextProperty()->SetFontFamilyToCourier();              // 等宽字体便于对齐
+    textActor_->GetTextProperty()->SetColor(1.0, 1.0, 1.0);               // 白字
+    textActor_->GetTextProperty()->SetBackgroundColor(0.0, 0.0, 0.0);     // 黑底
+    textActor_->GetTextProperty()->SetBackgroundOpacity(0.6);             // 半透明背景
+    textActor_->GetTextProperty()->SetVerticalJustificationToTop();
+    textActor_->GetPositionCoordinate()->SetCoordinateSystemToNormalizedDisplay();
+    textActor_->SetPosition(0.01, 0.99); // 左上角
+    textActor_->SetVisibility(0);        // 初始隐藏
+    textActor_->PickableOff();
+    renderer_->AddActor2D(textActor_);
+
+    // 监听每帧开始与结束
+    renderCallback_ = vtkSmartPointer<vtkCallbackCommand>::New();
+    renderCallback_->SetCallback(PerformanceHud::OnRenderEvent);
+    renderCallback_->SetClientData(this);
+    startObserver_ = renderWindow_->AddObserver(vtkCommand::StartEvent, renderCallback_);
+    endObserver_ = renderWindow_->AddObserver(vtkCommand::EndEvent, renderCallback_);
+}
+
+PerformanceHud::~PerformanceHud()
+{
+    if (renderWindow_)
+    {
+        renderWindow_->RemoveObserver(startObserver_);
+        renderWindow_->RemoveObserver(endObserver_);
+    }
+}
+
+void PerformanceHud::SetVisible(bool visible)
+{
+    visible_ = visible;
+    if (visible_)
+        UpdateText();
+    textActor_->SetVisibility(visible_ ? 1 : 0);
+    RenderScheduler::requestOrRender(renderScheduler_, renderWindow_);
+}
+
+void PerformanceHud::ReAddToRenderer()
+{
+    renderer_->AddActor2D(textActor_);
+}
+
+void PerformanceHud::OnRenderEvent(vtkObject *, unsigned long eid, void *clientdata, void *)
+{
+    auto self = static_cast<PerformanceHud *>(clientdata);
+    if (eid == vtkCommand::StartEvent)
+    {
+        self->frameStart_ = std::chrono::steady_clock::now();
+        return;
+    }
+
+    auto frameEnd = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::milli> elapsed = frameEnd - self->frameStart_;
+    if (TraceRecorder::instance().isEnabled())
+        TraceRecorder::instance().addComplete("Render", "render", self->frameStart_, frameEnd);
+    PipelineProfiler::instance().recordFrame(elapsed.count());
+    if (self->uploadPending_)
+    {
+        PipelineProfiler::instance().record("Render.Upload", elapsed.count());
+        self->uploadPending_ = false;
+    }
+
+    // 文本在下一帧生效，不为刷新 HUD 额外请求渲染
+    if (self->visible_)
+        self->UpdateText();
+}
+
+void PerformanceHud::UpdateText()
+{
+    PipelineProfiler &profiler = PipelineProfiler::instance();
+    PipelineProfiler::StageStats frame = profiler.stats(PipelineProfiler::FrameStage);
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "FPS " << profiler.getFps() << "   frame " << frame.last << " ms\n";
+    if (renderScheduler_)
+    {
+        oss << "renders " << renderScheduler_->getRenderCount() << " / requests " << renderScheduler_->getRequestCount()
+            << " (coalesced " << renderScheduler_->getCoalescedCount() << ")\n";
+    }
+    oss << std::left << std::setw(22) << "stage" << std::right << std::setw(9) << "last" << std::setw(9) << "p50"
+        << std::setw(9) << "p95" << "\n";
+    for (const auto &stage : profiler.snapshot())
+    {
+        oss << std::left << std::setw(22) << stage.name << std::right << std::setw(9) << stage.last << std::setw(9)
+            << stage.p50 << std::setw(9) << stage.p95 << "\n";
+    }
+    textActor_->SetInput(oss.str().c_str());
+}
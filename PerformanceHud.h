@@ -0,0 +1,56 @@
+/**
+ * @file PerformanceHud.h
+ * @brief 该头文件定义了 PerformanceHud 类，屏幕左上角的性能信息叠加层。
+ * @details 监听渲染窗口的 StartEvent / EndEvent 记录每帧耗时到 PipelineProfiler（不论 HUD 是否显示，
+ *          录制轨迹时同时写入 TraceRecorder），
+ *          显示时以文本 actor 列出 FPS、上一帧耗时、渲染请求合并数以及各阶段最近耗时的 p50 / p95。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkTextActor.h>
+#include <vtkCallbackCommand.h>
+#include <chrono>
+
+class RenderScheduler;
+
+/**
+ * @class PerformanceHud
+ * @brief 帧耗时统计与可选的屏幕性能叠加层。
+ */
+class PerformanceHud
+{
+public:
+    PerformanceHud(vtkSmartPointer<vtkRenderer> renderer, vtkSmartPointer<vtkRenderWindow> renderWindow,
+                   RenderScheduler *scheduler);
+    ~PerformanceHud();
+
+    // 显示或隐藏叠加层
+    void SetVisible(bool visible);
+    bool IsVisible() const { return visible_; }
+
+    // 场景清空后重新添加文本 actor
+    void ReAddToRenderer();
+
+    // 下一帧额外记为 "Render.Upload"（模型加载或重建后首帧包含 GPU 数据上传）
+    void MarkUploadPending() { uploadPending_ = true; }
+
+private:
+    static void OnRenderEvent(vtkObject *caller, unsigned long eid, void *clientdata, void *calldata);
+    // 按当前统计刷新文本
+    void UpdateText();
+
+    vtkSmartPointer<vtkRenderer> renderer_;
+    vtkSmartPointer<vtkRenderWindow> renderWindow_;
+    RenderScheduler *renderScheduler_;
+    vtkSmartPointer<vtkTextActor> textActor_;
+    vtkSmartPointer<vtkCallbackCommand> renderCallback_;
+    unsigned long startObserver_ = 0;
+    unsigned long endObserver_ = 0;
+
+    std::chrono::steady_clock::time_point frameStart_;
+    bool visible_ = false;
+    bool uploadPending_ = false;
+};
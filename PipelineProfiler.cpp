@@ -0,0 +1,103 @@
+#include "PipelineProfiler.h"
+
+#include <algorithm>
+
+PipelineProfiler &PipelineProfiler::instance()
+{
+    static PipelineProfiler profiler;
+    return profiler;
+}
+
+void PipelineProfiler::record(const std::string &stage, double milliseconds)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Ring &ring = stages_[stage];
+    ring.samples[ring.next] = static_cast<float>(milliseconds);
+    ring.next = (ring.next + 1) % kCapacity;
+    ring.size = std::min(ring.size + 1, kCapacity);
+    ++ring.count;
+    ring.last = milliseconds;
+}
+
+void PipelineProfiler::recordFrame(double milliseconds)
+{
+    record(FrameStage, milliseconds);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    frameEnds_[frameNext_] = Clock::now();
+    frameNext_ = (frameNext_ + 1) % frameEnds_.size();
+    frameSize_ = std::min(frameSize_ + 1, frameEnds_.size());
+}
+
+std::vector<PipelineProfiler::StageStats> PipelineProfiler::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<StageStats> result;
+    result.reserve(stages_.size());
+    for (const auto &entry : stages_)
+        result.push_back(summarize(entry.first, entry.second));
+    return result;
+}
+
+PipelineProfiler::StageStats PipelineProfiler::stats(const std::string &stage) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = stages_.find(stage);
+    if (it == stages_.end())
+    {
+        StageStats empty;
+        empty.name = stage;
+        return empty;
+    }
+    return summarize(it->first, it->second);
+}
+
+double PipelineProfiler::getFps() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frameSize_ < 2)
+        return 0.0;
+
+    const std::size_t capacity = frameEnds_.size();
+    Clock::time_point newest = frameEnds_[(frameNext_ + capacity - 1) % capacity];
+    if (Clock::now() - newest > std::chrono::seconds(1))
+        return 0.0; // 按需渲染，空闲时不显示帧率
+
+    // 只统计最近 1 秒内的帧
+    std::size_t frames = 1;
+    Clock::time_point oldest = newest;
+    for (std::size_t i = 2; i <= frameSize_; ++i)
+    {
+        Clock::time_point t = frameEnds_[(frameNext_ + capacity - i) % capacity];
+        if (newest - t > std::chrono::seconds(1))
+            break;
+        oldest = t;
+        ++frames;
+    }
+    std::chrono::duration<double> span = newest - oldest;
+    return span.count() > 0.0 ? (frames - 1) / span.count() : 0.0;
+}
+
+void PipelineProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    stages_.clear();
+    frameNext_ = 0;
+    frameSize_ = 0;
+}
+
+PipelineProfiler::StageStats PipelineProfiler::summarize(const std::string &name, const Ring &ring)
+{
+    StageStats stats;
+    stats.name = name;
+    stats.count = ring.count;
+    stats.last = ring.last;
+    if (ring.size == 0)
+        return stats;
+
+    std::vector<float> sorted(ring.samples.begin(), ring.samples.begin() + ring.size);
+    std::sort(sorted.begin(), sorted.end());
+    stats.p50 = sorted[(sorted.size() - 1) / 2];
+    stats.p95 = sorted[static_cast<std::size_t>(0.95 * (sorted.size() - 1))];
+    return stats;
+}
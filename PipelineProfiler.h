@@ -0,0 +1,114 @@
+/**
+ * @file PipelineProfiler.h
+ * @brief 该头文件定义了 PipelineProfiler 类与 ScopedStageTimer，用于统计各处理阶段与渲染帧的耗时。
+ * @details 每个阶段保留最近 128 次耗时的环形缓冲，按需计算 p50 / p95；渲染帧额外记录结束时间用于估算 FPS。
+ *          始终编译，记录一次只有两次取时与一次加锁，可以在模型管线、裁剪、切面、拾取和渲染中常驻。
+ */
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class PipelineProfiler
+ * @brief 全局阶段耗时统计（线程安全）。
+ */
+class PipelineProfiler
+{
+public:
+    /**
+     * @struct StageStats
+     * @brief 单个阶段的耗时统计，单位毫秒。
+     */
+    struct StageStats
+    {
+        std::string name;
+        std::size_t count = 0; ///< 累计记录次数
+        double last = 0.0;     ///< 最近一次耗时
+        double p50 = 0.0;      ///< 最近样本的中位数
+        double p95 = 0.0;      ///< 最近样本的 95% 分位数
+    };
+
+    static PipelineProfiler &instance();
+
+    /**
+     * @brief 记录一次阶段耗时。
+     * @param stage 阶段名称，如 "Pipeline.Transform"。
+     * @param milliseconds 耗时（毫秒）。
+     */
+    void record(const std::string &stage, double milliseconds);
+
+    /**
+     * @brief 记录一帧渲染耗时，同时用于计算 FPS。
+     */
+    void recordFrame(double milliseconds);
+
+    /**
+     * @brief 获取所有阶段的统计，按名称排序。
+     */
+    std::vector<StageStats> snapshot() const;
+
+    /**
+     * @brief 获取单个阶段的统计，未记录过时 count 为 0。
+     */
+    StageStats stats(const std::string &stage) const;
+
+    /**
+     * @brief 最近若干帧的平均帧率，距上一帧超过 1 秒时返回 0。
+     */
+    double getFps() const;
+
+    void reset();
+
+    // 渲染帧在统计中的阶段名
+    static constexpr const char *FrameStage = "Render";
+
+private:
+    PipelineProfiler() = default;
+
+    static constexpr std::size_t kCapacity = 128;
+    struct Ring
+    {
+        std::array<float, kCapacity> samples{};
+        std::size_t next = 0;  ///< 下一个写入位置
+        std::size_t size = 0;  ///< 有效样本数
+        std::size_t count = 0; ///< 累计记录次数
+        double last = 0.0;
+    };
+    static StageStats summarize(const std::string &name, const Ring &ring);
+
+    using Clock = std::chrono::steady_clock;
+    std::map<std::string, Ring> stages_;
+    std::array<Clock::time_point, 32> frameEnds_{}; ///< 最近帧结束时间
+    std::size_t frameNext_ = 0;
+    std::size_t frameSize_ = 0;
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @class ScopedStageTimer
+ * @brief 作用域计时器，析构时把耗时记入 PipelineProfiler。
+ */
+class ScopedStageTimer
+{
+public:
+    explicit ScopedStageTimer(const char *stage)
+        : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedStageTimer()
+    {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start_;
+        PipelineProfiler::instance().record(stage_, elapsed.count());
+    }
+
+    ScopedStageTimer(const ScopedStageTimer &) = delete;
+    ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+private:
+    const char *stage_;
+    std::chrono::steady_clock::time_point start_;
+};
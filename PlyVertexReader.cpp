@@ -0,0 +1,389 @@
+#include "PlyVertexReader.h"
+#include "ModelProbe.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkPLYReader.h>
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkDataArray.h>
+#include <vtkFloatArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    enum class PlyScalar
+    {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float32,
+        Float64
+    };
+
+    PlyScalar plyScalarFromName(const std::string &type)
+    {
+        if (type == "char" || type == "int8")
+            return PlyScalar::Int8;
+        if (type == "uchar" || type == "uint8")
+            return PlyScalar::UInt8;
+        if (type == "short" || type == "int16")
+            return PlyScalar::Int16;
+        if (type == "ushort" || type == "uint16")
+            return PlyScalar::UInt16;
+        if (type == "int" || type == "int32")
+            return PlyScalar::Int32;
+        if (type == "uint" || type == "uint32")
+            return PlyScalar::UInt32;
+        if (type == "float" || type == "float32")
+            return PlyScalar::Float32;
+        return PlyScalar::Float64;
+    }
+
+    int vtkTypeFromPly(PlyScalar type)
+    {
+        switch (type)
+        {
+        case PlyScalar::Int8:
+            return VTK_SIGNED_CHAR;
+        case PlyScalar::UInt8:
+            return VTK_UNSIGNED_CHAR;
+        case PlyScalar::Int16:
+            return VTK_SHORT;
+        case PlyScalar::UInt16:
+            return VTK_UNSIGNED_SHORT;
+        case PlyScalar::Int32:
+            return VTK_INT;
+        case PlyScalar::UInt32:
+            return VTK_UNSIGNED_INT;
+        case PlyScalar::Float32:
+            return VTK_FLOAT;
+        default:
+            return VTK_DOUBLE;
+        }
+    }
+
+    template <typename T>
+    double loadAs(const char *bytes)
+    {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return static_cast<double>(value);
+    }
+
+    // 读取一个（已按主机字节序排列的）二进制标量
+    double toDouble(const char *bytes, PlyScalar type)
+    {
+        switch (type)
+        {
+        case PlyScalar::Int8:
+            return loadAs<std::int8_t>(bytes);
+        case PlyScalar::UInt8:
+            return loadAs<std::uint8_t>(bytes);
+        case PlyScalar::Int16:
+            return loadAs<std::int16_t>(bytes);
+        case PlyScalar::UInt16:
+            return loadAs<std::uint16_t>(bytes);
+        case PlyScalar::Int32:
+            return loadAs<std::int32_t>(bytes);
+        case PlyScalar::UInt32:
+            return loadAs<std::uint32_t>(bytes);
+        case PlyScalar::Float32:
+            return loadAs<float>(bytes);
+        default:
+            return loadAs<double>(bytes);
+        }
+    }
+
+    // 顶点属性在输出中的用途
+    enum class Role
+    {
+        Coordinate,
+        Color,
+        Normal,
+        Array
+    };
+
+    struct Column
+    {
+        PlyScalar type = PlyScalar::Float32;
+        int size = 0;      ///< 字节数
+        int offset = 0;    ///< 在二进制顶点记录中的偏移
+        Role role = Role::Array;
+        int component = 0; ///< 坐标 / 颜色 / 法向中的分量
+        vtkDataArray *array = nullptr;
+    };
+}
+
+vtkSmartPointer<vtkPolyData> PlyVertexReader::read(const std::string &path, double origin[3])
+{
+    TRACE_SCOPE("PlyVertexReader::read");
+    if (origin)
+        origin[0] = origin[1] = origin[2] = 0.0;
+    ModelInfo info;
+    if (!ModelProbe::readPlyHeader(path, info))
+        return nullptr;
+    if (auto polyData = readVertices(path, info, origin))
+        return polyData;
+    if (origin)
+        origin[0] = origin[1] = origin[2] = 0.0;
+    return readWithVtk(path);
+}
+
+vtkSmartPointer<vtkPolyData> PlyVertexReader::readVertices(const std::string &path, const ModelInfo &info,
+                                                           double origin[3])
+{
+    if (!info.vertexElementFirst)
+        return nullptr;
+    const vtkIdType count = static_cast<vtkIdType>(info.vertexCount);
+
+    // 按属性名称分配用途；颜色只在 red / green / blue 都是 uchar 时合并
+    static const char *coordinateNames[3] = {"x", "y", "z"};
+    static const char *colorNames[4] = {"red", "green", "blue", "alpha"};
+    static const char *normalNames[3] = {"nx", "ny", "nz"};
+    std::vector<Column> columns;
+    bool hasCoordinate[3] = {false, false, false};
+    bool coordinateDouble = false;
+    int colorMask = 0;
+    int normalMask = 0;
+    int recordSize = 0;
+    for (const ModelInfo::Property &property : info.vertexProperties)
+    {
+        int size = ModelProbe::plyTypeSize(property.type);
+        if (property.isList || size == 0)
+            return nullptr;
+        Column column;
+        column.type = plyScalarFromName(property.type);
+        column.size = size;
+        column.offset = recordSize;
+        recordSize += size;
+        const std::string &name = property.name;
+        for (int i = 0; i < 3; ++i)
+        {
+            if (name == coordinateNames[i])
+            {
+                column.role = Role::Coordinate;
+                column.component = i;
+                hasCoordinate[i] = true;
+                coordinateDouble = coordinateDouble || column.type == PlyScalar::Float64;
+            }
+            else if (name == normalNames[i])
+            {
+                column.role = Role::Normal;
+                column.component = i;
+                normalMask |= 1 << i;
+            }
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            if (name == colorNames[i] && column.type == PlyScalar::UInt8)
+            {
+                column.role = Role::Color;
+                column.component = i;
+                colorMask |= 1 << i;
+            }
+        }
+        columns.push_back(column);
+    }
+    if (!hasCoordinate[0] || !hasCoordinate[1] || !hasCoordinate[2])
+        return nullptr;
+    bool mergeColors = (colorMask & 7) == 7;
+    int colorComponents = (colorMask & 8) ? 4 : 3;
+    bool mergeNormals = normalMask == 7;
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    // 指定原点时坐标减去原点后以 float 存储，否则 double 坐标保持 double
+    points->SetDataType(coordinateDouble && !origin ? VTK_DOUBLE : VTK_FLOAT);
+    points->SetNumberOfPoints(count);
+    polyData->SetPoints(points);
+    vtkDataArray *pointArray = points->GetData();
+
+    vtkSmartPointer<vtkUnsignedCharArray> colors;
+    if (mergeColors)
+    {
+        colors = vtkSmartPointer<vtkUnsignedCharArray>::New();
+        colors->SetName(colorComponents == 4 ? "RGBA" : "RGB");
+        colors->SetNumberOfComponents(colorComponents);
+        colors->SetNumberOfTuples(count);
+        polyData->GetPointData()->AddArray(colors);
+    }
+    vtkSmartPointer<vtkFloatArray> normals;
+    if (mergeNormals)
+    {
+        normals = vtkSmartPointer<vtkFloatArray>::New();
+        normals->SetName("Normals");
+        normals->SetNumberOfComponents(3);
+        normals->SetNumberOfTuples(count);
+        polyData->GetPointData()->SetNormals(normals);
+    }
+    for (std::size_t i = 0; i < columns.size(); ++i)
+    {
+        Column &column = columns[i];
+        if ((column.role == Role::Color && !mergeColors) || (column.role == Role::Normal && !mergeNormals))
+            column.role = Role::Array;
+        if (column.role == Role::Coordinate)
+            column.array = pointArray;
+        else if (column.role == Role::Color)
+            column.array = colors;
+        else if (column.role == Role::Normal)
+            column.array = normals;
+        else
+        {
+            // 其余属性保持原名称与原类型
+            auto array = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(vtkTypeFromPly(column.type)));
+            array->SetName(info.vertexProperties[i].name.c_str());
+            array->SetNumberOfComponents(1);
+            array->SetNumberOfTuples(count);
+            polyData->GetPointData()->AddArray(array);
+            column.array = array;
+        }
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return nullptr;
+    in.seekg(static_cast<std::streamoff>(info.headerBytes));
+
+    // 原点取第一个顶点坐标向下取整：整数原点在日志与导出中易读，局部坐标为相对首点的偏移。
+    // 扫描仪瓦片的范围通常在数公里内，float 局部坐标的精度仍在亚毫米级
+    double shift[3] = {0.0, 0.0, 0.0};
+    auto setOrigin = [&](const double first[3]) {
+        if (!origin)
+            return;
+        for (int i = 0; i < 3; ++i)
+            shift[i] = origin[i] = std::floor(first[i]);
+    };
+
+    ScopedStageTimer timer("Load.PLYVertices");
+    if (info.format == "ascii")
+    {
+        std::string line;
+        std::vector<double> values(columns.size());
+        for (vtkIdType id = 0; id < count; ++id)
+        {
+            if (!std::getline(in, line))
+                return nullptr;
+            const char *cursor = line.c_str();
+            double first[3] = {0.0, 0.0, 0.0};
+            for (std::size_t c = 0; c < columns.size(); ++c)
+            {
+                char *end = nullptr;
+                values[c] = std::strtod(cursor, &end);
+                if (end == cursor)
+                    return nullptr;
+                cursor = end;
+                if (columns[c].role == Role::Coordinate)
+                    first[columns[c].component] = values[c];
+            }
+            if (id == 0)
+                setOrigin(first);
+            for (std::size_t c = 0; c < columns.size(); ++c)
+            {
+                const Column &column = columns[c];
+                double value = column.role == Role::Coordinate ? values[c] - shift[column.component] : values[c];
+                column.array->SetComponent(id, column.role == Role::Array ? 0 : column.component, value);
+            }
+        }
+    }
+    else
+    {
+        const std::uint16_t probeValue = 1;
+        bool hostLittleEndian = *reinterpret_cast<const std::uint8_t *>(&probeValue) == 1;
+        bool swapBytes = (info.format == "binary_big_endian") == hostLittleEndian;
+        std::vector<char> buffer;
+        const vtkIdType chunk = 65536;
+        for (vtkIdType first = 0; first < count; first += chunk)
+        {
+            vtkIdType n = std::min(chunk, count - first);
+            buffer.resize(static_cast<std::size_t>(n) * recordSize);
+            if (!in.read(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+                return nullptr;
+            if (first == 0)
+            {
+                double firstVertex[3] = {0.0, 0.0, 0.0};
+                for (const Column &column : columns)
+                {
+                    if (column.role != Role::Coordinate)
+                        continue;
+                    char bytes[8];
+                    std::memcpy(bytes, buffer.data() + column.offset, column.size);
+                    if (swapBytes)
+                        std::reverse(bytes, bytes + column.size);
+                    firstVertex[column.component] = toDouble(bytes, column.type);
+                }
+                setOrigin(firstVertex);
+            }
+            for (const Column &column : columns)
+            {
+                const int components = column.array->GetNumberOfComponents();
+                const int dataSize = column.array->GetDataTypeSize();
+                char *target = static_cast<char *>(column.array->GetVoidPointer(0));
+                const int component = column.role == Role::Array ? 0 : column.component;
+                // 原类型与目标数组类型一致时直接拷贝字节，否则转换（如 double 坐标减去原点后写入 float 点）
+                const double offset = column.role == Role::Coordinate ? shift[column.component] : 0.0;
+                bool sameType = vtkTypeFromPly(column.type) == column.array->GetDataType() && offset == 0.0;
+                for (vtkIdType i = 0; i < n; ++i)
+                {
+                    char bytes[8];
+                    std::memcpy(bytes, buffer.data() + static_cast<std::size_t>(i) * recordSize + column.offset,
+                                column.size);
+                    if (swapBytes)
+                        std::reverse(bytes, bytes + column.size);
+                    std::size_t index = static_cast<std::size_t>(first + i) * components + component;
+                    if (sameType)
+                    {
+                        std::memcpy(target + index * dataSize, bytes, column.size);
+                    }
+                    else if (dataSize == sizeof(double))
+                    {
+                        double value = toDouble(bytes, column.type) - offset;
+                        std::memcpy(target + index * dataSize, &value, sizeof(value));
+                    }
+                    else
+                    {
+                        float value = static_cast<float>(toDouble(bytes, column.type) - offset);
+                        std::memcpy(target + index * dataSize, &value, sizeof(value));
+                    }
+                }
+            }
+        }
+    }
+    pointArray->Modified();
+    std::cout << "[PlyVertexReader] Read " << count << " vertices with " << polyData->GetPointData()->GetNumberOfArrays()
+              << " attribute arrays from " << path;
+    if (origin)
+        std::cout << ", origin (" << origin[0] << ", " << origin[1] << ", " << origin[2] << ")";
+    std::cout << std::endl;
+    return polyData;
+}
+
+vtkSmartPointer<vtkPolyData> PlyVertexReader::readWithVtk(const std::string &path)
+{
+    ScopedStageTimer timer("Load.PLYReader");
+    auto reader = vtkSmartPointer<vtkPLYReader>::New();
+    reader->SetFileName(path.c_str());
+    reader->Update();
+    vtkSmartPointer<vtkPolyData> polyData = reader->GetOutput();
+    if (!polyData || polyData->GetNumberOfPoints() == 0)
+        return nullptr;
+    // vtkElevationFilter 不传递输入的活动标量，RGB 改为普通数组保留下来
+    vtkSmartPointer<vtkDataArray> colors = polyData->GetPointData()->GetScalars();
+    if (colors)
+    {
+        polyData->GetPointData()->SetScalars(nullptr);
+        polyData->GetPointData()->AddArray(colors);
+    }
+    return polyData;
+}
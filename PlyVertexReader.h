@@ -0,0 +1,49 @@
+/**
+ * @file PlyVertexReader.h
+ * @brief 该头文件定义了 PlyVertexReader 类，读取 PLY 点云的全部顶点属性。
+ * @details vtkPLYReader 只读取坐标、法向、纹理坐标与 RGB，并把 RGB 设为活动标量，经 vtkElevationFilter 后
+ *          被高程标量替换。扫描仪写入的强度、回波次数、分类等属性因此丢失。
+ *
+ *          本读取器按文件头逐列读取顶点元素：
+ *          - x / y / z 为点坐标。指定原点输出时坐标减去原点（第一个顶点向下取整）后以 float 存储：
+ *            地理参考点云的坐标常为 6~7 位整数，直接存 float 只剩分米级精度，存 double 则内存加倍；
+ *            减去 double 原点后 float 局部坐标保持亚毫米精度。不指定原点时 double 坐标保持 double；
+ *          - red / green / blue（/ alpha）为 uchar 时合并为 "RGB"（"RGBA"）数组；
+ *          - nx / ny / nz 合并为法向；
+ *          - 其余标量属性按原名称与原类型各存一个数组。
+ *
+ *          所有属性只作为普通点数组添加（不设为活动标量），经中心对齐、Elevation 着色与顶点单元生成后
+ *          仍以引用方式传递到渲染数据，切换着色来源时无需复制或重建管线。
+ *          PLY 管线只显示点，面元素不读取。顶点不是第一个元素或含列表属性时回退到 vtkPLYReader。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <string>
+
+struct ModelInfo;
+
+/**
+ * @class PlyVertexReader
+ * @brief PLY 顶点属性读取。
+ */
+class PlyVertexReader
+{
+public:
+    /**
+     * @brief 读取 PLY 文件的顶点与全部顶点属性。
+     * @param path 文件路径。
+     * @param origin 非空时输出坐标原点，返回的点坐标为相对该原点的 float 局部坐标（原始坐标 = 局部坐标 + 原点）。
+     *               回退到 vtkPLYReader 时原点为 0。
+     * @return 读取失败或没有顶点时返回 nullptr。
+     */
+    static vtkSmartPointer<vtkPolyData> read(const std::string &path, double origin[3] = nullptr);
+
+private:
+    // 按文件头逐列读取顶点元素，布局不支持时返回 nullptr
+    static vtkSmartPointer<vtkPolyData> readVertices(const std::string &path, const ModelInfo &info,
+                                                     double origin[3]);
+    // vtkPLYReader 读取，RGB 改为普通点数组，避免被高程标量替换
+    static vtkSmartPointer<vtkPolyData> readWithVtk(const std::string &path);
+};
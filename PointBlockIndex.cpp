@@ -0,0 +1,298 @@
+#include "PointBlockIndex.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkPlanes.h>
+#include <vtkPoints.h>
+#include <vtkDataArray.h>
+#include <vtkSMPTools.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace
+{
+    // 管线中的点为 float，直接读取连续数组；其它类型经 vtkPoints::GetPoint
+    struct PointReader
+    {
+        vtkPoints *points = nullptr;
+        const float *xyz = nullptr;
+
+        explicit PointReader(vtkPoints *p) : points(p)
+        {
+            if (p->GetDataType() == VTK_FLOAT)
+                xyz = static_cast<const float *>(p->GetData()->GetVoidPointer(0));
+        }
+
+        void get(vtkIdType id, double p[3]) const
+        {
+            if (xyz)
+            {
+                p[0] = xyz[3 * id];
+                p[1] = xyz[3 * id + 1];
+                p[2] = xyz[3 * id + 2];
+            }
+            else
+            {
+                points->GetPoint(id, p);
+            }
+        }
+    };
+
+    struct PlaneSet
+    {
+        std::vector<double> origins;
+        std::vector<double> normals;
+        int count = 0;
+
+        // 所有平面内侧（n·(p-o) <= 0）
+        bool contains(const double p[3]) const
+        {
+            for (int k = 0; k < count; ++k)
+            {
+                const double *o = &origins[3 * k];
+                const double *n = &normals[3 * k];
+                if (n[0] * (p[0] - o[0]) + n[1] * (p[1] - o[1]) + n[2] * (p[2] - o[2]) > 0.0)
+                    return false;
+            }
+            return true;
+        }
+    };
+}
+
+bool PointBlockIndex::build(vtkPolyData *polyData, vtkIdType blockSize)
+{
+    TRACE_SCOPE("PointBlockIndex::build");
+    ScopedStageTimer timer("BlockIndex.Build");
+    polyData_ = polyData;
+    points_ = polyData ? polyData->GetPoints() : nullptr;
+    numPoints_ = points_ ? points_->GetNumberOfPoints() : 0;
+    blockSize_ = std::max<vtkIdType>(1, blockSize);
+    blockBounds_.clear();
+    if (numPoints_ == 0)
+        return false;
+
+    const vtkIdType blockCount = (numPoints_ + blockSize_ - 1) / blockSize_;
+    blockBounds_.resize(static_cast<std::size_t>(blockCount) * 6);
+    PointReader reader(points_);
+    vtkSMPTools::For(0, blockCount, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double p[3];
+        for (vtkIdType b = begin; b < end; ++b)
+        {
+            double *bounds = &blockBounds_[6 * b];
+            const vtkIdType first = b * blockSize_;
+            const vtkIdType last = std::min(numPoints_, first + blockSize_);
+            reader.get(first, p);
+            for (int axis = 0; axis < 3; ++axis)
+                bounds[2 * axis] = bounds[2 * axis + 1] = p[axis];
+            for (vtkIdType i = first + 1; i < last; ++i)
+            {
+                reader.get(i, p);
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    bounds[2 * axis] = std::min(bounds[2 * axis], p[axis]);
+                    bounds[2 * axis + 1] = std::max(bounds[2 * axis + 1], p[axis]);
+                }
+            }
+        } });
+    return true;
+}
+
+bool PointBlockIndex::isBuiltFor(vtkPolyData *polyData) const
+{
+    return polyData && polyData == polyData_.GetPointer() && polyData->GetPoints() == points_.GetPointer() &&
+           polyData->GetNumberOfPoints() == numPoints_ && numPoints_ > 0;
+}
+
+void PointBlockIndex::getBlockBounds(int block, double bounds[6]) const
+{
+    std::copy(blockBounds_.begin() + 6 * block, blockBounds_.begin() + 6 * block + 6, bounds);
+}
+
+void PointBlockIndex::collectInside(vtkPlanes *planes, std::vector<vtkIdType> &ids, int *acceptedBlocks,
+                                    int *testedBlocks) const
+{
+    TRACE_SCOPE("PointBlockIndex::collectInside");
+    ids.clear();
+    if (numPoints_ == 0 || !planes || !planes->GetPoints() || !planes->GetNormals())
+        return;
+
+    PlaneSet planeSet;
+    planeSet.count = planes->GetNumberOfPlanes();
+    planeSet.origins.resize(3 * planeSet.count);
+    planeSet.normals.resize(3 * planeSet.count);
+    for (int k = 0; k < planeSet.count; ++k)
+    {
+        planes->GetPoints()->GetPoint(k, &planeSet.origins[3 * k]);
+        planes->GetNormals()->GetTuple(k, &planeSet.normals[3 * k]);
+    }
+
+    // 每块的结果：整块接受时只记录标记，逐点判断时记录点号
+    enum class BlockState : char
+    {
+        Outside,
+        Inside,
+        Partial
+    };
+    const int blockCount = getNumberOfBlocks();
+    std::vector<BlockState> states(static_cast<std::size_t>(blockCount), BlockState::Outside);
+    std::vector<std::vector<vtkIdType>> partialIds(static_cast<std::size_t>(blockCount));
+    PointReader reader(points_);
+    vtkSMPTools::For(0, blockCount, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double p[3];
+        for (vtkIdType b = begin; b < end; ++b)
+        {
+            const double *bounds = &blockBounds_[6 * b];
+            // 包围盒在平面法向上的最近 / 最远角点决定块与半空间的关系
+            bool outside = false;
+            bool inside = true;
+            for (int k = 0; k < planeSet.count && !outside; ++k)
+            {
+                const double *o = &planeSet.origins[3 * k];
+                const double *n = &planeSet.normals[3 * k];
+                double nearest = 0.0;
+                double farthest = 0.0;
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    double lo = n[axis] * (bounds[2 * axis] - o[axis]);
+                    double hi = n[axis] * (bounds[2 * axis + 1] - o[axis]);
+                    nearest += std::min(lo, hi);
+                    farthest += std::max(lo, hi);
+                }
+                outside = nearest > 0.0;
+                inside = inside && farthest <= 0.0;
+            }
+            if (outside)
+                continue;
+            if (inside)
+            {
+                states[b] = BlockState::Inside;
+                continue;
+            }
+            states[b] = BlockState::Partial;
+            const vtkIdType first = b * blockSize_;
+            const vtkIdType last = std::min(numPoints_, first + blockSize_);
+            for (vtkIdType i = first; i < last; ++i)
+            {
+                reader.get(i, p);
+                if (planeSet.contains(p))
+                    partialIds[b].push_back(i);
+            }
+        } });
+
+    int accepted = 0;
+    int tested = 0;
+    for (int b = 0; b < blockCount; ++b)
+    {
+        if (states[b] == BlockState::Inside)
+        {
+            ++accepted;
+            const vtkIdType first = static_cast<vtkIdType>(b) * blockSize_;
+            const vtkIdType last = std::min(numPoints_, first + blockSize_);
+            for (vtkIdType i = first; i < last; ++i)
+                ids.push_back(i);
+        }
+        else if (states[b] == BlockState::Partial)
+        {
+            ++tested;
+            ids.insert(ids.end(), partialIds[b].begin(), partialIds[b].end());
+        }
+    }
+    if (acceptedBlocks)
+        *acceptedBlocks = accepted;
+    if (testedBlocks)
+        *testedBlocks = tested;
+}
+
+vtkIdType PointBlockIndex::pickPoint(const double p0[3], const double p1[3], double tolerance, double position[3]) const
+{
+    TRACE_SCOPE("PointBlockIndex::pickPoint");
+    const double d[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    const double length2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+    if (numPoints_ == 0 || length2 <= 0.0)
+        return -1;
+
+    // 线段与扩大 expand 后的块包围盒是否相交（slab 法）。点到其在线段上投影的各轴偏差都不超过 expand 时，
+    // 投影点必在扩大后的包围盒内，因此不相交的块不可能有更近的点
+    auto segmentHitsBlock = [&](const double *bounds, double expand)
+    {
+        double tEnter = 0.0;
+        double tExit = 1.0;
+        for (int axis = 0; axis < 3 && tEnter <= tExit; ++axis)
+        {
+            double lo = bounds[2 * axis] - expand;
+            double hi = bounds[2 * axis + 1] + expand;
+            if (std::abs(d[axis]) < std::numeric_limits<double>::epsilon())
+            {
+                if (p0[axis] < lo || p0[axis] > hi)
+                    return false;
+                continue;
+            }
+            double t0 = (lo - p0[axis]) / d[axis];
+            double t1 = (hi - p0[axis]) / d[axis];
+            if (t0 > t1)
+                std::swap(t0, t1);
+            tEnter = std::max(tEnter, t0);
+            tExit = std::min(tExit, t1);
+        }
+        return tEnter <= tExit;
+    };
+
+    // 点到射线的距离：点与其在线段上投影之差的最大分量（与 vtkPointPicker 的度量相同）
+    auto rayDistance = [&](const double p[3], double &t)
+    {
+        t = ((p[0] - p0[0]) * d[0] + (p[1] - p0[1]) * d[1] + (p[2] - p0[2]) * d[2]) / length2;
+        double distance = 0.0;
+        for (int axis = 0; axis < 3; ++axis)
+            distance = std::max(distance, std::abs(p[axis] - (p0[axis] + t * d[axis])));
+        return distance;
+    };
+
+    // 与容差范围相交的块，按块中心到射线的距离由近到远遍历，最近的点通常在前几块
+    std::vector<std::pair<double, int>> candidates;
+    for (int b = 0; b < getNumberOfBlocks(); ++b)
+    {
+        const double *bounds = &blockBounds_[6 * b];
+        if (!segmentHitsBlock(bounds, tolerance))
+            continue;
+        const double center[3] = {0.5 * (bounds[0] + bounds[1]), 0.5 * (bounds[2] + bounds[3]),
+                                  0.5 * (bounds[4] + bounds[5])};
+        double t = 0.0;
+        candidates.emplace_back(rayDistance(center, t), b);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    // 取距离射线最近的点（相同时取更靠近 p0 的点）；块与扩大当前最近距离后的射线范围不相交时跳过
+    PointReader reader(points_);
+    vtkIdType best = -1;
+    double bestDistance = tolerance;
+    double bestT = std::numeric_limits<double>::max();
+    double p[3];
+    for (const auto &candidate : candidates)
+    {
+        if (best >= 0 && !segmentHitsBlock(&blockBounds_[6 * candidate.second], bestDistance))
+            continue;
+        const vtkIdType first = static_cast<vtkIdType>(candidate.second) * blockSize_;
+        const vtkIdType last = std::min(numPoints_, first + blockSize_);
+        for (vtkIdType i = first; i < last; ++i)
+        {
+            reader.get(i, p);
+            double t = 0.0;
+            const double distance = rayDistance(p, t);
+            if (t < 0.0 || t > 1.0 || distance > bestDistance)
+                continue;
+            if (best < 0 || distance < bestDistance || t < bestT)
+            {
+                best = i;
+                bestDistance = distance;
+                bestT = t;
+            }
+        }
+    }
+    if (best >= 0 && position)
+        reader.get(best, position);
+    return best;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file PointBlockIndex.h
+ * @brief 该头文件定义了 PointBlockIndex 类，按点号定长分块的隐式空间索引。
+ * @details 点云按点号顺序每 blockSize 个点为一块，只记录各块的包围盒，不复制点、不建树，构建为一次并行遍历。
+ *          点按空间填充曲线重排后（见 SpatialReorder）块包围盒紧凑，查询可整块跳过或整块接受：
+ *          - 凸多面体（箱体裁剪的 6 个平面）内的点：块在某平面外侧则跳过，块在所有平面内侧则整块接受，
+ *            其余块逐点判断；
+ *          - 射线拾取：只遍历射线（按容差扩大后）穿过的块，按块中心到射线的距离排序，
+ *            与按当前最近距离扩大后的射线范围不相交的块跳过。
+ *          采集顺序的点云块包围盒很大，查询退化为逐点遍历，结果不变。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vector>
+
+class vtkPlanes;
+
+/**
+ * @class PointBlockIndex
+ * @brief 点块包围盒索引，由构建它的数据的持有者（如 BoxClipperController）持有。
+ */
+class PointBlockIndex
+{
+public:
+    static constexpr vtkIdType DefaultBlockSize = 1024;
+
+    /**
+     * @brief 为点云构建块包围盒，保存数据引用。
+     * @return 数据为空时返回 false。
+     */
+    bool build(vtkPolyData *polyData, vtkIdType blockSize = DefaultBlockSize);
+
+    /**
+     * @brief 索引是否对应该数据（同一组点且点数未变）。
+     */
+    bool isBuiltFor(vtkPolyData *polyData) const;
+
+    vtkPolyData *getPolyData() const { return polyData_; }
+    int getNumberOfBlocks() const { return static_cast<int>(blockBounds_.size() / 6); }
+    vtkIdType getBlockSize() const { return blockSize_; }
+    void getBlockBounds(int block, double bounds[6]) const;
+
+    /**
+     * @brief 收集位于所有平面内侧（法向指向外侧，vtkPlanes 的约定）的点号，按点号升序。
+     * @param acceptedBlocks 可选输出：整块接受的块数。
+     * @param testedBlocks 可选输出：需要逐点判断的块数。
+     */
+    void collectInside(vtkPlanes *planes, std::vector<vtkIdType> &ids, int *acceptedBlocks = nullptr,
+                       int *testedBlocks = nullptr) const;
+
+    /**
+     * @brief 射线拾取：在线段 p0→p1 上投影、且与投影点各轴偏差不超过 tolerance 的点中，取偏差最大分量最小的点，
+     *        相同时取更靠近 p0 的点（与 vtkPointPicker 在单个数据集内的选择规则相同）。
+     * @param position 可选输出：命中点坐标。
+     * @return 点号，没有命中时返回 -1。
+     */
+    vtkIdType pickPoint(const double p0[3], const double p1[3], double tolerance, double position[3] = nullptr) const;
+
+    /**
+     * @brief 块包围盒占用的字节数。
+     */
+    std::size_t getMemorySize() const { return blockBounds_.capacity() * sizeof(double); }
+
+private:
+    vtkSmartPointer<vtkPolyData> polyData_;
+    vtkSmartPointer<vtkPoints> points_;
+    vtkIdType numPoints_ = 0;
+    vtkIdType blockSize_ = DefaultBlockSize;
+    std::vector<double> blockBounds_; ///< 每块 6 个值
+};
@@ -0,0 +1,262 @@
+#include "PointBudgetController.h"
+#include "CulledPointCloudMapper.h"
+#include "RenderScheduler.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkActor.h>
+#include <vtkActorCollection.h>
+#include <vtkCamera.h>
+#include <vtkCommand.h>
+#include <vtkRenderWindow.h>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    const int RefineDelayMs = 150; // 相机静止多久后细化
+    const int MaxRefineSteps = 24;
+
+    // 以 2^(level-1) 为步长从 count 个点中取到的点数
+    vtkIdType pointsAtLevel(vtkIdType count, unsigned char level)
+    {
+        if (level == 0)
+            return 0;
+        const vtkIdType stride = vtkIdType(1) << (level - 1);
+        return (count + stride - 1) / stride;
+    }
+
+    // 屏幕误差不超过 error 的最粗级别，不细于目标级别
+    unsigned char levelForError(vtkIdType count, float diameter, unsigned char target, double error)
+    {
+        const double maxStride = diameter > 0.0f ? count * (error / diameter) * (error / diameter)
+                                                 : std::numeric_limits<double>::max();
+        unsigned char level = target;
+        double stride = double(vtkIdType(1) << (target - 1));
+        while (level < CulledPointCloudMapper::MaxLevel && stride * 2.0 <= maxStride)
+        {
+            stride *= 2.0;
+            ++level;
+        }
+        return level;
+    }
+
+    struct Target
+    {
+        CulledPointCloudMapper *mapper = nullptr;
+        std::vector<unsigned char> levels;   ///< 目标级别
+        std::vector<float> diameters;        ///< 投影直径（像素）
+        std::vector<vtkIdType> counts;       ///< 每块点数
+        std::vector<unsigned char> assigned; ///< 分配的级别
+    };
+}
+
+PointBudgetController::PointBudgetController(vtkSmartPointer<vtkRenderer> renderer, RenderScheduler *scheduler,
+                                             QObject *parent)
+    : QObject(parent), renderer_(renderer), renderScheduler_(scheduler)
+{
+    renderCallback_ = vtkSmartPointer<vtkCallbackCommand>::New();
+    renderCallback_->SetCallback(PointBudgetController::OnRenderEvent);
+    renderCallback_->SetClientData(this);
+    startObserver_ = renderer_->AddObserver(vtkCommand::StartEvent, renderCallback_);
+    endObserver_ = renderer_->AddObserver(vtkCommand::EndEvent, renderCallback_);
+
+    refineTimer_.setSingleShot(true);
+    refineTimer_.setInterval(RefineDelayMs);
+    connect(&refineTimer_, &QTimer::timeout, this, &PointBudgetController::refine);
+}
+
+PointBudgetController::~PointBudgetController()
+{
+    if (renderer_)
+    {
+        renderer_->RemoveObserver(startObserver_);
+        renderer_->RemoveObserver(endObserver_);
+    }
+}
+
+void PointBudgetController::setBudget(vtkIdType points)
+{
+    budget_ = std::max<vtkIdType>(0, points);
+    refineStep_ = 0;
+    refineTimer_.stop();
+    if (budget_ == 0)
+    {
+        clearLevels();
+        converged_ = true;
+    }
+    qDebug() << "[PointBudgetController] Budget" << budget_ << "points per frame";
+    RenderScheduler::requestOrRender(renderScheduler_, renderer_->GetRenderWindow());
+}
+
+void PointBudgetController::OnRenderEvent(vtkObject *, unsigned long eid, void *clientdata, void *)
+{
+    auto self = static_cast<PointBudgetController *>(clientdata);
+    if (self->budget_ == 0)
+        return;
+    if (eid == vtkCommand::StartEvent)
+        self->allocate();
+    else if (!self->converged_)
+        self->refineTimer_.start(); // 每帧重新计时，交互期间不细化
+}
+
+void PointBudgetController::refine()
+{
+    if (budget_ == 0 || converged_ || refineStep_ >= MaxRefineSteps)
+        return;
+    ++refineStep_;
+    RenderScheduler::requestOrRender(renderScheduler_, renderer_->GetRenderWindow());
+}
+
+void PointBudgetController::clearLevels()
+{
+    vtkActorCollection *actors = renderer_->GetActors();
+    vtkCollectionSimpleIterator it;
+    actors->InitTraversal(it);
+    while (vtkActor *actor = actors->GetNextActor(it))
+    {
+        if (auto mapper = CulledPointCloudMapper::SafeDownCast(actor->GetMapper()))
+            mapper->ClearBudgetLevels();
+    }
+}
+
+void PointBudgetController::allocate()
+{
+    TRACE_SCOPE("PointBudgetController::allocate");
+    ScopedStageTimer timer("Render.Budget");
+
+    // 视图变化后从预算本身重新细化
+    vtkCamera *camera = renderer_->GetActiveCamera();
+    std::array<double, 14> view{};
+    camera->GetPosition(&view[0]);
+    camera->GetFocalPoint(&view[3]);
+    camera->GetViewUp(&view[6]);
+    view[9] = camera->GetViewAngle();
+    view[10] = camera->GetParallelScale();
+    view[11] = camera->GetParallelProjection();
+    int *size = renderer_->GetSize();
+    view[12] = size[0];
+    view[13] = size[1];
+    if (view != view_)
+    {
+        view_ = view;
+        refineStep_ = 0;
+    }
+
+    // 收集可见点云 mapper 的目标级别
+    std::vector<Target> targets;
+    vtkActorCollection *actors = renderer_->GetActors();
+    vtkCollectionSimpleIterator it;
+    actors->InitTraversal(it);
+    while (vtkActor *actor = actors->GetNextActor(it))
+    {
+        auto mapper = CulledPointCloudMapper::SafeDownCast(actor->GetMapper());
+        if (!mapper || !actor->GetVisibility() || !mapper->PrepareBlocks())
+            continue;
+        Target target;
+        target.mapper = mapper;
+        mapper->ComputeLevels(renderer_, actor, target.levels, &target.diameters);
+        target.counts.resize(target.levels.size());
+        for (std::size_t b = 0; b < target.levels.size(); ++b)
+            target.counts[b] = mapper->GetBlockPointCount(static_cast<int>(b));
+        targets.push_back(std::move(target));
+    }
+
+    vtkIdType budget = budget_;
+    for (int step = 0; step < refineStep_ && budget < std::numeric_limits<vtkIdType>::max() / 2; ++step)
+        budget *= 2;
+
+    // 给定误差阈值时的分配与总点数
+    auto assign = [&targets](double error)
+    {
+        vtkIdType total = 0;
+        for (Target &target : targets)
+        {
+            target.assigned.resize(target.levels.size());
+            for (std::size_t b = 0; b < target.levels.size(); ++b)
+            {
+                unsigned char level = target.levels[b];
+                if (level > 0)
+                    level = levelForError(target.counts[b], target.diameters[b], level, error);
+                target.assigned[b] = level;
+                total += pointsAtLevel(target.counts[b], level);
+            }
+        }
+        return total;
+    };
+
+    float maxDiameter = 0.0f;
+    targetPoints_ = 0;
+    for (const Target &target : targets)
+    {
+        for (std::size_t b = 0; b < target.levels.size(); ++b)
+        {
+            targetPoints_ += pointsAtLevel(target.counts[b], target.levels[b]);
+            maxDiameter = std::max(maxDiameter, target.diameters[b]);
+        }
+    }
+
+    if (targetPoints_ <= budget)
+    {
+        for (Target &target : targets)
+            target.assigned = target.levels;
+        allocatedPoints_ = targetPoints_;
+    }
+    else
+    {
+        // 误差阈值不小于最大投影直径时所有块取最粗级别
+        double coarse = std::max(1.0, 2.0 * maxDiameter);
+        allocatedPoints_ = assign(coarse);
+        if (allocatedPoints_ > budget)
+        {
+            // 最粗级别仍超出预算：按投影直径从大到小保留块
+            std::vector<std::pair<float, std::pair<std::size_t, std::size_t>>> order;
+            for (std::size_t t = 0; t < targets.size(); ++t)
+            {
+                for (std::size_t b = 0; b < targets[t].assigned.size(); ++b)
+                {
+                    if (targets[t].assigned[b] > 0)
+                        order.push_back({-targets[t].diameters[b], {t, b}});
+                }
+            }
+            std::sort(order.begin(), order.end());
+            allocatedPoints_ = 0;
+            for (const auto &entry : order)
+            {
+                Target &target = targets[entry.second.first];
+                const std::size_t b = entry.second.second;
+                vtkIdType points = pointsAtLevel(target.counts[b], target.assigned[b]);
+                if (allocatedPoints_ + points > budget)
+                    target.assigned[b] = 0;
+                else
+                    allocatedPoints_ += points;
+            }
+        }
+        else
+        {
+            // 对数尺度二分：在预算内取最小的误差阈值
+            double fine = 1e-3;
+            for (int iteration = 0; iteration < 24; ++iteration)
+            {
+                double middle = std::sqrt(fine * coarse);
+                if (assign(middle) <= budget)
+                    coarse = middle;
+                else
+                    fine = middle;
+            }
+            allocatedPoints_ = assign(coarse);
+        }
+    }
+
+    for (Target &target : targets)
+        target.mapper->SetBudgetLevels(target.assigned);
+
+    bool converged = allocatedPoints_ >= targetPoints_;
+    if (converged && !converged_ && refineStep_ > 0)
+        qDebug() << "[PointBudgetController] Converged at" << allocatedPoints_ << "points after" << refineStep_
+                 << "refinements";
+    converged_ = converged;
+}
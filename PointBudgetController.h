@@ -0,0 +1,71 @@
+/**
+ * @file PointBudgetController.h
+ * @brief 该头文件定义了 PointBudgetController 类，按全局点数预算分配各点云块的绘制级别并在空闲时逐步细化。
+ * @details 启用预算后，每帧开始时（渲染器 StartEvent）收集场景中所有可见的 CulledPointCloudMapper，
+ *          取各块按视锥 / 屏幕尺寸得到的目标级别与投影直径，在所有模型、瓦片之间统一分配：
+ *          - 块在步长 s 下的屏幕误差为投影直径 × sqrt(s / 点数)（相邻绘制点的像素间距）；
+ *          - 二分查找误差阈值，使各块取满足阈值的最粗级别（不细于目标级别）时总点数不超过预算；
+ *          - 所有块取最粗级别仍超出预算时，按投影直径从大到小保留块，其余块本帧不绘制。
+ *          分配只取决于相机与数据，同一视图结果相同；各步长的点互相嵌套，细化只增加点，画面不会跳动。
+ *
+ *          帧结束后未达到目标级别时启动空闲定时器：相机静止一段时间后预算加倍并请求重绘，
+ *          直到全部块达到目标级别（收敛）；相机变化后从预算本身重新开始。
+ *          颜色风格、着色来源与点大小作用于 mapper / actor，不受影响；点大小参与目标级别的计算。
+ */
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <vtkSmartPointer.h>
+#include <vtkRenderer.h>
+#include <vtkCallbackCommand.h>
+#include <array>
+
+class RenderScheduler;
+
+/**
+ * @class PointBudgetController
+ * @brief 全局点数预算与渐进细化，由 ThreeDimensionalDisplayPage 持有。
+ */
+class PointBudgetController : public QObject
+{
+    Q_OBJECT
+
+public:
+    PointBudgetController(vtkSmartPointer<vtkRenderer> renderer, RenderScheduler *scheduler, QObject *parent = nullptr);
+    ~PointBudgetController() override;
+
+    /**
+     * @brief 设置每帧点数预算，0 关闭（各 mapper 恢复按视图自行剔除），并请求重绘。
+     */
+    void setBudget(vtkIdType points);
+    vtkIdType getBudget() const { return budget_; }
+
+    // 最近一帧分配的点数、全部达到目标级别时的点数与是否已收敛
+    vtkIdType getAllocatedPoints() const { return allocatedPoints_; }
+    vtkIdType getTargetPoints() const { return targetPoints_; }
+    bool isConverged() const { return converged_; }
+
+private:
+    static void OnRenderEvent(vtkObject *caller, unsigned long eid, void *clientdata, void *calldata);
+    // 为本帧分配各块级别
+    void allocate();
+    // 清除所有 mapper 上的预算级别
+    void clearLevels();
+    // 空闲定时器：预算加倍并重绘
+    void refine();
+
+    vtkSmartPointer<vtkRenderer> renderer_;
+    RenderScheduler *renderScheduler_;
+    vtkSmartPointer<vtkCallbackCommand> renderCallback_;
+    unsigned long startObserver_ = 0;
+    unsigned long endObserver_ = 0;
+    QTimer refineTimer_;
+
+    vtkIdType budget_ = 0;                 ///< 每帧点数预算，0 表示关闭
+    int refineStep_ = 0;                   ///< 当前视图下已细化的次数（预算 × 2^refineStep_）
+    std::array<double, 14> view_{};        ///< 上一帧的相机参数与视口尺寸，用于判断视图变化
+    vtkIdType allocatedPoints_ = 0;
+    vtkIdType targetPoints_ = 0;
+    bool converged_ = true;
+};
@@ -0,0 +1,184 @@
+#include "PointKdTree.h"
+
+#include <vtkPoints.h>
+#include <vtkSMPTools.h>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace
+{
+    const std::int64_t kLeafSize = 8;
+    // 串行划分到该深度后（2^6 = 64 棵子树）并行构建子树
+    const int kParallelDepth = 6;
+}
+
+bool PointKdTree::build(vtkPolyData *cloud, const double transform[16])
+{
+    points_.clear();
+    axis_.clear();
+    if (!cloud || cloud->GetNumberOfPoints() == 0)
+        return false;
+
+    const std::int64_t n = cloud->GetNumberOfPoints();
+    points_.resize(static_cast<std::size_t>(n));
+    axis_.assign(static_cast<std::size_t>(n), 0);
+
+    vtkPoints *points = cloud->GetPoints();
+    vtkSMPTools::For(0, n, [&](vtkIdType begin, vtkIdType end)
+                     {
+        double p[3];
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            points->GetPoint(i, p);
+            for (int row = 0; row < 3; ++row)
+            {
+                double value = transform ? transform[4 * row] * p[0] + transform[4 * row + 1] * p[1] +
+                                               transform[4 * row + 2] * p[2] + transform[4 * row + 3]
+                                         : p[row];
+                points_[i].v[row] = static_cast<float>(value);
+            }
+        } });
+
+    // 上层串行划分，剩余子树互不重叠，可并行构建
+    std::vector<std::int64_t> subtrees;
+    buildRange(0, n, 0, &subtrees);
+    vtkSMPTools::For(0, static_cast<vtkIdType>(subtrees.size() / 2), [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType i = begin; i < end; ++i)
+            buildRange(subtrees[2 * i], subtrees[2 * i + 1], 0, nullptr); });
+
+    std::cout << "[PointKdTree] Built over " << n << " points." << std::endl;
+    return true;
+}
+
+void PointKdTree::buildRange(std::int64_t begin, std::int64_t end, int depth, std::vector<std::int64_t> *subtrees)
+{
+    if (end - begin <= kLeafSize)
+        return;
+    if (subtrees && depth >= kParallelDepth)
+    {
+        subtrees->push_back(begin);
+        subtrees->push_back(end);
+        return;
+    }
+
+    splitRange(begin, end);
+    std::int64_t mid = begin + (end - begin) / 2;
+    buildRange(begin, mid, depth + 1, subtrees);
+    buildRange(mid + 1, end, depth + 1, subtrees);
+}
+
+void PointKdTree::splitRange(std::int64_t begin, std::int64_t end)
+{
+    float bmin[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float bmax[3] = {-bmin[0], -bmin[1], -bmin[2]};
+    for (std::int64_t i = begin; i < end; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            bmin[k] = std::min(bmin[k], points_[i].v[k]);
+            bmax[k] = std::max(bmax[k], points_[i].v[k]);
+        }
+    }
+
+    int axis = 0;
+    if (bmax[1] - bmin[1] > bmax[axis] - bmin[axis])
+        axis = 1;
+    if (bmax[2] - bmin[2] > bmax[axis] - bmin[axis])
+        axis = 2;
+
+    std::int64_t mid = begin + (end - begin) / 2;
+    std::nth_element(points_.begin() + begin, points_.begin() + mid, points_.begin() + end,
+                     [axis](const Point3f &a, const Point3f &b)
+                     { return a.v[axis] < b.v[axis]; });
+    axis_[mid] = static_cast<std::uint8_t>(axis);
+}
+
+template <class Visitor>
+void PointKdTree::search(std::int64_t begin, std::int64_t end, const double p[3], const double &bound, Visitor &visit) const
+{
+    if (end - begin <= kLeafSize)
+    {
+        for (std::int64_t i = begin; i < end; ++i)
+            visit(i);
+        return;
+    }
+
+    std::int64_t mid = begin + (end - begin) / 2;
+    visit(mid);
+
+    int axis = axis_[mid];
+    double diff = p[axis] - points_[mid].v[axis];
+    // 先搜索查询点所在一侧，另一侧仅在划分面落在当前半径内时搜索
+    if (diff < 0.0)
+    {
+        search(begin, mid, p, bound, visit);
+        if (diff * diff < bound)
+            search(mid + 1, end, p, bound, visit);
+    }
+    else
+    {
+        search(mid + 1, end, p, bound, visit);
+        if (diff * diff < bound)
+            search(begin, mid, p, bound, visit);
+    }
+}
+
+std::int64_t PointKdTree::nearest(const double p[3], double &distance2) const
+{
+    std::int64_t best = -1;
+    distance2 = std::numeric_limits<double>::max();
+    if (empty())
+        return best;
+
+    auto visit = [&](std::int64_t i)
+    {
+        const float *q = points_[i].v;
+        double dx = p[0] - q[0], dy = p[1] - q[1], dz = p[2] - q[2];
+        double d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 < distance2)
+        {
+            distance2 = d2;
+            best = i;
+        }
+    };
+    search(0, size(), p, distance2, visit);
+    return best;
+}
+
+void PointKdTree::kNearest(const double p[3], int k, std::vector<std::int64_t> &indices, double maxDistance2) const
+{
+    indices.clear();
+    if (empty() || k <= 0)
+        return;
+
+    // 大顶堆保存当前 k 个最近点，堆顶为其中最远者
+    using Candidate = std::pair<double, std::int64_t>;
+    std::priority_queue<Candidate> heap;
+    double bound = maxDistance2;
+
+    auto visit = [&](std::int64_t i)
+    {
+        const float *q = points_[i].v;
+        double dx = p[0] - q[0], dy = p[1] - q[1], dz = p[2] - q[2];
+        double d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 >= bound)
+            return;
+        heap.emplace(d2, i);
+        if (static_cast<int>(heap.size()) > k)
+            heap.pop();
+        if (static_cast<int>(heap.size()) == k)
+            bound = heap.top().first;
+    };
+    search(0, size(), p, bound, visit);
+
+    indices.resize(heap.size());
+    for (std::size_t i = heap.size(); i > 0; --i)
+    {
+        indices[i - 1] = heap.top().second;
+        heap.pop();
+    }
+}
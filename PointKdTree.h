@@ -0,0 +1,79 @@
+/**
+ * @file PointKdTree.h
+ * @brief 该头文件定义了 PointKdTree 类，面向大规模点云的静态 k-d 树。
+ * @details 点坐标复制为紧凑的 float 数组并按树序重排，树结构隐式存储：区间 [begin, end) 的中位数
+ *          位置即节点，只额外记录每个节点的划分轴。上层按串行划分，子树并行构建；查询只读，
+ *          可以在多个线程中同时调用。
+ */
+#pragma once
+
+#include <vtkPolyData.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class PointKdTree
+ * @brief 点云 k-d 树，支持最近邻与 k 近邻查询。
+ */
+class PointKdTree
+{
+public:
+    /**
+     * @brief 由点云构建 k-d 树。
+     * @param cloud 点云。
+     * @param transform 构建前对点坐标施加的 4x4 矩阵（行主序），通常为
+     *        ModelPipelineBuilder::getDisplayToCenteredMatrix，树中坐标为真实尺度、与 Z 拉伸无关；为空时直接使用点坐标。
+     * @return 点云为空时返回 false。
+     */
+    bool build(vtkPolyData *cloud, const double transform[16] = nullptr);
+
+    /**
+     * @brief 最近邻查询。
+     * @param p 查询点（与构建时处于同一尺度）。
+     * @param distance2 输出最近距离的平方。
+     * @return 最近点在树中的序号，树为空时返回 -1。
+     */
+    std::int64_t nearest(const double p[3], double &distance2) const;
+
+    /**
+     * @brief k 近邻查询。
+     * @param p 查询点。
+     * @param k 近邻数量。
+     * @param indices 输出近邻在树中的序号，按距离从近到远排列。
+     * @param maxDistance2 只返回距离平方小于该值的点。
+     */
+    void kNearest(const double p[3], int k, std::vector<std::int64_t> &indices,
+                  double maxDistance2 = 1e300) const;
+
+    /**
+     * @brief 获取树中第 index 个点的坐标。
+     */
+    const float *point(std::int64_t index) const { return points_[index].v; }
+
+    std::int64_t size() const { return static_cast<std::int64_t>(axis_.size()); }
+    bool empty() const { return axis_.empty(); }
+
+    // 占用的内存字节数
+    std::size_t getMemorySize() const
+    {
+        return points_.capacity() * sizeof(Point3f) + axis_.capacity() * sizeof(std::uint8_t);
+    }
+
+private:
+    struct Point3f
+    {
+        float v[3];
+    };
+
+    // 构建 [begin, end)，depth 达到并行层数时把区间记入 subtrees 留待并行构建
+    void buildRange(std::int64_t begin, std::int64_t end, int depth, std::vector<std::int64_t> *subtrees);
+    // 沿包围盒最长轴做中位数划分
+    void splitRange(std::int64_t begin, std::int64_t end);
+    // 深度优先搜索，visitor 处理候选点并通过 bound 收紧剪枝半径（距离平方）
+    template <class Visitor>
+    void search(std::int64_t begin, std::int64_t end, const double p[3], const double &bound, Visitor &visit) const;
+
+    std::vector<Point3f> points_;     ///< 按树序重排的坐标
+    std::vector<std::uint8_t> axis_;  ///< 以该位置为中位数的节点的划分轴
+};
@@ -0,0 +1,291 @@
+#include "QuantizedPointStore.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkFloatArray.h>
+#include <vtkSMPTools.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    const double Levels16 = 65535.0;
+    const double Levels21 = 2097151.0;
+    const std::uint64_t Mask21 = (std::uint64_t(1) << 21) - 1;
+
+    // 解码核：连续数组、无分支，编码时的误差校验也调用同一函数，保证校验与实际解码一致
+    void decode16(const std::uint16_t *q, vtkIdType n, const float origin[3], const float step[3], float *out)
+    {
+        const float ox = origin[0], oy = origin[1], oz = origin[2];
+        const float sx = step[0], sy = step[1], sz = step[2];
+        for (vtkIdType i = 0; i < n; ++i)
+        {
+            out[3 * i + 0] = ox + sx * static_cast<float>(q[3 * i + 0]);
+            out[3 * i + 1] = oy + sy * static_cast<float>(q[3 * i + 1]);
+            out[3 * i + 2] = oz + sz * static_cast<float>(q[3 * i + 2]);
+        }
+    }
+
+    void decode21(const std::uint64_t *q, vtkIdType n, const float origin[3], const float step[3], float *out)
+    {
+        const float ox = origin[0], oy = origin[1], oz = origin[2];
+        const float sx = step[0], sy = step[1], sz = step[2];
+        for (vtkIdType i = 0; i < n; ++i)
+        {
+            const std::uint64_t v = q[i];
+            out[3 * i + 0] = ox + sx * static_cast<float>(v & Mask21);
+            out[3 * i + 1] = oy + sy * static_cast<float>((v >> 21) & Mask21);
+            out[3 * i + 2] = oz + sz * static_cast<float>(v >> 42);
+        }
+    }
+
+    std::uint32_t quantize(double value, double origin, double step, double levels)
+    {
+        if (step <= 0.0)
+            return 0;
+        double q = std::round((value - origin) / step);
+        return static_cast<std::uint32_t>(std::min(std::max(q, 0.0), levels));
+    }
+}
+
+bool QuantizedPointStore::encode(vtkPoints *points, double errorBound, vtkIdType blockSize)
+{
+    TRACE_SCOPE("QuantizedPointStore::encode");
+    ScopedStageTimer timer("Quantize.Encode");
+    clear();
+    if (!points || points->GetNumberOfPoints() == 0 || errorBound <= 0.0 || blockSize <= 0)
+        return false;
+
+    // 按 float 坐标编码（管线中的点均为 float），double 点先转换
+    vtkSmartPointer<vtkFloatArray> floatCopy;
+    const float *xyz = nullptr;
+    if (points->GetDataType() == VTK_FLOAT)
+    {
+        xyz = static_cast<const float *>(points->GetData()->GetVoidPointer(0));
+    }
+    else
+    {
+        floatCopy = vtkSmartPointer<vtkFloatArray>::New();
+        floatCopy->DeepCopy(points->GetData());
+        xyz = floatCopy->GetPointer(0);
+    }
+
+    numPoints_ = points->GetNumberOfPoints();
+    blockSize_ = blockSize;
+    errorBound_ = errorBound;
+    const vtkIdType blockCount = (numPoints_ + blockSize - 1) / blockSize;
+    blocks_.resize(static_cast<std::size_t>(blockCount));
+
+    // 1. 各块包围盒与编码选择（只校验，不写出）
+    vtkSMPTools::For(0, blockCount, [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType b = begin; b < end; ++b)
+        {
+            Block &block = blocks_[b];
+            block.first = b * blockSize;
+            block.count = std::min(blockSize, numPoints_ - block.first);
+            const float *p = xyz + 3 * block.first;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                block.bounds[2 * axis] = p[axis];
+                block.bounds[2 * axis + 1] = p[axis];
+            }
+            for (vtkIdType i = 1; i < block.count; ++i)
+            {
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    double v = p[3 * i + axis];
+                    block.bounds[2 * axis] = std::min(block.bounds[2 * axis], v);
+                    block.bounds[2 * axis + 1] = std::max(block.bounds[2 * axis + 1], v);
+                }
+            }
+            if (!encodeBlock(p, block, Encoding::Bits16, nullptr) && !encodeBlock(p, block, Encoding::Bits21, nullptr))
+                encodeBlock(p, block, Encoding::Float, nullptr);
+        } });
+
+    // 2. 各编码数组中的偏移
+    std::size_t count16 = 0;
+    std::size_t count21 = 0;
+    std::size_t countFloat = 0;
+    for (Block &block : blocks_)
+    {
+        std::size_t &counter = block.encoding == Encoding::Bits16   ? count16
+                               : block.encoding == Encoding::Bits21 ? count21
+                                                                    : countFloat;
+        block.offset = counter;
+        counter += static_cast<std::size_t>(block.count);
+    }
+    packed16_.resize(count16 * 3);
+    packed21_.resize(count21);
+    raw_.resize(countFloat * 3);
+
+    // 3. 按选定的编码写出
+    vtkSMPTools::For(0, blockCount, [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType b = begin; b < end; ++b)
+        {
+            Block &block = blocks_[b];
+            void *target = block.encoding == Encoding::Bits16   ? static_cast<void *>(packed16_.data() + 3 * block.offset)
+                           : block.encoding == Encoding::Bits21 ? static_cast<void *>(packed21_.data() + block.offset)
+                                                                : static_cast<void *>(raw_.data() + 3 * block.offset);
+            encodeBlock(xyz + 3 * block.first, block, block.encoding, target);
+        } });
+
+    std::cout << "[QuantizedPointStore] Encoded " << numPoints_ << " points in " << blockCount << " blocks ("
+              << getBlockCount(Encoding::Bits16) << " x 16 bit, " << getBlockCount(Encoding::Bits21) << " x 21 bit, "
+              << getBlockCount(Encoding::Float) << " x float), " << getMemorySize() << " bytes, max error "
+              << getMaxError() << std::endl;
+    return true;
+}
+
+bool QuantizedPointStore::encodeBlock(const float *xyz, Block &block, Encoding encoding, void *target)
+{
+    block.encoding = encoding;
+    block.maxError = 0.0;
+    if (encoding == Encoding::Float)
+    {
+        std::fill(block.origin, block.origin + 3, 0.f);
+        std::fill(block.step, block.step + 3, 0.f);
+        if (target)
+            std::memcpy(target, xyz, static_cast<std::size_t>(block.count) * 3 * sizeof(float));
+        return true;
+    }
+
+    // 步长取块范围除以量化级数，超过误差界时该编码不可用
+    const double levels = encoding == Encoding::Bits16 ? Levels16 : Levels21;
+    double step[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        step[axis] = (block.bounds[2 * axis + 1] - block.bounds[2 * axis]) / levels;
+        if (step[axis] > errorBound_)
+            return false;
+        block.origin[axis] = static_cast<float>(block.bounds[2 * axis]);
+        block.step[axis] = static_cast<float>(step[axis]);
+    }
+
+    // 量化后按解码核解码，逐点比较实测误差
+    const vtkIdType n = block.count;
+    std::vector<std::uint16_t> q16;
+    std::vector<std::uint64_t> q21;
+    std::vector<float> decoded(static_cast<std::size_t>(n) * 3);
+    if (encoding == Encoding::Bits16)
+    {
+        q16.resize(static_cast<std::size_t>(n) * 3);
+        for (vtkIdType i = 0; i < 3 * n; ++i)
+            q16[i] = static_cast<std::uint16_t>(quantize(xyz[i], block.origin[i % 3], block.step[i % 3], levels));
+        decode16(q16.data(), n, block.origin, block.step, decoded.data());
+    }
+    else
+    {
+        q21.resize(static_cast<std::size_t>(n));
+        for (vtkIdType i = 0; i < n; ++i)
+        {
+            std::uint64_t value = 0;
+            for (int axis = 0; axis < 3; ++axis)
+                value |= std::uint64_t(quantize(xyz[3 * i + axis], block.origin[axis], block.step[axis], levels))
+                         << (21 * axis);
+            q21[i] = value;
+        }
+        decode21(q21.data(), n, block.origin, block.step, decoded.data());
+    }
+    for (vtkIdType i = 0; i < 3 * n; ++i)
+        block.maxError = std::max(block.maxError, std::abs(static_cast<double>(decoded[i]) - xyz[i]));
+    if (block.maxError > errorBound_)
+        return false;
+
+    if (target && encoding == Encoding::Bits16)
+        std::memcpy(target, q16.data(), q16.size() * sizeof(std::uint16_t));
+    else if (target)
+        std::memcpy(target, q21.data(), q21.size() * sizeof(std::uint64_t));
+    return true;
+}
+
+void QuantizedPointStore::clear()
+{
+    blocks_.clear();
+    blocks_.shrink_to_fit();
+    packed16_.clear();
+    packed16_.shrink_to_fit();
+    packed21_.clear();
+    packed21_.shrink_to_fit();
+    raw_.clear();
+    raw_.shrink_to_fit();
+    numPoints_ = 0;
+    errorBound_ = 0.0;
+}
+
+int QuantizedPointStore::getBlockCount(Encoding encoding) const
+{
+    return static_cast<int>(std::count_if(blocks_.begin(), blocks_.end(), [encoding](const Block &block)
+                                          { return block.encoding == encoding; }));
+}
+
+double QuantizedPointStore::getMaxError() const
+{
+    double maxError = 0.0;
+    for (const Block &block : blocks_)
+        maxError = std::max(maxError, block.maxError);
+    return maxError;
+}
+
+void QuantizedPointStore::decodeBlock(int index, float *xyz) const
+{
+    const Block &block = blocks_[index];
+    switch (block.encoding)
+    {
+    case Encoding::Bits16:
+        decode16(packed16_.data() + 3 * block.offset, block.count, block.origin, block.step, xyz);
+        break;
+    case Encoding::Bits21:
+        decode21(packed21_.data() + block.offset, block.count, block.origin, block.step, xyz);
+        break;
+    default:
+        std::memcpy(xyz, raw_.data() + 3 * block.offset, static_cast<std::size_t>(block.count) * 3 * sizeof(float));
+        break;
+    }
+}
+
+void QuantizedPointStore::getPoint(vtkIdType id, double point[3]) const
+{
+    const Block &block = blocks_[static_cast<std::size_t>(id / blockSize_)];
+    const std::size_t index = block.offset + static_cast<std::size_t>(id - block.first);
+    float xyz[3];
+    switch (block.encoding)
+    {
+    case Encoding::Bits16:
+        decode16(packed16_.data() + 3 * index, 1, block.origin, block.step, xyz);
+        break;
+    case Encoding::Bits21:
+        decode21(packed21_.data() + index, 1, block.origin, block.step, xyz);
+        break;
+    default:
+        std::memcpy(xyz, raw_.data() + 3 * index, sizeof(xyz));
+        break;
+    }
+    point[0] = xyz[0];
+    point[1] = xyz[1];
+    point[2] = xyz[2];
+}
+
+vtkSmartPointer<vtkPoints> QuantizedPointStore::decode() const
+{
+    TRACE_SCOPE("QuantizedPointStore::decode");
+    ScopedStageTimer timer("Quantize.Decode");
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetDataType(VTK_FLOAT);
+    points->SetNumberOfPoints(numPoints_);
+    float *xyz = static_cast<float *>(points->GetData()->GetVoidPointer(0));
+    vtkSMPTools::For(0, static_cast<vtkIdType>(blocks_.size()), [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType b = begin; b < end; ++b)
+            decodeBlock(static_cast<int>(b), xyz + 3 * blocks_[b].first); });
+    return points;
+}
+
+std::size_t QuantizedPointStore::getMemorySize() const
+{
+    return blocks_.capacity() * sizeof(Block) + packed16_.capacity() * sizeof(std::uint16_t) +
+           packed21_.capacity() * sizeof(std::uint64_t) + raw_.capacity() * sizeof(float);
+}
@@ -0,0 +1,109 @@
+/**
+ * @file QuantizedPointStore.h
+ * @brief 该头文件定义了 QuantizedPointStore 类，以块内量化整数紧凑存储点坐标。
+ * @details float 坐标每点 12 字节。按顺序每 blockSize 个点分为一块，记录块包围盒，块内坐标相对包围盒最小角量化：
+ *          - 三个分量都能以 16 位表示时每点 6 字节；
+ *          - 否则尝试 21 位（三个分量打包进一个 64 位整数），每点 8 字节；
+ *          - 仍超出误差界（块范围过大）时该块保留 float 原值。
+ *
+ *          量化步长不超过误差界，编码后按解码核实际解码并与原坐标比较，实测误差超出误差界时改用下一种编码，
+ *          因此解码坐标与原坐标的误差保证不超过误差界（如 1 mm）。
+ *
+ *          解码核按块处理连续数组、无分支，便于编译器自动向量化；整体解码用 vtkSMPTools 按块并行。
+ *          空间连续的点（如扫描线、瓦片）块包围盒小，多数块可用 16 位编码。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPoints.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class QuantizedPointStore
+ * @brief 分块量化的点坐标存储。
+ */
+class QuantizedPointStore
+{
+public:
+    static constexpr vtkIdType DefaultBlockSize = 4096;
+
+    enum class Encoding
+    {
+        Bits16, ///< 每分量 16 位
+        Bits21, ///< 每分量 21 位，打包为 64 位整数
+        Float   ///< 保留 float 原值
+    };
+
+    /**
+     * @struct Block
+     * @brief 一块连续编号的点。
+     */
+    struct Block
+    {
+        vtkIdType first = 0;               ///< 第一个点的编号
+        vtkIdType count = 0;               ///< 点数
+        Encoding encoding = Encoding::Float;
+        std::size_t offset = 0;            ///< 在对应编码数组中的起始下标（按点）
+        float origin[3] = {0.f, 0.f, 0.f}; ///< 量化原点（块包围盒最小角）
+        float step[3] = {0.f, 0.f, 0.f};   ///< 各分量的量化步长
+        double bounds[6] = {0.0, -1.0, 0.0, -1.0, 0.0, -1.0}; ///< 块包围盒
+        double maxError = 0.0;             ///< 实测最大误差（各分量绝对误差的最大值）
+    };
+
+    /**
+     * @brief 编码点坐标，替换已有内容。
+     * @param points 输入点。
+     * @param errorBound 允许的最大误差（与坐标同单位），必须大于 0。
+     * @param blockSize 每块点数。
+     * @return 没有点或参数无效时返回 false。
+     */
+    bool encode(vtkPoints *points, double errorBound = 0.001, vtkIdType blockSize = DefaultBlockSize);
+
+    void clear();
+    bool isEmpty() const { return numPoints_ == 0; }
+
+    vtkIdType getNumberOfPoints() const { return numPoints_; }
+    int getNumberOfBlocks() const { return static_cast<int>(blocks_.size()); }
+    const Block &getBlock(int index) const { return blocks_[index]; }
+    int getBlockCount(Encoding encoding) const;
+    double getErrorBound() const { return errorBound_; }
+
+    /**
+     * @brief 所有块的实测最大误差。
+     */
+    double getMaxError() const;
+
+    /**
+     * @brief 解码一块到 xyz（count * 3 个 float）。
+     */
+    void decodeBlock(int index, float *xyz) const;
+
+    /**
+     * @brief 解码单个点（拾取等随机访问）。
+     */
+    void getPoint(vtkIdType id, double point[3]) const;
+
+    /**
+     * @brief 按块并行解码为 float 点。
+     */
+    vtkSmartPointer<vtkPoints> decode() const;
+
+    /**
+     * @brief 编码数据与块表占用的字节数。
+     */
+    std::size_t getMemorySize() const;
+
+private:
+    // 按编码量化一块并记录实测误差，超出误差界时返回 false；target 非空时写出编码数据
+    bool encodeBlock(const float *xyz, Block &block, Encoding encoding, void *target);
+
+    std::vector<Block> blocks_;
+    std::vector<std::uint16_t> packed16_; ///< Bits16 块，每点 3 个
+    std::vector<std::uint64_t> packed21_; ///< Bits21 块，每点 1 个
+    std::vector<float> raw_;              ///< Float 块，每点 3 个
+    vtkIdType numPoints_ = 0;
+    vtkIdType blockSize_ = DefaultBlockSize;
+    double errorBound_ = 0.0;
+};
@@ -0,0 +1,50 @@
+#include "RenderScheduler.h"
+
+RenderScheduler::RenderScheduler(vtkSmartPointer<vtkRenderWindow> renderWindow, QObject *parent)
+    : QObject(parent), renderWindow_(renderWindow)
+{
+    timer_.setSingleShot(true);
+    timer_.setInterval(0); // 下一次事件循环空闲时触发
+    connect(&timer_, &QTimer::timeout, this, &RenderScheduler::flush);
+}
+
+void RenderScheduler::requestRender()
+{
+    ++requestCount_;
+    if (timer_.isActive())
+    {
+        ++coalescedCount_; // 本周期已有待执行的渲染
+        return;
+    }
+    timer_.start();
+}
+
+void RenderScheduler::renderNow()
+{
+    if (timer_.isActive())
+        timer_.stop();
+    flush();
+}
+
+void RenderScheduler::requestOrRender(RenderScheduler *scheduler, vtkRenderWindow *renderWindow)
+{
+    if (scheduler)
+        scheduler->requestRender();
+    else if (renderWindow)
+        renderWindow->Render();
+}
+
+void RenderScheduler::resetCounters()
+{
+    requestCount_ = 0;
+    renderCount_ = 0;
+    coalescedCount_ = 0;
+}
+
+void RenderScheduler::flush()
+{
+    if (!renderWindow_)
+        return;
+    ++renderCount_;
+    renderWindow_->Render();
+}
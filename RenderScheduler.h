@@ -0,0 +1,59 @@
+/**
+ * @file RenderScheduler.h
+ * @brief 该头文件定义了 RenderScheduler 类，用于合并同一事件循环周期内的重复渲染请求。
+ * @details 控制器不再直接调用 Render()，而是通过 requestRender() 标记场景需要重绘；调度器在下一次
+ *          事件循环空闲时（零延迟单次定时器）只渲染一帧。被合并掉的请求数量可用于性能统计。
+ */
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <vtkSmartPointer.h>
+#include <vtkRenderWindow.h>
+
+/**
+ * @class RenderScheduler
+ * @brief 渲染请求调度器，由 ThreeDimensionalDisplayPage 持有。
+ */
+class RenderScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 构造函数。
+     * @param renderWindow 被调度的渲染窗口。
+     * @param parent 父对象。
+     */
+    explicit RenderScheduler(vtkSmartPointer<vtkRenderWindow> renderWindow, QObject *parent = nullptr);
+
+    /**
+     * @brief 请求一次渲染，同一事件循环周期内的多次请求只渲染一帧。
+     */
+    void requestRender();
+
+    /**
+     * @brief 立即渲染并取消尚未执行的请求（如截图前需要最新画面）。
+     */
+    void renderNow();
+
+    /**
+     * @brief 有调度器时请求渲染，否则直接渲染，供未设置调度器的控制器使用。
+     */
+    static void requestOrRender(RenderScheduler *scheduler, vtkRenderWindow *renderWindow);
+
+    quint64 getRequestCount() const { return requestCount_; }     ///< 累计渲染请求数
+    quint64 getRenderCount() const { return renderCount_; }       ///< 累计实际渲染帧数
+    quint64 getCoalescedCount() const { return coalescedCount_; } ///< 累计被合并的请求数
+    void resetCounters();
+
+private slots:
+    void flush();
+
+private:
+    vtkSmartPointer<vtkRenderWindow> renderWindow_;
+    QTimer timer_;
+    quint64 requestCount_ = 0;
+    quint64 renderCount_ = 0;
+    quint64 coalescedCount_ = 0;
+};
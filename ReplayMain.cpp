@@ -0,0 +1,346 @@
+/**
+ * @file ReplayMain.cpp
+ * @brief 交互会话回放程序（MyAppReplay）。
+ * @details 读取 InteractionRecorder 录制的会话文件，在与录制时同尺寸的离屏渲染窗口中按顺序重放每个事件，
+ *          并分别测量事件处理耗时和随后一帧的渲染耗时。回放不等待录制时的时间间隔，结果只取决于构建版本与机器，
+ *          可作为每个版本的确定性交互基准。没有 OpenGL 环境时可用 --no-render 只测事件处理耗时。
+ *
+ *          用法示例：
+ *            MyAppReplay session.vis --csv replay.csv
+ *            MyAppReplay session.vis --model /data/bench/terrain_cloud_10000000.ply --no-render
+ *            MyAppReplay session.vis --model mesh.obj --mesh-weld 0 --mesh-order overdraw --csv reordered.csv
+ *          网格重排前后的帧耗时用同一会话分别回放比较（render_ms），ACMR 在加载时输出。
+ */
+#include "InteractionRecorder.h"
+#include "ModelPinelineBuilder.h"
+#include "BoxClipperController.h"
+#include "MeshSliceController.h"
+#include "MeasurementController.h"
+#include "RenderScheduler.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <vtkSmartPointer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindowInteractor.h>
+#include <vtkCamera.h>
+#include <vtkTransform.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMilliseconds(Clock::time_point start)
+    {
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        return elapsed.count();
+    }
+
+    /**
+     * @class ReplayScene
+     * @brief 回放用场景，按 ThreeDimensionalDisplayPage 的方式响应各类事件。
+     */
+    class ReplayScene
+    {
+    public:
+        ReplayScene(vtkRenderer *renderer, vtkRenderWindowInteractor *interactor, RenderScheduler *scheduler)
+            : renderer_(renderer), interactor_(interactor), boxClipper_(interactor, renderer), slicer_(renderer),
+              measurement_(renderer, interactor)
+        {
+            boxClipper_.SetRenderScheduler(scheduler);
+            slicer_.SetRenderScheduler(scheduler);
+            measurement_.setRenderScheduler(scheduler);
+        }
+
+        // OBJ 网格加载后的焊接容差（< 0 关闭）与面顺序，在加载事件之前设置
+        void setMeshOptions(double weldTolerance, MeshCacheOptimizer::Mode order)
+        {
+            builder_.setMeshCleanTolerance(weldTolerance);
+            builder_.setMeshOrder(order);
+        }
+
+        /**
+         * @brief 应用一个事件。
+         * @return 事件无法应用（如模型加载失败）时返回 false。
+         */
+        bool apply(const InteractionEvent &event, const QString &modelOverride)
+        {
+            const std::vector<double> &v = event.values;
+            switch (event.type)
+            {
+            case InteractionType::LoadModel:
+                return loadModel(modelOverride.isEmpty() ? QString::fromStdString(event.text) : modelOverride);
+            case InteractionType::Camera:
+            {
+                if (v.size() < 12)
+                    return false;
+                vtkCamera *camera = renderer_->GetActiveCamera();
+                camera->SetPosition(v[0], v[1], v[2]);
+                camera->SetFocalPoint(v[3], v[4], v[5]);
+                camera->SetViewUp(v[6], v[7], v[8]);
+                camera->SetViewAngle(v[9]);
+                camera->SetParallelScale(v[10]);
+                camera->SetParallelProjection(v[11] != 0.0);
+                renderer_->ResetCameraClippingRange();
+                return true;
+            }
+            case InteractionType::BoxEnabled:
+                if (v.empty())
+                    return false;
+                boxClipper_.SetEnabled(v[0] != 0.0);
+                return true;
+            case InteractionType::BoxTransform:
+            {
+                if (v.size() < 16)
+                    return false;
+                auto transform = vtkSmartPointer<vtkTransform>::New();
+                transform->SetMatrix(v.data());
+                boxClipper_.SetBoxTransform(transform);
+                return true;
+            }
+            case InteractionType::Slice:
+                if (v.empty())
+                    return false;
+                slicer_.ShowSlice(static_cast<SliceDirection>(static_cast<int>(v[0])));
+                return true;
+            case InteractionType::HideSlice:
+                slicer_.HideSlice();
+                return true;
+            case InteractionType::ZScale:
+                if (v.empty() || !loaded_)
+                    return false;
+                setZScale(v[0]);
+                return true;
+            case InteractionType::MeasurementMode:
+                if (v.empty())
+                    return false;
+                measurement_.setMode(static_cast<MeasurementMode>(static_cast<int>(v[0])));
+                return true;
+            case InteractionType::MeasurementClick:
+                if (v.size() < 2)
+                    return false;
+                interactor_->SetEventPosition(static_cast<int>(v[0]), static_cast<int>(v[1]));
+                measurement_.onLeftButtonPressed();
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        bool loadModel(const QString &path)
+        {
+            if (!builder_.loadModel(path))
+            {
+                std::cerr << "[Replay] Failed to load model: " << path.toStdString() << std::endl;
+                return false;
+            }
+            loaded_ = true;
+            renderer_->RemoveAllViewProps();
+            addModelActors();
+            vtkActor *primary = primaryActor();
+            slicer_.SetOriginalActor(primary);
+            slicer_.UpdatePolyData(builder_.getProcessedPolyData());
+            boxClipper_.SetInputDataAndReplaceOriginal(builder_.getProcessedPolyData(), primary);
+            renderer_->ResetCamera();
+            measurement_.ReAddActorsToRenderer();
+            measurement_.setSurfaceMesh(isMesh() ? builder_.getProcessedPolyData().GetPointer() : nullptr);
+            return true;
+        }
+
+        void setZScale(double zScale)
+        {
+            builder_.setZAxisScale(zScale);
+            renderer_->RemoveActor(builder_.getActor());
+            renderer_->RemoveActor(builder_.getSurfaceActor());
+            renderer_->RemoveActor(builder_.getWireframeActor());
+            renderer_->RemoveActor(builder_.getPointsActor());
+            addModelActors();
+            boxClipper_.SetInputDataAndReplaceOriginal(builder_.getProcessedPolyData(), primaryActor());
+            measurement_.setSurfaceMesh(isMesh() ? builder_.getProcessedPolyData().GetPointer() : nullptr);
+        }
+
+        void addModelActors()
+        {
+            if (!isMesh())
+            {
+                renderer_->AddActor(builder_.getActor());
+                return;
+            }
+            // 与页面默认状态一致：OBJ 只显示面
+            if (auto surfaceActor = builder_.getSurfaceActor())
+            {
+                surfaceActor->SetVisibility(1);
+                renderer_->AddActor(surfaceActor);
+            }
+            if (auto wireframeActor = builder_.getWireframeActor())
+            {
+                wireframeActor->SetVisibility(0);
+                renderer_->AddActor(wireframeActor);
+            }
+            if (auto pointsActor = builder_.getPointsActor())
+            {
+                pointsActor->SetVisibility(0);
+                renderer_->AddActor(pointsActor);
+            }
+        }
+
+        bool isMesh() const { return builder_.getModelType() == ModelPipelineBuilder::ModelType::OBJ; }
+        vtkActor *primaryActor() const { return isMesh() ? builder_.getSurfaceActor() : builder_.getActor(); }
+
+        vtkRenderer *renderer_;
+        vtkRenderWindowInteractor *interactor_;
+        ModelPipelineBuilder builder_;
+        BoxClipperController boxClipper_;
+        MeshSliceController slicer_;
+        MeasurementController measurement_;
+        bool loaded_ = false;
+    };
+
+    /**
+     * @struct ReplayTiming
+     * @brief 单个事件的回放耗时。
+     */
+    struct ReplayTiming
+    {
+        std::size_t index = 0;
+        InteractionType type = InteractionType::Camera;
+        double applyMs = 0.0;  ///< 事件处理
+        double renderMs = 0.0; ///< 随后一帧渲染
+    };
+
+    double percentile(std::vector<double> values, double fraction)
+    {
+        if (values.empty())
+            return 0.0;
+        std::sort(values.begin(), values.end());
+        auto index = static_cast<std::size_t>(fraction * (values.size() - 1) + 0.5);
+        return values[std::min(index, values.size() - 1)];
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("MyAppReplay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays a recorded interaction session offscreen and reports per-event latency.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("session", "Interaction session file (*.vis).");
+    QCommandLineOption csvOption("csv", "Write per-event timings to a CSV file.", "file");
+    QCommandLineOption modelOption("model", "Load this model instead of the paths recorded in the session.", "file");
+    QCommandLineOption noRenderOption("no-render", "Only time event handling, do not render (no OpenGL required).");
+    QCommandLineOption meshWeldOption("mesh-weld", "Weld duplicate OBJ vertices within this tolerance (< 0 off).",
+                                      "value", "-1");
+    QCommandLineOption meshOrderOption("mesh-order", "OBJ triangle order: file, cache or overdraw.", "mode", "file");
+    parser.addOptions({csvOption, modelOption, noRenderOption, meshWeldOption, meshOrderOption});
+    parser.process(app);
+
+    MeshCacheOptimizer::Mode meshOrder = MeshCacheOptimizer::Mode::None;
+    const QString meshOrderName = parser.value(meshOrderOption);
+    if (meshOrderName == "cache")
+        meshOrder = MeshCacheOptimizer::Mode::VertexCache;
+    else if (meshOrderName == "overdraw")
+        meshOrder = MeshCacheOptimizer::Mode::Overdraw;
+    else if (meshOrderName != "file")
+    {
+        std::cerr << "[Replay] Unknown mesh order: " << meshOrderName.toStdString() << std::endl;
+        return 1;
+    }
+
+    if (parser.positionalArguments().isEmpty())
+        parser.showHelp(1);
+
+    InteractionRecorder session;
+    if (!session.load(parser.positionalArguments().front().toStdString()))
+        return 1;
+
+    // 与录制时同尺寸的离屏窗口，保证点击位置与相机投影一致
+    auto renderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+    renderWindow->SetOffScreenRendering(1);
+    renderWindow->SetSize(std::max(1, session.getWindowWidth()), std::max(1, session.getWindowHeight()));
+    auto renderer = vtkSmartPointer<vtkRenderer>::New();
+    renderer->SetBackground(0.5, 0.5, 0.5);
+    renderWindow->AddRenderer(renderer);
+    auto interactor = vtkSmartPointer<vtkRenderWindowInteractor>::New();
+    interactor->SetRenderWindow(renderWindow);
+    RenderScheduler scheduler(renderWindow); // 事件循环不运行，由回放在每个事件后显式渲染
+
+    ReplayScene scene(renderer, interactor, &scheduler);
+    scene.setMeshOptions(parser.value(meshWeldOption).toDouble(), meshOrder);
+    const bool render = !parser.isSet(noRenderOption);
+    const QString modelOverride = parser.value(modelOption);
+
+    std::vector<ReplayTiming> timings;
+    const std::vector<InteractionEvent> &events = session.getEvents();
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        ReplayTiming timing;
+        timing.index = i;
+        timing.type = events[i].type;
+
+        Clock::time_point start = Clock::now();
+        bool applied = scene.apply(events[i], modelOverride);
+        timing.applyMs = elapsedMilliseconds(start);
+        if (!applied)
+        {
+            std::cerr << "[Replay] Event " << i << " (" << InteractionRecorder::typeName(events[i].type)
+                      << ") could not be applied." << std::endl;
+            if (events[i].type == InteractionType::LoadModel)
+                return 1;
+            continue;
+        }
+
+        if (render)
+        {
+            start = Clock::now();
+            scheduler.renderNow();
+            timing.renderMs = elapsedMilliseconds(start);
+        }
+        timings.push_back(timing);
+    }
+
+    // 按事件类型汇总
+    std::map<int, std::vector<double>> totals;
+    for (const ReplayTiming &timing : timings)
+        totals[static_cast<int>(timing.type)].push_back(timing.applyMs + timing.renderMs);
+    std::cout << "\n"
+              << std::left << std::setw(18) << "event" << std::right << std::setw(8) << "count" << std::setw(12)
+              << "median ms" << std::setw(12) << "p95 ms" << std::setw(12) << "max ms" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto &entry : totals)
+    {
+        const std::vector<double> &samples = entry.second;
+        std::cout << std::left << std::setw(18) << InteractionRecorder::typeName(static_cast<InteractionType>(entry.first))
+                  << std::right << std::setw(8) << samples.size() << std::setw(12) << percentile(samples, 0.5)
+                  << std::setw(12) << percentile(samples, 0.95) << std::setw(12)
+                  << *std::max_element(samples.begin(), samples.end()) << "\n";
+    }
+
+    if (parser.isSet(csvOption))
+    {
+        std::ofstream out(parser.value(csvOption).toStdString(), std::ios::trunc);
+        if (!out)
+        {
+            std::cerr << "[Replay] Cannot open " << parser.value(csvOption).toStdString() << std::endl;
+            return 1;
+        }
+        out << "index,event,recorded_ms,apply_ms,render_ms,total_ms\n";
+        out << std::fixed << std::setprecision(3);
+        for (const ReplayTiming &timing : timings)
+        {
+            out << timing.index << ',' << InteractionRecorder::typeName(timing.type) << ','
+                << events[timing.index].time << ',' << timing.applyMs << ',' << timing.renderMs << ','
+                << timing.applyMs + timing.renderMs << '\n';
+        }
+    }
+    return 0;
+}
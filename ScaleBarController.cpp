@@ -1,10 +1,14 @@
 #include "ScaleBarController.h"
+#include "RenderScheduler.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
 #include <vtkTextProperty.h>
 #include <vtkCoordinate.h>
 #include <vtkCamera.h>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 #include <vtkProperty2D.h>
 #include <qDebug>
 
@@ -63,6 +67,8 @@ void ScaleBarController::CreateScaleBarActors()
 // 更新比例尺的显示内容（根据当前缩放）
 void ScaleBarController::UpdateScaleBar()
 {
+    ScopedStageTimer timer("ScaleBar.Update");
+    TRACE_SCOPE("ScaleBarController::UpdateScaleBar");
     double scale = GetCurrentScaleFactor();    // world units / pixel
     double worldLength = scale * pixelLength_; // 当前比例尺实际长度（单位：米）
 
@@ -79,7 +85,7 @@ void ScaleBarController::UpdateScaleBar()
 
     // 更新线段位置
     lineSource_->SetPoint1(0, 0, 0);
-    lineSource_->SetPoint2(barPixel, 0, 0); // 以像素长度为单位画横线
+    lineSource_->SetPoint2(barPixel * magnification_, 0, 0); // 以像素长度为单位画横线
     lineSource_->Modified();
 
     // 更新显示文本
@@ -87,7 +93,14 @@ void ScaleBarController::UpdateScaleBar()
     oss << std::fixed << std::setprecision(2) << worldLength << " m";
     scaleText_->SetInput(oss.str().c_str());
 
-    renderWindow_->Render();
+    RenderScheduler::requestOrRender(renderScheduler_, renderWindow_);
+}
+
+// 设置输出放大倍数：比例尺代表的实际长度不变，线段像素长度按倍数放大（字号与线宽由导出器统一放大）
+void ScaleBarController::SetMagnification(int magnification)
+{
+    magnification_ = std::max(1, magnification);
+    UpdateScaleBar();
 }
 
 // 场景清除重建后，重新添加比例尺图元
@@ -160,7 +173,7 @@ void ScaleBarController::OnInteractionEvent(vtkObject *caller, unsigned long eid
         {
             cam->SetDistance(self->lastValidCameraDistance_);
         }
-        self->renderWindow_->Render(); // 强制刷新场景
+        RenderScheduler::requestOrRender(self->renderScheduler_, self->renderWindow_); // 强制刷新场景
         // qDebug() << "[ScaleBar] Zoom limit reached. Reverted to last valid state.";
         return;
     }
@@ -22,6 +22,8 @@
 #include <vtkRenderWindowInteractor.h>
 #include <vtkCallbackCommand.h>
 
+class RenderScheduler;
+
 // 管理并绘制屏幕固定像素长度的比例尺控制器
 class ScaleBarController
 {
@@ -37,6 +39,12 @@ public:
     // 当比例尺需要重新添加回 renderer 时调用（如清空或重建渲染场景后）
     void ReAddToRenderer();
 
+    // 设置渲染调度器，未设置时直接渲染
+    void SetRenderScheduler(RenderScheduler *scheduler) { renderScheduler_ = scheduler; }
+
+    // 设置输出放大倍数（分块导出高分辨率截图时使用），线段像素长度随之放大，导出后恢复为 1
+    void SetMagnification(int magnification);
+
 private:
     // 交互事件的静态回调函数，用于处理缩放限制、比例尺更新等逻辑
     static void OnInteractionEvent(vtkObject *caller, unsigned long eid,
@@ -69,10 +77,13 @@ private:
 
     vtkSmartPointer<vtkCallbackCommand> interactionCallback_; // 鼠标缩放事件监听回调
 
+    RenderScheduler *renderScheduler_ = nullptr; // 渲染调度器（由页面持有）
+
     // -------------------------
     // 状态控制参数
     // -------------------------
     const int pixelLength_ = 200; // 比例尺在屏幕上固定显示的像素长度（单位 px）
+    int magnification_ = 1;       // 输出图像相对窗口的放大倍数
 
     double lastValidParallelScale_ = 1.0;  // 上一次合法 Parallel 投影的相机缩放值
     double lastValidCameraDistance_ = 1.0; // 上一次合法 Perspective 投影的相机距离
@@ -0,0 +1,582 @@
+#include "SceneModel.h"
+#include "ColorMaps.h"
+#include "MemoryReport.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkAppendPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <QFileInfo>
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+SceneModel::SceneModel(vtkSmartPointer<vtkRenderer> renderer)
+    : renderer_(renderer)
+{
+}
+
+int SceneModel::addModel(const QString &filePath, bool replaceScene)
+{
+    TRACE_SCOPE("SceneModel::addModel");
+    Entry entry;
+    entry.builder = std::make_unique<ModelPipelineBuilder>();
+    // 之后加载的模型按场景原点对齐，与第一个模型处于同一坐标系
+    if (hasOrigin_ && !replaceScene)
+        entry.builder->setCenterOverride(origin_);
+    entry.builder->setCompactPositions(compactErrorBound_);
+    entry.builder->setSpatialOrder(spatialOrder_);
+    entry.builder->setViewCulling(viewCulling_);
+    entry.builder->setMeshCleanTolerance(meshCleanTolerance_);
+    entry.builder->setMeshOrder(meshOrder_);
+    if (!entry.builder->loadModel(filePath))
+    {
+        std::cerr << "[SceneModel] Failed to load model: " << filePath.toStdString() << std::endl;
+        return -1;
+    }
+    if (replaceScene)
+        clear();
+    if (!hasOrigin_)
+    {
+        entry.builder->getCenter(origin_);
+        hasOrigin_ = true;
+    }
+
+    entry.id = nextId_++;
+    addActors(entry);
+    entries_.push_back(std::move(entry));
+    invalidateMergedData();
+    std::cout << "[SceneModel] Added model " << entries_.back().id << ": " << filePath.toStdString() << " ("
+              << entries_.size() << " in scene)" << std::endl;
+    return entries_.back().id;
+}
+
+int SceneModel::addTiledModel(const QString &dirPath, bool replaceScene, std::size_t budgetBytes)
+{
+    TRACE_SCOPE("SceneModel::addTiledModel");
+    Entry entry;
+    entry.tiles = std::make_unique<TiledModelLoader>();
+    if (hasOrigin_ && !replaceScene)
+        entry.tiles->setCenterOverride(origin_);
+    entry.tiles->setCompactPositions(compactErrorBound_);
+    entry.tiles->setSpatialOrder(spatialOrder_);
+    entry.tiles->setViewCulling(viewCulling_);
+    if (!entry.tiles->loadDirectory(dirPath, budgetBytes))
+    {
+        std::cerr << "[SceneModel] Failed to load tiles: " << dirPath.toStdString() << std::endl;
+        return -1;
+    }
+    if (replaceScene)
+        clear();
+    if (!hasOrigin_)
+    {
+        entry.tiles->getCenter(origin_);
+        hasOrigin_ = true;
+    }
+
+    entry.id = nextId_++;
+    addActors(entry);
+    entries_.push_back(std::move(entry));
+    invalidateMergedData();
+    std::cout << "[SceneModel] Added tiled model " << entries_.back().id << ": " << dirPath.toStdString() << " ("
+              << entries_.back().tiles->getTileCount() << " tiles)" << std::endl;
+    return entries_.back().id;
+}
+
+void SceneModel::removeModel(int id)
+{
+    auto it = std::find_if(entries_.begin(), entries_.end(), [id](const Entry &entry)
+                           { return entry.id == id; });
+    if (it == entries_.end())
+        return;
+    removeActors(*it);
+    entries_.erase(it);
+    if (selection_ == id)
+        selection_ = AllModels;
+    invalidateMergedData();
+    // 原点保持不变，剩余模型无需重新对齐；场景清空后由下一个模型重新确定
+    if (entries_.empty())
+        hasOrigin_ = false;
+}
+
+void SceneModel::clear()
+{
+    for (const Entry &entry : entries_)
+        removeActors(entry);
+    entries_.clear();
+    selection_ = AllModels;
+    hasOrigin_ = false;
+    invalidateMergedData();
+}
+
+void SceneModel::reAddToRenderer()
+{
+    for (const Entry &entry : entries_)
+        addActors(entry);
+}
+
+std::vector<int> SceneModel::getModelIds() const
+{
+    std::vector<int> ids;
+    ids.reserve(entries_.size());
+    for (const Entry &entry : entries_)
+        ids.push_back(entry.id);
+    return ids;
+}
+
+ModelPipelineBuilder *SceneModel::getBuilder(int id) const
+{
+    const Entry *entry = findEntry(id);
+    return entry ? entry->builder.get() : nullptr;
+}
+
+TiledModelLoader *SceneModel::getTiledModel(int id) const
+{
+    const Entry *entry = findEntry(id);
+    return entry ? entry->tiles.get() : nullptr;
+}
+
+QString SceneModel::getDisplayName(int id) const
+{
+    const Entry *entry = findEntry(id);
+    if (!entry)
+        return QString();
+    if (entry->tiles)
+        return QString("%1 (%2 tiles)")
+            .arg(QFileInfo(entry->tiles->getDirectoryPath()).fileName())
+            .arg(entry->tiles->getTileCount());
+    return QFileInfo(entry->builder->getFilePath()).fileName();
+}
+
+void SceneModel::setSelection(int id)
+{
+    selection_ = findEntry(id) ? id : AllModels;
+}
+
+int SceneModel::getActiveId() const
+{
+    if (selection_ != AllModels)
+        return selection_;
+    return entries_.empty() ? -1 : entries_.front().id;
+}
+
+std::vector<int> SceneModel::getSelectedIds() const
+{
+    if (selection_ != AllModels)
+        return {selection_};
+    return getModelIds();
+}
+
+std::vector<int> SceneModel::getTargetIds() const
+{
+    if (selection_ != AllModels)
+        return {selection_};
+    std::vector<int> ids;
+    for (const Entry &entry : entries_)
+    {
+        if (entry.visible)
+            ids.push_back(entry.id);
+    }
+    return ids;
+}
+
+void SceneModel::setVisible(int id, bool visible)
+{
+    Entry *entry = findEntry(id);
+    if (!entry || entry->visible == visible)
+        return;
+    entry->visible = visible;
+    for (vtkActor *actor : collectActors(*entry))
+    {
+        if (!visible)
+        {
+            entry->savedVisibility[actor] = actor->GetVisibility() != 0;
+            actor->VisibilityOff();
+            continue;
+        }
+        auto saved = entry->savedVisibility.find(actor);
+        actor->SetVisibility(saved == entry->savedVisibility.end() || saved->second);
+    }
+    if (visible)
+        entry->savedVisibility.clear();
+    invalidateMergedData();
+}
+
+bool SceneModel::isVisible(int id) const
+{
+    const Entry *entry = findEntry(id);
+    return entry && entry->visible;
+}
+
+void SceneModel::setColorStyle(int id, int style)
+{
+    Entry *entry = findEntry(id);
+    if (!entry)
+        return;
+    entry->colorStyle = style;
+    applyColorStyle(*entry);
+}
+
+int SceneModel::getColorStyle(int id) const
+{
+    const Entry *entry = findEntry(id);
+    return entry ? entry->colorStyle : -1;
+}
+
+bool SceneModel::setColorSource(int id, const std::string &name)
+{
+    Entry *entry = findEntry(id);
+    if (!entry)
+        return false;
+    bool applied = false;
+    for (ModelPipelineBuilder *builder : entryBuilders(*entry))
+        applied = builder->setColorSource(name) || applied;
+    if (!applied)
+        return false;
+    entry->colorSource = name;
+    applyColorStyle(*entry); // 标量范围已变化，按新范围取共享查找表
+    return true;
+}
+
+std::string SceneModel::getColorSource(int id) const
+{
+    const Entry *entry = findEntry(id);
+    return entry ? entry->colorSource : std::string();
+}
+
+std::vector<std::string> SceneModel::getColorSources(int id) const
+{
+    const Entry *entry = findEntry(id);
+    if (!entry)
+        return {};
+    std::vector<ModelPipelineBuilder *> builders = entryBuilders(*entry);
+    return builders.empty() ? std::vector<std::string>() : builders.front()->getColorSources();
+}
+
+void SceneModel::setZAxisScale(int id, double scale)
+{
+    Entry *entry = findEntry(id);
+    if (!entry)
+        return;
+    // 管线重建会替换 mapper，actor 对象保持不变；先移除再添加，保证渲染器持有最新管线
+    removeActors(*entry);
+    if (entry->tiles)
+        entry->tiles->setZAxisScale(scale);
+    else
+        entry->builder->setZAxisScale(scale);
+    addActors(*entry);
+    applyColorStyle(*entry);
+    invalidateMergedData(); // k-d 树坐标为原始坐标 − 中心，与 Z 拉伸无关，无需重建
+}
+
+void SceneModel::setCompactPositions(double errorBound)
+{
+    TRACE_SCOPE("SceneModel::setCompactPositions");
+    compactErrorBound_ = errorBound;
+    for (Entry &entry : entries_)
+    {
+        if (entry.tiles)
+            entry.tiles->setCompactPositions(errorBound);
+        else
+            entry.builder->setCompactPositions(errorBound);
+    }
+}
+
+void SceneModel::setViewCulling(bool enabled)
+{
+    viewCulling_ = enabled;
+    for (Entry &entry : entries_)
+    {
+        if (entry.tiles)
+            entry.tiles->setViewCulling(enabled);
+        else
+            entry.builder->setViewCulling(enabled);
+    }
+}
+
+vtkActor *SceneModel::getPrimaryActor(int id) const
+{
+    const Entry *entry = findEntry(id);
+    if (!entry)
+        return nullptr;
+    std::vector<ModelPipelineBuilder *> builders = entryBuilders(*entry);
+    return builders.empty() ? nullptr : primaryActor(*builders.front());
+}
+
+std::vector<vtkActor *> SceneModel::getTargetActors() const
+{
+    std::vector<vtkActor *> actors;
+    for (int id : getTargetIds())
+    {
+        for (ModelPipelineBuilder *builder : entryBuilders(*findEntry(id)))
+        {
+            if (vtkActor *actor = primaryActor(*builder))
+                actors.push_back(actor);
+        }
+    }
+    return actors;
+}
+
+vtkSmartPointer<vtkPolyData> SceneModel::getTargetPolyData()
+{
+    std::vector<int> ids = getTargetIds();
+    if (ids.empty())
+        return nullptr;
+    if (ids.size() == 1 && getBuilder(ids.front()))
+        return getBuilder(ids.front())->getProcessedPolyData();
+    if (mergedPolyData_ && mergedIds_ == ids)
+        return mergedPolyData_;
+
+    ScopedStageTimer timer("Scene.MergeTargets");
+    TRACE_SCOPE("SceneModel::getTargetPolyData");
+    auto append = vtkSmartPointer<vtkAppendPolyData>::New();
+    for (int id : ids)
+    {
+        for (ModelPipelineBuilder *builder : entryBuilders(*findEntry(id)))
+        {
+            if (auto polyData = builder->getProcessedPolyData())
+                append->AddInputData(polyData);
+        }
+    }
+    if (append->GetNumberOfInputConnections(0) == 0)
+        return nullptr; // 瓦片全部卸载
+    append->Update();
+    mergedPolyData_ = vtkSmartPointer<vtkPolyData>::New();
+    mergedPolyData_->ShallowCopy(append->GetOutput());
+    mergedIds_ = ids;
+    std::cout << "[SceneModel] Merged " << ids.size() << " models, " << mergedPolyData_->GetNumberOfPoints()
+              << " points." << std::endl;
+    return mergedPolyData_;
+}
+
+std::shared_ptr<const PointKdTree> SceneModel::getPointIndex(int id)
+{
+    Entry *entry = findEntry(id);
+    if (!entry || !entry->builder)
+        return nullptr; // 瓦片数据集不建整体索引，瓦片包围盒即其空间索引
+    if (!entry->pointIndex)
+    {
+        ScopedStageTimer timer("Scene.BuildPointIndex");
+        // 树中坐标为“原始坐标 − 中心”，Z 拉伸改变时无需重建
+        double displayToCentered[16];
+        entry->builder->getDisplayToCenteredMatrix(displayToCentered);
+        auto tree = std::make_shared<PointKdTree>();
+        if (!tree->build(entry->builder->getProcessedPolyData(), displayToCentered))
+            return nullptr;
+        entry->pointIndex = tree;
+    }
+    return entry->pointIndex;
+}
+
+void SceneModel::appendMemoryUsage(MemoryReport &report) const
+{
+    for (const Entry &entry : entries_)
+    {
+        if (entry.tiles)
+        {
+            entry.tiles->appendMemoryUsage(report);
+            continue;
+        }
+        entry.builder->appendMemoryUsage(report);
+        if (entry.pointIndex)
+        {
+            std::string owner = "Model: " + QFileInfo(entry.builder->getFilePath()).fileName().toStdString();
+            report.addBytes(owner, "point kd-tree", entry.pointIndex->getMemorySize());
+        }
+    }
+    for (const auto &item : sharedLookupTables_)
+        report.addArray("Scene", std::string("lookup table: ") + ColorMaps::styleName(std::get<0>(item.first)),
+                        item.second->GetTable());
+    if (mergedPolyData_)
+        report.addPolyData("Scene", "merged targets", mergedPolyData_);
+}
+
+std::size_t SceneModel::evictTiles(std::size_t bytesToFree, const double viewPoint[3])
+{
+    ScopedStageTimer timer("Scene.EvictTiles");
+    std::size_t freed = 0;
+    int evicted = 0;
+    for (Entry &entry : entries_)
+    {
+        if (!entry.tiles)
+            continue;
+        for (int index : entry.tiles->getEvictionOrder(viewPoint))
+        {
+            if (freed >= bytesToFree)
+                break;
+            for (vtkActor *actor : collectActors(*entry.tiles->getTileBuilder(index)))
+            {
+                renderer_->RemoveActor(actor);
+                entry.savedVisibility.erase(actor);
+            }
+            freed += entry.tiles->getTileMemorySize(index);
+            entry.tiles->evictTile(index);
+            ++evicted;
+        }
+    }
+    if (evicted > 0)
+    {
+        invalidateMergedData();
+        std::cout << "[SceneModel] Evicted " << evicted << " tiles, freed " << freed / (1024 * 1024) << " MB"
+                  << std::endl;
+    }
+    return freed;
+}
+
+int SceneModel::reloadTiles(int id, std::size_t budgetBytes, const double viewPoint[3])
+{
+    Entry *entry = findEntry(id);
+    if (!entry || !entry->tiles)
+        return 0;
+    ScopedStageTimer timer("Scene.ReloadTiles");
+    std::vector<int> order;
+    if (viewPoint)
+    {
+        order = entry->tiles->getLoadOrder(viewPoint);
+    }
+    else
+    {
+        for (int index = 0; index < entry->tiles->getTileCount(); ++index)
+        {
+            if (!entry->tiles->isTileResident(index))
+                order.push_back(index);
+        }
+    }
+
+    int reloaded = 0;
+    std::size_t loadedBytes = 0;
+    for (int index : order)
+    {
+        // 按文件头估算判断，放不下的瓦片即停止，避免读入后再被卸载
+        std::size_t estimate = entry->tiles->getTileEstimatedSize(index);
+        if (budgetBytes > 0 && loadedBytes + estimate > budgetBytes)
+            break;
+        if (!entry->tiles->reloadTile(index))
+            continue;
+        loadedBytes += estimate;
+        entry->tiles->getTileBuilder(index)->setColorSource(entry->colorSource);
+        for (vtkActor *actor : collectActors(*entry->tiles->getTileBuilder(index)))
+        {
+            if (!entry->visible)
+            {
+                entry->savedVisibility[actor] = actor->GetVisibility() != 0;
+                actor->VisibilityOff();
+            }
+            renderer_->AddActor(actor);
+        }
+        ++reloaded;
+    }
+    if (reloaded > 0)
+    {
+        applyColorStyle(*entry);
+        invalidateMergedData();
+    }
+    return reloaded;
+}
+
+SceneModel::Entry *SceneModel::findEntry(int id)
+{
+    for (Entry &entry : entries_)
+    {
+        if (entry.id == id)
+            return &entry;
+    }
+    return nullptr;
+}
+
+const SceneModel::Entry *SceneModel::findEntry(int id) const
+{
+    for (const Entry &entry : entries_)
+    {
+        if (entry.id == id)
+            return &entry;
+    }
+    return nullptr;
+}
+
+std::vector<ModelPipelineBuilder *> SceneModel::entryBuilders(const Entry &entry)
+{
+    if (entry.tiles)
+        return entry.tiles->getResidentBuilders();
+    return {entry.builder.get()};
+}
+
+std::vector<vtkActor *> SceneModel::collectActors(const Entry &entry)
+{
+    std::vector<vtkActor *> actors;
+    for (ModelPipelineBuilder *builder : entryBuilders(entry))
+    {
+        std::vector<vtkActor *> builderActors = collectActors(*builder);
+        actors.insert(actors.end(), builderActors.begin(), builderActors.end());
+    }
+    return actors;
+}
+
+vtkActor *SceneModel::primaryActor(const ModelPipelineBuilder &builder)
+{
+    if (builder.getModelType() == ModelPipelineBuilder::ModelType::OBJ)
+        return builder.getSurfaceActor();
+    return builder.getActor();
+}
+
+std::vector<vtkActor *> SceneModel::collectActors(const ModelPipelineBuilder &builder)
+{
+    std::vector<vtkActor *> actors;
+    if (builder.getModelType() == ModelPipelineBuilder::ModelType::PLY)
+    {
+        actors.push_back(builder.getActor());
+    }
+    else if (builder.getModelType() == ModelPipelineBuilder::ModelType::OBJ)
+    {
+        for (vtkActor *actor : {builder.getSurfaceActor().GetPointer(), builder.getWireframeActor().GetPointer(),
+                                builder.getPointsActor().GetPointer()})
+        {
+            if (actor)
+                actors.push_back(actor);
+        }
+    }
+    return actors;
+}
+
+void SceneModel::addActors(const Entry &entry)
+{
+    for (vtkActor *actor : collectActors(entry))
+        renderer_->AddActor(actor);
+}
+
+void SceneModel::removeActors(const Entry &entry)
+{
+    for (vtkActor *actor : collectActors(entry))
+        renderer_->RemoveActor(actor);
+}
+
+void SceneModel::applyColorStyle(const Entry &entry)
+{
+    if (entry.colorStyle < 0)
+        return; // 管线默认色带
+    for (vtkActor *actor : collectActors(entry))
+    {
+        auto mapper = vtkPolyDataMapper::SafeDownCast(actor->GetMapper());
+        if (mapper)
+            mapper->SetLookupTable(getSharedLookupTable(entry.colorStyle, mapper->GetScalarRange()));
+    }
+}
+
+// mapper 绘制时会把自身标量范围写入 LUT，范围不同的 mapper 共用一张表会使其反复修改、每帧重新映射颜色，
+// 因此按（风格, 范围）共享
+vtkSmartPointer<vtkLookupTable> SceneModel::getSharedLookupTable(int style, const double range[2])
+{
+    auto key = std::make_tuple(style, range[0], range[1]);
+    auto it = sharedLookupTables_.find(key);
+    if (it != sharedLookupTables_.end())
+        return it->second;
+    auto lut = ColorMaps::createLookupTableForStyle(style, range[0], range[1]);
+    sharedLookupTables_[key] = lut;
+    return lut;
+}
+
+void SceneModel::invalidateMergedData()
+{
+    mergedPolyData_ = nullptr;
+    mergedIds_.clear();
+}
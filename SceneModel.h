@@ -0,0 +1,264 @@
+/**
+ * @file SceneModel.h
+ * @brief 该头文件定义了 SceneModel 类，管理场景中同时显示的多个模型（如分块扫描的地形瓦片）。
+ * @details 每个模型拥有独立的 ModelPipelineBuilder 管线，以及各自的可见性、颜色风格与 Z 拉伸状态。
+ *          第一个加载的模型的中心作为场景原点，之后加载的模型统一按该原点对齐，相邻瓦片因此无缝拼接。
+ *
+ *          共享资源：
+ *          - 颜色查找表按（风格, 标量范围）缓存；elevation 标量都归一化到 0~1，因此同一风格的所有模型
+ *            共用一张 LUT，偏差着色等自定义范围各自一张。
+ *          - 点 k-d 树按模型懒构建并以 shared_ptr 共享给变化检测等分析功能，模型移除时一并释放。
+ *          - 内存报告汇总所有模型与共享资源，页面以一个全局预算检查。
+ *
+ *          瓦片数据集（一个目录下的 PLY 瓦片，见 TiledModelLoader）作为一个模型加入场景，各瓦片的 actor
+ *          随模型一起显示、隐藏与着色；超出内存预算时可按与视点的距离卸载远处瓦片。
+ *
+ *          裁剪、切面与测量作用于"目标模型"：选中单个模型时即该模型，选择全部模型时为所有可见模型，
+ *          此时使用合并后的数据副本（按需生成并缓存）。
+ */
+#pragma once
+
+#include "ModelPinelineBuilder.h"
+#include "PointKdTree.h"
+#include "TiledModelLoader.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkRenderer.h>
+#include <vtkLookupTable.h>
+#include <vtkPolyData.h>
+#include <vtkActor.h>
+#include <QString>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+class MemoryReport;
+
+/**
+ * @class SceneModel
+ * @brief 多模型场景：持有各模型的管线并负责其 actor 在渲染器中的增删，由 ThreeDimensionalDisplayPage 持有。
+ */
+class SceneModel
+{
+public:
+    /**
+     * @brief 选择全部模型时的选择 id。
+     */
+    static constexpr int AllModels = -1;
+
+    explicit SceneModel(vtkSmartPointer<vtkRenderer> renderer);
+
+    /**
+     * @brief 加载模型并添加到场景与渲染器。
+     * @param filePath 模型文件路径。
+     * @param replaceScene 为 true 时加载成功后移除其他模型，新模型成为场景原点；加载失败时场景不变。
+     * @return 新模型的 id，加载失败返回 -1。
+     */
+    int addModel(const QString &filePath, bool replaceScene = false);
+
+    /**
+     * @brief 加载目录下的 PLY 瓦片作为一个模型，参数与返回值同 addModel。
+     * @param budgetBytes 常驻瓦片的估算占用上限（见 TiledModelLoader::loadDirectory），0 表示读取全部瓦片。
+     */
+    int addTiledModel(const QString &dirPath, bool replaceScene = false, std::size_t budgetBytes = 0);
+
+    /**
+     * @brief 从场景与渲染器中移除模型，并释放其管线与空间索引。
+     */
+    void removeModel(int id);
+
+    /**
+     * @brief 移除所有模型并重置场景原点。
+     */
+    void clear();
+
+    /**
+     * @brief 渲染器清除所有图元后，重新添加所有模型的 actor。
+     */
+    void reAddToRenderer();
+
+    std::vector<int> getModelIds() const;
+    int getModelCount() const { return static_cast<int>(entries_.size()); }
+
+    /**
+     * @brief 获取模型的管线，id 不存在或为瓦片数据集时返回 nullptr。
+     */
+    ModelPipelineBuilder *getBuilder(int id) const;
+
+    /**
+     * @brief 获取瓦片数据集，id 不存在或为单文件模型时返回 nullptr。
+     */
+    TiledModelLoader *getTiledModel(int id) const;
+
+    /**
+     * @brief 模型显示名称（文件名，瓦片数据集为目录名与瓦片数）。
+     */
+    QString getDisplayName(int id) const;
+
+    // 当前选择：模型 id 或 AllModels，id 不存在时回退为 AllModels
+    void setSelection(int id);
+    int getSelection() const { return selection_; }
+
+    /**
+     * @brief 单模型功能（偏差、变化检测、体积等）使用的模型：选中的模型，选择全部时为第一个模型。
+     * @return 模型 id，场景为空时返回 -1。
+     */
+    int getActiveId() const;
+
+    /**
+     * @brief Z 拉伸、颜色风格等按模型设置的状态作用的模型：选中的模型，选择全部时为所有模型（含隐藏的）。
+     */
+    std::vector<int> getSelectedIds() const;
+
+    /**
+     * @brief 裁剪、切面、测量的目标模型：选中的模型，选择全部时为所有可见模型。
+     */
+    std::vector<int> getTargetIds() const;
+
+    // 隐藏模型时记录各 actor 的可见性，重新显示时恢复
+    void setVisible(int id, bool visible);
+    bool isVisible(int id) const;
+
+    /**
+     * @brief 设置模型的颜色风格，使用按风格共享的查找表。
+     * @param style 颜色风格（见 ColorMaps），-1 表示管线默认的高程色带。
+     */
+    void setColorStyle(int id, int style);
+    int getColorStyle(int id) const;
+
+    /**
+     * @brief 切换模型的着色来源（高程或模型自带的属性），只重新绑定 mapper，并按新范围套用颜色风格。
+     * @return 模型没有该属性时返回 false。
+     */
+    bool setColorSource(int id, const std::string &name);
+    std::string getColorSource(int id) const;
+
+    /**
+     * @brief 模型可用的着色来源（瓦片数据集取第一个已加载瓦片）。
+     */
+    std::vector<std::string> getColorSources(int id) const;
+
+    /**
+     * @brief 设置模型的 Z 轴拉伸比例并重建其管线，保持 actor 的可见性与颜色风格。
+     */
+    void setZAxisScale(int id, double scale);
+
+    /**
+     * @brief 所有模型（含之后加载的模型）原始坐标的紧凑存储误差界，<= 0 关闭；不重建管线，显示不变。
+     */
+    void setCompactPositions(double errorBound);
+    double getCompactPositions() const { return compactErrorBound_; }
+
+    /**
+     * @brief 之后加载的 PLY 点云与瓦片的点顺序（见 SpatialReorder），已加载的模型不变。
+     */
+    void setSpatialOrder(SpatialReorder::Curve curve) { spatialOrder_ = curve; }
+    SpatialReorder::Curve getSpatialOrder() const { return spatialOrder_; }
+
+    /**
+     * @brief 所有点云模型（含之后加载的模型）是否按视锥与屏幕尺寸剔除点块（见 CulledPointCloudMapper）。
+     */
+    void setViewCulling(bool enabled);
+    bool isViewCulling() const { return viewCulling_; }
+
+    /**
+     * @brief 之后加载的 OBJ 网格的顶点焊接容差（见 MeshCleaner），< 0 不清理；已加载的模型不变。
+     */
+    void setMeshCleanTolerance(double tolerance) { meshCleanTolerance_ = tolerance; }
+    double getMeshCleanTolerance() const { return meshCleanTolerance_; }
+
+    /**
+     * @brief 之后加载的 OBJ 网格的面与顶点顺序（见 MeshCacheOptimizer），已加载的模型不变。
+     */
+    void setMeshOrder(MeshCacheOptimizer::Mode mode) { meshOrder_ = mode; }
+    MeshCacheOptimizer::Mode getMeshOrder() const { return meshOrder_; }
+
+    /**
+     * @brief 模型的主 actor（PLY 为点云，OBJ 为面，瓦片数据集为第一个已加载瓦片的点云）。
+     */
+    vtkActor *getPrimaryActor(int id) const;
+
+    /**
+     * @brief 目标模型的主 actor 列表（瓦片数据集展开为各已加载瓦片），用于裁剪替换、切面隐藏与拾取。
+     */
+    std::vector<vtkActor *> getTargetActors() const;
+
+    /**
+     * @brief 目标模型的数据：单个模型直接返回其处理后数据，多个模型返回合并后的副本（缓存至目标变化）。
+     * @return 没有目标模型时返回 nullptr。
+     */
+    vtkSmartPointer<vtkPolyData> getTargetPolyData();
+
+    /**
+     * @brief 获取模型的点 k-d 树，首次调用时构建。
+     * @details 树中坐标经 ModelPipelineBuilder::getDisplayToCenteredMatrix 换算为原始坐标减去模型中心，
+     *          真实尺度且与 Z 拉伸无关，拉伸改变后仍然有效；查询点须以同一中心换算。
+     * @return 模型不存在、为瓦片数据集或没有点时返回 nullptr。
+     */
+    std::shared_ptr<const PointKdTree> getPointIndex(int id);
+
+    /**
+     * @brief 登记所有模型、共享查找表、空间索引与合并缓存的内存占用。
+     */
+    void appendMemoryUsage(MemoryReport &report) const;
+
+    /**
+     * @brief 按与视点的距离从远到近卸载瓦片，直到释放 bytesToFree 字节或没有可卸载的瓦片。
+     * @param viewPoint 显示坐标中的视点（通常为相机位置）。
+     * @return 实际释放的字节数（估算）。
+     */
+    std::size_t evictTiles(std::size_t bytesToFree, const double viewPoint[3]);
+
+    /**
+     * @brief 重新加载瓦片数据集中已卸载的瓦片，保持模型的可见性与颜色风格。
+     * @param budgetBytes 新加载瓦片的估算占用上限，0 表示加载全部已卸载的瓦片。
+     * @param viewPoint 显示坐标中的视点，有预算时从近到远加载；为空时按瓦片顺序。
+     * @return 重新加载的瓦片数。
+     */
+    int reloadTiles(int id, std::size_t budgetBytes = 0, const double viewPoint[3] = nullptr);
+
+private:
+    struct Entry
+    {
+        int id = -1;
+        std::unique_ptr<ModelPipelineBuilder> builder; // 单文件模型
+        std::unique_ptr<TiledModelLoader> tiles;       // 瓦片数据集（此时 builder 为空）
+        bool visible = true;
+        int colorStyle = -1;
+        std::string colorSource = ModelPipelineBuilder::ElevationSource;
+        std::map<vtkActor *, bool> savedVisibility; // 隐藏前各 actor 的可见性
+        std::shared_ptr<const PointKdTree> pointIndex;
+    };
+
+    Entry *findEntry(int id);
+    const Entry *findEntry(int id) const;
+    // 模型的全部管线（瓦片数据集为已加载的瓦片）
+    static std::vector<ModelPipelineBuilder *> entryBuilders(const Entry &entry);
+    // 模型的全部 actor（PLY 一个，OBJ 面/线/点三个）
+    static std::vector<vtkActor *> collectActors(const ModelPipelineBuilder &builder);
+    static std::vector<vtkActor *> collectActors(const Entry &entry);
+    static vtkActor *primaryActor(const ModelPipelineBuilder &builder);
+    void addActors(const Entry &entry);
+    void removeActors(const Entry &entry);
+    void applyColorStyle(const Entry &entry);
+    vtkSmartPointer<vtkLookupTable> getSharedLookupTable(int style, const double range[2]);
+    void invalidateMergedData();
+
+    vtkSmartPointer<vtkRenderer> renderer_;
+    std::vector<Entry> entries_;
+    int nextId_ = 0;
+    int selection_ = AllModels;
+    bool hasOrigin_ = false;
+    double origin_[3] = {0.0, 0.0, 0.0}; // 场景原点（第一个模型的中心，原始坐标）
+    double compactErrorBound_ = 0.0;     // 原始坐标紧凑存储的误差界，<= 0 表示未启用
+    SpatialReorder::Curve spatialOrder_ = SpatialReorder::Curve::None; // 加载时的点顺序
+    bool viewCulling_ = true;            // 点云是否逐帧剔除点块
+    double meshCleanTolerance_ = -1.0;   // 加载 OBJ 时的焊接容差，< 0 不清理
+    MeshCacheOptimizer::Mode meshOrder_ = MeshCacheOptimizer::Mode::None; // 加载 OBJ 时的面顺序
+
+    std::map<std::tuple<int, double, double>, vtkSmartPointer<vtkLookupTable>> sharedLookupTables_; // 按风格与范围共享
+    vtkSmartPointer<vtkPolyData> mergedPolyData_; // 多目标合并数据缓存
+    std::vector<int> mergedIds_;                  // 缓存对应的目标模型
+};
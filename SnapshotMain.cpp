@@ -0,0 +1,495 @@
+/**
+ * @file SnapshotMain.cpp
+ * @brief 批量离屏截图程序（MyAppSnapshot）。
+ * @details 复用 ModelPipelineBuilder 的加载与高程着色流程和 ColorMaps 色带，按相机预设离屏渲染每个模型并写出 PNG，
+ *          用于夜间批量生成缩略图和标准视图。离屏后端（OSMesa / EGL）由 VTK 的构建选项决定，
+ *          程序只使用 vtkRenderWindow 工厂返回的离屏窗口，不需要显示服务器。
+ *
+ *          多个模型时以进程池并行：每个模型由一个子进程（本程序的 --worker 模式）渲染，
+ *          单个模型崩溃或超时不会影响整批任务；输出已存在的模型直接跳过，中断后可原样重跑。
+ *          输出文件名为 <名称>_<视图>.png；目录输入的名称取模型相对输入目录的路径（去扩展名，分隔符换为 '_'）。
+ *
+ *          用法示例：
+ *            MyAppSnapshot /data/scans --recursive --views iso,top,front --size 512x512 --jobs 16 -o /data/thumbs
+ *            MyAppSnapshot scan.ply --views top --parallel --colormap viridis --z-scale 3
+ */
+#include "ModelPinelineBuilder.h"
+#include "ColorMaps.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QHash>
+#include <QProcess>
+#include <QThread>
+#include <QTimer>
+#include <vtkSmartPointer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkCamera.h>
+#include <vtkActor.h>
+#include <vtkProperty.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkWindowToImageFilter.h>
+#include <vtkPNGWriter.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    /**
+     * @struct CameraPreset
+     * @brief 标准视图：相机位于焦点的 direction 方向，适配模型包围盒。
+     */
+    struct CameraPreset
+    {
+        const char *name;
+        double direction[3];
+        double viewUp[3];
+    };
+
+    const CameraPreset kPresets[] = {
+        {"top", {0, 0, 1}, {0, 1, 0}},
+        {"bottom", {0, 0, -1}, {0, 1, 0}},
+        {"front", {0, -1, 0}, {0, 0, 1}},
+        {"back", {0, 1, 0}, {0, 0, 1}},
+        {"left", {-1, 0, 0}, {0, 0, 1}},
+        {"right", {1, 0, 0}, {0, 0, 1}},
+        {"iso", {1, -1, 1}, {0, 0, 1}},
+    };
+
+    const CameraPreset *findPreset(const QString &name)
+    {
+        for (const CameraPreset &preset : kPresets)
+        {
+            if (name == preset.name)
+                return &preset;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @struct SnapshotOptions
+     * @brief 截图参数，进程池模式下原样传给子进程。
+     */
+    struct SnapshotOptions
+    {
+        QDir outputDir;
+        QStringList views;
+        int width = 512;
+        int height = 512;
+        int colorStyle = -1;      ///< -1 保持 ModelPipelineBuilder 默认着色
+        double zScale = 1.0;
+        double pointSize = 1.0;
+        bool parallelProjection = false;
+        bool overwrite = false;
+    };
+
+    /**
+     * @struct ModelJob
+     * @brief 待渲染的模型及其输出文件名前缀。
+     */
+    struct ModelJob
+    {
+        QString path;
+        QString name; ///< 输出文件名前缀：目录输入为相对输入目录的路径（去扩展名，分隔符换为 '_'），文件输入为文件名
+    };
+
+    QString snapshotPath(const SnapshotOptions &options, const QString &name, const QString &view)
+    {
+        return options.outputDir.filePath(name + "_" + view + ".png");
+    }
+
+    bool allSnapshotsExist(const SnapshotOptions &options, const QString &name)
+    {
+        return std::all_of(options.views.begin(), options.views.end(), [&](const QString &view)
+                           { return QFileInfo::exists(snapshotPath(options, name, view)); });
+    }
+
+    // 相对输入目录的路径去掉扩展名，分隔符换为 '_'，递归搜索时不同子目录中的同名模型不会互相覆盖
+    QString relativeSnapshotName(const QDir &root, const QString &modelPath)
+    {
+        QFileInfo relative(root.relativeFilePath(modelPath));
+        QString name = relative.path() == "." ? relative.completeBaseName()
+                                              : relative.path() + "/" + relative.completeBaseName();
+        name.replace('/', '_');
+        name.replace('\\', '_');
+        return name;
+    }
+
+    /**
+     * @class SnapshotRenderer
+     * @brief 复用同一个离屏窗口依次渲染模型，避免每个模型重新创建 OpenGL 上下文。
+     */
+    class SnapshotRenderer
+    {
+    public:
+        explicit SnapshotRenderer(const SnapshotOptions &options)
+            : options_(options)
+        {
+            renderWindow_ = vtkSmartPointer<vtkRenderWindow>::New();
+            renderWindow_->SetOffScreenRendering(1);
+            renderWindow_->SetSize(options_.width, options_.height);
+            renderer_ = vtkSmartPointer<vtkRenderer>::New();
+            renderer_->SetBackground(0.5, 0.5, 0.5);
+            renderWindow_->AddRenderer(renderer_);
+        }
+
+        /**
+         * @brief 加载模型并写出所有视图。
+         * @return 加载或写文件失败时返回 false。
+         */
+        bool renderModel(const ModelJob &job)
+        {
+            const QString &modelPath = job.path;
+            ModelPipelineBuilder builder;
+            builder.setViewCulling(false); // 回归截图绘制全部点，不随视图剔除或抽稀
+            if (!builder.loadModel(modelPath))
+            {
+                std::cerr << "[Snapshot] Failed to load model: " << modelPath.toStdString() << std::endl;
+                return false;
+            }
+            if (options_.zScale != 1.0)
+                builder.setZAxisScale(options_.zScale);
+
+            const bool isMesh = builder.getModelType() == ModelPipelineBuilder::ModelType::OBJ;
+            vtkSmartPointer<vtkActor> actor = isMesh ? builder.getSurfaceActor() : builder.getActor();
+            auto mapper = actor ? vtkPolyDataMapper::SafeDownCast(actor->GetMapper()) : nullptr;
+            if (!mapper)
+            {
+                std::cerr << "[Snapshot] Model has no renderable data: " << modelPath.toStdString() << std::endl;
+                return false;
+            }
+            if (options_.colorStyle >= 0)
+            {
+                double *range = mapper->GetScalarRange();
+                mapper->SetLookupTable(ColorMaps::createLookupTableForStyle(options_.colorStyle, range[0], range[1]));
+            }
+            if (!isMesh)
+                actor->GetProperty()->SetPointSize(options_.pointSize);
+
+            renderer_->AddActor(actor);
+            bool ok = true;
+            for (const QString &view : options_.views)
+                ok = renderView(*findPreset(view), snapshotPath(options_, job.name, view)) && ok;
+            renderer_->RemoveAllViewProps(); // 释放模型数据，下一个模型复用窗口
+            return ok;
+        }
+
+    private:
+        bool renderView(const CameraPreset &preset, const QString &outputPath)
+        {
+            vtkCamera *camera = renderer_->GetActiveCamera();
+            camera->SetFocalPoint(0, 0, 0);
+            camera->SetPosition(preset.direction);
+            camera->SetViewUp(preset.viewUp);
+            camera->SetParallelProjection(options_.parallelProjection);
+            renderer_->ResetCamera();
+            renderWindow_->Render();
+
+            auto windowToImage = vtkSmartPointer<vtkWindowToImageFilter>::New();
+            windowToImage->SetInput(renderWindow_);
+            windowToImage->ReadFrontBufferOff();
+            windowToImage->Update();
+
+            auto writer = vtkSmartPointer<vtkPNGWriter>::New();
+            writer->SetFileName(outputPath.toStdString().c_str());
+            writer->SetInputConnection(windowToImage->GetOutputPort());
+            writer->Write();
+            if (writer->GetErrorCode() != 0)
+            {
+                std::cerr << "[Snapshot] Failed to write " << outputPath.toStdString() << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        SnapshotOptions options_;
+        vtkSmartPointer<vtkRenderWindow> renderWindow_;
+        vtkSmartPointer<vtkRenderer> renderer_;
+    };
+
+    // 展开输入：文件直接使用，目录收集其中的 PLY/OBJ
+    std::vector<ModelJob> collectModels(const QStringList &inputs, bool recursive)
+    {
+        std::vector<ModelJob> models;
+        for (const QString &input : inputs)
+        {
+            QFileInfo info(input);
+            if (info.isDir())
+            {
+                QStringList found;
+                QDirIterator it(input, {"*.ply", "*.obj", "*.PLY", "*.OBJ"}, QDir::Files,
+                                recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+                while (it.hasNext())
+                    found << it.next();
+                found.sort();
+                QDir root(input);
+                for (const QString &path : found)
+                    models.push_back({path, relativeSnapshotName(root, path)});
+            }
+            else if (info.isFile())
+            {
+                models.push_back({info.filePath(), info.completeBaseName()});
+            }
+            else
+            {
+                std::cerr << "[Snapshot] Input not found: " << input.toStdString() << std::endl;
+            }
+        }
+
+        // 多个输入中仍可能重名（如两个输入目录中的同名文件），加序号区分
+        QHash<QString, int> used;
+        for (ModelJob &job : models)
+        {
+            int count = used.value(job.name, 0);
+            used[job.name] = count + 1;
+            if (count == 0)
+                continue;
+            QString renamed = job.name + "_" + QString::number(count + 1);
+            std::cerr << "[Snapshot] Duplicate output name " << job.name.toStdString() << ", writing "
+                      << job.path.toStdString() << " as " << renamed.toStdString() << std::endl;
+            job.name = renamed;
+        }
+        return models;
+    }
+
+    /**
+     * @struct BatchResult
+     * @brief 批处理统计。
+     */
+    struct BatchResult
+    {
+        int rendered = 0;
+        int skipped = 0;
+        QStringList failed;
+    };
+
+    // 在当前进程中依次渲染
+    void runSequential(const std::vector<ModelJob> &models, const SnapshotOptions &options, BatchResult &result)
+    {
+        SnapshotRenderer renderer(options);
+        for (const ModelJob &model : models)
+        {
+            if (!options.overwrite && allSnapshotsExist(options, model.name))
+            {
+                ++result.skipped;
+                continue;
+            }
+            if (renderer.renderModel(model))
+            {
+                ++result.rendered;
+                std::cout << "[Snapshot] " << model.path.toStdString() << std::endl;
+            }
+            else
+            {
+                result.failed << model.path;
+            }
+        }
+    }
+
+    // 进程池：最多 jobs 个子进程同时运行，每个子进程渲染一个模型
+    void runProcessPool(const std::vector<ModelJob> &models, const SnapshotOptions &options,
+                        const QStringList &workerArguments, int jobs, int timeoutSeconds, BatchResult &result)
+    {
+        std::vector<ModelJob> pending;
+        for (const ModelJob &model : models)
+        {
+            if (!options.overwrite && allSnapshotsExist(options, model.name))
+                ++result.skipped;
+            else
+                pending.push_back(model);
+        }
+        if (pending.empty())
+            return;
+
+        QEventLoop loop;
+        int next = 0;
+        int running = 0;
+        std::function<void()> launch;
+        auto finish = [&](QProcess *process, const QString &model, bool ok)
+        {
+            if (ok)
+                ++result.rendered;
+            else
+                result.failed << model;
+            --running;
+            process->deleteLater();
+            launch();
+        };
+
+        launch = [&]()
+        {
+            while (running < jobs && next < static_cast<int>(pending.size()))
+            {
+                const ModelJob &job = pending[next++];
+                const QString model = job.path;
+                auto *process = new QProcess;
+                process->setProcessChannelMode(QProcess::ForwardedChannels);
+
+                if (timeoutSeconds > 0)
+                {
+                    auto *timer = new QTimer(process);
+                    timer->setSingleShot(true);
+                    QObject::connect(timer, &QTimer::timeout, process, [process, model]()
+                                     {
+                                         std::cerr << "[Snapshot] Timed out: " << model.toStdString() << std::endl;
+                                         process->kill(); });
+                    timer->start(timeoutSeconds * 1000);
+                }
+                QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                                 [&, process, model](int exitCode, QProcess::ExitStatus status)
+                                 { finish(process, model, status == QProcess::NormalExit && exitCode == 0); });
+                QObject::connect(process, &QProcess::errorOccurred, [&, process, model](QProcess::ProcessError error)
+                                 {
+                                     if (error == QProcess::FailedToStart)
+                                         finish(process, model, false); });
+
+                ++running;
+                process->start(QCoreApplication::applicationFilePath(),
+                               workerArguments + QStringList{"--name", job.name, model});
+            }
+            if (running == 0)
+                loop.quit();
+        };
+
+        // 在事件循环中启动，保证 FailedToStart 等同步信号到达时 loop 已在运行
+        QTimer::singleShot(0, &loop, [&]()
+                           { launch(); });
+        loop.exec();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("MyAppSnapshot");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Renders PLY/OBJ models offscreen to PNG for a set of camera presets.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "Model files or directories containing *.ply / *.obj.", "inputs...");
+    QCommandLineOption outputOption({"o", "output-dir"}, "Directory for PNG files.", "dir", "snapshots");
+    QCommandLineOption viewsOption("views", "Camera presets: top, bottom, front, back, left, right, iso.", "list", "iso,top");
+    QCommandLineOption sizeOption("size", "Image size WIDTHxHEIGHT.", "size", "512x512");
+    QCommandLineOption colormapOption("colormap", "jet, viridis, cooltowarm, grayscale or rainbow (default: viewer colouring).",
+                                      "name");
+    QCommandLineOption zScaleOption("z-scale", "Z axis stretch factor.", "factor", "1.0");
+    QCommandLineOption pointSizeOption("point-size", "Point size for point clouds.", "pixels", "1.0");
+    QCommandLineOption parallelOption("parallel", "Use parallel (orthographic) projection.");
+    QCommandLineOption recursiveOption("recursive", "Search input directories recursively.");
+    QCommandLineOption overwriteOption("overwrite", "Re-render models whose PNG files already exist.");
+    QCommandLineOption jobsOption("jobs", "Number of worker processes.", "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption timeoutOption("timeout", "Seconds before a worker is killed (0 = no limit).", "seconds", "600");
+    QCommandLineOption workerOption("worker", "Internal: render the given models in this process.");
+    workerOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    QCommandLineOption nameOption("name", "Internal: output file name prefix of the single worker model.", "name");
+    nameOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    parser.addOptions({outputOption, viewsOption, sizeOption, colormapOption, zScaleOption, pointSizeOption,
+                       parallelOption, recursiveOption, overwriteOption, jobsOption, timeoutOption, workerOption,
+                       nameOption});
+    parser.process(app);
+
+    if (parser.positionalArguments().isEmpty())
+        parser.showHelp(1);
+
+    SnapshotOptions options;
+    options.outputDir = QDir(parser.value(outputOption));
+    options.views = parser.value(viewsOption).split(',', QString::SkipEmptyParts);
+    for (QString &view : options.views)
+    {
+        view = view.trimmed().toLower();
+        if (!findPreset(view))
+        {
+            std::cerr << "[Snapshot] Unknown view: " << view.toStdString() << std::endl;
+            return 1;
+        }
+    }
+    QStringList size = parser.value(sizeOption).toLower().split('x');
+    options.width = size.size() == 2 ? size[0].toInt() : 0;
+    options.height = size.size() == 2 ? size[1].toInt() : 0;
+    if (options.width <= 0 || options.height <= 0 || options.views.isEmpty())
+    {
+        std::cerr << "[Snapshot] Invalid --size or --views." << std::endl;
+        return 1;
+    }
+    if (parser.isSet(colormapOption))
+    {
+        options.colorStyle = ColorMaps::styleFromName(parser.value(colormapOption).toStdString());
+        if (options.colorStyle < 0)
+        {
+            std::cerr << "[Snapshot] Unknown colormap: " << parser.value(colormapOption).toStdString() << std::endl;
+            return 1;
+        }
+    }
+    options.zScale = parser.value(zScaleOption).toDouble();
+    options.pointSize = std::max(1.0, parser.value(pointSizeOption).toDouble());
+    options.parallelProjection = parser.isSet(parallelOption);
+    options.overwrite = parser.isSet(overwriteOption);
+    if (options.zScale <= 0.0)
+        options.zScale = 1.0;
+    if (!options.outputDir.exists() && !QDir().mkpath(options.outputDir.path()))
+    {
+        std::cerr << "[Snapshot] Cannot create output directory: " << options.outputDir.path().toStdString() << std::endl;
+        return 1;
+    }
+
+    // 子进程：渲染传入的模型后退出，由父进程汇总
+    if (parser.isSet(workerOption))
+    {
+        // 输出名由父进程按输入目录确定后传入
+        std::vector<ModelJob> models;
+        for (const QString &path : parser.positionalArguments())
+            models.push_back({path, QFileInfo(path).completeBaseName()});
+        if (parser.isSet(nameOption) && models.size() == 1)
+            models.front().name = parser.value(nameOption);
+        BatchResult result;
+        runSequential(models, options, result);
+        return result.failed.isEmpty() ? 0 : 1;
+    }
+
+    std::vector<ModelJob> models = collectModels(parser.positionalArguments(), parser.isSet(recursiveOption));
+    if (models.empty())
+    {
+        std::cerr << "[Snapshot] No models to render." << std::endl;
+        return 1;
+    }
+
+    const int jobs = std::max(1, parser.value(jobsOption).toInt());
+    auto start = std::chrono::steady_clock::now();
+    BatchResult result;
+    if (jobs == 1 || models.size() == 1)
+    {
+        runSequential(models, options, result);
+    }
+    else
+    {
+        QStringList workerArguments{"--worker",
+                                    "--output-dir", options.outputDir.path(),
+                                    "--views", options.views.join(','),
+                                    "--size", QString("%1x%2").arg(options.width).arg(options.height),
+                                    "--z-scale", QString::number(options.zScale, 'g', 17),
+                                    "--point-size", QString::number(options.pointSize)};
+        if (options.colorStyle >= 0)
+            workerArguments << "--colormap" << ColorMaps::styleName(options.colorStyle);
+        if (options.parallelProjection)
+            workerArguments << "--parallel";
+        workerArguments << "--overwrite"; // 跳过判断已在父进程完成
+        runProcessPool(models, options, workerArguments, jobs, parser.value(timeoutOption).toInt(), result);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double perHour = elapsed.count() > 0.0 ? result.rendered * 3600.0 / elapsed.count() : 0.0;
+    std::cout << "[Snapshot] " << result.rendered << " rendered, " << result.skipped << " skipped, "
+              << result.failed.size() << " failed in " << elapsed.count() << " s (" << perHour
+              << " models/hour, " << jobs << " jobs)" << std::endl;
+    for (const QString &model : result.failed)
+        std::cerr << "[Snapshot] Failed: " << model.toStdString() << std::endl;
+    return result.failed.isEmpty() ? 0 : 1;
+}
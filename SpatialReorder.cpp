@@ -0,0 +1,272 @@
+#include "SpatialReorder.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+
+#include <vtkDataArray.h>
+#include <vtkCellArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkPointData.h>
+#include <vtkSMPTools.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    const int BitsPerAxis = 21;
+    const double MaxCoordinate = double((1u << BitsPerAxis) - 1);
+
+    // 21 位整数的各位之间插入两个 0
+    std::uint64_t spreadBits(std::uint32_t value)
+    {
+        std::uint64_t x = value & 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffffULL;
+        x = (x | x << 16) & 0x1f0000ff0000ffULL;
+        x = (x | x << 8) & 0x100f00f00f00f00fULL;
+        x = (x | x << 4) & 0x10c30c30c30c30c3ULL;
+        x = (x | x << 2) & 0x1249249249249249ULL;
+        return x;
+    }
+}
+
+const char *SpatialReorder::curveName(Curve curve)
+{
+    switch (curve)
+    {
+    case Curve::Morton:
+        return "Morton";
+    case Curve::Hilbert:
+        return "Hilbert";
+    default:
+        return "None";
+    }
+}
+
+std::uint64_t SpatialReorder::mortonCode(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+    return spreadBits(x) << 2 | spreadBits(y) << 1 | spreadBits(z);
+}
+
+std::uint64_t SpatialReorder::hilbertCode(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+    // Skilling 的坐标到 Hilbert 转置形式变换，转置形式按位交织即为 Hilbert 编码
+    std::uint32_t X[3] = {x, y, z};
+    const std::uint32_t M = 1u << (BitsPerAxis - 1);
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+        std::uint32_t P = Q - 1;
+        for (int i = 0; i < 3; ++i)
+        {
+            if (X[i] & Q)
+            {
+                X[0] ^= P;
+            }
+            else
+            {
+                std::uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+    for (int i = 1; i < 3; ++i)
+        X[i] ^= X[i - 1];
+    std::uint32_t t = 0;
+    for (std::uint32_t Q = M; Q > 1; Q >>= 1)
+    {
+        if (X[2] & Q)
+            t ^= Q - 1;
+    }
+    for (int i = 0; i < 3; ++i)
+        X[i] ^= t;
+    return mortonCode(X[0], X[1], X[2]);
+}
+
+std::vector<vtkIdType> SpatialReorder::computeOrder(vtkPoints *points, Curve curve)
+{
+    TRACE_SCOPE("SpatialReorder::computeOrder");
+    const vtkIdType numPoints = points ? points->GetNumberOfPoints() : 0;
+    std::vector<vtkIdType> order(static_cast<std::size_t>(numPoints));
+    for (vtkIdType i = 0; i < numPoints; ++i)
+        order[i] = i;
+    if (numPoints < 2 || curve == Curve::None)
+        return order;
+
+    // 按包围盒把坐标量化为每轴 21 位整数，各轴独立缩放
+    double bounds[6];
+    points->GetBounds(bounds);
+    double scale[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        double extent = bounds[2 * axis + 1] - bounds[2 * axis];
+        scale[axis] = extent > 0.0 ? MaxCoordinate / extent : 0.0;
+    }
+
+    std::vector<std::uint64_t> keys(static_cast<std::size_t>(numPoints));
+    {
+        ScopedStageTimer timer("Reorder.Keys");
+        vtkSMPTools::For(0, numPoints, [&](vtkIdType begin, vtkIdType end)
+                         {
+            double p[3];
+            for (vtkIdType i = begin; i < end; ++i)
+            {
+                points->GetPoint(i, p);
+                std::uint32_t q[3];
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    double v = (p[axis] - bounds[2 * axis]) * scale[axis];
+                    q[axis] = static_cast<std::uint32_t>(std::min(std::max(v, 0.0), MaxCoordinate));
+                }
+                keys[i] = curve == Curve::Hilbert ? hilbertCode(q[0], q[1], q[2]) : mortonCode(q[0], q[1], q[2]);
+            } });
+    }
+    {
+        ScopedStageTimer timer("Reorder.Sort");
+        radixSort(keys, order);
+    }
+    return order;
+}
+
+void SpatialReorder::radixSort(std::vector<std::uint64_t> &keys, std::vector<vtkIdType> &ids)
+{
+    const vtkIdType n = static_cast<vtkIdType>(keys.size());
+    // 固定分块数：每块统计直方图后按 (桶, 块) 顺序求偏移，块内顺序分发，保证稳定
+    const vtkIdType chunkCount = std::max<vtkIdType>(1, std::min<vtkIdType>(256, n / 65536));
+    const vtkIdType chunkSize = (n + chunkCount - 1) / chunkCount;
+    std::vector<std::uint64_t> keysOut(keys.size());
+    std::vector<vtkIdType> idsOut(ids.size());
+    std::vector<std::array<vtkIdType, 256>> histograms(static_cast<std::size_t>(chunkCount));
+
+    const int totalBits = 3 * BitsPerAxis;
+    for (int shift = 0; shift < totalBits; shift += 8)
+    {
+        vtkSMPTools::For(0, chunkCount, 1, [&](vtkIdType begin, vtkIdType end)
+                         {
+            for (vtkIdType c = begin; c < end; ++c)
+            {
+                std::array<vtkIdType, 256> &histogram = histograms[c];
+                histogram.fill(0);
+                const vtkIdType last = std::min(n, (c + 1) * chunkSize);
+                for (vtkIdType i = c * chunkSize; i < last; ++i)
+                    ++histogram[(keys[i] >> shift) & 0xff];
+            } });
+
+        // 所有键在这一字节上相同时跳过本趟
+        bool skip = false;
+        for (int digit = 0; digit < 256 && !skip; ++digit)
+        {
+            vtkIdType total = 0;
+            for (const auto &histogram : histograms)
+                total += histogram[digit];
+            skip = total == n;
+        }
+        if (skip)
+            continue;
+
+        vtkIdType offset = 0;
+        for (int digit = 0; digit < 256; ++digit)
+        {
+            for (auto &histogram : histograms)
+            {
+                vtkIdType count = histogram[digit];
+                histogram[digit] = offset;
+                offset += count;
+            }
+        }
+
+        vtkSMPTools::For(0, chunkCount, 1, [&](vtkIdType begin, vtkIdType end)
+                         {
+            for (vtkIdType c = begin; c < end; ++c)
+            {
+                std::array<vtkIdType, 256> &cursor = histograms[c];
+                const vtkIdType last = std::min(n, (c + 1) * chunkSize);
+                for (vtkIdType i = c * chunkSize; i < last; ++i)
+                {
+                    vtkIdType target = cursor[(keys[i] >> shift) & 0xff]++;
+                    keysOut[target] = keys[i];
+                    idsOut[target] = ids[i];
+                }
+            } });
+        keys.swap(keysOut);
+        ids.swap(idsOut);
+    }
+}
+
+vtkSmartPointer<vtkDataArray> SpatialReorder::gatherArray(vtkDataArray *array, const std::vector<vtkIdType> &ids)
+{
+    auto output = vtkSmartPointer<vtkDataArray>::Take(array->NewInstance());
+    output->SetName(array->GetName());
+    output->SetNumberOfComponents(array->GetNumberOfComponents());
+    output->SetNumberOfTuples(static_cast<vtkIdType>(ids.size()));
+    // 数组为连续存储（AOS），按元组字节复制
+    const std::size_t tupleBytes = static_cast<std::size_t>(array->GetNumberOfComponents()) * array->GetDataTypeSize();
+    const char *source = static_cast<const char *>(array->GetVoidPointer(0));
+    char *target = static_cast<char *>(output->GetVoidPointer(0));
+    vtkSMPTools::For(0, static_cast<vtkIdType>(ids.size()), [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType i = begin; i < end; ++i)
+            std::memcpy(target + static_cast<std::size_t>(i) * tupleBytes,
+                        source + static_cast<std::size_t>(ids[i]) * tupleBytes, tupleBytes); });
+    return output;
+}
+
+vtkSmartPointer<vtkPolyData> SpatialReorder::gatherPoints(vtkPolyData *input, const std::vector<vtkIdType> &ids)
+{
+    auto output = vtkSmartPointer<vtkPolyData>::New();
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetData(gatherArray(input->GetPoints()->GetData(), ids));
+    output->SetPoints(points);
+
+    vtkPointData *inputData = input->GetPointData();
+    vtkPointData *outputData = output->GetPointData();
+    for (int i = 0; i < inputData->GetNumberOfArrays(); ++i)
+    {
+        if (vtkDataArray *array = inputData->GetArray(i))
+            outputData->AddArray(gatherArray(array, ids));
+    }
+    // 保留法向、标量等属性指定
+    for (int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attribute)
+    {
+        vtkDataArray *array = inputData->GetAttribute(attribute);
+        if (array && array->GetName())
+            outputData->SetActiveAttribute(array->GetName(), attribute);
+    }
+    return output;
+}
+
+void SpatialReorder::addVertexCells(vtkPolyData *polyData)
+{
+    // 每个点一个顶点单元：[1, id]
+    const vtkIdType count = polyData->GetNumberOfPoints();
+    auto connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity->SetNumberOfValues(2 * count);
+    vtkIdType *cells = connectivity->GetPointer(0);
+    vtkSMPTools::For(0, count, [&](vtkIdType begin, vtkIdType end)
+                     {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+            cells[2 * i] = 1;
+            cells[2 * i + 1] = i;
+        } });
+    auto verts = vtkSmartPointer<vtkCellArray>::New();
+    verts->SetCells(count, connectivity);
+    polyData->SetVerts(verts);
+}
+
+bool SpatialReorder::reorder(vtkPolyData *polyData, Curve curve)
+{
+    TRACE_SCOPE("SpatialReorder::reorder");
+    if (curve == Curve::None || !polyData || !polyData->GetPoints() || polyData->GetNumberOfPoints() == 0 ||
+        polyData->GetNumberOfCells() > 0)
+        return false;
+
+    ScopedStageTimer timer("Load.Reorder");
+    std::vector<vtkIdType> order = computeOrder(polyData->GetPoints(), curve);
+    vtkSmartPointer<vtkPolyData> sorted = gatherPoints(polyData, order);
+    polyData->SetPoints(sorted->GetPoints());
+    polyData->GetPointData()->ShallowCopy(sorted->GetPointData());
+    std::cout << "[SpatialReorder] Reordered " << polyData->GetNumberOfPoints() << " points along the "
+              << curveName(curve) << " curve" << std::endl;
+    return true;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file SpatialReorder.h
+ * @brief 该头文件定义了 SpatialReorder 类，沿空间填充曲线重排点云的点与属性。
+ * @details 扫描仪按采集顺序写出点，空间相邻的点在内存中相距很远，箱体裁剪、切片、拾取与邻域查询都会频繁缓存未命中。
+ *          加载后按包围盒把坐标量化为每轴 21 位整数，计算 63 位 Morton（Z 序）或 Hilbert 曲线编码，
+ *          用并行 LSD 基数排序（每趟 8 位，并行统计直方图、按块稳定分发）得到新顺序，再重排坐标与全部点属性。
+ *
+ *          Hilbert 曲线相邻编码的点总是空间相邻，块包围盒比 Morton 更紧；Morton 编码计算更快。
+ *          重排后按顺序切分的定长块即为隐式空间索引（见 PointBlockIndex）。
+ *          只处理没有单元的点云（网格的单元引用点号，重排需同时改写拓扑）。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <cstdint>
+#include <vector>
+
+class vtkDataArray;
+
+/**
+ * @class SpatialReorder
+ * @brief 点云空间重排。
+ */
+class SpatialReorder
+{
+public:
+    enum class Curve
+    {
+        None,    ///< 保持采集顺序
+        Morton,  ///< Z 序曲线
+        Hilbert  ///< Hilbert 曲线
+    };
+
+    static const char *curveName(Curve curve);
+
+    /**
+     * @brief 计算沿曲线的点顺序：返回的 order[i] 为新顺序中第 i 个点的原点号。
+     */
+    static std::vector<vtkIdType> computeOrder(vtkPoints *points, Curve curve);
+
+    /**
+     * @brief 原地重排点云的坐标与全部点属性（保留法向、标量等属性指定）。
+     * @return 数据含单元、没有点或 curve 为 None 时不修改并返回 false。
+     */
+    static bool reorder(vtkPolyData *polyData, Curve curve);
+
+    /**
+     * @brief 按点号列表取出坐标与全部点属性组成新的点云（不含单元），用于重排与裁剪结果。
+     */
+    static vtkSmartPointer<vtkPolyData> gatherPoints(vtkPolyData *input, const std::vector<vtkIdType> &ids);
+
+    /**
+     * @brief 为每个点设置一个顶点单元（与 vtkVertexGlyphFilter 的输出相同），使点云可直接绘制。
+     */
+    static void addVertexCells(vtkPolyData *polyData);
+
+    /**
+     * @brief 按点号列表并行复制数组的元组（同类型、同分量数）。
+     */
+    static vtkSmartPointer<vtkDataArray> gatherArray(vtkDataArray *array, const std::vector<vtkIdType> &ids);
+
+private:
+    // 每轴 21 位坐标交织为 63 位编码
+    static std::uint64_t mortonCode(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+    static std::uint64_t hilbertCode(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+    // 按 keys 稳定排序 ids（并行 LSD 基数排序）
+    static void radixSort(std::vector<std::uint64_t> &keys, std::vector<vtkIdType> &ids);
+};
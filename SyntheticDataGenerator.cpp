@@ -0,0 +1,154 @@
+#include "SyntheticDataGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // 每块写出的点数
+    constexpr std::int64_t kChunkPoints = 1 << 20;
+
+    std::uint64_t splitMix64(std::uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    bool isLittleEndian()
+    {
+        const std::uint16_t probe = 1;
+        return *reinterpret_cast<const std::uint8_t *>(&probe) == 1;
+    }
+}
+
+SyntheticDataGenerator::SyntheticDataGenerator(const TerrainOptions &options)
+    : options_(options)
+{
+    options_.pointCount = std::max<std::int64_t>(options_.pointCount, 4);
+    columns_ = static_cast<std::int64_t>(std::ceil(std::sqrt(static_cast<double>(options_.pointCount))));
+    meshRows_ = std::max<std::int64_t>(2, options_.pointCount / columns_);
+}
+
+double SyntheticDataGenerator::random01(std::uint64_t key) const
+{
+    return (splitMix64(key ^ options_.seed) >> 11) * (1.0 / 9007199254740992.0); // 53 位尾数
+}
+
+double SyntheticDataGenerator::heightAt(double x, double y) const
+{
+    const double a = options_.amplitude;
+    // 大尺度起伏 + 中尺度山脊
+    double h = 0.50 * a * std::sin(0.013 * x) * std::cos(0.011 * y) +
+               0.25 * a * std::sin(0.041 * x + 0.7) * std::sin(0.037 * y + 1.3) +
+               0.10 * a * std::sin(0.11 * (x + y));
+    // 小尺度粗糙度：按格网单元的确定性噪声；负坐标的单元号为负，先转为有符号整数再按位转为无符号参与哈希
+    auto cx = static_cast<std::uint64_t>(static_cast<std::int64_t>(std::floor(x / options_.spacing)));
+    auto cy = static_cast<std::uint64_t>(static_cast<std::int64_t>(std::floor(y / options_.spacing)));
+    h += 0.02 * a * (random01(cx * 0x100000001B3ull + cy) - 0.5);
+    return h;
+}
+
+bool SyntheticDataGenerator::writePointCloudPly(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[SyntheticDataGenerator] Cannot open file for writing: " << path << std::endl;
+        return false;
+    }
+
+    out << "ply\n"
+        << "format " << (isLittleEndian() ? "binary_little_endian" : "binary_big_endian") << " 1.0\n"
+        << "comment synthetic terrain seed " << options_.seed << "\n"
+        << "element vertex " << options_.pointCount << "\n"
+        << "property float x\nproperty float y\nproperty float z\n"
+        << "end_header\n";
+
+    std::vector<float> chunk;
+    chunk.reserve(static_cast<std::size_t>(kChunkPoints) * 3);
+    for (std::int64_t begin = 0; begin < options_.pointCount; begin += kChunkPoints)
+    {
+        std::int64_t end = std::min(options_.pointCount, begin + kChunkPoints);
+        chunk.clear();
+        for (std::int64_t i = begin; i < end; ++i)
+        {
+            // 格网位置加半个间距以内的抖动，模拟扫描点分布
+            std::int64_t gx = i % columns_;
+            std::int64_t gy = i / columns_;
+            double x = (gx + random01(2 * i) - 0.5) * options_.spacing;
+            double y = (gy + random01(2 * i + 1) - 0.5) * options_.spacing;
+            chunk.push_back(static_cast<float>(x));
+            chunk.push_back(static_cast<float>(y));
+            chunk.push_back(static_cast<float>(heightAt(x, y)));
+        }
+        out.write(reinterpret_cast<const char *>(chunk.data()), static_cast<std::streamsize>(chunk.size() * sizeof(float)));
+        if (!out)
+        {
+            std::cerr << "[SyntheticDataGenerator] Write failed: " << path << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SyntheticDataGenerator::writeMeshObj(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[SyntheticDataGenerator] Cannot open file for writing: " << path << std::endl;
+        return false;
+    }
+
+    out << "# synthetic terrain seed " << options_.seed << ", " << columns_ << " x " << meshRows_ << " vertices\n";
+
+    std::string chunk;
+    char line[96];
+    auto flush = [&]()
+    {
+        out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        chunk.clear();
+        return static_cast<bool>(out);
+    };
+
+    // 顶点
+    const std::int64_t vertexCount = getMeshVertexCount();
+    for (std::int64_t i = 0; i < vertexCount; ++i)
+    {
+        double x = (i % columns_) * options_.spacing;
+        double y = (i / columns_) * options_.spacing;
+        int n = std::snprintf(line, sizeof(line), "v %.4f %.4f %.4f\n", x, y, heightAt(x, y));
+        chunk.append(line, static_cast<std::size_t>(n));
+        if (chunk.size() > (1u << 24) && !flush())
+            break;
+    }
+
+    // 每个格网单元两个三角形（OBJ 索引从 1 开始）
+    for (std::int64_t row = 0; row + 1 < meshRows_ && out; ++row)
+    {
+        for (std::int64_t col = 0; col + 1 < columns_; ++col)
+        {
+            long long a = row * columns_ + col + 1;
+            long long b = a + 1;
+            long long c = a + columns_;
+            long long d = c + 1;
+            int n = std::snprintf(line, sizeof(line), "f %lld %lld %lld\nf %lld %lld %lld\n", a, b, d, a, d, c);
+            chunk.append(line, static_cast<std::size_t>(n));
+        }
+        if (chunk.size() > (1u << 24) && !flush())
+            break;
+    }
+
+    if (!flush())
+    {
+        std::cerr << "[SyntheticDataGenerator] Write failed: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file SyntheticDataGenerator.h
+ * @brief 该头文件定义了 SyntheticDataGenerator 类，生成任意规模的合成地形点云与网格，供基准测试使用。
+ * @details 地形高度由若干正弦波叠加确定性噪声构成，同一组参数总是生成相同的数据。点云按格网加抖动排列，
+ *          写为二进制 PLY；网格为规则格网三角化，写为 OBJ。写文件时按块流式输出，内存占用与规模无关，
+ *          可以生成 10 亿点级别的数据。
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct TerrainOptions
+ * @brief 合成地形参数。
+ */
+struct TerrainOptions
+{
+    std::int64_t pointCount = 1000000; ///< 目标点数（网格为顶点数，按整行取整）
+    double spacing = 0.5;              ///< 格网间距
+    double amplitude = 25.0;           ///< 地形起伏幅度
+    std::uint64_t seed = 20250523;     ///< 噪声与抖动的随机种子
+};
+
+/**
+ * @class SyntheticDataGenerator
+ * @brief 合成地形生成器，与界面和渲染器无关。
+ */
+class SyntheticDataGenerator
+{
+public:
+    explicit SyntheticDataGenerator(const TerrainOptions &options);
+
+    /**
+     * @brief 地形在 (x, y) 处的高度。
+     */
+    double heightAt(double x, double y) const;
+
+    /**
+     * @brief 生成点云并写为二进制 PLY（float x y z）。
+     * @return 文件无法写入时返回 false。
+     */
+    bool writePointCloudPly(const std::string &path) const;
+
+    /**
+     * @brief 生成规则格网三角网格并写为 OBJ。
+     * @return 文件无法写入时返回 false。
+     */
+    bool writeMeshObj(const std::string &path) const;
+
+    // 网格的列数与行数（顶点数 = 列数 * 行数）
+    std::int64_t getMeshColumns() const { return columns_; }
+    std::int64_t getMeshRows() const { return meshRows_; }
+    std::int64_t getMeshVertexCount() const { return columns_ * meshRows_; }
+
+private:
+    // 由整数键生成 [0, 1) 的确定性随机数
+    double random01(std::uint64_t key) const;
+
+    TerrainOptions options_;
+    std::int64_t columns_ = 0;  ///< 每行点数
+    std::int64_t meshRows_ = 0; ///< 网格行数（至少 2 行）
+};
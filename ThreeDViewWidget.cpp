@@ -8,6 +8,10 @@
 #include <QDoubleValidator>
 #include <QSlider>
 #include <QMouseEvent>
+#include <QMenu>
+#include <QInputDialog>
+#include <QProgressDialog>
+#include <QSignalBlocker>
 #include <iostream>
 #include <sstream>
 #include <vtkActor.h>
@@ -21,11 +25,14 @@
 #include <vtkProperty.h>
 #include <vtkRenderWindow.h>
 #include <array>
+#include <algorithm>
+#include <cmath>
 #include <vtkPLYReader.h>
 #include <vtkOBJReader.h>
 #include <vtkTIFFReader.h>
 #include <vtkImageDataGeometryFilter.h>
 #include <vtkTransform.h>
+#include <vtkMatrix4x4.h>
 #include <vtkVertexGlyphFilter.h>
 #include <vtkFeatureEdges.h>
 #include <vtkInteractorStyleTrackballCamera.h>
@@ -41,6 +48,11 @@
 #include <vtkProperty2D.h>
 #include <vtkTransformFilter.h>
 #include <vtkCubeSource.h>
+#include <vtkPointData.h>
+#include "TraceRecorder.h"
+#include "ColorMaps.h"
+#include "TiledScreenshotExporter.h"
+#include "ModelProbe.h"
 
 #include <vtkAutoInit.h>
 VTK_MODULE_INIT(vtkRenderingOpenGL2);
@@ -75,8 +87,14 @@ ThreeDimensionalDisplayPage::ThreeDimensionalDisplayPage(QWidget *parent)
     current_color_style = 0;       // 0:Jet, 1:Viridis, 2:CoolWarm, 3:Grayscale, 4:Rainbow
     current_scalar_range[0] = 0.0; // 最小值
     current_scalar_range[1] = 1.0; // 最大值
+    deviation_enabled_ = false;
+    deviationHistogramWidget_ = nullptr;
+    change_enabled_ = false;
+    changeMethod_ = CloudChangeDetector::Method::NearestNeighbour;
+    change_scalar_range_[0] = 0.0;
+    change_scalar_range_[1] = 1.0;
 
-    model_pinpeline_builder_ = std::make_unique<ModelPipelineBuilder>();
+    model_pinpeline_builder_ = &emptyBuilder_;
 
     main_layout_ = new QVBoxLayout();
     this->setLayout(main_layout_);
@@ -116,26 +134,43 @@ ThreeDimensionalDisplayPage::ThreeDimensionalDisplayPage(QWidget *parent)
     m_pScene->SetRenderWindow(renderWindow_);
     interactor_ = m_pScene->GetInteractor();
     renderWindow_->SetInteractor(interactor_);
+    renderScheduler_ = new RenderScheduler(renderWindow_, this);
+    sceneModel_ = std::make_unique<SceneModel>(renderer_);
+    performanceHud_ = std::make_unique<PerformanceHud>(renderer_, renderWindow_, renderScheduler_);
+    pointBudget_ = std::make_unique<PointBudgetController>(renderer_, renderScheduler_);
     addCoordinateAxes();
 
     // 创建比例尺控制器
     scaleBarController_ = std::make_unique<ScaleBarController>(renderer_, renderWindow_, interactor_);
+    scaleBarController_->SetRenderScheduler(renderScheduler_);
     // 启动交互器
     interactor_->Initialize();
     // 切面图
     meshSliceController_ = std::make_unique<MeshSliceController>(renderer_);
+    meshSliceController_->SetRenderScheduler(renderScheduler_);
     meshSliceController_->SetOriginalActor(testActor);
     meshSliceController_->UpdatePolyData(cylinderSource->GetOutput()); // 传入最终用于渲染的 polydata
     // 初始化箱形剪控制器
     boxClipper_ = std::make_unique<BoxClipperController>(interactor_, renderer_);
+    boxClipper_->SetRenderScheduler(renderScheduler_);
+    boxClipper_->SetInteractionRecorder(&interactionRecorder_);
     boxClipper_enabled_ = false;
     boxClipper_->SetInputDataAndReplaceOriginal(cylinderSource->GetOutput(), testActor);
     // 初始化测量控制器
     measurementController_ = std::make_unique<MeasurementController>(renderer_, interactor_);
+    measurementController_->setRenderScheduler(renderScheduler_);
+    // 录制交互时，每帧渲染前检查相机是否变化（旋转、平移、缩放都会触发渲染）
+    cameraRecordCallback_ = vtkSmartPointer<vtkCallbackCommand>::New();
+    cameraRecordCallback_->SetClientData(this);
+    cameraRecordCallback_->SetCallback([](vtkObject *, unsigned long, void *clientData, void *)
+                                       {
+        auto self = static_cast<ThreeDimensionalDisplayPage *>(clientData);
+        self->interactionRecorder_.recordCameraIfChanged(self->renderer_->GetActiveCamera()); });
+    renderer_->AddObserver(vtkCommand::StartEvent, cameraRecordCallback_);
     initSelectFilePath();
     initControlBtn();
     initMeasurementMenu();
-    renderWindow_->Render();
+    renderScheduler_->requestRender();
 }
 
 ThreeDimensionalDisplayPage::~ThreeDimensionalDisplayPage()
@@ -155,12 +190,73 @@ void ThreeDimensionalDisplayPage::initSelectFilePath()
     file_select_button->setToolTip("Select file path"); // 原：选择文件路径
     select_file_path_layout->addWidget(file_select_button);
 
+    QPushButton *folder_select_button = new QPushButton("Select Folder");
+    folder_select_button->setToolTip("Load a folder of PLY tiles as one model"); // 瓦片数据集
+    select_file_path_layout->addWidget(folder_select_button);
+
+    // 点云加载后的点顺序：沿空间填充曲线重排可加速箱体裁剪与拾取，对之后加载的模型生效
+    select_file_path_layout->addWidget(new QLabel("Point order:"));
+    QComboBox *point_order_combo = new QComboBox();
+    point_order_combo->addItem("Acquisition", static_cast<int>(SpatialReorder::Curve::None));
+    point_order_combo->addItem("Morton", static_cast<int>(SpatialReorder::Curve::Morton));
+    point_order_combo->addItem("Hilbert", static_cast<int>(SpatialReorder::Curve::Hilbert));
+    point_order_combo->setToolTip("Reorder point clouds along a space-filling curve when loading");
+    select_file_path_layout->addWidget(point_order_combo);
+
+    // OBJ 网格加载后焊接纹理接缝处的重复顶点并去掉退化 / 重复面，对之后加载的模型生效
+    select_file_path_layout->addWidget(new QLabel("OBJ weld:"));
+    QComboBox *mesh_weld_combo = new QComboBox();
+    mesh_weld_combo->addItem("Off", -1.0);
+    mesh_weld_combo->addItem("Exact", 0.0);
+    mesh_weld_combo->addItem("0.001", 0.001);
+    mesh_weld_combo->addItem("0.01", 0.01);
+    mesh_weld_combo->setToolTip("Merge duplicate vertices within the tolerance and drop degenerate or duplicate faces when loading OBJ meshes");
+    select_file_path_layout->addWidget(mesh_weld_combo);
+
+    // OBJ 网格按 GPU 顶点缓存（可选兼顾过度绘制）重排面与顶点，对之后加载的模型生效
+    select_file_path_layout->addWidget(new QLabel("OBJ order:"));
+    QComboBox *mesh_order_combo = new QComboBox();
+    mesh_order_combo->addItem("File", static_cast<int>(MeshCacheOptimizer::Mode::None));
+    mesh_order_combo->addItem("Vertex cache", static_cast<int>(MeshCacheOptimizer::Mode::VertexCache));
+    mesh_order_combo->addItem("Overdraw", static_cast<int>(MeshCacheOptimizer::Mode::Overdraw));
+    mesh_order_combo->setToolTip("Reorder OBJ triangles and vertices for the GPU vertex cache when loading");
+    select_file_path_layout->addWidget(mesh_order_combo);
+
     file_path_edit_ = new QLineEdit();
     file_path_edit_->setPlaceholderText("Select file to load"); // 原：请选择加载文件路径
     select_file_path_layout->addWidget(file_path_edit_);
+
+    // 多模型场景：追加模型、选择当前模型、显隐与移除
+    QPushButton *add_model_button = new QPushButton("Add");
+    add_model_button->setToolTip("Add models to the scene"); // 追加模型（如相邻的地形瓦片）
+    select_file_path_layout->addWidget(add_model_button);
+    model_combo_ = new QComboBox();
+    model_combo_->setMinimumWidth(160);
+    select_file_path_layout->addWidget(model_combo_);
+    model_visible_btn_ = new QPushButton("Hide Model");
+    select_file_path_layout->addWidget(model_visible_btn_);
+    QPushButton *remove_model_button = new QPushButton("Remove");
+    select_file_path_layout->addWidget(remove_model_button);
     main_layout_->addLayout(select_file_path_layout);
+    refreshModelList();
 
     connect(file_select_button, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::SlotFileSelectBtnClicked);
+    connect(folder_select_button, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::SlotFolderSelectBtnClicked);
+    connect(point_order_combo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this, point_order_combo](int index)
+            { sceneModel_->setSpatialOrder(static_cast<SpatialReorder::Curve>(point_order_combo->itemData(index).toInt())); });
+    connect(mesh_weld_combo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this, mesh_weld_combo](int index)
+            { sceneModel_->setMeshCleanTolerance(mesh_weld_combo->itemData(index).toDouble()); });
+    connect(mesh_order_combo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this, mesh_order_combo](int index)
+            { sceneModel_->setMeshOrder(static_cast<MeshCacheOptimizer::Mode>(mesh_order_combo->itemData(index).toInt())); });
+    connect(add_model_button, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::SlotAddModelBtnClicked);
+    connect(model_combo_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index)
+            {
+        if (index < 0)
+            return;
+        sceneModel_->setSelection(model_combo_->itemData(index).toInt());
+        applyModelSelection(); });
+    connect(model_visible_btn_, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::toggleSelectedModelVisibility);
+    connect(remove_model_button, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::removeSelectedModel);
 }
 
 void ThreeDimensionalDisplayPage::initControlBtn()
@@ -216,6 +312,12 @@ void ThreeDimensionalDisplayPage::initControlBtn()
     QPushButton *rainbow_btn = new QPushButton("Rainbow");
     control_btn_layout->addWidget(rainbow_btn);
 
+    // 着色来源：高程或模型自带的属性（RGB、强度、分类等），切换时只重新绑定 mapper
+    control_btn_layout->addWidget(new QLabel("Color by:"));
+    color_source_combo_ = new QComboBox();
+    color_source_combo_->setMinimumWidth(120);
+    control_btn_layout->addWidget(color_source_combo_);
+
     // 第二排按钮 控制切面图显示
     QHBoxLayout *control_btn_layout_2 = new QHBoxLayout();
     main_layout_->addLayout(control_btn_layout_2);
@@ -246,20 +348,164 @@ void ThreeDimensionalDisplayPage::initControlBtn()
     measurement_btn_ = new QPushButton("measurement");
     control_btn_layout_2->addWidget(measurement_btn_);
 
+    // 体积计算按钮（下拉选择参考面）
+    volume_btn_ = new QPushButton("volume");
+    QMenu *volume_menu = new QMenu(volume_btn_);
+    volume_menu->addAction("Against picked plane", this, [this]()
+                           { computeVolume(VolumeCalculator::ReferenceType::Plane); });
+    volume_menu->addAction("Against fitted base", this, [this]()
+                           { computeVolume(VolumeCalculator::ReferenceType::FittedPlane); });
+    volume_menu->addAction("Against second model...", this, [this]()
+                           { computeVolume(VolumeCalculator::ReferenceType::Surface); });
+    volume_btn_->setMenu(volume_menu);
+    control_btn_layout_2->addWidget(volume_btn_);
+
+    // 偏差热力图按钮（点云对比参考网格）
+    deviation_btn_ = new QPushButton("deviation");
+    control_btn_layout_2->addWidget(deviation_btn_);
+    connect(deviation_btn_, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::toggleDeviation);
+
+    // 两期点云变化检测按钮（当前点云为参考，比较点云在首次计算时选择）
+    change_btn_ = new QPushButton("change");
+    QMenu *change_menu = new QMenu(change_btn_);
+    change_menu->addAction("Nearest neighbour distance", this, [this]()
+                           { computeChange(CloudChangeDetector::Method::NearestNeighbour); });
+    change_menu->addAction("Local plane distance (M3C2)", this, [this]()
+                           { computeChange(CloudChangeDetector::Method::LocalPlane); });
+    change_menu->addAction("Export change field...", this, &ThreeDimensionalDisplayPage::exportChange);
+    change_menu->addAction("Clear comparison", this, [this]()
+                           {
+        clearChange();
+        renderScheduler_->requestRender(); });
+    change_btn_->setMenu(change_menu);
+    control_btn_layout_2->addWidget(change_btn_);
+
+    // 性能叠加层开关
+    perf_btn_ = new QPushButton("perf");
+    perf_btn_->setCheckable(true);
+    control_btn_layout_2->addWidget(perf_btn_);
+    connect(perf_btn_, &QPushButton::toggled, this, [this](bool checked)
+            { performanceHud_->SetVisible(checked); });
+
+    // 点云按视锥与屏幕尺寸剔除点块（默认开启），关闭时绘制全部点便于对比
+    QPushButton *cull_btn = new QPushButton("cull");
+    cull_btn->setCheckable(true);
+    cull_btn->setChecked(true);
+    cull_btn->setToolTip("Skip point blocks outside the view and thin blocks covering few pixels");
+    control_btn_layout_2->addWidget(cull_btn);
+    connect(cull_btn, &QPushButton::toggled, this, [this](bool checked)
+            {
+        sceneModel_->setViewCulling(checked);
+        renderScheduler_->requestRender(); });
+
+    // 每帧点数预算（百万点），留空或 0 关闭；相机静止后逐帧细化到完整细节
+    control_btn_layout_2->addWidget(new QLabel("Budget (M pts):"));
+    QLineEdit *budget_edit = new QLineEdit();
+    budget_edit->setPlaceholderText("off");
+    budget_edit->setFixedWidth(60);
+    auto *budget_validator = new QDoubleValidator(0.0, 1000.0, 2, budget_edit);
+    budget_validator->setNotation(QDoubleValidator::StandardNotation);
+    budget_edit->setValidator(budget_validator);
+    budget_edit->setToolTip("Points drawn per frame while interacting; refines to full detail when idle");
+    control_btn_layout_2->addWidget(budget_edit);
+    connect(budget_edit, &QLineEdit::editingFinished, this, [this, budget_edit]()
+            { pointBudget_->setBudget(static_cast<vtkIdType>(budget_edit->text().toDouble() * 1e6)); });
+
+    // 轨迹录制开关：停止时选择保存位置
+    trace_btn_ = new QPushButton("trace");
+    trace_btn_->setCheckable(true);
+    control_btn_layout_2->addWidget(trace_btn_);
+    connect(trace_btn_, &QPushButton::toggled, this, [this](bool checked)
+            {
+        TraceRecorder &recorder = TraceRecorder::instance();
+        if (checked)
+        {
+            recorder.start();
+            trace_btn_->setText("stop trace");
+            return;
+        }
+        recorder.stop();
+        trace_btn_->setText("trace");
+        QString path = QFileDialog::getSaveFileName(this, "Save trace", "trace.json", "Chrome Trace (*.json)");
+        if (path.isEmpty())
+            return;
+        if (!recorder.writeJson(path.toStdString()))
+            QMessageBox::warning(this, "Trace", "Failed to write trace file."); });
+
+    // 内存报告：查看各模块占用、设置预算
+    memory_btn_ = new QPushButton("memory");
+    QMenu *memory_menu = new QMenu(memory_btn_);
+    connect(memory_menu->addAction("Show report"), &QAction::triggered, this, [this]()
+            { showMemoryReport(); });
+    connect(memory_menu->addAction("Set budget..."), &QAction::triggered, this, [this]()
+            {
+        bool ok = false;
+        int budget = QInputDialog::getInt(this, "Memory budget", "Budget in MB (0 = unlimited):", memory_budget_mb_, 0,
+                                          1024 * 1024, 256, &ok);
+        if (!ok)
+            return;
+        memory_budget_mb_ = budget;
+        checkMemoryBudget(); });
+    connect(memory_menu->addAction("Reload evicted tiles"), &QAction::triggered, this, [this]()
+            {
+        // 从相机由近到远加载，估算占用超出剩余预算的瓦片保持卸载
+        double cameraPosition[3];
+        renderer_->GetActiveCamera()->GetPosition(cameraPosition);
+        int reloaded = 0;
+        for (int id : sceneModel_->getModelIds())
+            reloaded += sceneModel_->reloadTiles(id, availableTileBudget(false), cameraPosition);
+        if (reloaded == 0)
+            return;
+        qDebug() << "[ThreeDimensionalDisplayPage] Reloaded" << reloaded << "tiles";
+        applyModelSelection();
+        checkMemoryBudget(); });
+    QAction *compact_action = memory_menu->addAction("Compact original positions (1 mm)");
+    compact_action->setCheckable(true);
+    connect(compact_action, &QAction::toggled, this, [this](bool checked)
+            {
+        // 原始坐标只在重建管线时使用，量化存储不改变显示
+        sceneModel_->setCompactPositions(checked ? 0.001 : 0.0);
+        checkMemoryBudget(); });
+    memory_btn_->setMenu(memory_menu);
+    control_btn_layout_2->addWidget(memory_btn_);
+
+    // 交互录制：停止时保存会话文件，用 MyAppReplay 回放测延迟
+    record_btn_ = new QPushButton("record");
+    record_btn_->setCheckable(true);
+    control_btn_layout_2->addWidget(record_btn_);
+    connect(record_btn_, &QPushButton::toggled, this, [this](bool checked)
+            {
+        if (checked)
+            startInteractionRecording();
+        else
+            stopInteractionRecording(); });
+
+    // 高分辨率分块截图（输出尺寸 = 窗口尺寸 × 倍数）
+    QPushButton *hires_btn = new QPushButton("hi-res export");
+    control_btn_layout_2->addWidget(hires_btn);
+    connect(hires_btn, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::exportTiledScreenshot);
+
     connect(btnSliceX, &QPushButton::clicked, this, [=]()
-            { meshSliceController_->ShowSlice(SLICE_X); renderWindow_->Render(); });
+            {
+        interactionRecorder_.record(InteractionType::Slice, {static_cast<double>(SLICE_X)});
+        meshSliceController_->ShowSlice(SLICE_X); });
 
     connect(btnSliceY, &QPushButton::clicked, this, [=]()
-            { meshSliceController_->ShowSlice(SLICE_Y); renderWindow_->Render(); });
+            {
+        interactionRecorder_.record(InteractionType::Slice, {static_cast<double>(SLICE_Y)});
+        meshSliceController_->ShowSlice(SLICE_Y); });
 
     connect(btnSliceZ, &QPushButton::clicked, this, [=]()
-            { meshSliceController_->ShowSlice(SLICE_Z); renderWindow_->Render(); });
+            {
+        interactionRecorder_.record(InteractionType::Slice, {static_cast<double>(SLICE_Z)});
+        meshSliceController_->ShowSlice(SLICE_Z); });
 
     connect(hideSlice, &QPushButton::clicked, this, [=]()
             {
+    interactionRecorder_.record(InteractionType::HideSlice);
     if (meshSliceController_)
         meshSliceController_->HideSlice(); 
-        renderWindow_->Render(); });
+        renderScheduler_->requestRender(); });
 
     connect(cross_section, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::SlotCilckedCrossSectionBtn);
 
@@ -274,6 +520,8 @@ void ThreeDimensionalDisplayPage::initControlBtn()
             { updateColorStyle(3); });
     connect(rainbow_btn, &QPushButton::clicked, this, [this]()
             { updateColorStyle(4); });
+    connect(color_source_combo_, QOverload<int>::of(&QComboBox::activated), this, [this](int index)
+            { updateColorSource(color_source_combo_->itemText(index).toStdString()); });
 
     connect(bounding_box_control_btn_, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::OnBoundingBoxButtonClicked);
     connect(surfaceToggleButton_, &QPushButton::clicked, this, &ThreeDimensionalDisplayPage::toggleSurfaceVisibility);
@@ -288,13 +536,31 @@ void ThreeDimensionalDisplayPage::initMeasurementMenu()
     measurementMenuWidget_ = new MeasurementMenuWidget(this);
     // 连接槽函数（你已有的 measurementController_）
     connect(measurementMenuWidget_, &MeasurementMenuWidget::pointMeasureRequested, this, [=]()
-            { measurementController_->setMode(MeasurementMode::Point); });
+            { setMeasurementMode(MeasurementMode::Point); });
     connect(measurementMenuWidget_, &MeasurementMenuWidget::lineMeasureRequested, this, [=]()
-            { measurementController_->setMode(MeasurementMode::Line); });
+            { setMeasurementMode(MeasurementMode::Line); });
     connect(measurementMenuWidget_, &MeasurementMenuWidget::triangleMeasureRequested, this, [=]()
-            { measurementController_->setMode(MeasurementMode::Triangle); });
+            { setMeasurementMode(MeasurementMode::Triangle); });
     connect(measurementMenuWidget_, &MeasurementMenuWidget::closeMeasureRequested, this, [=]()
-            { measurementController_->setMode(MeasurementMode::None); });
+            { setMeasurementMode(MeasurementMode::None); });
+    connect(measurementMenuWidget_, &MeasurementMenuWidget::saveSessionRequested, this, [=]()
+            {
+        QString path = QFileDialog::getSaveFileName(this, "Save measurements", "", "Measurement Session (*.vms)");
+        if (path.isEmpty())
+            return;
+        if (!measurementController_->session().save(path.toStdString()))
+            QMessageBox::warning(this, "Measurement", "Failed to save measurement session."); });
+    connect(measurementMenuWidget_, &MeasurementMenuWidget::loadSessionRequested, this, [=]()
+            {
+        QString path = QFileDialog::getOpenFileName(this, "Load measurements", "", "Measurement Session (*.vms);;All Files (*)");
+        if (path.isEmpty())
+            return;
+        if (!measurementController_->session().load(path.toStdString()))
+        {
+            QMessageBox::warning(this, "Measurement", "Failed to load measurement session.");
+            return;
+        }
+        measurementController_->showSession(); });
 
     // 测量按钮点击后显示菜单（放在合适位置，如右上角）
     connect(measurement_btn_, &QPushButton::clicked, this, [=]()
@@ -303,82 +569,241 @@ void ThreeDimensionalDisplayPage::initMeasurementMenu()
         measurementMenuWidget_->showMenu(globalPos); });
 }
 
-void ThreeDimensionalDisplayPage::loadModelByExtension(const QString &filePath)
+void ThreeDimensionalDisplayPage::loadModelByExtension(const QString &filePath, bool append)
 {
     if (!QFileInfo::exists(filePath))
     {
         qDebug() << "File does not exist: " << filePath;
         return;
     }
-    if (!model_pinpeline_builder_->loadModel(filePath))
+    // 替换时加载成功后才清除旧模型；追加时按场景原点对齐。目录按 PLY 瓦片数据集加载
+    bool isTileFolder = QFileInfo(filePath).isDir();
+    int id = isTileFolder ? sceneModel_->addTiledModel(filePath, !append, availableTileBudget(!append))
+                          : sceneModel_->addModel(filePath, !append);
+    if (id < 0)
     {
         qDebug() << "Failed to load model: " << filePath;
         return;
     }
 
-    renderer_->RemoveAllViewProps();
-    renderer_->SetBackground(0.5, 0.5, 0.5); // 可选：统一背景色
-    if (model_pinpeline_builder_->getModelType() == ModelPipelineBuilder::ModelType::PLY)
+    if (!append)
     {
-        ply_point_actor_ = model_pinpeline_builder_->getActor();
-        renderer_->AddActor(ply_point_actor_);
-        // 设置切面控制器
-        meshSliceController_->SetOriginalActor(ply_point_actor_);
-        meshSliceController_->UpdatePolyData(model_pinpeline_builder_->getProcessedPolyData());
-        // BoxClipper 设置
-        boxClipper_->SetInputDataAndReplaceOriginal(model_pinpeline_builder_->getProcessedPolyData(),
-                                                    ply_point_actor_);
+        model_pinpeline_builder_ = &emptyBuilder_; // 旧模型已释放
+        renderer_->RemoveAllViewProps();
+        sceneModel_->reAddToRenderer();
+        renderer_->SetBackground(0.5, 0.5, 0.5); // 可选：统一背景色
+        // 新模型不再沿用旧的偏差着色
+        deviation_enabled_ = false;
+        deviationReferenceBuilder_.reset();
+        deviationArray_ = nullptr;
+        deviation_btn_->setText("deviation");
+        if (deviationHistogramWidget_)
+            deviationHistogramWidget_->hide();
+        change_enabled_ = false;
+        comparedBuilder_.reset();
+        changeArray_ = nullptr;
+        changeDetector_ = CloudChangeDetector(); // 参考点云已更换
     }
-    else if (model_pinpeline_builder_->getModelType() == ModelPipelineBuilder::ModelType::OBJ)
+
+    // 新模型成为选中模型：更新当前 actor、切面、裁剪、测量与 BoundingBox
+    sceneModel_->setSelection(id);
+    refreshModelList();
+    applyModelSelection();
+    if (surfaceActor_)
+        surfaceActor_->SetVisibility(is_surface_visible_);
+    if (wireframeActor_)
+        wireframeActor_->SetVisibility(is_wireframe_visible_);
+    if (pointsActor_)
+        pointsActor_->SetVisibility(is_points_visible_);
+
+    // 重设相机、刷新渲染器
+    renderer_->ResetCamera();
+    renderScheduler_->requestRender();
+
+    if (!append)
+    {
+        // 比例尺处理
+        if (scaleBarController_)
+        {
+            scaleBarController_->ReAddToRenderer();
+            scaleBarController_->UpdateScaleBar(); // 主动触发更新比例尺显示
+        }
+
+        // 性能叠加层：重新添加
+        performanceHud_->ReAddToRenderer();
+
+        // 重新添加测量控件的 2D actor
+        if (measurementController_)
+            measurementController_->ReAddActorsToRenderer();
+
+        // 会话回放只支持单模型场景，追加的模型与瓦片数据集不录制
+        if (!isTileFolder)
+            interactionRecorder_.record(InteractionType::LoadModel, {}, filePath.toStdString());
+    }
+    performanceHud_->MarkUploadPending(); // 新模型首帧计为数据上传
+
+    checkMemoryBudget();
+    m_pScene->update(); // 最后刷新界面
+}
+
+void ThreeDimensionalDisplayPage::refreshModelList()
+{
+    // 重建列表时不触发选择变化
+    QSignalBlocker blocker(model_combo_);
+    model_combo_->clear();
+    model_combo_->addItem("All models", SceneModel::AllModels);
+    for (int id : sceneModel_->getModelIds())
+    {
+        QString name = sceneModel_->getDisplayName(id);
+        if (!sceneModel_->isVisible(id))
+            name += " (hidden)";
+        model_combo_->addItem(name, id);
+    }
+    model_combo_->setCurrentIndex(std::max(0, model_combo_->findData(sceneModel_->getSelection())));
+}
+
+void ThreeDimensionalDisplayPage::applyModelSelection()
+{
+    ModelPipelineBuilder *active = sceneModel_->getBuilder(sceneModel_->getActiveId());
+    if (!active)
+        active = &emptyBuilder_;
+    if (active != model_pinpeline_builder_)
+    {
+        // 偏差与变化量针对当前模型计算，切换模型后关闭
+        if (deviation_enabled_)
+            clearDeviation();
+        clearChange();
+        changeDetector_ = CloudChangeDetector();
+        model_pinpeline_builder_ = active;
+    }
+    int selection = sceneModel_->getSelection();
+    model_visible_btn_->setText(selection == SceneModel::AllModels || sceneModel_->isVisible(selection) ? "Hide Model"
+                                                                                                      : "Show Model");
+
+    // 点大小、点线面显隐、偏差与变化检测作用于当前模型
+    auto modelType = model_pinpeline_builder_->getModelType();
+    bool isObj = modelType == ModelPipelineBuilder::ModelType::OBJ;
+    ply_point_actor_ = modelType == ModelPipelineBuilder::ModelType::PLY ? model_pinpeline_builder_->getActor() : nullptr;
+    surfaceActor_ = isObj ? model_pinpeline_builder_->getSurfaceActor() : nullptr;
+    wireframeActor_ = isObj ? model_pinpeline_builder_->getWireframeActor() : nullptr;
+    pointsActor_ = isObj ? model_pinpeline_builder_->getPointsActor() : nullptr;
+
+    // 着色来源列表取当前模型的属性
     {
-        // 添加 OBJ 专属的线框、点、面 actor
-        surfaceActor_ = model_pinpeline_builder_->getSurfaceActor();
-        wireframeActor_ = model_pinpeline_builder_->getWireframeActor();
-        pointsActor_ = model_pinpeline_builder_->getPointsActor();
+        QSignalBlocker blocker(color_source_combo_);
+        color_source_combo_->clear();
+        int activeId = sceneModel_->getActiveId();
+        for (const std::string &source : sceneModel_->getColorSources(activeId))
+            color_source_combo_->addItem(QString::fromStdString(source));
+        color_source_combo_->setCurrentText(QString::fromStdString(sceneModel_->getColorSource(activeId)));
+    }
 
-        if (surfaceActor_)
+    // 切面、裁剪与测量作用于目标模型（选择全部时为所有可见模型的合并数据）
+    vtkSmartPointer<vtkPolyData> targetPolyData = sceneModel_->getTargetPolyData();
+    std::vector<vtkActor *> targetActors = sceneModel_->getTargetActors();
+    if (!targetPolyData)
+        targetPolyData = vtkSmartPointer<vtkPolyData>::New();
+
+    meshSliceController_->HideSlice();
+    meshSliceController_->SetOriginalActors(targetActors);
+    meshSliceController_->UpdatePolyData(targetPolyData);
+    boxClipper_->SetInputDataAndReplaceOriginals(targetPolyData, targetActors);
+    boxClipper_enabled_ = false;
+    if (measurementController_)
+    {
+        // 网格模型支持沿表面测距
+        measurementController_->setSurfaceMesh(targetPolyData->GetNumberOfPolys() > 0 ? targetPolyData.GetPointer() : nullptr);
+        // 启用箱体裁剪时原始 actor 不在场景中，裁剪结果同样可拾取
+        std::vector<vtkActor *> pickActors = targetActors;
+        pickActors.push_back(boxClipper_->GetClippedActor());
+        measurementController_->setPickActors(pickActors);
+        // 点云拾取复用裁剪器的点块索引（箱体裁剪或切面显示时自动回退到 vtkPointPicker）
+        measurementController_->setPointIndex(boxClipper_->GetPointBlockIndex(), targetActors);
+
+        // 单点测量显示原始坐标：场景中各模型共用中心，取当前模型（瓦片数据集取任一已加载瓦片）的变换
+        ModelPipelineBuilder *worldBuilder = model_pinpeline_builder_ != &emptyBuilder_ ? model_pinpeline_builder_ : nullptr;
+        if (!worldBuilder)
         {
-            surfaceActor_->SetVisibility(is_surface_visible_);
-            renderer_->AddActor(surfaceActor_);
+            if (TiledModelLoader *tiles = sceneModel_->getTiledModel(sceneModel_->getActiveId()))
+            {
+                std::vector<ModelPipelineBuilder *> resident = tiles->getResidentBuilders();
+                if (!resident.empty())
+                    worldBuilder = resident.front();
+            }
         }
-        if (wireframeActor_)
+        if (worldBuilder)
         {
-            wireframeActor_->SetVisibility(is_wireframe_visible_);
-            renderer_->AddActor(wireframeActor_);
+            double displayToWorld[16];
+            worldBuilder->getDisplayToWorldMatrix(displayToWorld);
+            measurementController_->setDisplayToWorld(displayToWorld);
         }
-        if (pointsActor_)
+        else
         {
-            pointsActor_->SetVisibility(is_points_visible_);
-            renderer_->AddActor(pointsActor_);
+            measurementController_->setDisplayToWorld(nullptr);
         }
-        meshSliceController_->SetOriginalActor(surfaceActor_);
-        meshSliceController_->UpdatePolyData(model_pinpeline_builder_->getProcessedPolyData());
-        // BoxClipper 设置
-        boxClipper_->SetInputDataAndReplaceOriginal(model_pinpeline_builder_->getProcessedPolyData(),
-                                                    surfaceActor_);
     }
-    // 添加 BoundingBox
-    addBoundingBox(model_pinpeline_builder_->getProcessedPolyData());
-    boxClipper_enabled_ = false;
 
-    // 重设相机、刷新渲染器
-    renderer_->ResetCamera();
-    renderWindow_->Render();
+    // 添加 BoundingBox
+    if (targetPolyData->GetNumberOfPoints() > 0)
+    {
+        addBoundingBox(targetPolyData);
+    }
+    else if (boundingBoxActor_)
+    {
+        renderer_->RemoveActor(boundingBoxActor_);
+        boundingBoxActor_ = nullptr;
+    }
+    renderScheduler_->requestRender();
+}
 
-    // 比例尺处理
-    if (scaleBarController_)
+void ThreeDimensionalDisplayPage::removeSelectedModel()
+{
+    int id = sceneModel_->getSelection();
+    if (id == SceneModel::AllModels)
     {
-        scaleBarController_->ReAddToRenderer();
-        scaleBarController_->UpdateScaleBar(); // 主动触发更新比例尺显示
+        QMessageBox::information(this, "Models", "Select a model to remove.");
+        return;
+    }
+    // 先恢复裁剪与切面隐藏的原始 actor，再移除模型
+    if (boxClipper_enabled_)
+    {
+        boxClipper_enabled_ = false;
+        boxClipper_->SetEnabled(false);
+    }
+    meshSliceController_->HideSlice();
+    if (sceneModel_->getBuilder(id) == model_pinpeline_builder_)
+    {
+        if (deviation_enabled_)
+            clearDeviation();
+        clearChange();
+        changeDetector_ = CloudChangeDetector();
+        model_pinpeline_builder_ = &emptyBuilder_;
     }
 
-    // 重新添加测量控件的 2D actor
-    if (measurementController_)
+    sceneModel_->removeModel(id);
+    refreshModelList();
+    applyModelSelection();
+    checkMemoryBudget();
+}
+
+void ThreeDimensionalDisplayPage::toggleSelectedModelVisibility()
+{
+    int id = sceneModel_->getSelection();
+    if (id == SceneModel::AllModels)
+    {
+        QMessageBox::information(this, "Models", "Select a model to hide or show.");
+        return;
+    }
+    if (boxClipper_enabled_)
     {
-        measurementController_->ReAddActorsToRenderer();
+        boxClipper_enabled_ = false;
+        boxClipper_->SetEnabled(false);
     }
+    meshSliceController_->HideSlice();
 
-    m_pScene->update(); // 最后刷新界面
+    sceneModel_->setVisible(id, !sceneModel_->isVisible(id));
+    refreshModelList();
+    applyModelSelection();
 }
 
 void ThreeDimensionalDisplayPage::addCoordinateAxes()
@@ -473,7 +898,7 @@ void ThreeDimensionalDisplayPage::OnBoundingBoxButtonClicked()
         bounding_box_control_btn_->setText(isBoundingBoxVisible_ ? "Hide Bounding Box" : "Show Bounding Box"); // 原：隐藏边框/显示边框
     }
 
-    renderWindow_->Render();
+    renderScheduler_->requestRender();
 }
 
 void ThreeDimensionalDisplayPage::toggleSurfaceVisibility()
@@ -483,7 +908,7 @@ void ThreeDimensionalDisplayPage::toggleSurfaceVisibility()
         is_surface_visible_ = !is_surface_visible_;
         surfaceActor_->SetVisibility(is_surface_visible_);
         surfaceToggleButton_->setText(is_surface_visible_ ? "Hide Surface" : "Show Surface"); // 原：隐藏面/显示面
-        renderWindow_->Render();
+        renderScheduler_->requestRender();
     }
 }
 
@@ -494,7 +919,7 @@ void ThreeDimensionalDisplayPage::toggleWireframeVisibility()
         is_wireframe_visible_ = !is_wireframe_visible_;
         wireframeActor_->SetVisibility(is_wireframe_visible_);
         wireframeToggleButton_->setText(is_wireframe_visible_ ? "Hide Wireframe" : "Show Wireframe"); // 原：隐藏边/显示边
-        renderWindow_->Render();
+        renderScheduler_->requestRender();
     }
 }
 
@@ -505,7 +930,7 @@ void ThreeDimensionalDisplayPage::togglePointsVisibility()
         is_points_visible_ = !is_points_visible_;
         pointsActor_->SetVisibility(is_points_visible_);
         pointsToggleButton_->setText(is_points_visible_ ? "Hide Points" : "Show Points"); // 原：隐藏点/显示点
-        renderWindow_->Render();
+        renderScheduler_->requestRender();
     }
 }
 
@@ -519,32 +944,7 @@ void ThreeDimensionalDisplayPage::setPointSize()
     {
         pointsActor_->GetProperty()->SetPointSize(point_size_edit_->text().toInt());
     }
-    renderWindow_->Render();
-}
-
-vtkSmartPointer<vtkLookupTable> ThreeDimensionalDisplayPage::createJetLookupTable(double minValue, double maxValue, double gamma)
-{
-    auto lut = vtkSmartPointer<vtkLookupTable>::New();
-    lut->SetNumberOfTableValues(256);
-    lut->SetRange(minValue, maxValue); // 设置标量范围
-
-    for (int i = 0; i < 256; ++i)
-    {
-        double t = static_cast<double>(i) / 255.0;
-
-        // 非线性调整 t，使颜色更集中于中间值
-        t = std::pow(t, gamma);
-
-        // Jet 配色映射：蓝 → 青 → 绿 → 黄 → 红
-        double r = std::clamp(1.5 - std::abs(4.0 * t - 3.0), 0.0, 1.0);
-        double g = std::clamp(1.5 - std::abs(4.0 * t - 2.0), 0.0, 1.0);
-        double b = std::clamp(1.5 - std::abs(4.0 * t - 1.0), 0.0, 1.0);
-
-        lut->SetTableValue(i, r, g, b);
-    }
-
-    lut->Build();
-    return lut;
+    renderScheduler_->requestRender();
 }
 
 void ThreeDimensionalDisplayPage::updateLUTWithGamma(double gamma)
@@ -571,12 +971,13 @@ void ThreeDimensionalDisplayPage::updateLUTWithGamma(double gamma)
     lut->Build();
 
     mapper->SetLookupTable(lut);
-    renderWindow_->Render();
+    renderScheduler_->requestRender();
 }
 
 void ThreeDimensionalDisplayPage::SlotCilckedCrossSectionBtn()
 {
     boxClipper_enabled_ = !boxClipper_enabled_;
+    interactionRecorder_.record(InteractionType::BoxEnabled, {boxClipper_enabled_ ? 1.0 : 0.0});
     // 如果使用箱体切割器默认只显示面 目前只切割了面
     if (boxClipper_enabled_ && model_pinpeline_builder_->getModelType() == ModelPipelineBuilder::ModelType::OBJ)
     {
@@ -603,179 +1004,489 @@ void ThreeDimensionalDisplayPage::SlotFileSelectBtnClicked()
     {
         qDebug() << "dir_name:" << dir_name;
         file_path_edit_->setText(dir_name);
-        loadModelByExtension(dir_name);
+        if (confirmModelLoad(dir_name, false))
+            loadModelByExtension(dir_name);
     }
 }
 
-vtkSmartPointer<vtkLookupTable> ThreeDimensionalDisplayPage::createViridisLookupTable(double minValue, double maxValue)
+void ThreeDimensionalDisplayPage::SlotFolderSelectBtnClicked()
 {
-    auto lut = vtkSmartPointer<vtkLookupTable>::New();
-    lut->SetNumberOfTableValues(256);
-    lut->SetRange(minValue, maxValue);
-
-    for (int i = 0; i < 256; ++i)
+    QString dir_name = QFileDialog::getExistingDirectory(this, "Select tile folder", "");
+    if (!dir_name.isEmpty())
     {
-        double t = i / 255.0;
-        // 近似 Matplotlib Viridis 色带（更精确的RGB值可参考官方定义）
-        double r = 0.2795 + 0.4702 * t + 0.1649 * t * t - 0.0008 * t * t * t;
-        double g = 0.0021 + 0.7047 * t + 0.0704 * t * t - 0.0053 * t * t * t;
-        double b = 0.3904 + 0.1066 * t + 0.1968 * t * t - 0.0641 * t * t * t;
-        lut->SetTableValue(i, r, g, b);
+        file_path_edit_->setText(dir_name);
+        loadModelByExtension(dir_name);
     }
-    lut->Build();
-    return lut;
 }
 
-vtkSmartPointer<vtkLookupTable> ThreeDimensionalDisplayPage::createCoolToWarmLookupTable(double minValue, double maxValue)
+void ThreeDimensionalDisplayPage::SlotAddModelBtnClicked()
 {
-    auto lut = vtkSmartPointer<vtkLookupTable>::New();
-    lut->SetNumberOfTableValues(256);
-    lut->SetRange(minValue, maxValue);
-
-    for (int i = 0; i < 256; ++i)
+    QString filter = "Supported Files (*.ply *.obj);;PLY Files (*.ply);;OBJ Files (*.obj);;All Files (*)";
+    QStringList paths = QFileDialog::getOpenFileNames(this, "Add models", "", filter);
+    for (const QString &path : paths)
     {
-        double t = i / 255.0;
-        double r = t;                     // 红：从0→1
-        double g = 1 - fabs(t - 0.5) * 2; // 绿：中间最亮
-        double b = 1 - t;                 // 蓝：从1→0
-        lut->SetTableValue(i, r, g, b);
+        bool append = sceneModel_->getModelCount() > 0;
+        if (confirmModelLoad(path, append))
+            loadModelByExtension(path, append);
     }
-    lut->Build();
-    return lut;
 }
 
-vtkSmartPointer<vtkLookupTable> ThreeDimensionalDisplayPage::createGrayscaleLookupTable(double minValue, double maxValue)
+bool ThreeDimensionalDisplayPage::confirmModelLoad(const QString &filePath, bool append)
 {
-    auto lut = vtkSmartPointer<vtkLookupTable>::New();
-    lut->SetNumberOfTableValues(256);
-    lut->SetRange(minValue, maxValue);
-
-    for (int i = 0; i < 256; ++i)
+    ModelInfo info;
+    if (!ModelProbe::probe(filePath.toStdString(), info))
+        return true; // 探测失败时由加载流程报告错误
+    QString summary = QString::fromStdString(ModelProbe::toText(info));
+    qDebug().noquote() << "[ThreeDimensionalDisplayPage] Probe" << filePath << "\n" << summary;
+    file_path_edit_->setToolTip(summary);
+
+    // 预计超出内存预算时先提示，并给出建议的抽稀比例；追加时扣除场景已占用的部分
+    if (memory_budget_mb_ <= 0)
+        return true;
+    std::size_t budgetBytes = static_cast<std::size_t>(memory_budget_mb_) * 1024 * 1024;
+    std::size_t usedBytes = 0;
+    if (append)
     {
-        double gray = i / 255.0; // 从黑→白
-        lut->SetTableValue(i, gray, gray, gray);
+        MemoryReport report;
+        buildMemoryReport(report);
+        usedBytes = report.getTotalCpuBytes() + report.getTotalGpuBytes();
     }
-    lut->Build();
-    return lut;
-}
-
-vtkSmartPointer<vtkLookupTable> ThreeDimensionalDisplayPage::createRainbowLookupTable(double minValue, double maxValue)
-{
-    auto lut = vtkSmartPointer<vtkLookupTable>::New();
-    lut->SetNumberOfTableValues(256);
-    lut->SetHueRange(0.666, 0.0); // 色相从蓝(0.666)→红(0.0)
-    lut->SetSaturationRange(1.0, 1.0);
-    lut->SetValueRange(1.0, 1.0);
-    lut->SetRange(minValue, maxValue);
-    lut->Build();
-    return lut;
+    std::size_t availableBytes = usedBytes < budgetBytes ? budgetBytes - usedBytes : 1;
+    double keepRatio = ModelProbe::suggestKeepRatio(info, availableBytes);
+    if (keepRatio >= 1.0)
+        return true;
+    int step = static_cast<int>(std::ceil(1.0 / keepRatio));
+    QString message = QString("%1\n\nThe model is expected to exceed the memory budget (%2 MB available).\n"
+                              "Suggested downsampling: keep 1 of every %3 points.\n\nLoad anyway?")
+                          .arg(summary)
+                          .arg(static_cast<double>(availableBytes) / (1024 * 1024), 0, 'f', 0)
+                          .arg(step);
+    return QMessageBox::question(this, "Load model", message) == QMessageBox::Yes;
 }
 
 // 新增槽函数实现颜色更新
 void ThreeDimensionalDisplayPage::updateColorStyle(int style)
 {
     current_color_style = style;
-    if (ply_point_actor_) // PLY点云模型
+    // 选中的模型（或全部模型）使用场景共享的查找表，mapper 按各自标量范围映射（偏差着色同样适用）
+    for (int id : sceneModel_->getSelectedIds())
+        sceneModel_->setColorStyle(id, style);
+    if (deviation_enabled_)
+        updateHistogram(deviationArray_, current_scalar_range,
+                        ColorMaps::createLookupTableForStyle(style, current_scalar_range[0], current_scalar_range[1]));
+    if (change_enabled_ && comparedBuilder_) // 比较点云按变化量范围着色
     {
-        auto mapper = vtkPolyDataMapper::SafeDownCast(ply_point_actor_->GetMapper());
+        auto mapper = vtkPolyDataMapper::SafeDownCast(comparedBuilder_->getActor()->GetMapper());
         if (mapper)
         {
-            vtkSmartPointer<vtkLookupTable> new_lut;
-            switch (style)
-            {
-            case 0:
-                new_lut = createJetLookupTable(current_scalar_range[0], current_scalar_range[1], 1.0);
-                break;
-            case 1:
-                new_lut = createViridisLookupTable(current_scalar_range[0], current_scalar_range[1]);
-                break;
-            case 2:
-                new_lut = createCoolToWarmLookupTable(current_scalar_range[0], current_scalar_range[1]);
-                break;
-            case 3:
-                new_lut = createGrayscaleLookupTable(current_scalar_range[0], current_scalar_range[1]);
-                break;
-            case 4:
-                new_lut = createRainbowLookupTable(current_scalar_range[0], current_scalar_range[1]);
-                break;
-            }
+            auto new_lut = ColorMaps::createLookupTableForStyle(style, change_scalar_range_[0], change_scalar_range_[1]);
             mapper->SetLookupTable(new_lut);
-            renderWindow_->Render();
+            updateHistogram(changeArray_, change_scalar_range_, new_lut);
         }
     }
-    if (surfaceActor_) // OBJ网格模型
+    renderScheduler_->requestRender();
+}
+
+void ThreeDimensionalDisplayPage::updateColorSource(const std::string &name)
+{
+    // 偏差着色占用当前模型的 mapper，切换着色来源时先关闭
+    if (deviation_enabled_)
+        clearDeviation();
+    for (int id : sceneModel_->getSelectedIds())
     {
-        auto mapper = vtkPolyDataMapper::SafeDownCast(surfaceActor_->GetMapper());
-        if (mapper)
+        if (!sceneModel_->setColorSource(id, name))
+            qDebug() << "[ThreeDimensionalDisplayPage] Model" << id << "has no attribute" << QString::fromStdString(name);
+    }
+    renderScheduler_->requestRender();
+}
+
+void ThreeDimensionalDisplayPage::setZAxisStretching()
+{
+    double zScale = zaxis_stretching_edit_->text().toDouble();
+    interactionRecorder_.record(InteractionType::ZScale, {zScale});
+
+    // 1. 重建选中模型（或全部模型）的管线，场景负责替换 actor 并保持显隐与颜色风格
+    for (int id : sceneModel_->getSelectedIds())
+        sceneModel_->setZAxisScale(id, zScale);
+    performanceHud_->MarkUploadPending(); // 管线重建后首帧重新上传数据
+
+    // 2. 更新 BoundingBox、boxClipper、切面与测地线网格（拉伸后坐标已变化）
+    applyModelSelection();
+
+    // 3. 偏差着色：参考网格同步拉伸后重新计算
+    if (deviation_enabled_ && deviationReferenceBuilder_)
+    {
+        renderer_->RemoveActor(deviationReferenceBuilder_->getSurfaceActor());
+        deviationReferenceBuilder_->setZAxisScale(zScale);
+        if (!applyDeviation())
+            clearDeviation();
+    }
+
+    // 4. 变化量：比较点云同步拉伸，距离以真实尺度计算，无需重新计算
+    if (change_enabled_ && comparedBuilder_)
+    {
+        renderer_->RemoveActor(comparedBuilder_->getActor());
+        comparedBuilder_->setZAxisScale(zScale);
+        applyChangeColoring();
+    }
+
+    boxClipper_enabled_ = false;
+    renderScheduler_->requestRender();
+}
+
+void ThreeDimensionalDisplayPage::computeVolume(VolumeCalculator::ReferenceType referenceType)
+{
+    auto polyData = model_pinpeline_builder_->getProcessedPolyData();
+    if (!polyData)
+    {
+        QMessageBox::information(this, "Volume", "Load a model first.");
+        return;
+    }
+
+    VolumeCalculator calculator;
+    calculator.setZScale(model_pinpeline_builder_->getZAxisScale());
+
+    // 计算区域：启用箱体裁剪时使用盒子范围
+    if (boxClipper_enabled_)
+    {
+        double bounds[6];
+        boxClipper_->GetBoxBounds(bounds);
+        calculator.setRegionBounds(bounds);
+    }
+
+    ModelPipelineBuilder referenceBuilder; // 第二个模型，需在计算结束前保持有效
+    if (referenceType == VolumeCalculator::ReferenceType::Plane)
+    {
+        // 使用最近一次三角形测量的三个点作为参考平面
+        const Measurement *triangle = nullptr;
+        const auto &measurements = measurementController_->session().measurements();
+        for (auto it = measurements.rbegin(); it != measurements.rend(); ++it)
         {
-            vtkSmartPointer<vtkLookupTable> new_lut;
-            switch (style)
+            if (it->type == MeasurementType::Triangle)
             {
-            case 0:
-                new_lut = createJetLookupTable(current_scalar_range[0], current_scalar_range[1]);
-                break;
-            case 1:
-                new_lut = createViridisLookupTable(current_scalar_range[0], current_scalar_range[1]);
-                break;
-            case 2:
-                new_lut = createCoolToWarmLookupTable(current_scalar_range[0], current_scalar_range[1]);
-                break;
-            case 3:
-                new_lut = createGrayscaleLookupTable(current_scalar_range[0], current_scalar_range[1]);
-                break;
-            case 4:
-                new_lut = createRainbowLookupTable(current_scalar_range[0], current_scalar_range[1]);
+                triangle = &*it;
                 break;
             }
-            mapper->SetLookupTable(new_lut);
-            renderWindow_->Render();
         }
+        // 会话中为原始坐标，换算到当前显示坐标后与模型数据比较
+        MeasurementPoint A{}, B{}, C{};
+        if (triangle)
+        {
+            A = measurementController_->toDisplay(triangle->points[0]);
+            B = measurementController_->toDisplay(triangle->points[1]);
+            C = measurementController_->toDisplay(triangle->points[2]);
+        }
+        if (!triangle || !calculator.setReferencePlane(A.data(), B.data(), C.data()))
+        {
+            QMessageBox::information(this, "Volume", "Pick a non-vertical plane with a triangle measurement first.");
+            return;
+        }
+    }
+    else if (referenceType == VolumeCalculator::ReferenceType::FittedPlane)
+    {
+        calculator.setReferenceFitted();
     }
+    else
+    {
+        QString filter = "Supported Files (*.ply *.obj);;PLY Files (*.ply);;OBJ Files (*.obj)";
+        QString path = QFileDialog::getOpenFileName(this, "Select reference model", "", filter);
+        if (path.isEmpty())
+            return;
+        // 参考模型与当前模型使用同一中心与拉伸比例，保证处于同一坐标系
+        double center[3];
+        model_pinpeline_builder_->getCenter(center);
+        referenceBuilder.setCenterOverride(center);
+        if (!referenceBuilder.loadModel(path, model_pinpeline_builder_->getZAxisScale()))
+        {
+            QMessageBox::warning(this, "Volume", "Failed to load reference model.");
+            return;
+        }
+        calculator.setReferenceSurface(referenceBuilder.getProcessedPolyData());
+    }
+
+    VolumeResult result = calculator.compute(polyData);
+    if (!result.valid)
+    {
+        QMessageBox::information(this, "Volume", "No data inside the region to compute a volume.");
+        return;
+    }
+
+    QString text = QString("Cut: %1\nFill: %2\nNet: %3\nArea: %4\nSamples: %5")
+                       .arg(result.cut, 0, 'f', 3)
+                       .arg(result.fill, 0, 'f', 3)
+                       .arg(result.net, 0, 'f', 3)
+                       .arg(result.area, 0, 'f', 3)
+                       .arg(result.samples);
+    if (result.cellSize > 0.0)
+        text += QString("\nGrid cell: %1").arg(result.cellSize, 0, 'f', 4);
+    QMessageBox::information(this, "Volume", text);
 }
 
-void ThreeDimensionalDisplayPage::setZAxisStretching()
+void ThreeDimensionalDisplayPage::toggleDeviation()
 {
-    double zScale = zaxis_stretching_edit_->text().toDouble();
-    model_pinpeline_builder_->setZAxisScale(zScale);
+    if (deviation_enabled_)
+    {
+        clearDeviation();
+        renderScheduler_->requestRender();
+        return;
+    }
 
-    // 获取模型类型
-    auto modelType = model_pinpeline_builder_->getModelType();
+    if (model_pinpeline_builder_->getModelType() != ModelPipelineBuilder::ModelType::PLY || !ply_point_actor_)
+    {
+        QMessageBox::information(this, "Deviation", "Load a PLY point cloud first.");
+        return;
+    }
 
-    // 1. 移除旧 actor（所有可能的）
-    renderer_->RemoveActor(model_pinpeline_builder_->getActor());          // PLY 点云 actor
-    renderer_->RemoveActor(model_pinpeline_builder_->getSurfaceActor());   // OBJ 面 actor
-    renderer_->RemoveActor(model_pinpeline_builder_->getWireframeActor()); // OBJ 线 actor
-    renderer_->RemoveActor(model_pinpeline_builder_->getPointsActor());    // OBJ 点 actor
+    QString path = QFileDialog::getOpenFileName(this, "Select reference mesh", "", "OBJ Files (*.obj)");
+    if (path.isEmpty())
+        return;
+    clearChange(); // 偏差与变化量着色互斥
+
+    // 参考网格与点云使用同一中心与拉伸比例，保证处于同一坐标系
+    double center[3];
+    model_pinpeline_builder_->getCenter(center);
+    deviationReferenceBuilder_ = std::make_unique<ModelPipelineBuilder>();
+    deviationReferenceBuilder_->setCenterOverride(center);
+    // 伪法向符号依赖共享顶点，参考网格至少按精确位置焊接（场景设置了容差时沿用）
+    double weldTolerance = sceneModel_->getMeshCleanTolerance();
+    deviationReferenceBuilder_->setMeshCleanTolerance(weldTolerance >= 0.0 ? weldTolerance : 0.0);
+    if (!deviationReferenceBuilder_->loadModel(path, model_pinpeline_builder_->getZAxisScale()) ||
+        deviationReferenceBuilder_->getModelType() != ModelPipelineBuilder::ModelType::OBJ)
+    {
+        deviationReferenceBuilder_.reset();
+        QMessageBox::warning(this, "Deviation", "Failed to load reference mesh.");
+        return;
+    }
 
-    // 2. 添加新 actor
-    if (modelType == ModelPipelineBuilder::ModelType::PLY)
+    deviation_enabled_ = true;
+    current_color_style = 2; // 偏差默认使用发散色带 CoolWarm
+    if (!applyDeviation())
     {
-        renderer_->AddActor(model_pinpeline_builder_->getActor());
+        clearDeviation();
+        QMessageBox::warning(this, "Deviation", "Reference mesh has no triangles.");
+        return;
     }
-    else if (modelType == ModelPipelineBuilder::ModelType::OBJ)
+    deviation_btn_->setText("hide deviation");
+    renderScheduler_->requestRender();
+}
+
+bool ThreeDimensionalDisplayPage::applyDeviation()
+{
+    auto cloud = model_pinpeline_builder_->getProcessedPolyData();
+    auto mapper = vtkPolyDataMapper::SafeDownCast(ply_point_actor_->GetMapper());
+    double zScale = model_pinpeline_builder_->getZAxisScale();
+    if (!cloud || !mapper ||
+        !cloudMeshDeviation_.setReference(deviationReferenceBuilder_->getProcessedPolyData(), zScale))
+        return false;
+
+    deviationArray_ = cloudMeshDeviation_.compute(cloud, zScale);
+    if (!deviationArray_)
+        return false;
+    cloud->GetPointData()->AddArray(deviationArray_);
+
+    // 参考网格半透明显示，不参与着色
+    if (auto referenceActor = deviationReferenceBuilder_->getSurfaceActor())
     {
-        if (auto surfaceActor = model_pinpeline_builder_->getSurfaceActor())
-            renderer_->AddActor(surfaceActor);
-        if (auto wireframeActor = model_pinpeline_builder_->getWireframeActor())
-            renderer_->AddActor(wireframeActor);
-        if (auto pointsActor = model_pinpeline_builder_->getPointsActor())
-            renderer_->AddActor(pointsActor);
+        referenceActor->GetMapper()->ScalarVisibilityOff();
+        referenceActor->GetProperty()->SetColor(0.8, 0.8, 0.8);
+        referenceActor->GetProperty()->SetOpacity(0.3);
+        referenceActor->PickableOff();
+        renderer_->AddActor(referenceActor);
     }
 
-    // 3. 更新 BoundingBox
-    addBoundingBox(model_pinpeline_builder_->getProcessedPolyData());
+    // 对称色带：以 95% 绝对偏差为界，避免少数离群点压缩色彩
+    const DeviationStatistics &statistics = cloudMeshDeviation_.getStatistics();
+    double range = statistics.absP95;
+    if (range <= 0.0)
+        range = std::max(std::abs(statistics.min), std::abs(statistics.max));
+    if (range <= 0.0)
+        range = 1e-6;
+    current_scalar_range[0] = -range;
+    current_scalar_range[1] = range;
+
+    mapper->SetScalarModeToUsePointFieldData();
+    mapper->SelectColorArray(CloudMeshDeviation::ArrayName);
+    mapper->SetColorModeToMapScalars(); // 着色来源可能是直接使用的 RGB
+    mapper->SetScalarRange(current_scalar_range);
+
+    if (!deviationHistogramWidget_)
+        deviationHistogramWidget_ = new DeviationHistogramWidget(this);
+    deviationHistogramWidget_->setSummary(QString("Mean: %1  RMS: %2\nMin: %3  Max: %4  (%5 points)")
+                                              .arg(statistics.mean, 0, 'f', 4)
+                                              .arg(statistics.rms, 0, 'f', 4)
+                                              .arg(statistics.min, 0, 'f', 4)
+                                              .arg(statistics.max, 0, 'f', 4)
+                                              .arg(statistics.count));
+    deviationHistogramWidget_->show();
+
+    // LUT 与直方图在 updateColorStyle 中一并刷新
+    updateColorStyle(current_color_style);
+    return true;
+}
 
-    // 4. 更新 boxClipper
-    vtkSmartPointer<vtkActor> primaryActor = nullptr;
-    if (modelType == ModelPipelineBuilder::ModelType::PLY)
-        primaryActor = model_pinpeline_builder_->getActor();
-    else if (modelType == ModelPipelineBuilder::ModelType::OBJ)
-        primaryActor = model_pinpeline_builder_->getSurfaceActor();
+void ThreeDimensionalDisplayPage::clearDeviation()
+{
+    deviation_enabled_ = false;
+    deviation_btn_->setText("deviation");
+    if (deviationHistogramWidget_)
+        deviationHistogramWidget_->hide();
+    if (deviationReferenceBuilder_)
+    {
+        renderer_->RemoveActor(deviationReferenceBuilder_->getSurfaceActor());
+        deviationReferenceBuilder_.reset();
+    }
+    deviationArray_ = nullptr;
 
-    boxClipper_->SetInputDataAndReplaceOriginal(model_pinpeline_builder_->getProcessedPolyData(), primaryActor);
+    auto cloud = model_pinpeline_builder_->getProcessedPolyData();
+    auto mapper = ply_point_actor_ ? vtkPolyDataMapper::SafeDownCast(ply_point_actor_->GetMapper()) : nullptr;
+    if (!cloud || !mapper)
+        return;
 
-    boxClipper_enabled_ = false;
-    renderWindow_->Render();
+    // 恢复之前选择的着色来源（高程或模型属性）
+    cloud->GetPointData()->RemoveArray(CloudMeshDeviation::ArrayName);
+    model_pinpeline_builder_->setColorSource(model_pinpeline_builder_->getColorSource());
+    mapper->GetScalarRange(current_scalar_range);
+    updateColorStyle(current_color_style);
+}
+
+void ThreeDimensionalDisplayPage::updateHistogram(vtkFloatArray *field, const double range[2],
+                                                  vtkSmartPointer<vtkLookupTable> lut)
+{
+    if (!deviationHistogramWidget_ || !field)
+        return;
+    auto counts = CloudMeshDeviation::histogram(field, range[0], range[1], 64);
+    deviationHistogramWidget_->setHistogram(counts, range[0], range[1], lut);
+}
+
+void ThreeDimensionalDisplayPage::computeChange(CloudChangeDetector::Method method)
+{
+    if (model_pinpeline_builder_->getModelType() != ModelPipelineBuilder::ModelType::PLY || !ply_point_actor_)
+    {
+        QMessageBox::information(this, "Change", "Load the reference PLY point cloud first.");
+        return;
+    }
+
+    // 首次计算时加载比较点云，与参考点云使用同一中心与拉伸比例
+    if (!comparedBuilder_)
+    {
+        QString path = QFileDialog::getOpenFileName(this, "Select compared point cloud", "", "PLY Files (*.ply)");
+        if (path.isEmpty())
+            return;
+        double center[3];
+        model_pinpeline_builder_->getCenter(center);
+        comparedBuilder_ = std::make_unique<ModelPipelineBuilder>();
+        comparedBuilder_->setCenterOverride(center);
+        if (!comparedBuilder_->loadModel(path, model_pinpeline_builder_->getZAxisScale()) ||
+            comparedBuilder_->getModelType() != ModelPipelineBuilder::ModelType::PLY)
+        {
+            comparedBuilder_.reset();
+            QMessageBox::warning(this, "Change", "Failed to load compared point cloud.");
+            return;
+        }
+    }
+    if (deviation_enabled_)
+        clearDeviation();
+
+    // 参考点云的 k-d 树由场景按模型共享（坐标为原始坐标 − 中心，与 Z 拉伸无关），Z 拉伸与更换方法时复用
+    if (!changeDetector_.hasReference())
+        changeDetector_.setReferenceIndex(sceneModel_->getPointIndex(sceneModel_->getActiveId()));
+    if (!changeDetector_.hasReference())
+    {
+        QMessageBox::warning(this, "Change", "Reference point cloud is empty.");
+        return;
+    }
+
+    changeMethod_ = method;
+    // 比较点云与参考点云共用中心，换算到同一“原始坐标 − 中心”坐标系
+    double displayToCentered[16];
+    comparedBuilder_->getDisplayToCenteredMatrix(displayToCentered);
+    changeArray_ = changeDetector_.compute(comparedBuilder_->getProcessedPolyData(), displayToCentered, method);
+    const DeviationStatistics &statistics = changeDetector_.getStatistics();
+    if (!changeArray_ || !statistics.valid)
+    {
+        QMessageBox::information(this, "Change", "No corresponding points between the two clouds.");
+        return;
+    }
+
+    // 最近邻距离无符号，局部平面距离使用对称色带
+    double range = statistics.absP95 > 0.0 ? statistics.absP95 : std::max(std::abs(statistics.min), std::abs(statistics.max));
+    if (range <= 0.0)
+        range = 1e-6;
+    change_scalar_range_[0] = method == CloudChangeDetector::Method::LocalPlane ? -range : 0.0;
+    change_scalar_range_[1] = range;
+    if (method == CloudChangeDetector::Method::LocalPlane)
+        current_color_style = 2; // 有符号变化默认使用发散色带 CoolWarm
+
+    change_enabled_ = true;
+    ply_point_actor_->SetVisibility(false); // 参考点云隐藏，避免遮挡变化着色
+    if (!deviationHistogramWidget_)
+        deviationHistogramWidget_ = new DeviationHistogramWidget(this);
+    deviationHistogramWidget_->setSummary(QString("%1\nMean: %2  RMS: %3\nMin: %4  Max: %5  (%6 matched)")
+                                              .arg(method == CloudChangeDetector::Method::LocalPlane ? "Local plane" : "Nearest neighbour")
+                                              .arg(statistics.mean, 0, 'f', 4)
+                                              .arg(statistics.rms, 0, 'f', 4)
+                                              .arg(statistics.min, 0, 'f', 4)
+                                              .arg(statistics.max, 0, 'f', 4)
+                                              .arg(statistics.count));
+    deviationHistogramWidget_->show();
+
+    applyChangeColoring();
+    renderScheduler_->requestRender();
+}
+
+void ThreeDimensionalDisplayPage::applyChangeColoring()
+{
+    auto compared = comparedBuilder_->getProcessedPolyData();
+    auto actor = comparedBuilder_->getActor();
+    auto mapper = vtkPolyDataMapper::SafeDownCast(actor->GetMapper());
+    if (!compared || !mapper || !changeArray_)
+        return;
+
+    compared->GetPointData()->AddArray(changeArray_);
+    mapper->SetScalarModeToUsePointFieldData();
+    mapper->SelectColorArray(CloudChangeDetector::ArrayName);
+    mapper->SetScalarRange(change_scalar_range_);
+    actor->GetProperty()->SetPointSize(ply_point_actor_->GetProperty()->GetPointSize());
+    renderer_->AddActor(actor);
+
+    // LUT 与直方图在 updateColorStyle 中一并刷新
+    updateColorStyle(current_color_style);
+}
+
+void ThreeDimensionalDisplayPage::clearChange()
+{
+    if (comparedBuilder_)
+    {
+        renderer_->RemoveActor(comparedBuilder_->getActor());
+        comparedBuilder_.reset();
+    }
+    changeArray_ = nullptr;
+    if (!change_enabled_)
+        return;
+
+    change_enabled_ = false;
+    if (ply_point_actor_)
+        ply_point_actor_->SetVisibility(true);
+    if (deviationHistogramWidget_)
+        deviationHistogramWidget_->hide();
+}
+
+void ThreeDimensionalDisplayPage::exportChange()
+{
+    if (!change_enabled_ || !comparedBuilder_ || !changeArray_)
+    {
+        QMessageBox::information(this, "Change", "Compute a change field first.");
+        return;
+    }
+    QString path = QFileDialog::getSaveFileName(this, "Export change field", "", "VTK PolyData (*.vtp)");
+    if (path.isEmpty())
+        return;
+
+    double displayToWorld[16];
+    comparedBuilder_->getDisplayToWorldMatrix(displayToWorld);
+    if (!CloudChangeDetector::exportScalarField(comparedBuilder_->getProcessedPolyData(), changeArray_, displayToWorld,
+                                                path.toStdString()))
+        QMessageBox::warning(this, "Change", "Failed to export change field.");
 }
 
 bool ThreeDimensionalDisplayPage::eventFilter(QObject *obj, QEvent *event)
@@ -786,9 +1497,207 @@ bool ThreeDimensionalDisplayPage::eventFilter(QObject *obj, QEvent *event)
         if (mouseEvent->button() == Qt::LeftButton)
         {
             if (measurementController_)
+            {
+                int position[2];
+                interactor_->GetEventPosition(position);
+                interactionRecorder_.record(InteractionType::MeasurementClick, {double(position[0]), double(position[1])});
                 measurementController_->onLeftButtonPressed();
+            }
             return true; // 拦截事件
         }
     }
     return QWidget::eventFilter(obj, event); // 交给默认处理
 }
+
+void ThreeDimensionalDisplayPage::buildMemoryReport(MemoryReport &report) const
+{
+    report.setBudgetBytes(static_cast<std::size_t>(memory_budget_mb_) * 1024 * 1024);
+
+    // 模型（场景中所有模型及其共享资源、偏差参考网格、变化检测比较点云），共用一个全局预算
+    sceneModel_->appendMemoryUsage(report);
+    if (deviationReferenceBuilder_)
+        deviationReferenceBuilder_->appendMemoryUsage(report);
+    if (comparedBuilder_)
+        comparedBuilder_->appendMemoryUsage(report);
+
+    // 交互子系统
+    boxClipper_->AppendMemoryUsage(report);
+    meshSliceController_->AppendMemoryUsage(report);
+    measurementController_->appendMemoryUsage(report);
+
+    // 分析派生数据
+    report.addArray("Deviation", "deviation field", deviationArray_);
+    report.addBytes("Deviation", "reference BVH", cloudMeshDeviation_.getMemorySize());
+    report.addArray("ChangeDetection", "change field", changeArray_);
+    report.addBytes("ChangeDetection", "reference kd-tree", changeDetector_.getMemorySize());
+}
+
+void ThreeDimensionalDisplayPage::showMemoryReport()
+{
+    MemoryReport report;
+    buildMemoryReport(report);
+    std::string text = report.toText();
+    std::cout << "[ThreeDimensionalDisplayPage] Memory report\n" << text << std::endl;
+
+    QMessageBox box(report.isOverBudget() ? QMessageBox::Warning : QMessageBox::Information, "Memory",
+                    "<pre>" + QString::fromStdString(text).toHtmlEscaped() + "</pre>", QMessageBox::Ok, this);
+    box.exec();
+}
+
+void ThreeDimensionalDisplayPage::checkMemoryBudget()
+{
+    MemoryReport report;
+    buildMemoryReport(report);
+    memory_btn_->setText(report.isOverBudget() ? "memory (!)" : "memory");
+    if (!report.isOverBudget())
+        return;
+    qDebug() << "[ThreeDimensionalDisplayPage] Memory budget exceeded:"
+             << (report.getTotalCpuBytes() + report.getTotalGpuBytes()) / (1024 * 1024) << "MB used of"
+             << memory_budget_mb_ << "MB";
+
+    // 瓦片数据集：只承担超出部分中瓦片占用所占的比例，其余模块造成的超出不靠卸载瓦片解决
+    std::size_t tileBytes = 0;
+    for (int id : sceneModel_->getModelIds())
+    {
+        if (TiledModelLoader *tiles = sceneModel_->getTiledModel(id))
+            tileBytes += tiles->getResidentMemorySize();
+    }
+    if (tileBytes == 0)
+        return;
+    std::size_t used = report.getTotalCpuBytes() + report.getTotalGpuBytes();
+    std::size_t overage = used - report.getBudgetBytes();
+    auto tileShare = static_cast<std::size_t>(static_cast<double>(overage) * tileBytes / used);
+    // 裁剪与切面持有瓦片 actor，卸载前先恢复原始 actor
+    if (boxClipper_enabled_)
+    {
+        boxClipper_enabled_ = false;
+        boxClipper_->SetEnabled(false);
+    }
+    meshSliceController_->HideSlice();
+    double cameraPosition[3];
+    renderer_->GetActiveCamera()->GetPosition(cameraPosition);
+    if (sceneModel_->evictTiles(tileShare, cameraPosition) == 0)
+        return;
+    refreshModelList();
+    applyModelSelection();
+
+    // 只卸载一轮，不递归：剩余的超出由非瓦片数据造成，仅保留警告
+    MemoryReport after;
+    buildMemoryReport(after);
+    memory_btn_->setText(after.isOverBudget() ? "memory (!)" : "memory");
+}
+
+std::size_t ThreeDimensionalDisplayPage::availableTileBudget(bool replaceScene) const
+{
+    if (memory_budget_mb_ <= 0)
+        return 0;
+    MemoryReport report;
+    buildMemoryReport(report);
+    std::size_t used = report.getTotalCpuBytes() + report.getTotalGpuBytes();
+    if (replaceScene)
+    {
+        // 替换场景时现有模型随后释放，不占用预算
+        MemoryReport scene;
+        sceneModel_->appendMemoryUsage(scene);
+        used -= std::min(used, scene.getTotalCpuBytes() + scene.getTotalGpuBytes());
+    }
+    std::size_t budget = report.getBudgetBytes();
+    // 预算已用尽时返回 1 字节：只建立瓦片索引，不读取任何瓦片
+    return used < budget ? budget - used : 1;
+}
+
+void ThreeDimensionalDisplayPage::setMeasurementMode(MeasurementMode mode)
+{
+    interactionRecorder_.record(InteractionType::MeasurementMode, {static_cast<double>(mode)});
+    measurementController_->setMode(mode);
+}
+
+void ThreeDimensionalDisplayPage::startInteractionRecording()
+{
+    int *size = renderWindow_->GetSize();
+    interactionRecorder_.start(size[0], size[1]);
+
+    // 记录起始状态，使会话可以独立回放
+    QString modelPath = model_pinpeline_builder_->getFilePath();
+    if (!modelPath.isEmpty())
+    {
+        interactionRecorder_.record(InteractionType::LoadModel, {}, modelPath.toStdString());
+        if (model_pinpeline_builder_->getZAxisScale() != 1.0)
+            interactionRecorder_.record(InteractionType::ZScale, {model_pinpeline_builder_->getZAxisScale()});
+    }
+    if (boxClipper_enabled_)
+    {
+        interactionRecorder_.record(InteractionType::BoxEnabled, {1.0});
+        auto transform = vtkSmartPointer<vtkTransform>::New();
+        boxClipper_->GetBoxTransform(transform);
+        std::vector<double> matrix(16);
+        vtkMatrix4x4::DeepCopy(matrix.data(), transform->GetMatrix());
+        interactionRecorder_.record(InteractionType::BoxTransform, matrix);
+    }
+    if (measurementController_->getMode() != MeasurementMode::None)
+        interactionRecorder_.record(InteractionType::MeasurementMode, {static_cast<double>(measurementController_->getMode())});
+    interactionRecorder_.recordCameraIfChanged(renderer_->GetActiveCamera());
+
+    record_btn_->setText("stop recording");
+    std::cout << "[ThreeDimensionalDisplayPage] Interaction recording started." << std::endl;
+}
+
+void ThreeDimensionalDisplayPage::stopInteractionRecording()
+{
+    interactionRecorder_.stop();
+    record_btn_->setText("record");
+    std::cout << "[ThreeDimensionalDisplayPage] Interaction recording stopped, "
+              << interactionRecorder_.getEvents().size() << " events." << std::endl;
+
+    QString path = QFileDialog::getSaveFileName(this, "Save interaction session", "session.vis",
+                                                "Interaction Session (*.vis)");
+    if (path.isEmpty())
+        return;
+    if (!interactionRecorder_.save(path.toStdString()))
+        QMessageBox::warning(this, "Record", "Failed to write interaction session.");
+}
+
+void ThreeDimensionalDisplayPage::exportTiledScreenshot()
+{
+    int *size = renderWindow_->GetSize();
+    bool ok = false;
+    int magnification = QInputDialog::getInt(this, "High-resolution export",
+                                             QString("Window is %1 x %2 px. Magnification (output = window x N):")
+                                                 .arg(size[0])
+                                                 .arg(size[1]),
+                                             8, 1, 32, 1, &ok);
+    if (!ok)
+        return;
+    QString path = QFileDialog::getSaveFileName(this, "Export screenshot", "screenshot.png", "PNG Image (*.png)");
+    if (path.isEmpty())
+        return;
+
+    TiledScreenshotExporter exporter(renderWindow_, renderer_);
+    exporter.setMagnification(magnification);
+    QProgressDialog progress("Rendering tiles...", "Cancel", 0, magnification * magnification, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(500);
+    exporter.setProgressCallback([&progress](int done, int)
+                                 {
+        progress.setValue(done);
+        return !progress.wasCanceled(); });
+
+    // 性能叠加层不进入截图；分块相机不录制；比例尺线段按倍数放大；截图不受点数预算限制
+    bool hudVisible = performanceHud_->IsVisible();
+    performanceHud_->SetVisible(false);
+    vtkIdType pointBudget = pointBudget_->getBudget();
+    pointBudget_->setBudget(0);
+    renderer_->RemoveObserver(cameraRecordCallback_);
+    scaleBarController_->SetMagnification(magnification);
+
+    bool written = exporter.exportPng(path.toStdString());
+
+    scaleBarController_->SetMagnification(1);
+    renderer_->AddObserver(vtkCommand::StartEvent, cameraRecordCallback_);
+    performanceHud_->SetVisible(hudVisible);
+    pointBudget_->setBudget(pointBudget);
+    bool canceled = progress.wasCanceled();
+    progress.setValue(progress.maximum());
+    if (!written && !canceled)
+        QMessageBox::warning(this, "Export", "Failed to export the screenshot.");
+}
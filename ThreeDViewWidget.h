@@ -1,12 +1,22 @@
 /* 三维地形数据显示 */
 #ifndef CDS_FRONTEND_THREE_DIMENSIONAL_DISPLAY_PAGE_H__
 #define CDS_FRONTEND_THREE_DIMENSIONAL_DISPLAY_PAGE_H__
+#include "RenderScheduler.h"
+#include "PerformanceHud.h"
+#include "PointBudgetController.h"
 #include "ScaleBarController.h"
 #include "MeshSliceController.h"
 #include "BoxClipperController.h"
 #include "ModelPinelineBuilder.h"
+#include "SceneModel.h"
 #include "MeasurementController.h"
 #include "MeasurementMenuWidget.h"
+#include "VolumeCalculator.h"
+#include "CloudMeshDeviation.h"
+#include "DeviationHistogramWidget.h"
+#include "CloudChangeDetector.h"
+#include "MemoryReport.h"
+#include "InteractionRecorder.h"
 // #include "OverlayLineRenderer.h"
 
 #include <QWidget>
@@ -14,6 +24,7 @@
 #include <QVBoxLayout>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QComboBox>
 #include <QVTKOpenGLWidget.h>
 #include <vtkSmartPointer.h>
 #include <vtkGenericOpenGLRenderWindow.h>
@@ -27,6 +38,7 @@
 #include <vtkTextMapper.h>
 #include <vtkScalarBarActor.h>
 #include <vtkColorTransferFunction.h>
+#include <vtkCallbackCommand.h>
 
 class ThreeDimensionalDisplayPage : public QWidget
 {
@@ -43,8 +55,18 @@ private:
     void initControlBtn();
     // 初始化测量菜单
     void initMeasurementMenu();
-    // vtk加载文件
-    void loadModelByExtension(const QString &filePath);
+    // vtk加载文件（append 为 true 时追加到场景，否则替换场景中所有模型；目录按 PLY 瓦片数据集加载）
+    void loadModelByExtension(const QString &filePath, bool append = false);
+    // 加载前探测模型元数据，预计超出内存预算时询问是否继续
+    bool confirmModelLoad(const QString &filePath, bool append);
+    // 按场景内容刷新模型下拉框
+    void refreshModelList();
+    // 选择变化后更新当前模型，并把裁剪、切面、测量与边框指向目标模型
+    void applyModelSelection();
+    // 从场景中移除选中的模型
+    void removeSelectedModel();
+    // 显示/隐藏选中的模型
+    void toggleSelectedModelVisibility();
     // 加载坐标轴
     void addCoordinateAxes();
     // 标量颜色图例
@@ -61,21 +83,55 @@ private:
     void togglePointsVisibility();
     // 设置点大小
     void setPointSize();
-    // 渲染数据为jet风格
-    vtkSmartPointer<vtkLookupTable> createJetLookupTable(double minValue, double maxValue, double gamma = 0.7);
-    vtkSmartPointer<vtkLookupTable> createViridisLookupTable(double minValue, double maxValue);
-    vtkSmartPointer<vtkLookupTable> createCoolToWarmLookupTable(double minValue, double maxValue);
-    vtkSmartPointer<vtkLookupTable> createGrayscaleLookupTable(double minValue, double maxValue);
-    vtkSmartPointer<vtkLookupTable> createRainbowLookupTable(double minValue, double maxValue);
     void updateColorStyle(int style); // 颜色风格切换函数
+    // 切换选中模型（或全部模型）的着色来源
+    void updateColorSource(const std::string &name);
     // 设置Z轴拉伸
     void setZAxisStretching();
+    // 计算挖填方体积（区域：启用箱体裁剪时为盒子，否则为整个模型）
+    void computeVolume(VolumeCalculator::ReferenceType referenceType);
+    // 切换点云到参考网格的偏差着色
+    void toggleDeviation();
+    // 按当前参考网格计算偏差并着色（Z 拉伸后重新调用）
+    bool applyDeviation();
+    // 关闭偏差着色，恢复高程着色
+    void clearDeviation();
+    // 用当前颜色风格刷新直方图（偏差或变化量）
+    void updateHistogram(vtkFloatArray *field, const double range[2], vtkSmartPointer<vtkLookupTable> lut);
+    // 加载比较点云（首次）并计算两期点云之间的变化量
+    void computeChange(CloudChangeDetector::Method method);
+    // 将变化量数组绑定到比较点云并着色（Z 拉伸后重新调用）
+    void applyChangeColoring();
+    // 关闭变化量显示，卸载比较点云
+    void clearChange();
+    // 导出变化量标量场
+    void exportChange();
+    // 收集各模型、控制器与派生数据的内存占用
+    void buildMemoryReport(MemoryReport &report) const;
+    // 弹窗显示内存报告
+    void showMemoryReport();
+    // 超出内存预算时输出警告，场景中有瓦片数据集时按瓦片占用的比例卸载离相机最远的瓦片
+    void checkMemoryBudget();
+    // 预算内还可用于加载瓦片的字节数，未设置预算时返回 0（不限制）
+    std::size_t availableTileBudget(bool replaceScene) const;
+    // 切换测量模式（同时录制）
+    void setMeasurementMode(MeasurementMode mode);
+    // 开始录制交互会话（先记录当前模型、拉伸、裁剪与相机状态）
+    void startInteractionRecording();
+    // 停止录制并保存会话文件
+    void stopInteractionRecording();
+    // 分块渲染并导出高分辨率截图
+    void exportTiledScreenshot();
 
 protected:
     bool eventFilter(QObject *obj, QEvent *event);
 
 private slots:
     void SlotFileSelectBtnClicked();
+    // 选择 PLY 瓦片目录，作为一个模型加载
+    void SlotFolderSelectBtnClicked();
+    // 追加模型（如相邻的地形瓦片）
+    void SlotAddModelBtnClicked();
     // 用于测试渲染效果
     void updateLUTWithGamma(double gamma);
     // 点击箱体切割器按钮槽函数
@@ -85,7 +141,13 @@ private:
     QVBoxLayout *main_layout_;  // 主布局
     QLineEdit *file_path_edit_; // 文件路径
 
-    std::unique_ptr<ModelPipelineBuilder> model_pinpeline_builder_; // 模型构建器;
+    // 多模型场景：每个模型独立管线，共享查找表、空间索引与内存预算
+    std::unique_ptr<SceneModel> sceneModel_;
+    ModelPipelineBuilder *model_pinpeline_builder_; // 当前模型的构建器（场景为空时指向 emptyBuilder_）
+    ModelPipelineBuilder emptyBuilder_;             // 场景为空时的占位构建器
+    QComboBox *model_combo_;                        // 模型选择（全部模型 / 单个模型）
+    QComboBox *color_source_combo_;                 // 着色来源（高程 / 模型属性）
+    QPushButton *model_visible_btn_;                // 显示/隐藏选中的模型
 
     // 显示场景
     QVTKOpenGLWidget *m_pScene;
@@ -93,6 +155,22 @@ private:
     vtkSmartPointer<vtkRenderer> renderer_;
     // 创建交互器
     vtkSmartPointer<vtkRenderWindowInteractor> interactor_;
+    // 渲染调度器：合并同一事件循环周期内的渲染请求
+    RenderScheduler *renderScheduler_;
+    // 性能叠加层（帧耗时始终统计，叠加层可选显示）
+    std::unique_ptr<PerformanceHud> performanceHud_;
+    QPushButton *perf_btn_;
+    // 点云每帧点数预算与空闲时渐进细化
+    std::unique_ptr<PointBudgetController> pointBudget_;
+    // 性能轨迹录制（Chrome Trace Event JSON）
+    QPushButton *trace_btn_;
+    // 内存占用报告与预算
+    QPushButton *memory_btn_;
+    int memory_budget_mb_ = 4096; // 内存 + 显存预算（MB），0 表示不限制
+    // 交互录制（回放见 MyAppReplay）
+    QPushButton *record_btn_;
+    InteractionRecorder interactionRecorder_;
+    vtkSmartPointer<vtkCallbackCommand> cameraRecordCallback_; // 每帧渲染前记录相机变化
     // 边框显示
     vtkSmartPointer<vtkActor> boundingBoxActor_; // 用于存储BoundingBox的Actor
     bool isBoundingBoxVisible_;                  // 控制BoundingBox的显隐状态
@@ -134,6 +212,23 @@ private:
     MeasurementMenuWidget *measurementMenuWidget_;
     std::unique_ptr<MeasurementController> measurementController_;
     QPushButton *measurement_btn_;
+    // 体积计算
+    QPushButton *volume_btn_;
+    // 偏差热力图
+    QPushButton *deviation_btn_;
+    bool deviation_enabled_;
+    std::unique_ptr<ModelPipelineBuilder> deviationReferenceBuilder_; // 参考网格
+    CloudMeshDeviation cloudMeshDeviation_;
+    vtkSmartPointer<vtkFloatArray> deviationArray_;
+    DeviationHistogramWidget *deviationHistogramWidget_; // 偏差与变化量共用
+    // 两期点云变化检测（当前模型为参考点云）
+    QPushButton *change_btn_;
+    bool change_enabled_;
+    std::unique_ptr<ModelPipelineBuilder> comparedBuilder_; // 比较点云
+    CloudChangeDetector changeDetector_;
+    CloudChangeDetector::Method changeMethod_;
+    vtkSmartPointer<vtkFloatArray> changeArray_;
+    double change_scalar_range_[2];
     // std::unique_ptr<OverlayLineRenderer> overlayLineRenderer_;
 };
 
@@ -0,0 +1,398 @@
+#include "TiledModelLoader.h"
+#include "MemoryReport.h"
+#include "PipelineProfiler.h"
+#include "TraceRecorder.h"
+#include "PlyVertexReader.h"
+
+#include <vtkSMPTools.h>
+#include <vtkTransformPolyDataFilter.h>
+#include <vtkAbstractTransform.h>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+void TiledModelLoader::setCenterOverride(const double center[3])
+{
+    hasCenterOverride_ = true;
+    std::copy(center, center + 3, center_);
+}
+
+bool TiledModelLoader::loadDirectory(const QString &dirPath, std::size_t budgetBytes)
+{
+    ScopedStageTimer timer("Load.TiledDirectory");
+    TRACE_SCOPE("TiledModelLoader::loadDirectory");
+    auto start = std::chrono::steady_clock::now();
+    dirPath_ = dirPath;
+    tiles_.clear();
+
+    // 1. 并行读取文件头与抽样包围盒建立瓦片索引，跳过无效文件
+    QDir dir(dirPath);
+    QStringList files = dir.entryList(QStringList() << "*.ply" << "*.PLY", QDir::Files, QDir::Name);
+    std::vector<Tile> probed(static_cast<std::size_t>(files.size()));
+    std::vector<char> valid(probed.size(), 0);
+    {
+        ScopedStageTimer probeTimer("Load.TileIndex");
+        for (int i = 0; i < files.size(); ++i)
+            probed[i].filePath = dir.absoluteFilePath(files[i]);
+        vtkSMPTools::For(0, static_cast<vtkIdType>(probed.size()), 1, [&](vtkIdType begin, vtkIdType end)
+                         {
+            for (vtkIdType i = begin; i < end; ++i)
+            {
+                Tile &tile = probed[i];
+                valid[i] = ModelProbe::probe(tile.filePath.toStdString(), tile.info) ? 1 : 0;
+                if (!valid[i])
+                    continue;
+                tile.estimatedBytes = ModelProbe::estimateCpuBytes(tile.info) + ModelProbe::estimateGpuBytes(tile.info);
+                if (tile.info.hasBounds)
+                    std::copy(tile.info.bounds, tile.info.bounds + 6, tile.bounds);
+            } });
+    }
+    std::int64_t totalVertices = 0;
+    for (std::size_t i = 0; i < probed.size(); ++i)
+    {
+        if (!valid[i])
+        {
+            std::cerr << "[TiledModelLoader] Skipping invalid PLY: " << probed[i].filePath.toStdString() << std::endl;
+            continue;
+        }
+        totalVertices += probed[i].info.vertexCount;
+        tiles_.push_back(std::move(probed[i]));
+    }
+    if (tiles_.empty())
+    {
+        std::cerr << "[TiledModelLoader] No PLY tiles in " << dirPath.toStdString() << std::endl;
+        return false;
+    }
+
+    // 2. 无法抽样包围盒的瓦片（ASCII 等）只能完整读取一次确定包围盒，数据保留到选定常驻瓦片后
+    std::vector<vtkSmartPointer<vtkPolyData>> polyData(tiles_.size());
+    std::vector<char> failed(tiles_.size(), 0);
+    auto readTiles = [&](const std::vector<int> &indices)
+    {
+        ScopedStageTimer readTimer("Load.TileRead");
+        vtkSMPTools::For(0, static_cast<vtkIdType>(indices.size()), 1, [&](vtkIdType begin, vtkIdType end)
+                         {
+            for (vtkIdType i = begin; i < end; ++i)
+            {
+                TRACE_SCOPE_CAT("TiledModelLoader::readTile", "smp");
+                int index = indices[i];
+                polyData[index] = readTile(tiles_[index].filePath, tiles_[index].origin, spatialOrder_);
+                if (polyData[index])
+                    updateTileBounds(tiles_[index], polyData[index]);
+                else
+                    failed[index] = 1;
+            } });
+    };
+    std::vector<int> unbounded;
+    for (std::size_t i = 0; i < tiles_.size(); ++i)
+    {
+        if (!tiles_[i].info.hasBounds)
+            unbounded.push_back(static_cast<int>(i));
+    }
+    if (!unbounded.empty())
+        readTiles(unbounded);
+    if (!removeFailedTiles(failed, polyData))
+        return false;
+
+    // 3. 全局包围盒、中心与高程范围（抽样包围盒可能略小于真实范围，超出部分按色带端点着色）
+    std::copy(tiles_.front().bounds, tiles_.front().bounds + 6, bounds_);
+    for (const Tile &tile : tiles_)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            bounds_[2 * axis] = std::min(bounds_[2 * axis], tile.bounds[2 * axis]);
+            bounds_[2 * axis + 1] = std::max(bounds_[2 * axis + 1], tile.bounds[2 * axis + 1]);
+        }
+    }
+    if (!hasCenterOverride_)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+            center_[axis] = (bounds_[2 * axis] + bounds_[2 * axis + 1]) * 0.5;
+    }
+    elevationRange_[0] = bounds_[4];
+    elevationRange_[1] = bounds_[5];
+
+    // 4. 从数据中心由近到远选取估算占用不超过预算的瓦片读取，其余瓦片只保留索引
+    double centerWorld[3] = {(bounds_[0] + bounds_[1]) * 0.5, (bounds_[2] + bounds_[3]) * 0.5, (bounds_[4] + bounds_[5]) * 0.5};
+    double viewPoint[3];
+    worldToDisplay(centerWorld, viewPoint);
+    std::vector<int> selected = selectTilesWithinBudget(viewPoint, budgetBytes);
+    std::vector<char> isSelected(tiles_.size(), 0);
+    std::vector<int> toRead;
+    for (int index : selected)
+    {
+        isSelected[index] = 1;
+        if (!polyData[index])
+            toRead.push_back(index);
+    }
+    if (!toRead.empty())
+        readTiles(toRead);
+    for (std::size_t i = 0; i < tiles_.size(); ++i)
+    {
+        if (!isSelected[i])
+            polyData[i] = nullptr; // 只为确定包围盒读取的数据不常驻
+    }
+    if (!removeFailedTiles(failed, polyData))
+        return false;
+
+    // 各瓦片独立管线，共用全局中心与高程范围
+    int resident = 0;
+    {
+        ScopedStageTimer pipelineTimer("Load.TilePipelines");
+        for (std::size_t i = 0; i < tiles_.size(); ++i)
+        {
+            if (polyData[i] && buildTilePipeline(tiles_[i], polyData[i]))
+                ++resident;
+        }
+    }
+
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[TiledModelLoader] Indexed " << tiles_.size() << " tiles (" << totalVertices << " vertices) from "
+              << dirPath.toStdString() << ", loaded " << resident << " within budget in " << elapsed << " ms" << std::endl;
+    return true;
+}
+
+bool TiledModelLoader::removeFailedTiles(std::vector<char> &failed, std::vector<vtkSmartPointer<vtkPolyData>> &polyData)
+{
+    // 读取失败的瓦片不加入数据集
+    std::vector<Tile> kept;
+    std::vector<vtkSmartPointer<vtkPolyData>> keptData;
+    for (std::size_t i = 0; i < tiles_.size(); ++i)
+    {
+        if (failed[i])
+        {
+            std::cerr << "[TiledModelLoader] Failed to read tile: " << tiles_[i].filePath.toStdString() << std::endl;
+            continue;
+        }
+        kept.push_back(std::move(tiles_[i]));
+        keptData.push_back(polyData[i]);
+    }
+    tiles_ = std::move(kept);
+    polyData = std::move(keptData);
+    failed.assign(tiles_.size(), 0);
+    return !tiles_.empty();
+}
+
+std::vector<int> TiledModelLoader::selectTilesWithinBudget(const double viewPoint[3], std::size_t budgetBytes) const
+{
+    std::vector<int> order = getLoadOrder(viewPoint);
+    if (budgetBytes == 0)
+        return order;
+    // 由近到远累加，放不下的瓦片即停止，常驻瓦片在空间上保持连续
+    std::vector<int> selected;
+    std::size_t total = 0;
+    for (int index : order)
+    {
+        if (total + tiles_[index].estimatedBytes > budgetBytes)
+            break;
+        total += tiles_[index].estimatedBytes;
+        selected.push_back(index);
+    }
+    return selected;
+}
+
+int TiledModelLoader::getResidentTileCount() const
+{
+    return static_cast<int>(std::count_if(tiles_.begin(), tiles_.end(), [](const Tile &tile)
+                                          { return tile.builder != nullptr; }));
+}
+
+void TiledModelLoader::getCenter(double center[3]) const
+{
+    std::copy(center_, center_ + 3, center);
+}
+
+void TiledModelLoader::getElevationRange(double range[2]) const
+{
+    range[0] = elevationRange_[0];
+    range[1] = elevationRange_[1];
+}
+
+void TiledModelLoader::getBounds(double bounds[6]) const
+{
+    std::copy(bounds_, bounds_ + 6, bounds);
+}
+
+void TiledModelLoader::getTileBounds(int index, double bounds[6]) const
+{
+    std::copy(tiles_[index].bounds, tiles_[index].bounds + 6, bounds);
+}
+
+std::vector<ModelPipelineBuilder *> TiledModelLoader::getResidentBuilders() const
+{
+    std::vector<ModelPipelineBuilder *> builders;
+    for (const Tile &tile : tiles_)
+    {
+        if (tile.builder)
+            builders.push_back(tile.builder.get());
+    }
+    return builders;
+}
+
+void TiledModelLoader::setZAxisScale(double scale)
+{
+    zScale_ = scale;
+    for (Tile &tile : tiles_)
+    {
+        if (tile.builder)
+            tile.builder->setZAxisScale(scale);
+    }
+}
+
+void TiledModelLoader::setCompactPositions(double errorBound)
+{
+    compactErrorBound_ = errorBound;
+    for (Tile &tile : tiles_)
+    {
+        if (tile.builder)
+            tile.builder->setCompactPositions(errorBound);
+    }
+}
+
+void TiledModelLoader::setViewCulling(bool enabled)
+{
+    viewCulling_ = enabled;
+    for (Tile &tile : tiles_)
+    {
+        if (tile.builder)
+            tile.builder->setViewCulling(enabled);
+    }
+}
+
+void TiledModelLoader::evictTile(int index)
+{
+    tiles_[index].builder.reset();
+}
+
+bool TiledModelLoader::reloadTile(int index)
+{
+    Tile &tile = tiles_[index];
+    if (tile.builder)
+        return true;
+    // 原点由文件内容决定，重新读取后与首次读取相同
+    auto polyData = readTile(tile.filePath, tile.origin, spatialOrder_);
+    if (!polyData)
+        return false;
+    updateTileBounds(tile, polyData);
+    return buildTilePipeline(tile, polyData);
+}
+
+std::size_t TiledModelLoader::getResidentMemorySize() const
+{
+    std::size_t bytes = 0;
+    for (int i = 0; i < getTileCount(); ++i)
+        bytes += getTileMemorySize(i);
+    return bytes;
+}
+
+std::size_t TiledModelLoader::getTileMemorySize(int index) const
+{
+    if (!tiles_[index].builder)
+        return 0;
+    MemoryReport report;
+    tiles_[index].builder->appendMemoryUsage(report);
+    return report.getTotalCpuBytes() + report.getTotalGpuBytes();
+}
+
+std::vector<int> TiledModelLoader::getEvictionOrder(const double viewPoint[3]) const
+{
+    return sortByDistance(viewPoint, true);
+}
+
+std::vector<int> TiledModelLoader::getLoadOrder(const double viewPoint[3]) const
+{
+    return sortByDistance(viewPoint, false);
+}
+
+std::vector<int> TiledModelLoader::sortByDistance(const double viewPoint[3], bool resident) const
+{
+    std::vector<std::pair<double, int>> distances;
+    for (int i = 0; i < getTileCount(); ++i)
+    {
+        const Tile &tile = tiles_[i];
+        if ((tile.builder != nullptr) != resident)
+            continue;
+        // 瓦片中心换算到显示坐标，未加载的瓦片没有管线，按全局中心与拉伸比例换算
+        double center[3] = {(tile.bounds[0] + tile.bounds[1]) * 0.5, (tile.bounds[2] + tile.bounds[3]) * 0.5,
+                            (tile.bounds[4] + tile.bounds[5]) * 0.5};
+        worldToDisplay(center, center);
+        double d2 = 0.0;
+        for (int axis = 0; axis < 3; ++axis)
+            d2 += (center[axis] - viewPoint[axis]) * (center[axis] - viewPoint[axis]);
+        distances.emplace_back(d2, i);
+    }
+    // 卸载从远到近，加载从近到远
+    if (resident)
+        std::sort(distances.begin(), distances.end(), std::greater<std::pair<double, int>>());
+    else
+        std::sort(distances.begin(), distances.end());
+
+    std::vector<int> order;
+    order.reserve(distances.size());
+    for (const auto &item : distances)
+        order.push_back(item.second);
+    return order;
+}
+
+void TiledModelLoader::worldToDisplay(const double world[3], double display[3]) const
+{
+    // 与 ModelPipelineBuilder 的变换一致：p' = S·p − c
+    display[0] = world[0] - center_[0];
+    display[1] = world[1] - center_[1];
+    display[2] = world[2] * zScale_ - center_[2];
+}
+
+void TiledModelLoader::appendMemoryUsage(MemoryReport &report) const
+{
+    // 数百个瓦片逐项登记会淹没报告，按数据集汇总
+    MemoryReport tilesReport;
+    for (const Tile &tile : tiles_)
+    {
+        if (tile.builder)
+            tile.builder->appendMemoryUsage(tilesReport);
+    }
+    std::string owner = "Tiles: " + QFileInfo(dirPath_).fileName().toStdString();
+    std::ostringstream item;
+    item << getResidentTileCount() << "/" << tiles_.size() << " tiles resident";
+    report.addBytes(owner, item.str(), tilesReport.getTotalCpuBytes(), tilesReport.getTotalGpuBytes());
+    report.addBytes(owner, "tile index", tiles_.size() * sizeof(Tile));
+}
+
+vtkSmartPointer<vtkPolyData> TiledModelLoader::readTile(const QString &filePath, double origin[3],
+                                                       SpatialReorder::Curve curve)
+{
+    vtkSmartPointer<vtkPolyData> polyData = PlyVertexReader::read(filePath.toStdString(), origin);
+    if (!polyData || polyData->GetNumberOfPoints() == 0)
+        return nullptr;
+    SpatialReorder::reorder(polyData, curve);
+    return polyData;
+}
+
+void TiledModelLoader::updateTileBounds(Tile &tile, vtkPolyData *polyData)
+{
+    // 读取后以实际数据替换文件头抽样得到的包围盒
+    polyData->GetBounds(tile.bounds);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        tile.bounds[2 * axis] += tile.origin[axis];
+        tile.bounds[2 * axis + 1] += tile.origin[axis];
+    }
+}
+
+bool TiledModelLoader::buildTilePipeline(Tile &tile, vtkSmartPointer<vtkPolyData> polyData)
+{
+    auto builder = std::make_unique<ModelPipelineBuilder>();
+    builder->setCenterOverride(center_);
+    builder->setElevationRange(elevationRange_[0], elevationRange_[1]);
+    builder->setZAxisScale(zScale_); // 数据加载前只记录比例
+    builder->setCompactPositions(compactErrorBound_);
+    builder->setViewCulling(viewCulling_);
+    if (!builder->loadPolyData(polyData, tile.filePath, tile.origin))
+        return false;
+    tile.builder = std::move(builder);
+    return true;
+}
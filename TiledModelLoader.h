@@ -0,0 +1,178 @@
+/**
+ * @file TiledModelLoader.h
+ * @brief 该头文件定义了 TiledModelLoader 类，把一个目录下的 PLY 瓦片作为一个模型加载。
+ * @details 扫描仪交付的项目通常由数百个 PLY 瓦片组成。加载分四步：
+ *          1. 用 ModelProbe 并行读取每个文件的 PLY 文件头与抽样包围盒，建立瓦片索引并估算各瓦片加载后的占用，
+ *             跳过无效文件；
+ *          2. 无法抽样包围盒的瓦片（ASCII 或属性布局不定长）完整读取一次以确定包围盒；
+ *          3. 按所有瓦片包围盒的并集计算全局中心与全局高程范围，各瓦片的 ModelPipelineBuilder
+ *             统一中心对齐与 Elevation 着色范围，相同高度在各瓦片中颜色一致；
+ *          4. 从数据中心由近到远读取估算占用不超过预算的瓦片并构建管线，其余瓦片只保留索引，按需加载。
+ *
+ *          瓦片在内存中保持独立，可以单独卸载与重新加载（供按视点裁剪与内存预算使用）。
+ *          抽样包围盒在瓦片读取后替换为精确值，卸载后仍保留；全局中心与高程范围在加载目录时确定后不再改变。
+ */
+#pragma once
+
+#include "ModelPinelineBuilder.h"
+#include "ModelProbe.h"
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkActor.h>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class MemoryReport;
+
+/**
+ * @class TiledModelLoader
+ * @brief 瓦片数据集：持有各瓦片的管线、包围盒索引与全局中心、高程范围，由 SceneModel 持有。
+ */
+class TiledModelLoader
+{
+public:
+    /**
+     * @brief 指定全局中心（如场景中已有模型时使用场景原点），未指定时使用所有瓦片并集的中心。
+     */
+    void setCenterOverride(const double center[3]);
+
+    /**
+     * @brief 建立目录下所有 PLY 瓦片（不递归）的索引，并读取预算内离数据中心最近的瓦片。
+     * @param dirPath 目录路径。
+     * @param budgetBytes 常驻瓦片的估算占用上限（字节），0 表示读取全部瓦片。
+     * @return 没有可用瓦片时返回 false。
+     */
+    bool loadDirectory(const QString &dirPath, std::size_t budgetBytes = 0);
+
+    QString getDirectoryPath() const { return dirPath_; }
+    int getTileCount() const { return static_cast<int>(tiles_.size()); }
+    int getResidentTileCount() const;
+
+    // 全局中心（原始坐标）
+    void getCenter(double center[3]) const;
+    // 全局高程范围（原始坐标）
+    void getElevationRange(double range[2]) const;
+    // 所有瓦片并集的包围盒（原始坐标）
+    void getBounds(double bounds[6]) const;
+
+    /**
+     * @brief 瓦片包围盒（原始坐标），卸载后仍有效。
+     */
+    void getTileBounds(int index, double bounds[6]) const;
+    const ModelInfo &getTileInfo(int index) const { return tiles_[index].info; }
+    QString getTilePath(int index) const { return tiles_[index].filePath; }
+
+    /**
+     * @brief 瓦片的管线，已卸载时返回 nullptr。
+     */
+    ModelPipelineBuilder *getTileBuilder(int index) const { return tiles_[index].builder.get(); }
+    bool isTileResident(int index) const { return tiles_[index].builder != nullptr; }
+
+    /**
+     * @brief 所有已加载瓦片的管线。
+     */
+    std::vector<ModelPipelineBuilder *> getResidentBuilders() const;
+
+    /**
+     * @brief 设置所有瓦片的 Z 轴拉伸比例，已加载的瓦片立即重建管线，之后重新加载的瓦片沿用该比例。
+     */
+    void setZAxisScale(double scale);
+    double getZAxisScale() const { return zScale_; }
+
+    /**
+     * @brief 设置所有瓦片原始坐标的紧凑存储误差界（见 ModelPipelineBuilder::setCompactPositions），
+     *        之后重新加载的瓦片沿用该设置。
+     */
+    void setCompactPositions(double errorBound);
+
+    /**
+     * @brief 设置瓦片加载后的点顺序（见 ModelPipelineBuilder::setSpatialOrder），对之后读取的瓦片生效。
+     */
+    void setSpatialOrder(SpatialReorder::Curve curve) { spatialOrder_ = curve; }
+
+    /**
+     * @brief 设置所有瓦片是否逐帧剔除点块（见 ModelPipelineBuilder::setViewCulling），之后重新加载的瓦片沿用该设置。
+     */
+    void setViewCulling(bool enabled);
+
+    /**
+     * @brief 卸载瓦片（调用方需先从渲染器中移除其 actor）。
+     */
+    void evictTile(int index);
+
+    /**
+     * @brief 重新读取已卸载的瓦片并构建管线。
+     */
+    bool reloadTile(int index);
+
+    /**
+     * @brief 已加载瓦片占用的内存与显存估算（字节）。
+     */
+    std::size_t getTileMemorySize(int index) const;
+
+    /**
+     * @brief 按文件头估算的瓦片加载后占用（字节），未加载时也有效，用于按预算决定是否加载。
+     */
+    std::size_t getTileEstimatedSize(int index) const { return tiles_[index].estimatedBytes; }
+
+    /**
+     * @brief 所有已加载瓦片的内存与显存占用之和（字节）。
+     */
+    std::size_t getResidentMemorySize() const;
+
+    /**
+     * @brief 已加载瓦片按与视点距离从远到近排序，用于按预算卸载。
+     * @param viewPoint 显示坐标中的视点（通常为相机位置）。
+     */
+    std::vector<int> getEvictionOrder(const double viewPoint[3]) const;
+
+    /**
+     * @brief 未加载瓦片按与视点距离从近到远排序，用于按预算加载。
+     * @param viewPoint 显示坐标中的视点（通常为相机位置）。
+     */
+    std::vector<int> getLoadOrder(const double viewPoint[3]) const;
+
+    /**
+     * @brief 汇总登记所有已加载瓦片的内存占用，所属模块为 "Tiles: 目录名"。
+     */
+    void appendMemoryUsage(MemoryReport &report) const;
+
+private:
+    struct Tile
+    {
+        QString filePath;
+        ModelInfo info; ///< 文件头信息
+        std::size_t estimatedBytes = 0;                       ///< 按文件头估算的加载后占用
+        double bounds[6] = {0.0, -1.0, 0.0, -1.0, 0.0, -1.0}; ///< 原始坐标包围盒（读取前为抽样值）
+        double origin[3] = {0.0, 0.0, 0.0};                   ///< 瓦片点坐标（float 局部坐标）的原点
+        std::unique_ptr<ModelPipelineBuilder> builder;          ///< 卸载时为空
+    };
+
+    // 读取瓦片，点坐标为相对 origin 的 float 局部坐标，按 curve 重排点顺序
+    static vtkSmartPointer<vtkPolyData> readTile(const QString &filePath, double origin[3], SpatialReorder::Curve curve);
+    // 以全局中心、高程范围与当前拉伸比例构建瓦片管线
+    bool buildTilePipeline(Tile &tile, vtkSmartPointer<vtkPolyData> polyData);
+    // 以读取的数据更新瓦片的原始坐标包围盒
+    static void updateTileBounds(Tile &tile, vtkPolyData *polyData);
+    // 去掉标记为读取失败的瓦片及其数据，没有剩余瓦片时返回 false
+    bool removeFailedTiles(std::vector<char> &failed, std::vector<vtkSmartPointer<vtkPolyData>> &polyData);
+    // 从视点由近到远选取估算占用之和不超过预算的未加载瓦片，budgetBytes 为 0 时选取全部
+    std::vector<int> selectTilesWithinBudget(const double viewPoint[3], std::size_t budgetBytes) const;
+    // 已加载（resident 为 true，从远到近）或未加载（从近到远）的瓦片按与视点的距离排序
+    std::vector<int> sortByDistance(const double viewPoint[3], bool resident) const;
+    // 原始坐标按全局中心与拉伸比例换算到显示坐标，与瓦片管线的变换一致
+    void worldToDisplay(const double world[3], double display[3]) const;
+
+    QString dirPath_;
+    std::vector<Tile> tiles_;
+    bool hasCenterOverride_ = false;
+    double center_[3] = {0.0, 0.0, 0.0};
+    double elevationRange_[2] = {0.0, 1.0};
+    double bounds_[6] = {0.0, -1.0, 0.0, -1.0, 0.0, -1.0};
+    double zScale_ = 1.0;
+    double compactErrorBound_ = 0.0;
+    SpatialReorder::Curve spatialOrder_ = SpatialReorder::Curve::None;
+    bool viewCulling_ = true;
+};
@@ -0,0 +1,342 @@
+#include "TiledScreenshotExporter.h"
+#include "TraceRecorder.h"
+
+#include <vtkActor2D.h>
+#include <vtkActor2DCollection.h>
+#include <vtkCamera.h>
+#include <vtkCoordinate.h>
+#include <vtkMath.h>
+#include <vtkProperty2D.h>
+#include <vtkRendererCollection.h>
+#include <vtkScalarBarActor.h>
+#include <vtkTextActor.h>
+#include <vtkTextProperty.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtk_png.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace
+{
+    /**
+     * @class PngStreamWriter
+     * @brief 逐行写出 RGB PNG。libpng 以 longjmp 报错，setjmp 所在函数中只使用平凡类型的局部变量。
+     */
+    class PngStreamWriter
+    {
+    public:
+        ~PngStreamWriter() { close(); }
+
+        bool open(const std::string &filePath, int width, int height, int compressionLevel)
+        {
+            file_ = std::fopen(filePath.c_str(), "wb");
+            if (!file_)
+                return false;
+            png_ = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+            info_ = png_ ? png_create_info_struct(png_) : nullptr;
+            if (!info_)
+                return discard(filePath);
+            if (setjmp(png_jmpbuf(png_)))
+                return discard(filePath);
+            png_init_io(png_, file_);
+            png_set_compression_level(png_, compressionLevel);
+            png_set_filter(png_, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB); // 单一滤波器，避免逐行试探五种滤波
+            png_set_IHDR(png_, info_, static_cast<png_uint_32>(width), static_cast<png_uint_32>(height), 8,
+                         PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+            png_write_info(png_, info_);
+            return true;
+        }
+
+        bool writeRow(const unsigned char *row)
+        {
+            if (setjmp(png_jmpbuf(png_)))
+                return false;
+            png_write_row(png_, const_cast<png_bytep>(row));
+            return true;
+        }
+
+        bool finish()
+        {
+            if (setjmp(png_jmpbuf(png_)))
+                return false;
+            png_write_end(png_, nullptr);
+            png_destroy_write_struct(&png_, &info_);
+            png_ = nullptr;
+            info_ = nullptr;
+            bool ok = std::fclose(file_) == 0;
+            file_ = nullptr;
+            return ok;
+        }
+
+    private:
+        // 初始化失败：关闭并删除已创建的空文件
+        bool discard(const std::string &filePath)
+        {
+            close();
+            std::remove(filePath.c_str());
+            return false;
+        }
+
+        void close()
+        {
+            if (png_)
+                png_destroy_write_struct(&png_, info_ ? &info_ : nullptr);
+            if (file_)
+                std::fclose(file_);
+            png_ = nullptr;
+            info_ = nullptr;
+            file_ = nullptr;
+        }
+
+        std::FILE *file_ = nullptr;
+        png_structp png_ = nullptr;
+        png_infop info_ = nullptr;
+    };
+
+    /**
+     * @class OverlayTiler
+     * @brief 把渲染器中可见的 2D actor 换算到整幅输出图像的显示坐标，按块平移，结束后恢复原状态。
+     */
+    class OverlayTiler
+    {
+    public:
+        OverlayTiler(vtkRenderer *renderer, int magnification)
+        {
+            vtkActor2DCollection *actors = renderer->GetActors2D();
+            actors->InitTraversal();
+            for (vtkActor2D *actor = actors->GetNextActor2D(); actor; actor = actors->GetNextActor2D())
+            {
+                if (!actor->GetVisibility())
+                    continue;
+
+                OverlayState state;
+                state.actor = actor;
+                vtkCoordinate *position = actor->GetPositionCoordinate();
+                vtkCoordinate *position2 = actor->GetPosition2Coordinate();
+                state.positionSystem = position->GetCoordinateSystem();
+                state.positionReference = position->GetReferenceCoordinate();
+                std::copy_n(position->GetValue(), 3, state.position);
+                state.position2System = position2->GetCoordinateSystem();
+                std::copy_n(position2->GetValue(), 3, state.position2);
+                state.position2Relative = position2->GetReferenceCoordinate() == position;
+
+                // 原窗口中的显示坐标放大到整幅图像
+                double display[2];
+                std::copy_n(position->GetComputedDoubleDisplayValue(renderer), 2, display);
+                state.fullPosition[0] = display[0] * magnification;
+                state.fullPosition[1] = display[1] * magnification;
+                if (state.position2Relative)
+                {
+                    double *display2 = position2->GetComputedDoubleDisplayValue(renderer);
+                    state.fullExtent[0] = (display2[0] - display[0]) * magnification;
+                    state.fullExtent[1] = (display2[1] - display[1]) * magnification;
+                }
+                state.lineWidth = actor->GetProperty()->GetLineWidth();
+                actor->GetProperty()->SetLineWidth(static_cast<float>(state.lineWidth * magnification));
+                states_.push_back(state);
+
+                if (auto text = vtkTextActor::SafeDownCast(actor))
+                    scaleFont(text->GetTextProperty(), magnification);
+                if (auto scalarBar = vtkScalarBarActor::SafeDownCast(actor))
+                {
+                    scaleFont(scalarBar->GetTitleTextProperty(), magnification);
+                    scaleFont(scalarBar->GetLabelTextProperty(), magnification);
+                    scaleFont(scalarBar->GetAnnotationTextProperty(), magnification);
+                }
+            }
+        }
+
+        ~OverlayTiler()
+        {
+            for (const OverlayState &state : states_)
+            {
+                vtkCoordinate *position = state.actor->GetPositionCoordinate();
+                position->SetCoordinateSystem(state.positionSystem);
+                position->SetReferenceCoordinate(state.positionReference);
+                position->SetValue(state.position[0], state.position[1], state.position[2]);
+                vtkCoordinate *position2 = state.actor->GetPosition2Coordinate();
+                position2->SetCoordinateSystem(state.position2System);
+                position2->SetValue(state.position2[0], state.position2[1], state.position2[2]);
+                state.actor->GetProperty()->SetLineWidth(static_cast<float>(state.lineWidth));
+            }
+            for (const auto &font : fontSizes_)
+                font.first->SetFontSize(font.second);
+        }
+
+        // 将 2D actor 平移到左下角位于整幅图像 (originX, originY) 的分块中
+        void shiftToTile(int originX, int originY)
+        {
+            for (const OverlayState &state : states_)
+            {
+                vtkCoordinate *position = state.actor->GetPositionCoordinate();
+                position->SetReferenceCoordinate(nullptr);
+                position->SetCoordinateSystemToDisplay();
+                position->SetValue(state.fullPosition[0] - originX, state.fullPosition[1] - originY, 0.0);
+                if (state.position2Relative)
+                {
+                    vtkCoordinate *position2 = state.actor->GetPosition2Coordinate();
+                    position2->SetCoordinateSystemToDisplay();
+                    position2->SetValue(state.fullExtent[0], state.fullExtent[1], 0.0);
+                }
+            }
+        }
+
+    private:
+        struct OverlayState
+        {
+            vtkSmartPointer<vtkActor2D> actor;
+            int positionSystem = 0;
+            vtkSmartPointer<vtkCoordinate> positionReference;
+            double position[3] = {0, 0, 0};
+            int position2System = 0;
+            double position2[3] = {0, 0, 0};
+            bool position2Relative = false; ///< Position2 以 Position 为参考（宽高），平移时保持不变
+            double fullPosition[2] = {0, 0};
+            double fullExtent[2] = {0, 0};
+            double lineWidth = 1.0;
+        };
+
+        void scaleFont(vtkTextProperty *property, int magnification)
+        {
+            // 同一文本属性可能被多个 actor 共享，只放大一次
+            if (!property || fontSizes_.count(property))
+                return;
+            fontSizes_[property] = property->GetFontSize();
+            property->SetFontSize(property->GetFontSize() * magnification);
+        }
+
+        std::vector<OverlayState> states_;
+        std::map<vtkSmartPointer<vtkTextProperty>, int> fontSizes_;
+    };
+}
+
+TiledScreenshotExporter::TiledScreenshotExporter(vtkSmartPointer<vtkRenderWindow> renderWindow,
+                                                 vtkSmartPointer<vtkRenderer> renderer)
+    : renderWindow_(renderWindow), renderer_(renderer)
+{
+}
+
+void TiledScreenshotExporter::setMagnification(int magnification)
+{
+    magnification_ = std::max(1, magnification);
+}
+
+int TiledScreenshotExporter::getOutputWidth() const
+{
+    return renderWindow_->GetSize()[0] * magnification_;
+}
+
+int TiledScreenshotExporter::getOutputHeight() const
+{
+    return renderWindow_->GetSize()[1] * magnification_;
+}
+
+bool TiledScreenshotExporter::exportPng(const std::string &filePath)
+{
+    TRACE_SCOPE("TiledScreenshotExporter::exportPng");
+    auto start = std::chrono::steady_clock::now();
+    const int tileWidth = renderWindow_->GetSize()[0];
+    const int tileHeight = renderWindow_->GetSize()[1];
+    const int tiles = magnification_;
+    const int width = tileWidth * tiles;
+    const int height = tileHeight * tiles;
+    if (tileWidth <= 0 || tileHeight <= 0)
+        return false;
+
+    PngStreamWriter writer;
+    if (!writer.open(filePath, width, height, compressionLevel_))
+    {
+        std::cerr << "[TiledScreenshotExporter] Cannot open file for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    // 保存相机，导出后整体恢复
+    vtkCamera *camera = renderer_->GetActiveCamera();
+    auto savedCamera = vtkSmartPointer<vtkCamera>::New();
+    savedCamera->DeepCopy(camera);
+    const double viewAngle = camera->GetViewAngle();
+    const double parallelScale = camera->GetParallelScale();
+
+    // 其他渲染器（坐标轴方向标记等）固定在窗口视口内，分块时会在每块重复出现，导出期间不绘制
+    std::vector<vtkSmartPointer<vtkRenderer>> hiddenRenderers;
+    vtkRendererCollection *renderers = renderWindow_->GetRenderers();
+    renderers->InitTraversal();
+    for (vtkRenderer *renderer = renderers->GetNextItem(); renderer; renderer = renderers->GetNextItem())
+    {
+        if (renderer != renderer_ && renderer->GetDraw())
+        {
+            renderer->DrawOff();
+            hiddenRenderers.push_back(renderer);
+        }
+    }
+
+    const int swapBuffers = renderWindow_->GetSwapBuffers();
+    renderWindow_->SwapBuffersOff(); // 只读后台缓冲，分块画面不出现在界面上
+
+    bool ok = true;
+    {
+        OverlayTiler overlays(renderer_, tiles);
+        auto pixels = vtkSmartPointer<vtkUnsignedCharArray>::New();
+        std::vector<unsigned char> strip(static_cast<std::size_t>(width) * tileHeight * 3);
+        const std::size_t tileRowBytes = static_cast<std::size_t>(tileWidth) * 3;
+        const std::size_t stripRowBytes = static_cast<std::size_t>(width) * 3;
+
+        // 子视锥：视角（或平行缩放）缩小为 1/tiles，WindowCenter 把视锥中心移到对应分块
+        camera->SetViewAngle(vtkMath::DegreesFromRadians(
+            2.0 * std::atan(std::tan(vtkMath::RadiansFromDegrees(viewAngle) / 2.0) / tiles)));
+        camera->SetParallelScale(parallelScale / tiles);
+
+        // PNG 自上而下写行，VTK 像素自下而上，因此从最上面一行分块开始
+        int done = 0;
+        for (int row = tiles - 1; row >= 0 && ok; --row)
+        {
+            for (int column = 0; column < tiles && ok; ++column)
+            {
+                camera->SetWindowCenter(2.0 * column + 1.0 - tiles, 2.0 * row + 1.0 - tiles);
+                overlays.shiftToTile(column * tileWidth, row * tileHeight);
+                renderWindow_->Render();
+                if (renderWindow_->GetPixelData(0, 0, tileWidth - 1, tileHeight - 1, 0, pixels) == 0 ||
+                    pixels->GetNumberOfValues() < static_cast<vtkIdType>(tileRowBytes) * tileHeight)
+                {
+                    std::cerr << "[TiledScreenshotExporter] Failed to read tile pixels." << std::endl;
+                    ok = false;
+                    break;
+                }
+                const unsigned char *source = pixels->GetPointer(0);
+                for (int y = 0; y < tileHeight; ++y)
+                    std::memcpy(&strip[y * stripRowBytes + column * tileRowBytes], source + y * tileRowBytes, tileRowBytes);
+
+                ++done;
+                if (progressCallback_ && !progressCallback_(done, tiles * tiles))
+                    ok = false;
+            }
+            for (int y = tileHeight - 1; y >= 0 && ok; --y)
+                ok = writer.writeRow(&strip[y * stripRowBytes]);
+        }
+        ok = ok && writer.finish();
+    } // 恢复 2D actor
+
+    camera->DeepCopy(savedCamera);
+    for (auto &renderer : hiddenRenderers)
+        renderer->DrawOn();
+    renderWindow_->SetSwapBuffers(swapBuffers);
+    renderWindow_->Render();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    elapsedMilliseconds_ = elapsed.count();
+    if (!ok)
+    {
+        std::remove(filePath.c_str());
+        std::cerr << "[TiledScreenshotExporter] Export failed or cancelled: " << filePath << std::endl;
+        return false;
+    }
+    std::cout << "[TiledScreenshotExporter] Wrote " << width << " x " << height << " (" << tiles << " x " << tiles
+              << " tiles) in " << elapsedMilliseconds_ << " ms: " << filePath << std::endl;
+    return true;
+}
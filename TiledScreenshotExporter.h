@@ -0,0 +1,67 @@
+/**
+ * @file TiledScreenshotExporter.h
+ * @brief 该头文件定义了 TiledScreenshotExporter 类，将当前视图按 N×N 分块渲染并流式拼接为高分辨率 PNG。
+ * @details 输出尺寸为渲染窗口尺寸乘以放大倍数，每块仍按窗口尺寸渲染，因此不受屏幕与 GPU 最大帧缓冲尺寸限制。
+ *          每块通过相机 WindowCenter 偏移并按倍数缩小视角（或平行缩放），得到整幅视锥中对应的子视锥；
+ *          渲染时不交换缓冲区，直接读取后台缓冲，界面上不会看到分块画面。
+ *
+ *          一行分块拼成条带后立即逐行写入 PNG，内存中只保留一条带（宽 × 窗口高），从不持有整幅图像。
+ *          渲染器中的 2D actor（比例尺、颜色图例、测量标注等）先换算为整幅图像中的显示坐标，
+ *          每块渲染前平移到该块的局部坐标；字号与线宽按倍数放大。以像素为单位的几何（比例尺线段长度）
+ *          由所属控制器自行放大，见 ScaleBarController::SetMagnification。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <functional>
+#include <string>
+
+/**
+ * @class TiledScreenshotExporter
+ * @brief 分块高分辨率截图导出器，由 ThreeDimensionalDisplayPage 在导出时临时创建。
+ */
+class TiledScreenshotExporter
+{
+public:
+    /**
+     * @brief 进度回调。
+     * @param done 已完成的块数。
+     * @param total 总块数。
+     * @return 返回 false 取消导出。
+     */
+    using ProgressCallback = std::function<bool(int done, int total)>;
+
+    TiledScreenshotExporter(vtkSmartPointer<vtkRenderWindow> renderWindow, vtkSmartPointer<vtkRenderer> renderer);
+
+    // 放大倍数（每个方向的分块数），输出尺寸 = 窗口尺寸 × 倍数
+    void setMagnification(int magnification);
+    int getMagnification() const { return magnification_; }
+
+    // PNG 压缩等级（0-9），默认 1 以速度优先
+    void setCompressionLevel(int level) { compressionLevel_ = level; }
+
+    void setProgressCallback(ProgressCallback callback) { progressCallback_ = std::move(callback); }
+
+    // 按当前窗口尺寸计算的输出宽高
+    int getOutputWidth() const;
+    int getOutputHeight() const;
+
+    /**
+     * @brief 渲染所有分块并写出 PNG，完成后恢复相机、叠加层与其他渲染器。
+     * @return 写入成功返回 true；失败或取消时删除不完整的文件并返回 false。
+     */
+    bool exportPng(const std::string &filePath);
+
+    // 上一次导出耗时（毫秒）
+    double getElapsedMilliseconds() const { return elapsedMilliseconds_; }
+
+private:
+    vtkSmartPointer<vtkRenderWindow> renderWindow_;
+    vtkSmartPointer<vtkRenderer> renderer_;
+    int magnification_ = 4;
+    int compressionLevel_ = 1;
+    ProgressCallback progressCallback_;
+    double elapsedMilliseconds_ = 0.0;
+};
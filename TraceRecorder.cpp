@@ -0,0 +1,109 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+TraceRecorder &TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+void TraceRecorder::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    dropped_ = 0;
+    startThread_ = currentThreadId(); // 开始录制的线程（界面线程）
+    origin_ = Clock::now();
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void TraceRecorder::stop()
+{
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+std::uint32_t TraceRecorder::currentThreadId()
+{
+    static std::atomic<std::uint32_t> next{1};
+    thread_local std::uint32_t id = next.fetch_add(1);
+    return id;
+}
+
+void TraceRecorder::addComplete(const char *name, const char *category, Clock::time_point begin, Clock::time_point end)
+{
+    std::uint32_t thread = currentThreadId();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isEnabled())
+        return;
+    if (events_.size() >= MaxEvents)
+    {
+        ++dropped_;
+        return;
+    }
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.begin = std::chrono::duration_cast<std::chrono::microseconds>(begin - origin_).count();
+    event.duration = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    event.thread = thread;
+    events_.push_back(event);
+}
+
+std::size_t TraceRecorder::getEventCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+}
+
+std::size_t TraceRecorder::getDroppedCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+bool TraceRecorder::writeJson(const std::string &path) const
+{
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out)
+    {
+        std::cerr << "[TraceRecorder] Cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    // 线程名元数据
+    std::vector<std::uint32_t> threads;
+    for (const Event &event : events_)
+        threads.push_back(event.thread);
+    std::sort(threads.begin(), threads.end());
+    threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+    bool first = true;
+    for (std::uint32_t thread : threads)
+    {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+            << ",\"args\":{\"name\":\"" << (thread == startThread_ ? "main" : "worker ");
+        if (thread != startThread_)
+            out << thread;
+        out << "\"}}";
+        first = false;
+    }
+
+    for (const Event &event : events_)
+    {
+        // 名称与分类均为代码中的静态字符串，不含需要转义的字符
+        out << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+            << "\",\"ph\":\"X\",\"ts\":" << event.begin << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":"
+            << event.thread << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+
+    std::cout << "[TraceRecorder] Wrote " << events_.size() << " events (" << dropped_ << " dropped) to " << path
+              << std::endl;
+    return static_cast<bool>(out);
+}
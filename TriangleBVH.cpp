@@ -0,0 +1,391 @@
+#include "TriangleBVH.h"
+
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace
+{
+    const std::int32_t kLeafSize = 4;
+
+    inline double dot3(const double *a, const double *b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    // 最近点所在的三角形特征：内部、顶点 0..2、边 0..2（边 e 连接顶点 e 与 (e + 1) % 3）
+    enum Feature
+    {
+        FeatureFace = 0,
+        FeatureVertex0 = 1,
+        FeatureEdge0 = 4
+    };
+
+    // 点到三角形最近点（Ericson, Real-Time Collision Detection 5.1.5），返回最近点所在的特征
+    int closestPointOnTriangle(const double p[3], const double a[3], const double b[3], const double c[3], double out[3])
+    {
+        double ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        double ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        double ap[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+        double d1 = dot3(ab, ap);
+        double d2 = dot3(ac, ap);
+        if (d1 <= 0.0 && d2 <= 0.0)
+        {
+            std::copy(a, a + 3, out);
+            return FeatureVertex0;
+        }
+
+        double bp[3] = {p[0] - b[0], p[1] - b[1], p[2] - b[2]};
+        double d3 = dot3(ab, bp);
+        double d4 = dot3(ac, bp);
+        if (d3 >= 0.0 && d4 <= d3)
+        {
+            std::copy(b, b + 3, out);
+            return FeatureVertex0 + 1;
+        }
+
+        double vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+        {
+            double v = d1 / (d1 - d3);
+            for (int k = 0; k < 3; ++k)
+                out[k] = a[k] + v * ab[k];
+            return FeatureEdge0;
+        }
+
+        double cp[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+        double d5 = dot3(ab, cp);
+        double d6 = dot3(ac, cp);
+        if (d6 >= 0.0 && d5 <= d6)
+        {
+            std::copy(c, c + 3, out);
+            return FeatureVertex0 + 2;
+        }
+
+        double vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+        {
+            double w = d2 / (d2 - d6);
+            for (int k = 0; k < 3; ++k)
+                out[k] = a[k] + w * ac[k];
+            return FeatureEdge0 + 2;
+        }
+
+        double va = d3 * d6 - d5 * d4;
+        if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+        {
+            double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            for (int k = 0; k < 3; ++k)
+                out[k] = b[k] + w * (c[k] - b[k]);
+            return FeatureEdge0 + 1;
+        }
+
+        double denom = 1.0 / (va + vb + vc);
+        double v = vb * denom;
+        double w = vc * denom;
+        for (int k = 0; k < 3; ++k)
+            out[k] = a[k] + ab[k] * v + ac[k] * w;
+        return FeatureFace;
+    }
+
+    // 三角形的一条边，点号按从小到大排列，slot 为 3 * 三角形序号 + 局部边号
+    struct EdgeKey
+    {
+        std::int64_t lo;
+        std::int64_t hi;
+        std::int64_t slot;
+    };
+}
+
+bool TriangleBVH::build(vtkPolyData *mesh, double zScale)
+{
+    vertices_.clear();
+    normals_.clear();
+    triangleVertices_.clear();
+    vertexNormals_.clear();
+    edgeNormals_.clear();
+    order_.clear();
+    nodes_.clear();
+    if (!mesh || mesh->GetNumberOfPolys() == 0)
+        return false;
+
+    const double invZ = zScale > 0.0 ? 1.0 / zScale : 1.0;
+    vtkPoints *points = mesh->GetPoints();
+    vtkCellArray *polys = mesh->GetPolys();
+    vertices_.reserve(static_cast<std::size_t>(mesh->GetNumberOfPolys()) * 9);
+    triangleVertices_.reserve(static_cast<std::size_t>(mesh->GetNumberOfPolys()) * 3);
+
+    // 多边形按扇形拆为三角形
+    vtkIdType npts = 0;
+    vtkIdType *pts = nullptr;
+    double p[3][3];
+    for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+    {
+        for (vtkIdType k = 1; k + 1 < npts; ++k)
+        {
+            points->GetPoint(pts[0], p[0]);
+            points->GetPoint(pts[k], p[1]);
+            points->GetPoint(pts[k + 1], p[2]);
+            triangleVertices_.push_back(pts[0]);
+            triangleVertices_.push_back(pts[k]);
+            triangleVertices_.push_back(pts[k + 1]);
+            for (int v = 0; v < 3; ++v)
+            {
+                vertices_.push_back(static_cast<float>(p[v][0]));
+                vertices_.push_back(static_cast<float>(p[v][1]));
+                vertices_.push_back(static_cast<float>(p[v][2] * invZ));
+            }
+        }
+    }
+
+    const std::int64_t numTriangles = static_cast<std::int64_t>(vertices_.size() / 9);
+    if (numTriangles == 0)
+        return false;
+
+    normals_.resize(static_cast<std::size_t>(numTriangles) * 3);
+    std::vector<float> centroids(static_cast<std::size_t>(numTriangles) * 3);
+    order_.resize(static_cast<std::size_t>(numTriangles));
+    for (std::int64_t t = 0; t < numTriangles; ++t)
+    {
+        const float *v = &vertices_[9 * t];
+        double e1[3] = {v[3] - v[0], v[4] - v[1], v[5] - v[2]};
+        double e2[3] = {v[6] - v[0], v[7] - v[1], v[8] - v[2]};
+        double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+        double len = std::sqrt(dot3(n, n));
+        for (int k = 0; k < 3; ++k)
+        {
+            normals_[3 * t + k] = len > 0.0 ? static_cast<float>(n[k] / len) : 0.0f;
+            centroids[3 * t + k] = (v[k] + v[3 + k] + v[6 + k]) / 3.0f;
+        }
+        order_[t] = t;
+    }
+    buildPseudonormals(mesh->GetNumberOfPoints());
+
+    nodes_.reserve(static_cast<std::size_t>(2 * numTriangles / kLeafSize + 1));
+    buildNode(0, numTriangles, centroids);
+
+    std::cout << "[TriangleBVH] Built " << nodes_.size() << " nodes over " << numTriangles << " triangles." << std::endl;
+    return true;
+}
+
+void TriangleBVH::buildPseudonormals(std::int64_t numPoints)
+{
+    const std::int64_t numTriangles = getNumberOfTriangles();
+
+    // 顶点伪法向：相邻三角形法向按该顶点处的内角加权求和（Bærentzen & Aanæs 2005）
+    std::vector<double> vertexSum(static_cast<std::size_t>(numPoints) * 3, 0.0);
+    for (std::int64_t t = 0; t < numTriangles; ++t)
+    {
+        const float *v = &vertices_[9 * t];
+        const float *n = &normals_[3 * t];
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const float *o = v + 3 * corner;
+            const float *a = v + 3 * ((corner + 1) % 3);
+            const float *b = v + 3 * ((corner + 2) % 3);
+            double ea[3] = {a[0] - o[0], a[1] - o[1], a[2] - o[2]};
+            double eb[3] = {b[0] - o[0], b[1] - o[1], b[2] - o[2]};
+            double la = std::sqrt(dot3(ea, ea));
+            double lb = std::sqrt(dot3(eb, eb));
+            if (la <= 0.0 || lb <= 0.0)
+                continue;
+            double angle = std::acos(std::max(-1.0, std::min(1.0, dot3(ea, eb) / (la * lb))));
+            std::int64_t id = triangleVertices_[3 * t + corner];
+            for (int k = 0; k < 3; ++k)
+                vertexSum[3 * id + k] += angle * n[k];
+        }
+    }
+    vertexNormals_.assign(vertexSum.begin(), vertexSum.end());
+
+    // 边伪法向：共享该边的三角形法向之和，边界边即所在三角形的法向
+    std::vector<EdgeKey> edges(static_cast<std::size_t>(numTriangles) * 3);
+    for (std::int64_t t = 0; t < numTriangles; ++t)
+    {
+        for (int e = 0; e < 3; ++e)
+        {
+            std::int64_t a = triangleVertices_[3 * t + e];
+            std::int64_t b = triangleVertices_[3 * t + (e + 1) % 3];
+            edges[3 * t + e] = {std::min(a, b), std::max(a, b), 3 * t + e};
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const EdgeKey &x, const EdgeKey &y)
+              { return x.lo != y.lo ? x.lo < y.lo : x.hi < y.hi; });
+
+    edgeNormals_.assign(static_cast<std::size_t>(numTriangles) * 9, 0.0f);
+    for (std::size_t begin = 0; begin < edges.size();)
+    {
+        std::size_t end = begin + 1;
+        while (end < edges.size() && edges[end].lo == edges[begin].lo && edges[end].hi == edges[begin].hi)
+            ++end;
+        double sum[3] = {0.0, 0.0, 0.0};
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const float *n = &normals_[3 * (edges[i].slot / 3)];
+            for (int k = 0; k < 3; ++k)
+                sum[k] += n[k];
+        }
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+                edgeNormals_[3 * edges[i].slot + k] = static_cast<float>(sum[k]);
+        }
+        begin = end;
+    }
+}
+
+std::int64_t TriangleBVH::buildNode(std::int64_t begin, std::int64_t end, const std::vector<float> &centroids)
+{
+    std::int64_t index = static_cast<std::int64_t>(nodes_.size());
+    nodes_.push_back(Node());
+
+    // 节点包围盒与质心包围盒
+    float bmin[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+    float bmax[3] = {-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+    float cmin[3] = {bmin[0], bmin[1], bmin[2]};
+    float cmax[3] = {bmax[0], bmax[1], bmax[2]};
+    for (std::int64_t i = begin; i < end; ++i)
+    {
+        std::int64_t t = order_[i];
+        const float *v = &vertices_[9 * t];
+        for (int k = 0; k < 3; ++k)
+        {
+            bmin[k] = std::min({bmin[k], v[k], v[3 + k], v[6 + k]});
+            bmax[k] = std::max({bmax[k], v[k], v[3 + k], v[6 + k]});
+            cmin[k] = std::min(cmin[k], centroids[3 * t + k]);
+            cmax[k] = std::max(cmax[k], centroids[3 * t + k]);
+        }
+    }
+    std::copy(bmin, bmin + 3, nodes_[index].bmin);
+    std::copy(bmax, bmax + 3, nodes_[index].bmax);
+
+    std::int64_t count = end - begin;
+    if (count <= kLeafSize)
+    {
+        nodes_[index].start = begin;
+        nodes_[index].count = static_cast<std::int32_t>(count);
+        return index;
+    }
+
+    // 沿质心最长轴按中位数划分
+    int axis = 0;
+    float extent[3] = {cmax[0] - cmin[0], cmax[1] - cmin[1], cmax[2] - cmin[2]};
+    if (extent[1] > extent[axis])
+        axis = 1;
+    if (extent[2] > extent[axis])
+        axis = 2;
+    std::int64_t mid = begin + count / 2;
+    std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end,
+                     [&](std::int64_t a, std::int64_t b)
+                     { return centroids[3 * a + axis] < centroids[3 * b + axis]; });
+
+    buildNode(begin, mid, centroids); // 左孩子紧跟当前节点
+    std::int64_t right = buildNode(mid, end, centroids);
+    nodes_[index].start = right;
+    nodes_[index].count = 0;
+    return index;
+}
+
+double TriangleBVH::pointBoxDistance2(const double p[3], const Node &node)
+{
+    double d2 = 0.0;
+    for (int k = 0; k < 3; ++k)
+    {
+        double d = 0.0;
+        if (p[k] < node.bmin[k])
+            d = node.bmin[k] - p[k];
+        else if (p[k] > node.bmax[k])
+            d = p[k] - node.bmax[k];
+        d2 += d * d;
+    }
+    return d2;
+}
+
+double TriangleBVH::closestPoint(const double p[3], double closest[3], std::int64_t &triangle) const
+{
+    int feature = FeatureFace;
+    return closestFeature(p, closest, triangle, feature);
+}
+
+double TriangleBVH::closestFeature(const double p[3], double closest[3], std::int64_t &triangle, int &feature) const
+{
+    triangle = -1;
+    if (nodes_.empty())
+        return -1.0;
+
+    double best = std::numeric_limits<double>::max();
+    // 中位数划分保证树深约为 log2(N)，深度优先遍历的栈深不超过树深 + 1
+    std::int64_t stack[128];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node &node = nodes_[stack[--top]];
+        if (pointBoxDistance2(p, node) >= best)
+            continue;
+
+        if (node.count > 0)
+        {
+            for (std::int32_t i = 0; i < node.count; ++i)
+            {
+                std::int64_t t = order_[node.start + i];
+                const float *v = &vertices_[9 * t];
+                double a[3] = {v[0], v[1], v[2]};
+                double b[3] = {v[3], v[4], v[5]};
+                double c[3] = {v[6], v[7], v[8]};
+                double q[3];
+                int f = closestPointOnTriangle(p, a, b, c, q);
+                double d[3] = {p[0] - q[0], p[1] - q[1], p[2] - q[2]};
+                double d2 = dot3(d, d);
+                if (d2 < best)
+                {
+                    best = d2;
+                    triangle = t;
+                    feature = f;
+                    std::copy(q, q + 3, closest);
+                }
+            }
+            continue;
+        }
+
+        // 先访问更近的孩子（后入栈），便于尽早收紧 best
+        std::int64_t left = &node - nodes_.data() + 1;
+        std::int64_t right = node.start;
+        double dl = pointBoxDistance2(p, nodes_[left]);
+        double dr = pointBoxDistance2(p, nodes_[right]);
+        if (dl < dr)
+        {
+            stack[top++] = right;
+            stack[top++] = left;
+        }
+        else
+        {
+            stack[top++] = left;
+            stack[top++] = right;
+        }
+    }
+    return best;
+}
+
+double TriangleBVH::signedDistance(const double p[3]) const
+{
+    double closest[3];
+    std::int64_t triangle = -1;
+    int feature = FeatureFace;
+    double d2 = closestFeature(p, closest, triangle, feature);
+    if (triangle < 0)
+        return 0.0;
+
+    // 最近点在边或顶点上时相邻三角形的面法向可能给出相反的符号，改用该特征的伪法向
+    const float *n = &normals_[3 * triangle];
+    if (feature >= FeatureEdge0)
+        n = &edgeNormals_[9 * triangle + 3 * (feature - FeatureEdge0)];
+    else if (feature >= FeatureVertex0)
+        n = &vertexNormals_[3 * triangleVertices_[3 * triangle + feature - FeatureVertex0]];
+    double side = (p[0] - closest[0]) * n[0] + (p[1] - closest[1]) * n[1] + (p[2] - closest[2]) * n[2];
+    double distance = std::sqrt(d2);
+    return side < 0.0 ? -distance : distance;
+}
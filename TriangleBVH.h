@@ -0,0 +1,77 @@
+/**
+ * @file TriangleBVH.h
+ * @brief 该头文件定义了 TriangleBVH 类，三角形包围体层次树，用于快速查询点到网格的最近距离。
+ * @details 构建时把多边形按扇形拆成三角形并复制为紧凑的 float 顶点数组，按最长轴中位数递归划分，
+ *          节点以数组形式线性存储。查询只读，可以在多个线程中同时调用。
+ *          有符号距离按最近点所在特征取符号：三角形内部用面法向，边与顶点用角度加权伪法向
+ *          （Bærentzen & Aanæs 2005），伪法向按网格点号共享，要求网格已焊接且绕向一致。
+ */
+#pragma once
+
+#include <vtkPolyData.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class TriangleBVH
+ * @brief 三角形 BVH，支持并行的最近点 / 有符号距离查询。
+ */
+class TriangleBVH
+{
+public:
+    /**
+     * @brief 由网格构建 BVH。
+     * @param mesh 含多边形单元的网格。
+     * @param zScale 网格显示时的 Z 轴拉伸比例，构建时 Z 坐标会除以该比例还原真实尺度。
+     * @return 网格没有三角形时返回 false。
+     */
+    bool build(vtkPolyData *mesh, double zScale = 1.0);
+
+    /**
+     * @brief 查询点到网格的最近点。
+     * @param p 查询点（与构建时处于同一尺度）。
+     * @param closest 输出最近点。
+     * @param triangle 输出最近三角形序号。
+     * @return 最近距离的平方，BVH 为空时返回 -1。
+     */
+    double closestPoint(const double p[3], double closest[3], std::int64_t &triangle) const;
+
+    /**
+     * @brief 查询点到网格的有符号距离，沿最近特征（面 / 边 / 顶点）的伪法向为正。
+     */
+    double signedDistance(const double p[3]) const;
+
+    std::int64_t getNumberOfTriangles() const { return static_cast<std::int64_t>(normals_.size() / 3); }
+    bool empty() const { return nodes_.empty(); }
+
+    // 占用的内存字节数
+    std::size_t getMemorySize() const
+    {
+        return (vertices_.capacity() + normals_.capacity() + vertexNormals_.capacity() + edgeNormals_.capacity()) * sizeof(float) +
+               (order_.capacity() + triangleVertices_.capacity()) * sizeof(std::int64_t) + nodes_.capacity() * sizeof(Node);
+    }
+
+private:
+    struct Node
+    {
+        float bmin[3];
+        float bmax[3];
+        std::int64_t start; ///< 叶子：三角形在 order_ 中的起始位置；内部节点：右孩子下标
+        std::int32_t count; ///< 叶子三角形数，0 表示内部节点（左孩子为当前下标 + 1）
+    };
+
+    std::int64_t buildNode(std::int64_t begin, std::int64_t end, const std::vector<float> &centroids);
+    void buildPseudonormals(std::int64_t numPoints);
+    // 同 closestPoint，另输出最近点所在特征（内部 / 顶点 / 边）
+    double closestFeature(const double p[3], double closest[3], std::int64_t &triangle, int &feature) const;
+    static double pointBoxDistance2(const double p[3], const Node &node);
+
+    std::vector<float> vertices_;      ///< 每个三角形 9 个 float
+    std::vector<float> normals_;       ///< 每个三角形单位法向 3 个 float
+    std::vector<std::int64_t> triangleVertices_; ///< 每个三角形 3 个网格点号
+    std::vector<float> vertexNormals_; ///< 每个网格点的角度加权伪法向（未归一化）
+    std::vector<float> edgeNormals_;   ///< 每个三角形 3 条边的伪法向（未归一化）
+    std::vector<std::int64_t> order_;  ///< 叶子中三角形顺序
+    std::vector<Node> nodes_;
+};
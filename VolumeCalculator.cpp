@@ -0,0 +1,584 @@
+#include "VolumeCalculator.h"
+
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+#include <vtkDataArray.h>
+#include <vtkSMPTools.h>
+#include <vtkSMPThreadLocal.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    // 批量读取点坐标：float/double 直接访问原始数组，避免逐点虚函数调用
+    template <typename Func>
+    void forEachPoint(vtkPoints *points, vtkIdType begin, vtkIdType end, Func &&func)
+    {
+        vtkDataArray *data = points->GetData();
+        if (points->GetDataType() == VTK_FLOAT)
+        {
+            const float *p = static_cast<const float *>(data->GetVoidPointer(0));
+            for (vtkIdType i = begin; i < end; ++i)
+                func(i, p[3 * i], p[3 * i + 1], p[3 * i + 2]);
+        }
+        else if (points->GetDataType() == VTK_DOUBLE)
+        {
+            const double *p = static_cast<const double *>(data->GetVoidPointer(0));
+            for (vtkIdType i = begin; i < end; ++i)
+                func(i, p[3 * i], p[3 * i + 1], p[3 * i + 2]);
+        }
+        else
+        {
+            double p[3];
+            for (vtkIdType i = begin; i < end; ++i)
+            {
+                data->GetTuple(i, p);
+                func(i, p[0], p[1], p[2]);
+            }
+        }
+    }
+
+    // 多边形按扇形拆为三角形（每 3 个点号一个三角形），之后可并行随机访问
+    std::vector<vtkIdType> collectTriangles(vtkPolyData *data)
+    {
+        std::vector<vtkIdType> triangles;
+        triangles.reserve(static_cast<std::size_t>(data->GetNumberOfPolys()) * 3);
+        vtkCellArray *polys = data->GetPolys();
+        vtkIdType npts = 0;
+        vtkIdType *pts = nullptr;
+        for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+        {
+            for (vtkIdType k = 1; k + 1 < npts; ++k)
+            {
+                triangles.push_back(pts[0]);
+                triangles.push_back(pts[k]);
+                triangles.push_back(pts[k + 1]);
+            }
+        }
+        return triangles;
+    }
+
+    // 各线程的局部格网累加
+    struct GridPartial
+    {
+        std::vector<double> sum;
+        std::vector<int> count;
+        vtkIdType used = 0;
+    };
+
+    // 合并各线程的局部格网并求每格平均高程，返回参与的样本数
+    vtkIdType mergePartials(vtkSMPThreadLocal<GridPartial> &partials, std::size_t numCells,
+                            std::vector<double> &height, std::vector<int> &count)
+    {
+        height.assign(numCells, 0.0);
+        count.assign(numCells, 0);
+        vtkIdType used = 0;
+        for (auto it = partials.begin(); it != partials.end(); ++it)
+        {
+            if (it->sum.empty())
+                continue;
+            for (std::size_t c = 0; c < numCells; ++c)
+            {
+                height[c] += it->sum[c];
+                count[c] += it->count[c];
+            }
+            used += it->used;
+        }
+        for (std::size_t c = 0; c < numCells; ++c)
+        {
+            if (count[c] > 0)
+                height[c] /= count[c];
+        }
+        return used;
+    }
+
+    // 线性高差 h 在三角形上的正、负部分积分（A 为水平投影面积）
+    void integrateTriangle(double A, double h0, double h1, double h2, double &positive, double &negative)
+    {
+        double total = A * (h0 + h1 + h2) / 3.0;
+        if (h0 >= 0.0 && h1 >= 0.0 && h2 >= 0.0)
+        {
+            positive += total;
+            return;
+        }
+        if (h0 <= 0.0 && h1 <= 0.0 && h2 <= 0.0)
+        {
+            negative -= total;
+            return;
+        }
+        int numPositive = (h0 > 0.0) + (h1 > 0.0) + (h2 > 0.0);
+
+        // 找出符号“孤立”的顶点，其所在角上的小三角形面积占比为 t1*t2
+        double h[3] = {h0, h1, h2};
+        bool lonePositive = numPositive == 1;
+        int lone = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            if ((h[k] > 0.0) == lonePositive)
+            {
+                lone = k;
+                break;
+            }
+        }
+        double ha = h[lone];
+        double hb = h[(lone + 1) % 3];
+        double hc = h[(lone + 2) % 3];
+        double t1 = ha / (ha - hb);
+        double t2 = ha / (ha - hc);
+        double corner = A * t1 * t2 * ha / 3.0; // 孤立角部分的积分（与 ha 同号）
+
+        if (lonePositive)
+        {
+            positive += corner;
+            negative -= (total - corner);
+        }
+        else
+        {
+            negative -= corner;
+            positive += (total - corner);
+        }
+    }
+}
+
+bool VolumeCalculator::setReferencePlane(const double p0[3], const double p1[3], const double p2[3])
+{
+    double u[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    double v[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+    double n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+    // 平面必须不竖直，才能写成 z = f(x, y)
+    if (std::abs(n[2]) < 1e-12)
+        return false;
+    plane_[0] = -n[0] / n[2];
+    plane_[1] = -n[1] / n[2];
+    plane_[2] = p0[2] - plane_[0] * p0[0] - plane_[1] * p0[1];
+    referenceType_ = ReferenceType::Plane;
+    return true;
+}
+
+void VolumeCalculator::setReferenceHeightPlane(double a, double b, double c)
+{
+    plane_[0] = a;
+    plane_[1] = b;
+    plane_[2] = c;
+    referenceType_ = ReferenceType::Plane;
+}
+
+void VolumeCalculator::setReferenceFitted()
+{
+    referenceType_ = ReferenceType::FittedPlane;
+}
+
+void VolumeCalculator::setReferenceSurface(vtkSmartPointer<vtkPolyData> surface)
+{
+    referenceSurface_ = surface;
+    referenceType_ = ReferenceType::Surface;
+}
+
+void VolumeCalculator::setRegionPolygon(const std::vector<std::array<double, 2>> &polygon)
+{
+    polygon_ = polygon.size() >= 3 ? polygon : std::vector<std::array<double, 2>>();
+}
+
+void VolumeCalculator::setRegionBounds(const double bounds[6])
+{
+    std::copy(bounds, bounds + 6, bounds_);
+    hasBounds_ = true;
+}
+
+void VolumeCalculator::clearRegion()
+{
+    polygon_.clear();
+    hasBounds_ = false;
+}
+
+bool VolumeCalculator::insideRegion(double x, double y) const
+{
+    if (hasBounds_ && (x < bounds_[0] || x > bounds_[1] || y < bounds_[2] || y > bounds_[3]))
+        return false;
+    if (polygon_.empty())
+        return true;
+
+    // 射线法判断点是否在多边形内
+    bool inside = false;
+    for (std::size_t i = 0, j = polygon_.size() - 1; i < polygon_.size(); j = i++)
+    {
+        const auto &a = polygon_[i];
+        const auto &b = polygon_[j];
+        if ((a[1] > y) != (b[1] > y) &&
+            x < (b[0] - a[0]) * (y - a[1]) / (b[1] - a[1]) + a[0])
+            inside = !inside;
+    }
+    return inside;
+}
+
+bool VolumeCalculator::insideZRange(double z) const
+{
+    return !hasBounds_ || (z >= bounds_[4] && z <= bounds_[5]);
+}
+
+bool VolumeCalculator::initGrid(vtkPolyData *data, Grid &grid) const
+{
+    double b[6];
+    data->GetBounds(b);
+    if (hasBounds_)
+    {
+        b[0] = std::max(b[0], bounds_[0]);
+        b[1] = std::min(b[1], bounds_[1]);
+        b[2] = std::max(b[2], bounds_[2]);
+        b[3] = std::min(b[3], bounds_[3]);
+    }
+    if (!polygon_.empty())
+    {
+        double px[2] = {polygon_[0][0], polygon_[0][0]};
+        double py[2] = {polygon_[0][1], polygon_[0][1]};
+        for (const auto &p : polygon_)
+        {
+            px[0] = std::min(px[0], p[0]);
+            px[1] = std::max(px[1], p[0]);
+            py[0] = std::min(py[0], p[1]);
+            py[1] = std::max(py[1], p[1]);
+        }
+        b[0] = std::max(b[0], px[0]);
+        b[1] = std::min(b[1], px[1]);
+        b[2] = std::max(b[2], py[0]);
+        b[3] = std::min(b[3], py[1]);
+    }
+    double extent = std::max(b[1] - b[0], b[3] - b[2]);
+    if (!(extent > 0.0))
+        return false;
+
+    grid.cellSize = extent / gridResolution_;
+    grid.origin[0] = b[0];
+    grid.origin[1] = b[2];
+    grid.nx = std::max(1, static_cast<int>(std::ceil((b[1] - b[0]) / grid.cellSize)));
+    grid.ny = std::max(1, static_cast<int>(std::ceil((b[3] - b[2]) / grid.cellSize)));
+    return true;
+}
+
+vtkIdType VolumeCalculator::rasterise(vtkPolyData *data, Grid &grid) const
+{
+    const std::size_t numCells = static_cast<std::size_t>(grid.nx) * grid.ny;
+    vtkSMPThreadLocal<GridPartial> partials;
+
+    vtkPoints *points = data->GetPoints();
+    vtkSMPTools::For(0, data->GetNumberOfPoints(), [&](vtkIdType begin, vtkIdType end)
+                     {
+        GridPartial &local = partials.Local();
+        if (local.sum.empty())
+        {
+            local.sum.assign(numCells, 0.0);
+            local.count.assign(numCells, 0);
+        }
+        forEachPoint(points, begin, end, [&](vtkIdType, double x, double y, double z)
+                     {
+            if (!insideZRange(z))
+                return;
+            double fx = (x - grid.origin[0]) / grid.cellSize;
+            double fy = (y - grid.origin[1]) / grid.cellSize;
+            if (fx < 0.0 || fy < 0.0 || fx > grid.nx || fy > grid.ny)
+                return;
+            int ix = std::min(static_cast<int>(fx), grid.nx - 1); // 右/上边界上的点归入最后一格
+            int iy = std::min(static_cast<int>(fy), grid.ny - 1);
+            std::size_t cell = static_cast<std::size_t>(iy) * grid.nx + ix;
+            local.sum[cell] += z;
+            ++local.count[cell];
+            ++local.used; }); });
+
+    return mergePartials(partials, numCells, grid.height, grid.count);
+}
+
+vtkIdType VolumeCalculator::rasteriseSurface(vtkPolyData *surface, Grid &grid) const
+{
+    // 每个三角形覆盖的格网中心按重心坐标插值高程；多个三角形覆盖同一格（如折叠处）时取平均
+    const std::size_t numCells = static_cast<std::size_t>(grid.nx) * grid.ny;
+    std::vector<vtkIdType> triangles = collectTriangles(surface);
+    vtkSMPThreadLocal<GridPartial> partials;
+    vtkPoints *points = surface->GetPoints();
+    const vtkIdType numTriangles = static_cast<vtkIdType>(triangles.size() / 3);
+    vtkSMPTools::For(0, numTriangles, [&](vtkIdType begin, vtkIdType end)
+                     {
+        GridPartial &local = partials.Local();
+        if (local.sum.empty())
+        {
+            local.sum.assign(numCells, 0.0);
+            local.count.assign(numCells, 0);
+        }
+        double p[3][3];
+        for (vtkIdType t = begin; t < end; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+                points->GetPoint(triangles[3 * t + k], p[k]);
+            const double det = (p[1][1] - p[2][1]) * (p[0][0] - p[2][0]) + (p[2][0] - p[1][0]) * (p[0][1] - p[2][1]);
+            if (det == 0.0)
+                continue; // 竖直三角形没有水平投影
+
+            // 中心落在三角形包围盒内的格网单元
+            const double minX = std::min({p[0][0], p[1][0], p[2][0]});
+            const double maxX = std::max({p[0][0], p[1][0], p[2][0]});
+            const double minY = std::min({p[0][1], p[1][1], p[2][1]});
+            const double maxY = std::max({p[0][1], p[1][1], p[2][1]});
+            const int ix0 = std::max(0, static_cast<int>(std::ceil((minX - grid.origin[0]) / grid.cellSize - 0.5)));
+            const int ix1 = std::min(grid.nx - 1, static_cast<int>(std::floor((maxX - grid.origin[0]) / grid.cellSize - 0.5)));
+            const int iy0 = std::max(0, static_cast<int>(std::ceil((minY - grid.origin[1]) / grid.cellSize - 0.5)));
+            const int iy1 = std::min(grid.ny - 1, static_cast<int>(std::floor((maxY - grid.origin[1]) / grid.cellSize - 0.5)));
+            bool covered = false;
+            for (int iy = iy0; iy <= iy1; ++iy)
+            {
+                const double cy = grid.origin[1] + (iy + 0.5) * grid.cellSize;
+                for (int ix = ix0; ix <= ix1; ++ix)
+                {
+                    const double cx = grid.origin[0] + (ix + 0.5) * grid.cellSize;
+                    const double l0 = ((p[1][1] - p[2][1]) * (cx - p[2][0]) + (p[2][0] - p[1][0]) * (cy - p[2][1])) / det;
+                    const double l1 = ((p[2][1] - p[0][1]) * (cx - p[2][0]) + (p[0][0] - p[2][0]) * (cy - p[2][1])) / det;
+                    const double l2 = 1.0 - l0 - l1;
+                    const double eps = -1e-9; // 共享边上的中心两侧三角形都计入，平均后不变
+                    if (l0 < eps || l1 < eps || l2 < eps)
+                        continue;
+                    std::size_t cell = static_cast<std::size_t>(iy) * grid.nx + ix;
+                    local.sum[cell] += l0 * p[0][2] + l1 * p[1][2] + l2 * p[2][2];
+                    ++local.count[cell];
+                    covered = true;
+                }
+            }
+            local.used += covered ? 1 : 0;
+        } });
+    return mergePartials(partials, numCells, grid.height, grid.count);
+}
+
+bool VolumeCalculator::fitBasePlane(const Grid &grid)
+{
+    // 区域内且与区域外（或格网外）相邻的格网单元视为边界，对其高程做最小二乘平面拟合
+    auto cellInside = [&](int ix, int iy)
+    {
+        if (ix < 0 || iy < 0 || ix >= grid.nx || iy >= grid.ny)
+            return false;
+        double cx = grid.origin[0] + (ix + 0.5) * grid.cellSize;
+        double cy = grid.origin[1] + (iy + 0.5) * grid.cellSize;
+        return insideRegion(cx, cy);
+    };
+
+    double ata[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    double atb[3] = {0, 0, 0};
+    int used = 0;
+    for (int iy = 0; iy < grid.ny; ++iy)
+    {
+        for (int ix = 0; ix < grid.nx; ++ix)
+        {
+            std::size_t cell = static_cast<std::size_t>(iy) * grid.nx + ix;
+            if (grid.count[cell] == 0 || !cellInside(ix, iy))
+                continue;
+            bool border = !cellInside(ix - 1, iy) || !cellInside(ix + 1, iy) ||
+                          !cellInside(ix, iy - 1) || !cellInside(ix, iy + 1);
+            if (!border)
+                continue;
+            double row[3] = {grid.origin[0] + (ix + 0.5) * grid.cellSize,
+                             grid.origin[1] + (iy + 0.5) * grid.cellSize, 1.0};
+            for (int r = 0; r < 3; ++r)
+            {
+                for (int c = 0; c < 3; ++c)
+                    ata[r][c] += row[r] * row[c];
+                atb[r] += row[r] * grid.height[cell];
+            }
+            ++used;
+        }
+    }
+    if (used < 3)
+        return false;
+
+    // 3x3 正规方程，Cramer 法则求解
+    auto det3 = [](const double m[3][3])
+    {
+        return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+               m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+               m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    };
+    double det = det3(ata);
+    if (std::abs(det) < 1e-12)
+        return false;
+    for (int k = 0; k < 3; ++k)
+    {
+        double m[3][3];
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                m[r][c] = (c == k) ? atb[r] : ata[r][c];
+        plane_[k] = det3(m) / det;
+    }
+    std::cout << "[VolumeCalculator] Fitted base plane from " << used << " border cells: z = "
+              << plane_[0] << "*x + " << plane_[1] << "*y + " << plane_[2] << std::endl;
+    return true;
+}
+
+bool VolumeCalculator::referenceHeight(double x, double y, double &z) const
+{
+    if (referenceType_ != ReferenceType::Surface)
+    {
+        z = plane_[0] * x + plane_[1] * y + plane_[2];
+        return true;
+    }
+    const Grid &g = referenceGrid_;
+    double fx = (x - g.origin[0]) / g.cellSize;
+    double fy = (y - g.origin[1]) / g.cellSize;
+    if (fx < 0.0 || fy < 0.0 || fx > g.nx || fy > g.ny)
+        return false;
+    int ix = std::min(static_cast<int>(fx), g.nx - 1); // 与 rasterise 一致，右/上边界归入最后一格
+    int iy = std::min(static_cast<int>(fy), g.ny - 1);
+    std::size_t cell = static_cast<std::size_t>(iy) * g.nx + ix;
+    if (g.count[cell] == 0)
+        return false;
+    z = g.height[cell];
+    return true;
+}
+
+VolumeResult VolumeCalculator::compute(vtkPolyData *data)
+{
+    if (!data || data->GetNumberOfPoints() == 0)
+        return VolumeResult();
+
+    Grid grid;
+    if (!initGrid(data, grid))
+    {
+        std::cerr << "[VolumeCalculator] Region does not overlap the data." << std::endl;
+        return VolumeResult();
+    }
+
+    // 点云与拟合基准面都需要被测数据的栅格，只栅格化一次
+    const bool isMesh = data->GetNumberOfPolys() > 0;
+    if (!isMesh || referenceType_ == ReferenceType::FittedPlane)
+        rasterise(data, grid);
+
+    // 参考面准备：参考模型按同一格网栅格化
+    if (referenceType_ == ReferenceType::FittedPlane)
+    {
+        if (!fitBasePlane(grid))
+        {
+            std::cerr << "[VolumeCalculator] Not enough border samples to fit a base plane." << std::endl;
+            return VolumeResult();
+        }
+    }
+    else if (referenceType_ == ReferenceType::Surface)
+    {
+        if (!referenceSurface_ || referenceSurface_->GetNumberOfPoints() == 0)
+            return VolumeResult();
+        referenceGrid_ = Grid();
+        referenceGrid_.origin[0] = grid.origin[0];
+        referenceGrid_.origin[1] = grid.origin[1];
+        referenceGrid_.cellSize = grid.cellSize;
+        referenceGrid_.nx = grid.nx;
+        referenceGrid_.ny = grid.ny;
+        if (referenceSurface_->GetNumberOfPolys() > 0)
+        {
+            // 网格参考面按三角形覆盖栅格化，粗糙的设计面也能覆盖所有格网单元
+            rasteriseSurface(referenceSurface_, referenceGrid_);
+        }
+        else
+        {
+            bool hadBounds = hasBounds_;
+            hasBounds_ = false; // 参考面不受 Z 范围过滤
+            rasterise(referenceSurface_, referenceGrid_);
+            hasBounds_ = hadBounds;
+        }
+    }
+
+    VolumeResult result = isMesh ? computeFromMesh(data) : computeFromCloud(grid);
+
+    // 还原 Z 轴拉伸
+    result.cut /= zScale_;
+    result.fill /= zScale_;
+    result.net = result.cut - result.fill;
+    return result;
+}
+
+VolumeResult VolumeCalculator::computeFromCloud(const Grid &grid)
+{
+    VolumeResult result;
+
+    const double cellArea = grid.cellSize * grid.cellSize;
+    for (int iy = 0; iy < grid.ny; ++iy)
+    {
+        for (int ix = 0; ix < grid.nx; ++ix)
+        {
+            std::size_t cell = static_cast<std::size_t>(iy) * grid.nx + ix;
+            if (grid.count[cell] == 0)
+                continue;
+            double cx = grid.origin[0] + (ix + 0.5) * grid.cellSize;
+            double cy = grid.origin[1] + (iy + 0.5) * grid.cellSize;
+            double ref = 0.0;
+            if (!insideRegion(cx, cy) || !referenceHeight(cx, cy, ref))
+                continue;
+            double d = grid.height[cell] - ref;
+            if (d > 0.0)
+                result.cut += d * cellArea;
+            else
+                result.fill -= d * cellArea;
+            result.area += cellArea;
+            ++result.samples;
+        }
+    }
+    result.cellSize = grid.cellSize;
+    result.valid = result.samples > 0;
+    return result;
+}
+
+VolumeResult VolumeCalculator::computeFromMesh(vtkPolyData *data)
+{
+    std::vector<vtkIdType> triangles = collectTriangles(data);
+
+    struct Accumulator
+    {
+        double cut = 0.0;
+        double fill = 0.0;
+        double area = 0.0;
+        vtkIdType count = 0;
+    };
+    vtkSMPThreadLocal<Accumulator> accumulators;
+
+    vtkPoints *points = data->GetPoints();
+    const vtkIdType numTriangles = static_cast<vtkIdType>(triangles.size() / 3);
+    vtkSMPTools::For(0, numTriangles, [&](vtkIdType begin, vtkIdType end)
+                     {
+        Accumulator &acc = accumulators.Local();
+        double p[3][3];
+        double h[3];
+        for (vtkIdType t = begin; t < end; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+                points->GetPoint(triangles[3 * t + k], p[k]);
+
+            double cx = (p[0][0] + p[1][0] + p[2][0]) / 3.0;
+            double cy = (p[0][1] + p[1][1] + p[2][1]) / 3.0;
+            double cz = (p[0][2] + p[1][2] + p[2][2]) / 3.0;
+            if (!insideRegion(cx, cy) || !insideZRange(cz))
+                continue;
+
+            bool hasReference = true;
+            for (int k = 0; k < 3 && hasReference; ++k)
+            {
+                double ref = 0.0;
+                hasReference = referenceHeight(p[k][0], p[k][1], ref);
+                h[k] = p[k][2] - ref;
+            }
+            if (!hasReference)
+                continue;
+
+            // 水平投影面积
+            double A = 0.5 * std::abs((p[1][0] - p[0][0]) * (p[2][1] - p[0][1]) -
+                                      (p[2][0] - p[0][0]) * (p[1][1] - p[0][1]));
+            if (A <= 0.0)
+                continue;
+            integrateTriangle(A, h[0], h[1], h[2], acc.cut, acc.fill);
+            acc.area += A;
+            ++acc.count;
+        } });
+
+    VolumeResult result;
+    for (auto it = accumulators.begin(); it != accumulators.end(); ++it)
+    {
+        result.cut += it->cut;
+        result.fill += it->fill;
+        result.area += it->area;
+        result.samples += it->count;
+    }
+    result.valid = result.samples > 0;
+    return result;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file VolumeCalculator.h
+ * @brief 该头文件定义了 VolumeCalculator 类，用于计算模型相对参考面的挖方（cut）、填方（fill）和净体积。
+ * @details 参考面可以是拾取的三点平面、自动拟合的基准面或第二个已加载的模型；计算区域可以是 XY 多边形
+ *          或箱体裁剪器的包围盒。点云按规则格网并行栅格化后逐格积分，网格按三角形逐个精确积分。
+ *          参考模型为网格时按三角形覆盖栅格化（格网中心处重心插值），为点云时按点分格平均。
+ */
+#pragma once
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <array>
+#include <vector>
+
+/**
+ * @struct VolumeResult
+ * @brief 体积计算结果，单位与模型坐标一致。
+ */
+struct VolumeResult
+{
+    bool valid = false;     ///< 是否有数据参与计算
+    double cut = 0.0;       ///< 高于参考面的体积（挖方）
+    double fill = 0.0;      ///< 低于参考面的体积（填方）
+    double net = 0.0;       ///< cut - fill
+    double area = 0.0;      ///< 参与计算的水平投影面积
+    vtkIdType samples = 0;  ///< 参与计算的格网单元数（点云）或三角形数（网格）
+    double cellSize = 0.0;  ///< 点云栅格单元边长，网格模式为 0
+};
+
+/**
+ * @class VolumeCalculator
+ * @brief 挖填方体积计算引擎，不依赖渲染器。
+ */
+class VolumeCalculator
+{
+public:
+    /**
+     * @enum ReferenceType
+     * @brief 参考面类型。
+     */
+    enum class ReferenceType
+    {
+        Plane,       ///< 指定平面（如拾取的三点）
+        FittedPlane, ///< 以区域边界处的高程最小二乘拟合基准面
+        Surface      ///< 第二个模型表面
+    };
+
+    /**
+     * @brief 以三点确定参考平面。
+     * @return 三点共线时返回 false。
+     */
+    bool setReferencePlane(const double p0[3], const double p1[3], const double p2[3]);
+
+    /**
+     * @brief 以高度平面 z = a*x + b*y + c 作为参考。
+     */
+    void setReferenceHeightPlane(double a, double b, double c);
+
+    /**
+     * @brief 使用区域边界拟合的基准面作为参考。
+     */
+    void setReferenceFitted();
+
+    /**
+     * @brief 使用第二个模型表面作为参考（与被测模型处于同一坐标系）。
+     */
+    void setReferenceSurface(vtkSmartPointer<vtkPolyData> surface);
+
+    /**
+     * @brief 设置 XY 平面上的计算多边形，少于 3 个点时表示不限制。
+     */
+    void setRegionPolygon(const std::vector<std::array<double, 2>> &polygon);
+
+    /**
+     * @brief 设置计算包围盒（如箱体裁剪器的盒子），Z 范围同时用于过滤点。
+     */
+    void setRegionBounds(const double bounds[6]);
+
+    /**
+     * @brief 清除区域限制，使用整个模型。
+     */
+    void clearRegion();
+
+    /**
+     * @brief 点云栅格化时长边方向的格网数，默认 1024。
+     */
+    void setGridResolution(int resolution) { gridResolution_ = resolution > 1 ? resolution : 2; }
+
+    /**
+     * @brief 设置显示时的 Z 轴拉伸比例，结果会除以该比例还原真实体积。
+     */
+    void setZScale(double zScale) { zScale_ = zScale > 0.0 ? zScale : 1.0; }
+
+    /**
+     * @brief 计算体积，含多边形单元的数据按网格积分，否则按点云栅格化。
+     */
+    VolumeResult compute(vtkPolyData *data);
+
+    ReferenceType getReferenceType() const { return referenceType_; }
+
+private:
+    // 栅格定义
+    struct Grid
+    {
+        double origin[2] = {0.0, 0.0};
+        double cellSize = 1.0;
+        int nx = 0;
+        int ny = 0;
+        std::vector<double> height; ///< 每格平均高程
+        std::vector<int> count;     ///< 每格点数，0 表示无数据
+    };
+
+    VolumeResult computeFromCloud(const Grid &grid);
+    VolumeResult computeFromMesh(vtkPolyData *data);
+
+    // 按区域与数据范围初始化格网参数
+    bool initGrid(vtkPolyData *data, Grid &grid) const;
+    // 将点栅格化到格网（并行），返回落入的点数
+    vtkIdType rasterise(vtkPolyData *data, Grid &grid) const;
+    // 将网格的三角形栅格化到格网（并行，格网中心处重心插值），返回覆盖了格网中心的三角形数
+    vtkIdType rasteriseSurface(vtkPolyData *surface, Grid &grid) const;
+    // 拟合区域边界格网单元的高程平面
+    bool fitBasePlane(const Grid &grid);
+    // 参考面高程，无参考数据时返回 false
+    bool referenceHeight(double x, double y, double &z) const;
+
+    bool insideRegion(double x, double y) const;
+    bool insideZRange(double z) const;
+
+    ReferenceType referenceType_ = ReferenceType::FittedPlane;
+    double plane_[3] = {0.0, 0.0, 0.0}; ///< z = plane_[0]*x + plane_[1]*y + plane_[2]
+    vtkSmartPointer<vtkPolyData> referenceSurface_;
+    Grid referenceGrid_; ///< 参考模型栅格化结果
+
+    std::vector<std::array<double, 2>> polygon_;
+    bool hasBounds_ = false;
+    double bounds_[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+    int gridResolution_ = 1024;
+    double zScale_ = 1.0;
+};